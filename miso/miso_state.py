@@ -64,6 +64,18 @@ class MISOState(om.ImplicitComponent):
         )
         self.options.declare("depends", types=list)
         self.options.declare("check_partials", default=False)
+        self.options.declare(
+            "warm_start_adjoint",
+            default=False,
+            desc="if True, start each adjoint solve from the adjoint of the "
+            "same solve in the previous linearization",
+        )
+        self.options.declare(
+            "scenario",
+            default="",
+            types=str,
+            desc="name of the operating point, keeps warm starts separate",
+        )
 
     def setup(self):
         solver = self.options["solver"]
@@ -195,6 +207,11 @@ class MISOState(om.ImplicitComponent):
         solver = self.options["solver"]
         solver.linearize(input_dict)
 
+        # OpenMDAO solves for the adjoints in the same order after every
+        # linearization, so a variable's name and the number of its adjoints
+        # solved so far identify the functional being solved for
+        self._adjoint_solves = dict()
+
     def apply_linear(self, inputs, outputs, d_inputs, d_outputs, d_residuals, mode):
         solver = self.options["solver"]
 
@@ -295,9 +312,24 @@ class MISOState(om.ImplicitComponent):
             # print(f"{solver_type} solver solving for adjoint!")
             if np.linalg.norm(d_outputs["state"], 2) != 0.0:
                 input_dict = self.linear_inputs
-                solver.solveForAdjoint(
-                    input_dict, d_outputs["state"], d_residuals["state"]
-                )
+                if self.options["warm_start_adjoint"]:
+                    # only solves that run are counted, so skipped (zero)
+                    # seeds do not shift the keys of the later solves
+                    solves = getattr(self, "_adjoint_solves", dict())
+                    adjoint_solve = solves.get("state", 0)
+                    solves["state"] = adjoint_solve + 1
+                    self._adjoint_solves = solves
+                    solver.solveForAdjoint(
+                        input_dict,
+                        d_outputs["state"],
+                        d_residuals["state"],
+                        f"state{adjoint_solve}",
+                        self.options["scenario"],
+                    )
+                else:
+                    solver.solveForAdjoint(
+                        input_dict, d_outputs["state"], d_residuals["state"]
+                    )
                 # print(f"adjoint norm: {np.linalg.norm(d_residuals['state'])}")
                 # solver.solveForAdjoint(input_dict,
                 #                        state_bar,
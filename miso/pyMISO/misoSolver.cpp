@@ -1,5 +1,6 @@
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
 #include <pybind11/pybind11.h>
@@ -185,6 +186,55 @@ void initSolver(py::module &m)
            py::arg("inputs"),
            py::arg("state_bar"),
            py::arg("adjoint"))
+       .def(
+           "solveForAdjoint",
+           [](AbstractSolver2 &self,
+              const py::dict &py_inputs,
+              const py::array_t<double> &state_bar,
+              const py::array_t<double> &adjoint,
+              const std::string &output,
+              const std::string &scenario)
+           {
+              auto inputs = pyDictToMISOInputs(py_inputs);
+              auto state_bar_vec = npBufferToMFEMVector(state_bar);
+              auto adjoint_vec = npBufferToMFEMVector(adjoint);
+              self.solveForAdjoint(
+                  inputs, state_bar_vec, adjoint_vec, output, scenario);
+           },
+           "Solve for the adjoint of \"output\", starting from the adjoint "
+           "last solved for the same \"output\" and \"scenario\"",
+           py::arg("inputs"),
+           py::arg("state_bar"),
+           py::arg("adjoint"),
+           py::arg("output"),
+           py::arg("scenario") = "")
+       .def(
+           "solveForAdjoints",
+           [](AbstractSolver2 &self,
+              const py::dict &py_inputs,
+              const py::array_t<double> &state_bars,
+              const py::array_t<double> &adjoints)
+           {
+              auto inputs = pyDictToMISOInputs(py_inputs);
+              auto state_bars_mat = npBufferToMFEMDenseMatrix(state_bars);
+              auto adjoints_mat = npBufferToMFEMDenseMatrix(adjoints);
+              /// `adjoints_mat` wraps the caller's buffer, so it must not be
+              /// resized by solveForAdjoints
+              if (adjoints_mat.Height() != state_bars_mat.Height() ||
+                  adjoints_mat.Width() != state_bars_mat.Width())
+              {
+                 throw std::runtime_error(
+                     "Incompatible shape:\n"
+                     "\texpected \"adjoints\" to have the same shape as "
+                     "\"state_bars\"!");
+              }
+              self.solveForAdjoints(inputs, state_bars_mat, adjoints_mat);
+           },
+           "Solve for the adjoints of each row of \"state_bars\" together, "
+           "storing them in the rows of \"adjoints\"",
+           py::arg("inputs"),
+           py::arg("state_bars"),
+           py::arg("adjoints"))
        .def(
            "calcResidual",
            [](AbstractSolver2 &self,
@@ -272,6 +322,21 @@ void initSolver(py::module &m)
            py::arg("inputs"),
            py::arg("out_vec"))
 
+       .def(
+           "calcOutputs",
+           [](AbstractSolver2 &self,
+              const std::vector<std::string> &outputs,
+              const py::dict &py_inputs)
+           {
+              mfem::Vector values;
+              self.calcOutputs(outputs, pyDictToMISOInputs(py_inputs), values);
+              return std::vector<double>(values.begin(), values.end());
+           },
+           "Calculate the scalar outputs listed in \"outputs\" together, "
+           "using \"inputs\", in one pass over the mesh",
+           py::arg("outputs"),
+           py::arg("inputs"))
+
        .def(
            "calcOutputPartial",
            [](AbstractSolver2 &self,
@@ -393,6 +458,11 @@ void initSolver(py::module &m)
            py::arg("res_bar"),
            py::arg("wrt"),
            py::arg("wrt_bar"))
+       .def("clearWarmStarts", &AbstractSolver2::clearWarmStarts)
+
+       .def("getTimings", &AbstractSolver2::getTimings)
+       .def("resetTimings", &AbstractSolver2::resetTimings)
+       .def("writeTimings", &AbstractSolver2::writeTimings, py::arg("filename"))
 
        //  .def("calcL2Error",
        //       [](AbstractSolver &self,
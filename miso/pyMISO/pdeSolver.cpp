@@ -4,6 +4,7 @@
 
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
@@ -101,5 +102,45 @@ void initPDESolver(py::module &m)
               auto mesh_coords_vec = npBufferToMFEMVector(mesh_coords);
               return self.getMeshCoordinates(mesh_coords_vec);
            },
-           py::arg("mesh_coords"));
+           py::arg("mesh_coords"))
+       .def(
+           "solveAtRotorPositions",
+           [](PDESolver &self,
+              const nlohmann::json &sweep_options,
+              const std::vector<double> &angles,
+              const py::dict &py_inputs,
+              const py::array_t<double> &state)
+           {
+              auto *solver = dynamic_cast<MagnetostaticSolver *>(&self);
+              if (solver == nullptr)
+              {
+                 throw std::runtime_error(
+                     "solveAtRotorPositions is only supported by "
+                     "magnetostatic solvers!\n");
+              }
+              auto inputs = pyDictToMISOInputs(py_inputs);
+              auto state_vec = npBufferToMFEMVector(state);
+              return solver->solveAtRotorPositions(
+                  sweep_options, angles, inputs, state_vec);
+           },
+           py::arg("sweep_options"),
+           py::arg("angles"),
+           py::arg("inputs"),
+           py::arg("state"));
+
+   m.def(
+       "sweepRotorPositions",
+       [](const nlohmann::json &solver_options,
+          const nlohmann::json &sweep_options,
+          const py::dict &py_inputs,
+          mpi_comm comm)
+       {
+          auto inputs = pyDictToMISOInputs(py_inputs);
+          return sweepRotorPositions(
+              comm, solver_options, sweep_options, inputs);
+       },
+       py::arg("solver_options"),
+       py::arg("sweep_options"),
+       py::arg("inputs") = py::dict(),
+       py::arg("comm") = mpi_comm(MPI_COMM_WORLD));
 }
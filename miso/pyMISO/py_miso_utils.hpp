@@ -73,6 +73,38 @@ inline mfem::Vector npBufferToMFEMVector(const py::array_t<double> &buffer)
    return {static_cast<double *>(info.ptr), static_cast<int>(info.shape[0])};
 }
 
+/// Wraps a C-ordered (num_vectors, size) array as a size x num_vectors
+/// `mfem::DenseMatrix`, whose columns are the rows of the array
+inline mfem::DenseMatrix npBufferToMFEMDenseMatrix(
+    const py::array_t<double> &buffer)
+{
+   auto info = buffer.request();
+   /* Some sanity checks ... */
+   if (info.format != py::format_descriptor<double>::format())
+   {
+      throw std::runtime_error(
+          "Incompatible format:\n"
+          "\texpected a double array!");
+   }
+   if (info.ndim != 2)
+   {
+      throw std::runtime_error(
+          "Incompatible dimensions:\n"
+          "\texpected a 2D array!");
+   }
+   if (info.strides[1] != sizeof(double) ||
+       info.strides[0] != info.shape[1] * sizeof(double))
+   {
+      throw std::runtime_error(
+          "Incompatible stride:\n"
+          "\texpected a C-contiguous array!");
+   }
+
+   return mfem::DenseMatrix(static_cast<double *>(info.ptr),
+                            static_cast<int>(info.shape[1]),
+                            static_cast<int>(info.shape[0]));
+}
+
 template <typename T>
 mfem::Array<T> npBufferToMFEMArray(const py::array_t<T> &buffer)
 {
@@ -0,0 +1,238 @@
+/// Microbenchmark of the flux Jacobians used by the Euler integrators
+///
+/// For each flux function and dimension, times "repeats" Jacobian evaluations
+/// through an Adept tape and through the `Dual` forward-mode numbers that the
+/// integrators use, and reports the largest difference between the two.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "adept.h"
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "dual_number.hpp"
+#include "euler_fluxes.hpp"
+#include "utils.hpp"
+
+using namespace std;
+using namespace mfem;
+using namespace miso;
+
+/// Analytical flux in direction `dir` at the left state
+template <int dim>
+struct EulerFlux
+{
+   template <typename xdouble>
+   void operator()(const xdouble *dir,
+                   const xdouble *qL,
+                   const xdouble *qR,
+                   xdouble *flux) const
+   {
+      calcEulerFlux<xdouble, dim>(dir, qL, flux);
+   }
+};
+
+/// Entropy-conservative Ismail-Roe flux in the first coordinate direction
+template <int dim>
+struct IsmailRoeFlux
+{
+   template <typename xdouble>
+   void operator()(const xdouble *dir,
+                   const xdouble *qL,
+                   const xdouble *qR,
+                   xdouble *flux) const
+   {
+      calcIsmailRoeFlux<xdouble, dim>(0, qL, qR, flux);
+   }
+};
+
+/// Ismail-Roe face flux with dissipation, as used by `InterfaceIntegrator`
+template <int dim>
+struct IsmailRoeFaceFlux
+{
+   double diss_coeff;
+
+   template <typename xdouble>
+   void operator()(const xdouble *dir,
+                   const xdouble *qL,
+                   const xdouble *qR,
+                   xdouble *flux) const
+   {
+      calcIsmailRoeFaceFluxWithDiss<xdouble, dim>(
+          dir, xdouble(diss_coeff), qL, qR, flux);
+   }
+};
+
+/// Slip-wall flux at the left state, as used by `SlipWallBC`
+template <int dim>
+struct SlipWallFlux
+{
+   template <typename xdouble>
+   void operator()(const xdouble *dir,
+                   const xdouble *qL,
+                   const xdouble *qR,
+                   xdouble *flux) const
+   {
+      calcSlipWallFlux<xdouble, dim, false>(dir, dir, qL, flux);
+   }
+};
+
+/// Far-field flux at the left state with the right state as the free
+/// stream, as used by `FarFieldBC`
+template <int dim>
+struct FarFieldFlux
+{
+   template <typename xdouble>
+   void operator()(const xdouble *dir,
+                   const xdouble *qL,
+                   const xdouble *qR,
+                   xdouble *flux) const
+   {
+      xdouble work[dim + 2];
+      calcFarFieldFlux<xdouble, dim, false>(dir, qR, qL, work, flux);
+   }
+};
+
+/// Time the Jacobians of `flux` w.r.t. its left state, and also its right
+/// state if `two_states` is true, taped by Adept and from dual numbers
+/// \param[in] name - name of the flux function to report
+/// \param[in] flux - the flux function
+/// \param[in] repeats - number of Jacobians to time for each approach
+/// \param[in] out - stream to report to
+template <int dim, bool two_states, typename Flux>
+void benchmark(const string &name, Flux flux, int repeats, ostream &out);
+
+/// Run the benchmark for each flux function in dimension `dim`
+template <int dim>
+void benchmarkFluxes(double diss_coeff, int repeats, ostream &out)
+{
+   benchmark<dim, false>("euler", EulerFlux<dim>{}, repeats, out);
+   benchmark<dim, true>("ismail-roe", IsmailRoeFlux<dim>{}, repeats, out);
+   benchmark<dim, true>(
+       "ismail-roe-face", IsmailRoeFaceFlux<dim>{diss_coeff}, repeats, out);
+   benchmark<dim, false>("slip-wall", SlipWallFlux<dim>{}, repeats, out);
+   benchmark<dim, false>("far-field", FarFieldFlux<dim>{}, repeats, out);
+}
+
+int main(int argc, char *argv[])
+{
+   MPI_Init(&argc, &argv);
+   int rank = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   ostream *out = getOutStream(rank);
+
+   // Parse command-line options
+   OptionsParser args(argc, argv);
+   const char *options_file = "euler_flux_jacobians_options.json";
+   args.AddOption(&options_file, "-o", "--options", "Options file to use.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      MPI_Finalize();
+      return 1;
+   }
+
+   nlohmann::json options;
+   ifstream options_stream(options_file);
+   options_stream >> options;
+   const int repeats = options["repeats"].get<int>();
+   const double diss_coeff = options["diss-coeff"].get<double>();
+
+   *out << "repeats: " << repeats << "\n";
+   benchmarkFluxes<1>(diss_coeff, repeats, *out);
+   benchmarkFluxes<2>(diss_coeff, repeats, *out);
+   benchmarkFluxes<3>(diss_coeff, repeats, *out);
+
+   MPI_Finalize();
+   return 0;
+}
+
+template <int dim, bool two_states, typename Flux>
+void benchmark(const string &name, Flux flux, int repeats, ostream &out)
+{
+   constexpr int num_states = dim + 2;
+   constexpr int num_indep = two_states ? 2 * num_states : num_states;
+
+   // a physical pair of states and a direction
+   double dir[dim];
+   double qL[num_states];
+   double qR[num_states];
+   qL[0] = 1.0;
+   qR[0] = 0.9;
+   for (int di = 0; di < dim; ++di)
+   {
+      dir[di] = 0.6 - 0.4 * di;
+      qL[di + 1] = 0.3 - 0.2 * di;
+      qR[di + 1] = 0.25 - 0.15 * di;
+   }
+   qL[dim + 1] = 2.0;
+   qR[dim + 1] = 2.2;
+
+   // Jacobian taped by Adept
+   adept::Stack stack;
+   DenseMatrix jac_adept(num_states, num_indep);
+   vector<adouble> dir_a(dim);
+   vector<adouble> qL_a(num_states);
+   vector<adouble> qR_a(num_states);
+   double start = MPI_Wtime();
+   for (int i = 0; i < repeats; ++i)
+   {
+      adept::set_values(dir_a.data(), dim, dir);
+      adept::set_values(qL_a.data(), num_states, qL);
+      adept::set_values(qR_a.data(), num_states, qR);
+      stack.new_recording();
+      vector<adouble> flux_a(num_states);
+      flux(dir_a.data(), qL_a.data(), qR_a.data(), flux_a.data());
+      stack.independent(qL_a.data(), num_states);
+      if (two_states)
+      {
+         stack.independent(qR_a.data(), num_states);
+      }
+      stack.dependent(flux_a.data(), num_states);
+      stack.jacobian(jac_adept.GetData());
+   }
+   const double adept_time = (MPI_Wtime() - start) / repeats;
+
+   // Jacobian from dual numbers
+   using dual_t = Dual<num_indep>;
+   DenseMatrix jac_dual(num_states, num_indep);
+   start = MPI_Wtime();
+   for (int i = 0; i < repeats; ++i)
+   {
+      dual_t dir_d[dim];
+      dual_t qL_d[num_states];
+      dual_t qR_d[num_states];
+      setDualValues(dir, dim, dir_d);
+      seedDual(qL, num_states, 0, qL_d);
+      if (two_states)
+      {
+         seedDual(qR, num_states, num_states, qR_d);
+      }
+      else
+      {
+         setDualValues(qR, num_states, qR_d);
+      }
+      dual_t flux_d[num_states];
+      flux(dir_d, qL_d, qR_d, flux_d);
+      getDualJacobian(flux_d, num_states, 0, num_indep, jac_dual.GetData());
+   }
+   const double dual_time = (MPI_Wtime() - start) / repeats;
+
+   double max_diff = 0.0;
+   for (int j = 0; j < num_indep; ++j)
+   {
+      for (int i = 0; i < num_states; ++i)
+      {
+         max_diff = max(max_diff, fabs(jac_adept(i, j) - jac_dual(i, j)));
+      }
+   }
+   out << "dim: " << dim << ", " << name << ": adept " << adept_time * 1e6
+       << " us, dual " << dual_time * 1e6 << " us, speed-up "
+       << adept_time / dual_time << ", max |difference| " << max_diff << "\n";
+}
@@ -0,0 +1,179 @@
+/// Benchmark of time-step throughput with state logging off, synchronous, and
+/// asynchronous
+///
+/// Each "time step" applies a mass matrix "work-per-step" times to a state
+/// with "num-states" components per node, and then logs the state, as
+/// `AbstractSolver2` does with "each-timestep" loggers.  Synchronous logging
+/// waits for each write, as with "log-buffers": 0, while asynchronous logging
+/// writes through a ring of "log-buffers" buffers.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "data_logging.hpp"
+#include "utils.hpp"
+
+using namespace std;
+using namespace mfem;
+using namespace miso;
+
+/// Time `num_steps` steps of applying `mass` `work` times to `state`, and
+/// logging it with `logger` unless it is null
+/// \param[in] name - name of the run to report
+/// \param[in] mass - the operator applied at each step
+/// \param[inout] state - the state to step
+/// \param[in] num_steps - number of steps to time
+/// \param[in] work - number of times `mass` is applied at each step
+/// \param[in] logger - the logger to use, or null to not log
+/// \param[in] num_buffers - buffers of the asynchronous logger, or zero to wait
+/// for each write
+/// \param[in] out - stream to report to
+/// \return the wall-clock time per step
+double benchmark(const string &name,
+                 const HypreParMatrix &mass,
+                 Vector &state,
+                 int num_steps,
+                 int work,
+                 DataLogger *logger,
+                 int num_buffers,
+                 ostream &out);
+
+int main(int argc, char *argv[])
+{
+   MPI_Init(&argc, &argv);
+   int rank = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   ostream *out = getOutStream(rank);
+
+   // Parse command-line options
+   OptionsParser args(argc, argv);
+   const char *options_file = "logging_throughput_options.json";
+   args.AddOption(&options_file, "-o", "--options", "Options file to use.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      MPI_Finalize();
+      return 1;
+   }
+
+   nlohmann::json options;
+   ifstream options_stream(options_file);
+   options_stream >> options;
+   const int num_elements = options["num-elements"].get<int>();
+   const int degree = options["degree"].get<int>();
+   const int num_states = options["num-states"].get<int>();
+   const int num_steps = options["num-steps"].get<int>();
+   const int work = options["work-per-step"].get<int>();
+   const int num_buffers = options["log-buffers"].get<int>();
+
+   {
+      auto smesh = Mesh::MakeCartesian3D(num_elements,
+                                         num_elements,
+                                         num_elements,
+                                         Element::HEXAHEDRON);
+      ParMesh mesh(MPI_COMM_WORLD, smesh);
+      H1_FECollection fec(degree, mesh.Dimension());
+      ParFiniteElementSpace fes(&mesh, &fec, num_states, Ordering::byNODES);
+
+      ParBilinearForm mass_form(&fes);
+      mass_form.AddDomainIntegrator(new VectorMassIntegrator);
+      mass_form.Assemble();
+      mass_form.Finalize();
+      std::unique_ptr<HypreParMatrix> mass(mass_form.ParallelAssemble());
+
+      const auto num_dofs = fes.GlobalTrueVSize();
+      *out << "true dofs: " << num_dofs << ", state size: "
+           << num_dofs * sizeof(double) / 1e6 << " MB, steps: " << num_steps
+           << ", buffers: " << num_buffers << "\n";
+
+      Vector state(fes.GetTrueVSize());
+      state = 1.0;
+      ParGridFunction state_gf(&fes);
+
+      const double base_time = benchmark(
+          "no logging", *mass, state, num_steps, work, nullptr, 0, *out);
+
+      DataLogger binary = BinaryLogger{};
+      benchmark("binary, synchronous", *mass, state, num_steps, work, &binary,
+                0, *out);
+      const double binary_time =
+          benchmark("binary, asynchronous", *mass, state, num_steps, work,
+                    &binary, num_buffers, *out);
+
+      DataLogger paraview_sync =
+          ParaViewLogger("logging_throughput_sync", &mesh, 1);
+      std::get<ParaViewLogger>(paraview_sync).registerField("state", state_gf);
+      benchmark("paraview, synchronous", *mass, state, num_steps, work,
+                &paraview_sync, 0, *out);
+
+      DataLogger paraview = ParaViewLogger(
+          "logging_throughput_async", &mesh, std::max(num_buffers, 1));
+      std::get<ParaViewLogger>(paraview).registerField("state", state_gf);
+      const double paraview_time =
+          benchmark("paraview, asynchronous", *mass, state, num_steps, work,
+                    &paraview, num_buffers, *out);
+
+      *out << "asynchronous logging overhead: binary "
+           << 100.0 * (binary_time / base_time - 1.0) << "%, paraview "
+           << 100.0 * (paraview_time / base_time - 1.0) << "%\n";
+   }
+
+   MPI_Finalize();
+   return 0;
+}
+
+double benchmark(const string &name,
+                 const HypreParMatrix &mass,
+                 Vector &state,
+                 int num_steps,
+                 int work,
+                 DataLogger *logger,
+                 int num_buffers,
+                 ostream &out)
+{
+   int rank = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   AsyncStateLogger state_logger(num_buffers);
+   Vector work_vec(state.Size());
+
+   MPI_Barrier(MPI_COMM_WORLD);
+   const double start = MPI_Wtime();
+   for (int step = 0; step < num_steps; ++step)
+   {
+      for (int i = 0; i < work; ++i)
+      {
+         mass.Mult(state, work_vec);
+         const double norm = sqrt(InnerProduct(MPI_COMM_WORLD, work_vec,
+                                               work_vec));
+         state.Set(1.0 / norm, work_vec);
+      }
+      if (logger != nullptr)
+      {
+         state_logger.saveState(*logger, state, "state", step, step, rank);
+         if (num_buffers < 1)
+         {
+            state_logger.flush(*logger);
+         }
+      }
+   }
+   const double step_time = (MPI_Wtime() - start) / num_steps;
+   /// the final writes are part of the run's cost, but not of its throughput
+   const double flush_start = MPI_Wtime();
+   if (logger != nullptr)
+   {
+      state_logger.flush(*logger);
+   }
+   const double flush_time = MPI_Wtime() - flush_start;
+
+   out << name << ": " << 1.0 / step_time << " steps/s, " << step_time * 1e3
+       << " ms/step, final flush " << flush_time * 1e3 << " ms\n";
+   return step_time;
+}
@@ -0,0 +1,219 @@
+/// Hybrid MPI + threads assembly benchmark on the magnetostatic box case
+///
+/// Times repeated residual evaluations and Jacobian assemblies of the box
+/// case's curl-curl form for each entry of "assembly-threads" in the options
+/// file. Run with e.g. `OMP_NUM_THREADS=4 mpirun -np 2 ...` to compare ranks
+/// and threads; MISO must be configured with MISO_USE_OPENMP for more than
+/// one thread to be used.
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "coefficient.hpp"
+#include "electromag_integ.hpp"
+#include "finite_element_state.hpp"
+#include "miso_input.hpp"
+#include "miso_nonlinearform.hpp"
+#include "utils.hpp"
+
+using namespace std;
+using namespace mfem;
+using namespace miso;
+
+/// Linear reluctivity of the box case's materials
+class BoxReluctivity : public StateCoefficient
+{
+public:
+   BoxReluctivity(double mu_r) : nu(1.0 / (4e-7 * M_PI * mu_r)) { }
+
+   double Eval(ElementTransformation &trans,
+               const IntegrationPoint &ip,
+               const double state) override
+   {
+      return nu;
+   }
+
+   double EvalStateDeriv(ElementTransformation &trans,
+                         const IntegrationPoint &ip,
+                         const double state) override
+   {
+      return 0.0;
+   }
+
+private:
+   double nu;
+};
+
+/// Generate the box case's mesh, with attribute 1 below y = 0.5 and 2 above
+/// \param[in] nxy - number of elements in the x and y directions
+/// \param[in] nz - number of elements in the z direction
+Mesh buildMesh(int nxy, int nz);
+
+int main(int argc, char *argv[])
+{
+   // element assembly threads never call MPI, so funneled support is enough
+   int provided = 0;
+   MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+   int rank = 0;
+   int num_ranks = 1;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+   ostream *out = getOutStream(rank);
+
+   // Parse command-line options
+   OptionsParser args(argc, argv);
+   const char *options_file = "magnetostatic_box_threads_options.json";
+   args.AddOption(&options_file, "-o", "--options", "Options file to use.");
+   int nxy = 16;
+   int nz = 16;
+   args.AddOption(
+       &nxy, "-nxy", "--numxy", "Number of elements in x and y directions");
+   args.AddOption(&nz, "-nz", "--numz", "Number of elements in z direction");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      MPI_Finalize();
+      return 1;
+   }
+
+   nlohmann::json options;
+   ifstream options_stream(options_file);
+   options_stream >> options;
+
+   auto smesh = buildMesh(nxy, nz);
+   ParMesh mesh(MPI_COMM_WORLD, smesh);
+   smesh.Clear();
+   mesh.EnsureNodes();
+
+   const int order = options["space-dis"]["degree"].get<int>();
+   const int repeats = options["repeats"].get<int>();
+
+   map<string, FiniteElementState> fields;
+   fields.emplace(
+       piecewise_construct,
+       forward_as_tuple("state"),
+       forward_as_tuple(
+           mesh,
+           FiniteElementState::Options{
+               .order = order,
+               .coll = make_unique<ND_FECollection>(order, mesh.Dimension())}));
+   auto &mesh_gf = *dynamic_cast<ParGridFunction *>(mesh.GetNodes());
+   fields.emplace(piecewise_construct,
+                  forward_as_tuple("mesh_coords"),
+                  forward_as_tuple(mesh, *mesh_gf.ParFESpace(), "mesh_coords"));
+   auto &state = fields.at("state");
+
+   MeshDependentCoefficient nu;
+   nu.addCoefficient(
+       1, make_unique<BoxReluctivity>(options["mu_r"]["box1"].get<double>()));
+   nu.addCoefficient(
+       2, make_unique<BoxReluctivity>(options["mu_r"]["box2"].get<double>()));
+
+   Vector state_tv(state.space().GetTrueVSize());
+   state_tv.Randomize(rank);
+   MISOInputs inputs{{"state", state_tv}};
+
+   const auto global_size = state.space().GlobalTrueVSize();
+   *out << "ranks: " << num_ranks << ", elements: " << mesh.GetGlobalNE()
+        << ", dofs: " << global_size << ", degree: " << order << "\n";
+
+   for (const auto &threads : options["assembly-threads"])
+   {
+      MISONonlinearForm form(state.space(), fields);
+      form.addDomainIntegrator(new CurlCurlNLFIntegrator(nu));
+      setOptions(form,
+                 {{"assembly-threads", threads.get<int>()},
+                  {"geometric-cache", options["geometric-cache"]}});
+
+      // warm up; this also fills the geometric factor cache
+      Vector res_vec(getSize(form));
+      evaluate(form, inputs, res_vec);
+      getJacobian(form, inputs, "state");
+
+      MPI_Barrier(MPI_COMM_WORLD);
+      double start = MPI_Wtime();
+      for (int i = 0; i < repeats; ++i)
+      {
+         evaluate(form, inputs, res_vec);
+      }
+      double local_res_time = (MPI_Wtime() - start) / repeats;
+
+      MPI_Barrier(MPI_COMM_WORLD);
+      start = MPI_Wtime();
+      for (int i = 0; i < repeats; ++i)
+      {
+         getJacobian(form, inputs, "state");
+      }
+      double local_jac_time = (MPI_Wtime() - start) / repeats;
+
+      double res_time = 0.0;
+      double jac_time = 0.0;
+      MPI_Reduce(&local_res_time,
+                 &res_time,
+                 1,
+                 MPI_DOUBLE,
+                 MPI_MAX,
+                 0,
+                 MPI_COMM_WORLD);
+      MPI_Reduce(&local_jac_time,
+                 &jac_time,
+                 1,
+                 MPI_DOUBLE,
+                 MPI_MAX,
+                 0,
+                 MPI_COMM_WORLD);
+
+      const double norm =
+          sqrt(InnerProduct(MPI_COMM_WORLD, res_vec, res_vec));
+      *out << "threads per rank: " << threads
+           << ", residual: " << res_time << " s"
+           << ", jacobian: " << jac_time << " s"
+           << ", |R|: " << norm << "\n";
+   }
+
+   MPI_Finalize();
+   return 0;
+}
+
+Mesh buildMesh(int nxy, int nz)
+{
+   auto mesh = Mesh::MakeCartesian3D(nxy,
+                                     nxy,
+                                     nz,
+                                     Element::TETRAHEDRON,
+                                     1.0,
+                                     1.0,
+                                     (double)nz / (double)nxy,
+                                     true);
+
+   // assign attributes to top and bottom sides
+   for (int i = 0; i < mesh.GetNE(); ++i)
+   {
+      Element *elem = mesh.GetElement(i);
+
+      Array<int> verts;
+      elem->GetVertices(verts);
+
+      bool below = true;
+      for (int j = 0; j < verts.Size(); ++j)
+      {
+         auto *vtx = mesh.GetVertex(verts[j]);
+         if (vtx[1] > 0.5)
+         {
+            below = false;
+         }
+      }
+      elem->SetAttribute(below ? 1 : 2);
+   }
+   mesh.SetAttributes();
+
+   return mesh;
+}
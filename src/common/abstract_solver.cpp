@@ -1,25 +1,14 @@
+#include <fstream>
+#include <iomanip>
+
 #include "default_options.hpp"
+#include "functional_output.hpp"
 #include "mfem_extensions.hpp"
+#include "timers.hpp"
 #include "utils.hpp"
 
 #include "abstract_solver.hpp"
 
-namespace
-{
-void logState(miso::DataLogger &logger,
-              const mfem::Vector &state,
-              std::string fieldname,
-              int timestep,
-              double time,
-              int rank)
-{
-   std::visit([&](auto &&log)
-              { log.saveState(state, fieldname, timestep, time, rank); },
-              logger);
-}
-
-}  // namespace
-
 namespace miso
 {
 AbstractSolver2::AbstractSolver2(MPI_Comm incomm,
@@ -40,6 +29,9 @@ AbstractSolver2::AbstractSolver2(MPI_Comm incomm,
    {
       *out << std::setw(3) << options << std::endl;
    }
+
+   state_logger = std::make_unique<AsyncStateLogger>(
+       background_writer, options["log-buffers"].get<int>());
 }
 
 void AbstractSolver2::setState_(std::any function,
@@ -81,11 +73,23 @@ double AbstractSolver2::calcStateError_(std::any ex_sol,
 void AbstractSolver2::solveForState(const MISOInputs &inputs,
                                     mfem::Vector &state)
 {
+   ScopedTimer timer("solveForState");
+
    if (spatial_res)
    {
       setInputs(*spatial_res, inputs);
    }
 
+   /// time the Newton solver's linear solves; an adaptive linear tolerance
+   /// needs the Newton solver to see the linear solver itself
+   if (nonlinear_solver && linear_solver && !profiled_linear_solver &&
+       options["nonlin-solver"]["type"].get<std::string>() != "inexactnewton")
+   {
+      profiled_linear_solver =
+          std::make_unique<ProfiledLinearSolver>(*linear_solver);
+      nonlinear_solver->SetSolver(*profiled_linear_solver);
+   }
+
    /// if solving an unsteady problem
    if (ode)
    {
@@ -118,25 +122,50 @@ void AbstractSolver2::solveForState(const MISOInputs &inputs,
    {
       initialHook(state);
 
+      const bool extrapolate =
+          options["nonlin-solver"]["state-extrapolation"].get<bool>();
+      const bool extrapolated = extrapolate && extrapolateState(state);
+
       /// use input state as initial guess
       nonlinear_solver->iterative_mode = true;
 
       mfem::Vector zero;
       nonlinear_solver->Mult(zero, state);
+      forward_prec_set_up = true;
+      timers().count("newton-iterations", nonlinear_solver->GetNumIterations());
+      if (extrapolated)
+      {
+         timers().count("extrapolated-newton-iterations",
+                        nonlinear_solver->GetNumIterations());
+      }
+      if (extrapolate && nonlinear_solver->GetConverged())
+      {
+         if (converged_states.size() == 2)
+         {
+            converged_states.erase(converged_states.begin());
+         }
+         converged_states.push_back(state);
+      }
 
       /// log final state
       for (auto &pair : loggers)
       {
          auto &logger = pair.first;
-         logState(logger, state, "state", 1, 1.0, rank);
+         logState(logger, state, "state", 1, 1.0);
       }
+      flushLoggers();
    }
+
+   timer.stop();
+   logTimings();
 }
 
 void AbstractSolver2::solveForAdjoint(const MISOInputs &inputs,
                                       const mfem::Vector &state_bar,
                                       mfem::Vector &adjoint)
 {
+   ScopedTimer timer("solveForAdjoint");
+
    if (spatial_res)
    {
       setInputs(*spatial_res, inputs);
@@ -151,26 +180,160 @@ void AbstractSolver2::solveForAdjoint(const MISOInputs &inputs,
    }
    else  /// steady problem
    {
-      /// Create adjoint linear solver if we have not already
-      if (!adj_solver)
+      constructAdjointSolver();
+      if (adj_prec)
       {
-         auto *prec = getPreconditioner(*spatial_res);
-         adj_solver = constructLinearSolver(comm, options["adj-solver"], prec);
+         adj_prec->setForwardSetUp(forward_prec_set_up);
       }
 
       work.SetSize(state_bar.Size());
       work = state_bar;
       setUpAdjointSystem(*spatial_res, *adj_solver, inputs, work, adjoint);
+      /// the adjoint preconditioner sets up the forward preconditioner if a
+      /// Newton solve has not
+      forward_prec_set_up = forward_prec_set_up || adj_prec != nullptr;
 
-      adj_solver->Mult(work, adjoint);
+      {
+         ScopedTimer solve_timer("linear-solve");
+         adj_solver->Mult(work, adjoint);
+      }
+      timers().count("krylov-iterations", getNumIterations(*adj_solver));
+      /// without the adjoint preconditioner, the forward preconditioner has
+      /// now been set up for the transposed Jacobian
+      if (lagged_prec && !adj_prec)
+      {
+         lagged_prec->invalidate();
+      }
 
       /// log final state
       for (auto &pair : loggers)
       {
          auto &logger = pair.first;
-         logState(logger, adjoint, "adjoint", 0, 0.0, rank);
+         logState(logger, adjoint, "adjoint", 0, 0.0);
+      }
+      flushLoggers();
+   }
+
+   timer.stop();
+   logTimings();
+}
+
+void AbstractSolver2::solveForAdjoint(const MISOInputs &inputs,
+                                      const mfem::Vector &state_bar,
+                                      mfem::Vector &adjoint,
+                                      const std::string &output,
+                                      const std::string &scenario)
+{
+   if (ode)
+   {
+      solveForAdjoint(inputs, state_bar, adjoint);
+      return;
+   }
+
+   const auto key = scenario.empty() ? output : scenario + "/" + output;
+   auto cached = adjoint_cache.find(key);
+   const bool warm_start = cached != adjoint_cache.end() &&
+                           cached->second.Size() == state_bar.Size();
+   adjoint.SetSize(state_bar.Size());
+   if (warm_start)
+   {
+      adjoint = cached->second;
+   }
+   else
+   {
+      adjoint = 0.0;
+   }
+
+   constructAdjointSolver();
+   const bool iterative_mode = adj_solver->iterative_mode;
+   adj_solver->iterative_mode = warm_start;
+   solveForAdjoint(inputs, state_bar, adjoint);
+   adj_solver->iterative_mode = iterative_mode;
+
+   const int iterations = getNumIterations(*adj_solver);
+   if (warm_start)
+   {
+      timers().count("adjoint-warm-starts");
+      timers().count("warm-started-krylov-iterations", iterations);
+   }
+   else
+   {
+      timers().count("adjoint-cold-starts");
+      timers().count("cold-started-krylov-iterations", iterations);
+   }
+   adjoint_cache[key] = adjoint;
+}
+
+void AbstractSolver2::clearWarmStarts()
+{
+   adjoint_cache.clear();
+   converged_states.clear();
+}
+
+void AbstractSolver2::solveForAdjoints(const MISOInputs &inputs,
+                                       const mfem::DenseMatrix &state_bars,
+                                       mfem::DenseMatrix &adjoints)
+{
+   ScopedTimer timer("solveForAdjoints");
+
+   if (spatial_res)
+   {
+      setInputs(*spatial_res, inputs);
+   }
+
+   if (ode)
+   {
+      throw MISOException(
+          "AbstractSolver2::solveForAdjoints not implemented for unsteady "
+          "problems!\n");
+   }
+
+   constructAdjointSolver();
+   if (adj_prec)
+   {
+      adj_prec->setForwardSetUp(forward_prec_set_up);
+   }
+
+   const int size = state_bars.Height();
+   const int num_rhs = state_bars.Width();
+   adjoints.SetSize(size, num_rhs);
+   adjoints = 0.0;
+   work.SetSize(size);
+
+   /// after the first column sets the operator, the others reuse the
+   /// transposed Jacobian and preconditioner setup it left in `adj_solver`
+   FixedOperatorSolver fixed_adj_solver(*adj_solver);
+   for (int i = 0; i < num_rhs; ++i)
+   {
+      mfem::Vector state_bar(const_cast<double *>(state_bars.GetColumn(i)),
+                             size);
+      mfem::Vector adjoint(adjoints.GetColumn(i), size);
+
+      work = state_bar;
+      if (i == 0)
+      {
+         setUpAdjointSystem(*spatial_res, *adj_solver, inputs, work, adjoint);
+      }
+      else
+      {
+         setUpAdjointSystem(
+             *spatial_res, fixed_adj_solver, inputs, work, adjoint);
+      }
+
+      {
+         ScopedTimer solve_timer("linear-solve");
+         adj_solver->Mult(work, adjoint);
       }
+      timers().count("krylov-iterations", getNumIterations(*adj_solver));
+   }
+   forward_prec_set_up = forward_prec_set_up || adj_prec != nullptr;
+   if (lagged_prec && !adj_prec)
+   {
+      lagged_prec->invalidate();
    }
+
+   timer.stop();
+   logTimings();
 }
 
 void AbstractSolver2::calcResidual(const mfem::Vector &state,
@@ -285,6 +448,8 @@ void AbstractSolver2::setOutputOptions(const std::string &output,
 double AbstractSolver2::calcOutput(const std::string &output,
                                    const MISOInputs &inputs)
 {
+   ScopedTimer timer("calcOutput:" + output);
+
    try
    {
       auto output_iter = outputs.find(output);
@@ -306,6 +471,8 @@ void AbstractSolver2::calcOutput(const std::string &output,
                                  const MISOInputs &inputs,
                                  mfem::Vector &out_vec)
 {
+   ScopedTimer timer("calcOutput:" + output);
+
    try
    {
       auto output_iter = outputs.find(output);
@@ -329,11 +496,65 @@ void AbstractSolver2::calcOutput(const std::string &output,
    }
 }
 
+void AbstractSolver2::calcOutputs(const std::vector<std::string> &names,
+                                  const MISOInputs &inputs,
+                                  mfem::Vector &values)
+{
+   ScopedTimer timer("calcOutputs");
+
+   const int num_outputs = static_cast<int>(names.size());
+   values.SetSize(num_outputs);
+   try
+   {
+      std::vector<MISOOutput *> requested(num_outputs);
+      std::vector<FunctionalOutput *> functionals;
+      /// the functionals of output i are functionals[offsets[i]:offsets[i+1]]
+      std::vector<int> offsets(num_outputs + 1, 0);
+      for (int i = 0; i < num_outputs; ++i)
+      {
+         auto output_iter = outputs.find(names[i]);
+         if (output_iter == outputs.end())
+         {
+            throw MISOException("Did not find " + names[i] +
+                                " in output map!\n");
+         }
+         requested[i] = &output_iter->second;
+         setInputs(*requested[i], inputs);
+         addFunctionals(*requested[i], functionals);
+         offsets[i + 1] = static_cast<int>(functionals.size());
+      }
+
+      /// the inputs were set on the functionals along with their outputs
+      mfem::Vector functional_values;
+      miso::calcOutputs(functionals, inputs, functional_values, true);
+
+      for (int i = 0; i < num_outputs; ++i)
+      {
+         if (offsets[i + 1] > offsets[i])
+         {
+            values(i) = calcOutputFromFunctionals(
+                *requested[i], functional_values.GetData() + offsets[i]);
+         }
+         else
+         {
+            values(i) = miso::calcOutput(*requested[i], inputs);
+         }
+      }
+   }
+   catch (const std::out_of_range &exception)
+   {
+      std::cerr << exception.what() << std::endl;
+      values = std::nan("");
+   }
+}
+
 void AbstractSolver2::calcOutputPartial(const std::string &of,
                                         const std::string &wrt,
                                         const MISOInputs &inputs,
                                         double &partial)
 {
+   ScopedTimer timer("calcOutputPartial:" + of);
+
    try
    {
       auto output_iter = outputs.find(of);
@@ -357,6 +578,8 @@ void AbstractSolver2::calcOutputPartial(const std::string &of,
                                         const MISOInputs &inputs,
                                         mfem::Vector &partial)
 {
+   ScopedTimer timer("calcOutputPartial:" + of);
+
    try
    {
       auto output_iter = outputs.find(of);
@@ -379,6 +602,8 @@ void AbstractSolver2::outputJacobianVectorProduct(const std::string &of,
                                                   const std::string &wrt,
                                                   mfem::Vector &out_dot)
 {
+   ScopedTimer timer("outputJacobianVectorProduct:" + of);
+
    try
    {
       auto output_iter = outputs.find(of);
@@ -409,6 +634,8 @@ void AbstractSolver2::outputVectorJacobianProduct(const std::string &of,
                                                   const std::string &wrt,
                                                   mfem::Vector &wrt_bar)
 {
+   ScopedTimer timer("outputVectorJacobianProduct:" + of);
+
    try
    {
       auto output_iter = outputs.find(of);
@@ -451,6 +678,8 @@ void AbstractSolver2::linearize(const MISOInputs &inputs)
 double AbstractSolver2::jacobianVectorProduct(const mfem::Vector &wrt_dot,
                                               const std::string &wrt)
 {
+   ScopedTimer timer("jacobianVectorProduct:" + wrt);
+
    /// if solving an unsteady problem
    if (ode)
    {
@@ -468,6 +697,8 @@ void AbstractSolver2::jacobianVectorProduct(const mfem::Vector &wrt_dot,
                                             const std::string &wrt,
                                             mfem::Vector &res_dot)
 {
+   ScopedTimer timer("jacobianVectorProduct:" + wrt);
+
    /// if solving an unsteady problem
    if (ode)
    {
@@ -483,6 +714,8 @@ void AbstractSolver2::jacobianVectorProduct(const mfem::Vector &wrt_dot,
 double AbstractSolver2::vectorJacobianProduct(const mfem::Vector &res_bar,
                                               const std::string &wrt)
 {
+   ScopedTimer timer("vectorJacobianProduct:" + wrt);
+
    /// if solving an unsteady problem
    if (ode)
    {
@@ -500,6 +733,8 @@ void AbstractSolver2::vectorJacobianProduct(const mfem::Vector &res_bar,
                                             const std::string &wrt,
                                             mfem::Vector &wrt_bar)
 {
+   ScopedTimer timer("vectorJacobianProduct:" + wrt);
+
    /// if solving an unsteady problem
    if (ode)
    {
@@ -513,15 +748,168 @@ void AbstractSolver2::vectorJacobianProduct(const mfem::Vector &res_bar,
    }
 }
 
+nlohmann::json AbstractSolver2::getTimings() const
+{
+   return timers().reduce(comm);
+}
+
+void AbstractSolver2::resetTimings() { timers().reset(); }
+
+void AbstractSolver2::writeTimings(const std::string &filename) const
+{
+   auto timings = getTimings();
+   if (rank == 0)
+   {
+      std::ofstream file(filename);
+      file << std::setw(3) << timings << std::endl;
+   }
+}
+
+void AbstractSolver2::logTimings() const
+{
+   const auto filename = options["timing-file"].get<std::string>();
+   if (!filename.empty())
+   {
+      writeTimings(filename);
+   }
+}
+
+void AbstractSolver2::constructAdjointSolver()
+{
+   if (adj_solver)
+   {
+      return;
+   }
+   auto *prec = getPreconditioner(*spatial_res);
+   auto adjoint_jacobian = options["adjoint-jacobian"].get<std::string>();
+   if (prec != nullptr && adjoint_jacobian != "transpose" &&
+       !supportsTranspose(*prec))
+   {
+      if (adjoint_jacobian == "implicit")
+      {
+         throw MISOException(
+             "\"adjoint-jacobian\": \"implicit\" applies the transpose of "
+             "the forward preconditioner, which the \"lin-prec\" type does "
+             "not support; use \"transpose\", \"symmetric\", or "
+             "\"auto\"!\n");
+      }
+      if (adjoint_jacobian == "auto")
+      {
+         /// a non-symmetric Jacobian is transposed explicitly, and the
+         /// preconditioner is set up for whichever operator the adjoint uses
+         auto res_options = options;
+         res_options["adjoint-implicit-transpose"] = false;
+         setOptions(*spatial_res, res_options);
+         adjoint_jacobian = "transpose";
+      }
+   }
+   if (prec != nullptr && adjoint_jacobian != "transpose")
+   {
+      const auto adj_type = options["adj-solver"]["type"].get<std::string>();
+      if (adj_type.rfind("hypre", 0) == 0)
+      {
+         throw MISOException(
+             "\"adjoint-jacobian\": \"" + adjoint_jacobian +
+             "\" reuses the forward preconditioner, which hypre's "
+             "Krylov solvers cannot do; use an MFEM \"adj-solver\"!\n");
+      }
+      /// reuse the forward preconditioner instead of setting it up for the
+      /// transposed Jacobian
+      adj_prec = std::make_unique<AdjointPreconditioner>(*prec);
+      prec = adj_prec.get();
+   }
+   adj_solver = constructLinearSolver(comm, options["adj-solver"], prec);
+}
+
+bool AbstractSolver2::extrapolateState(mfem::Vector &state)
+{
+   if (converged_states.empty() ||
+       converged_states.back().Size() != state.Size())
+   {
+      return false;
+   }
+   mfem::Vector guess(converged_states.back());
+   if (converged_states.size() == 2 &&
+       converged_states.front().Size() == state.Size())
+   {
+      /// linear extrapolation from the last two converged states
+      guess *= 2.0;
+      guess -= converged_states.front();
+   }
+   /// keep the given initial guess if it is the better one; it is evaluated
+   /// last so the residual is not left holding the local guess
+   const double guess_norm = calcResidualNorm(guess);
+   if (guess_norm >= calcResidualNorm(state))
+   {
+      return false;
+   }
+   state = guess;
+   timers().count("state-extrapolations");
+   return true;
+}
+
+mfem::Solver *AbstractSolver2::lagPreconditioner(mfem::Solver *prec)
+{
+   const auto &prec_opts = options["lin-prec"];
+   const int rebuild_every = prec_opts["rebuild-every"].get<int>();
+   const int max_krylov_iters = prec_opts["rebuild-iter-threshold"].get<int>();
+   if (prec == nullptr || (rebuild_every == 1 && max_krylov_iters <= 0))
+   {
+      return prec;
+   }
+   const auto lin_type = options["lin-solver"]["type"].get<std::string>();
+   if (lin_type.rfind("hypre", 0) == 0)
+   {
+      throw MISOException(
+          "lagging the preconditioner hides it from hypre's Krylov solvers; "
+          "use an MFEM \"lin-solver\"!\n");
+   }
+   lagged_prec = std::make_unique<LaggedPreconditioner>(
+       *prec, rebuild_every, max_krylov_iters);
+   return lagged_prec.get();
+}
+
+void AbstractSolver2::logState(DataLogger &logger,
+                               const mfem::Vector &state,
+                               const std::string &fieldname,
+                               int timestep,
+                               double time)
+{
+   ScopedTimer timer("log-state");
+   state_logger->saveState(logger, state, fieldname, timestep, time, rank);
+   if (options["log-buffers"].get<int>() < 1)
+   {
+      state_logger->flush(logger);
+   }
+}
+
+void AbstractSolver2::flushLoggers()
+{
+   ScopedTimer timer("log-flush");
+   for (auto &pair : loggers)
+   {
+      state_logger->flush(pair.first);
+   }
+}
+
 void AbstractSolver2::initialHook(const mfem::Vector &state)
 {
+   const auto &history = options["time-history"];
+   const auto file = history["file"].get<std::string>();
+   if (ode && !file.empty())
+   {
+      /// each rank stores its own part of the states
+      time_history = std::make_unique<TimeHistory>(
+          file + "_" + std::to_string(rank),
+          history["compression"].get<std::string>());
+   }
    for (auto &pair : loggers)
    {
       auto &logger = pair.first;
       auto &options = pair.second;
       if (options.initial_state)
       {
-         logState(logger, state, "state", 0, 0.0, rank);
+         logState(logger, state, "state", 0, 0.0);
       }
    }
 }
@@ -531,13 +919,18 @@ void AbstractSolver2::iterationHook(int iter,
                                     double dt,
                                     const mfem::Vector &state)
 {
+   if (time_history)
+   {
+      ScopedTimer timer("time-history");
+      time_history->append(state, t);
+   }
    for (auto &pair : loggers)
    {
       auto &logger = pair.first;
       auto &options = pair.second;
       if (options.each_timestep)
       {
-         logState(logger, state, "state", iter, t, rank);
+         logState(logger, state, "state", iter, t);
       }
    }
 }
@@ -569,15 +962,21 @@ void AbstractSolver2::terminalHook(int iter,
                                    double t_final,
                                    const mfem::Vector &state)
 {
+   if (time_history)
+   {
+      ScopedTimer timer("time-history");
+      time_history->append(state, t_final);
+   }
    for (auto &pair : loggers)
    {
       auto &logger = pair.first;
       auto &options = pair.second;
       if (options.final_state)
       {
-         logState(logger, state, "state", iter, t_final, rank);
+         logState(logger, state, "state", iter, t_final);
       }
    }
+   flushLoggers();
 }
 
 }  // namespace miso
@@ -2,6 +2,7 @@
 #define MISO_ABSTRACT_SOLVER
 
 #include <any>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -10,10 +11,12 @@
 #include "nlohmann/json.hpp"
 
 #include "data_logging.hpp"
+#include "mfem_extensions.hpp"
 #include "miso_input.hpp"
 #include "miso_output.hpp"
 #include "miso_residual.hpp"
 #include "ode.hpp"
+#include "time_history.hpp"
 #include "utils.hpp"
 
 namespace miso
@@ -32,6 +35,12 @@ public:
    /// \brief Retrieve the currently set solver options
    const nlohmann::json &getOptions() const { return options; }
 
+   /// \return the states stored by the last unsteady solve, following the
+   /// "time-history" options, or null if none were stored
+   /// \note Step `i` is the state at the start of time step `i`, and the last
+   /// step is the final state
+   const TimeHistory *getTimeHistory() const { return time_history.get(); }
+
    /// \brief Generic function that allows derived classes to set the state
    /// based on the type T
    /// \param[in] function - any object that a derived solver will know how to
@@ -91,6 +100,39 @@ public:
                         const mfem::Vector &state_bar,
                         mfem::Vector &adjoint);
 
+   /// Solve for the adjoint of @a output, starting from the adjoint last
+   /// solved for the same @a output and @a scenario, if there is one
+   /// \param[in] inputs - scalars and fields that the residual may depend on
+   /// that satisfies R(inputs) = 0
+   /// \param[in] state_bar - the derivative of @a output w.r.t. the state
+   /// \param[out] adjoint - the solution to the equation
+   /// \partial R / \partial @a state * adjoint^T = @a state_bar
+   /// \param[in] output - name of the output whose adjoint is solved for
+   /// \param[in] scenario - optional name of the operating point
+   /// \note The "adjoint-warm-starts" and "adjoint-cold-starts" counters, and
+   /// the Krylov iterations each took, measure what warm starts save
+   void solveForAdjoint(const MISOInputs &inputs,
+                        const mfem::Vector &state_bar,
+                        mfem::Vector &adjoint,
+                        const std::string &output,
+                        const std::string &scenario = "");
+
+   /// Forget the cached adjoints and converged states used as initial guesses
+   void clearWarmStarts();
+
+   /// Solve for the adjoints of several outputs that share the @a inputs
+   /// \param[in] inputs - scalars and fields that the residual may depend on
+   /// that satisfies R(inputs) = 0
+   /// \param[in] state_bars - each column is the derivative of an output
+   /// w.r.t. the state
+   /// \param[out] adjoints - each column solves the adjoint equation for the
+   /// same column of @a state_bars
+   /// \note The transposed Jacobian is formed, and the adjoint solver's
+   /// preconditioner set up, once for all the columns
+   void solveForAdjoints(const MISOInputs &inputs,
+                         const mfem::DenseMatrix &state_bars,
+                         mfem::DenseMatrix &adjoints);
+
    /// Compute the residual and store the it in @a residual
    /// \param[in] state - the state to evaluate the residual at
    /// \param[out] residual - the discrete residual vector
@@ -164,6 +206,18 @@ public:
                    const MISOInputs &inputs,
                    mfem::Vector &out_vec);
 
+   /// Evaluates several scalar outputs together
+   /// \param[in] names - specifies the desired outputs
+   /// \param[in] inputs - collection of field or scalar inputs to set before
+   ///                     evaluating the outputs
+   /// \param[out] values - the value of each output, in the order of @a names
+   /// \note The functionals the outputs are built from are all evaluated in
+   /// one sweep over the mesh, with a single reduction over the ranks; outputs
+   /// that are not built from functionals are evaluated one at a time
+   void calcOutputs(const std::vector<std::string> &names,
+                    const MISOInputs &inputs,
+                    mfem::Vector &values);
+
    /// Evaluates and returns the partial derivative of output specifed by
    /// `of` with respect to the input specified by `wrt`
    /// \param[in] of - specifies the desired output
@@ -264,6 +318,18 @@ public:
                               const std::string &wrt,
                               mfem::Vector &wrt_bar);
 
+   /// \return the timers and counters of everything in miso, reduced over
+   /// the solver's ranks (see `TimerRegistry::reduce`)
+   /// \note Collective on the solver's communicator
+   nlohmann::json getTimings() const;
+
+   /// Clear the timers and counters of everything in miso
+   void resetTimings();
+
+   /// Write the reduced timers and counters to the JSON file @a filename
+   /// \note Collective on the solver's communicator; only rank 0 writes
+   void writeTimings(const std::string &filename) const;
+
    AbstractSolver2(MPI_Comm incomm, const nlohmann::json &solver_options);
 
    virtual ~AbstractSolver2() = default;
@@ -299,6 +365,22 @@ protected:
 
    /// linear system solver used for adjoint solve
    std::unique_ptr<mfem::Solver> adj_solver;
+   /// the last adjoint solved for each output and scenario
+   std::map<std::string, mfem::Vector> adjoint_cache;
+   /// the last two converged steady states, oldest first; only kept if
+   /// "state-extrapolation" is set in "nonlin-solver"
+   std::vector<mfem::Vector> converged_states;
+   /// applies the forward preconditioner to adjoint systems without setting
+   /// it up again; used unless "adjoint-jacobian" is "transpose", or is
+   /// "auto" and the preconditioner does not implement `MultTranspose`
+   std::unique_ptr<AdjointPreconditioner> adj_prec;
+   /// true once the forward preconditioner has been set up by a Newton solve
+   bool forward_prec_set_up = false;
+   /// times the Newton solver's linear solves
+   std::unique_ptr<ProfiledLinearSolver> profiled_linear_solver;
+   /// reuses the forward preconditioner's setup across Newton iterations and
+   /// `solveForState` calls; only used if "lin-prec" asks for lagging
+   std::unique_ptr<LaggedPreconditioner> lagged_prec;
 
    /// \brief the ordinary differential equation that describes how to evolve
    /// the state variables
@@ -307,11 +389,58 @@ protected:
    /// map of outputs the solver can compute
    std::map<std::string, MISOOutput> outputs;
 
+   /// the one thread that writes logged states and ParaView output; declared
+   /// before the loggers and writers that post to it, so that it outlives them
+   BackgroundWriter background_writer;
    /// Optional data loggers that will save state vectors during timestepping
    std::vector<DataLoggerWithOpts> loggers;
+   /// writes the loggers' states on `background_writer`, through a ring of
+   /// "log-buffers" buffers
+   std::unique_ptr<AsyncStateLogger> state_logger;
+
+   /// stores the states of unsteady solves if the "time-history" option has a
+   /// file
+   std::unique_ptr<TimeHistory> time_history;
+
+   /// Save `state` with `logger`; the write finishes in the background unless
+   /// "log-buffers" is zero
+   void logState(DataLogger &logger,
+                 const mfem::Vector &state,
+                 const std::string &fieldname,
+                 int timestep,
+                 double time);
+
+   /// Wait until every logged state has been written
+   void flushLoggers();
+
+   /// Write the timers and counters to the "timing-file" option, if set
+   void logTimings() const;
+
+   /// Construct `adj_solver` if it has not been constructed yet
+   void constructAdjointSolver();
+
+   /// Replace @a state by the extrapolation of `converged_states` if the
+   /// residual is smaller there
+   /// \param[inout] state - the initial guess for the steady state
+   /// \return true if @a state was replaced
+   bool extrapolateState(mfem::Vector &state);
+
+   /// Wrap the residual's preconditioner so that its setup is reused over
+   /// several Newton iterations, following the "rebuild-every" and
+   /// "rebuild-iter-threshold" options of "lin-prec"
+   /// \param[in] prec - the residual's preconditioner, may be null
+   /// \return the preconditioner to give the linear solver, which is `prec`
+   /// itself if every Newton iteration sets it up again
+   mfem::Solver *lagPreconditioner(mfem::Solver *prec);
 
    void addLogger(DataLogger logger, LoggingOptions &&options)
    {
+      if (auto *paraview = std::get_if<ParaViewLogger>(&logger))
+      {
+         paraview->setBackgroundWriter(
+             background_writer,
+             AbstractSolver2::options["log-buffers"].get<int>());
+      }
       loggers.emplace_back(std::make_pair<DataLogger, LoggingOptions>(
           std::move(logger), std::move(options)));
    }
@@ -20,6 +20,56 @@ void StateCoefficient::EvalRevDiff(double Q_bar,
        "\tEvalRevDiff not implemented for this coefficient!\n");
 }
 
+void StateCoefficient::EvalBatch(mfem::ElementTransformation &trans,
+                                 const mfem::IntegrationRule &ir,
+                                 const mfem::Vector &states,
+                                 mfem::Vector &values)
+{
+   const int npoints = ir.GetNPoints();
+   values.SetSize(npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+      values(i) = Eval(trans, ip, states(i));
+   }
+}
+
+void StateCoefficient::EvalStateDerivBatch(mfem::ElementTransformation &trans,
+                                           const mfem::IntegrationRule &ir,
+                                           const mfem::Vector &states,
+                                           mfem::Vector &values,
+                                           mfem::Vector &derivs)
+{
+   const int npoints = ir.GetNPoints();
+   values.SetSize(npoints);
+   derivs.SetSize(npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+      values(i) = Eval(trans, ip, states(i));
+      derivs(i) = EvalStateDeriv(trans, ip, states(i));
+   }
+}
+
+void ThreeStateCoefficient::EvalBatch(mfem::ElementTransformation &trans,
+                                      const mfem::IntegrationRule &ir,
+                                      const mfem::Vector &states1,
+                                      const mfem::Vector &states2,
+                                      const mfem::Vector &states3,
+                                      mfem::Vector &values)
+{
+   const int npoints = ir.GetNPoints();
+   values.SetSize(npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+      values(i) = Eval(trans, ip, states1(i), states2(i), states3(i));
+   }
+}
+
 double HashinShtrikmanWeightedCoefficient::Eval(
     mfem::ElementTransformation &trans,
     const mfem::IntegrationPoint &ip)
@@ -90,106 +140,45 @@ double ParameterContinuationCoefficient::EvalStateDeriv(
 double MeshDependentCoefficient::Eval(ElementTransformation &trans,
                                       const IntegrationPoint &ip)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      auto *coeff = it->second.get();
-      value = coeff->Eval(trans, ip);
+      return material.coeff->Eval(trans, ip);
    }
-   else if (default_coeff)
-   {
-      value = default_coeff->Eval(trans, ip);
-   }
-   else  // if attribute not found and no default set, evaluate to zero
-   {
-      value = 0.0;
-   }
-   // std::cout << "nu val in eval: " << value << "\n";
-   return value;
+   // if attribute not found and no default set, evaluate to zero
+   return 0.0;
 }
 
 double MeshDependentCoefficient::Eval(ElementTransformation &trans,
                                       const IntegrationPoint &ip,
                                       const double state)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(coeff);
-      if (state_coeff != nullptr)
-      {
-         value = state_coeff->Eval(trans, ip, state);
-      }
-      else
-      {
-         value = coeff->Eval(trans, ip);
-      }
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(default_coeff.get());
-      if (state_coeff != nullptr)
-      {
-         value = state_coeff->Eval(trans, ip, state);
-      }
-      else
-      {
-         value = default_coeff->Eval(trans, ip);
-      }
+      return material.typed->Eval(trans, ip, state);
    }
-   else  // if attribute not found and no default set, evaluate to zero
+   if (material.coeff != nullptr)
    {
-      value = 0.0;
+      return material.coeff->Eval(trans, ip);
    }
-   // std::cout << "nu val in eval: " << value << "\n";
-   return value;
+   // if attribute not found and no default set, evaluate to zero
+   return 0.0;
 }
 
 double MeshDependentCoefficient::EvalStateDeriv(ElementTransformation &trans,
                                                 const IntegrationPoint &ip,
                                                 const double state)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(coeff);
-      if (state_coeff != nullptr)
-      {
-         value = state_coeff->EvalStateDeriv(trans, ip, state);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->EvalStateDeriv(trans, ip, state);
    }
-   else if (default_coeff)
-   {
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(default_coeff.get());
-      if (state_coeff != nullptr)
-      {
-         value = state_coeff->EvalStateDeriv(trans, ip, state);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 double MeshDependentCoefficient::EvalState2ndDeriv(
@@ -197,40 +186,13 @@ double MeshDependentCoefficient::EvalState2ndDeriv(
     const mfem::IntegrationPoint &ip,
     const double state)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(coeff);
-      if (state_coeff != nullptr)
-      {
-         value = state_coeff->EvalState2ndDeriv(trans, ip, state);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->EvalState2ndDeriv(trans, ip, state);
    }
-   else if (default_coeff)
-   {
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(default_coeff.get());
-      if (state_coeff != nullptr)
-      {
-         value = state_coeff->EvalState2ndDeriv(trans, ip, state);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 void MeshDependentCoefficient::EvalRevDiff(const double Q_bar,
@@ -238,18 +200,11 @@ void MeshDependentCoefficient::EvalRevDiff(const double Q_bar,
                                            const IntegrationPoint &ip,
                                            DenseMatrix &PointMat_bar)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   Coefficient *coeff = nullptr;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      coeff = it->second.get();
-      coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      default_coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
+      material.coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
    }
    // if attribute not found and no default set, don't change PointMat_bar
 }
@@ -260,35 +215,98 @@ void MeshDependentCoefficient::EvalRevDiff(const double Q_bar,
                                            double state,
                                            DenseMatrix &PointMat_bar)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(coeff);
-      if (state_coeff != nullptr)
-      {
-         state_coeff->EvalRevDiff(Q_bar, trans, ip, state, PointMat_bar);
-      }
-      else
-      {
-         coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
-      }
+      material.typed->EvalRevDiff(Q_bar, trans, ip, state, PointMat_bar);
    }
-   else if (default_coeff)
+   else if (material.coeff != nullptr)
    {
-      auto *state_coeff = dynamic_cast<StateCoefficient *>(default_coeff.get());
-      if (state_coeff != nullptr)
-      {
-         state_coeff->EvalRevDiff(Q_bar, trans, ip, state, PointMat_bar);
-      }
-      else
+      material.coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
+   }
+   // if attribute not found and no default set, don't change PointMat_bar
+}
+
+void MeshDependentCoefficient::EvalBatch(ElementTransformation &trans,
+                                         const IntegrationRule &ir,
+                                         const Vector &states,
+                                         Vector &values)
+{
+   const int npoints = ir.GetNPoints();
+   values.SetSize(npoints);
+
+   // resolve the material once for the whole element
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
+   {
+      material.typed->EvalBatch(trans, ir, states, values);
+      return;
+   }
+   if (material.coeff == nullptr)
+   {
+      values = 0.0;
+      return;
+   }
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+      values(i) = material.coeff->Eval(trans, ip);
+   }
+}
+
+void MeshDependentCoefficient::EvalStateDerivBatch(ElementTransformation &trans,
+                                                   const IntegrationRule &ir,
+                                                   const Vector &states,
+                                                   Vector &values,
+                                                   Vector &derivs)
+{
+   const int npoints = ir.GetNPoints();
+   values.SetSize(npoints);
+   derivs.SetSize(npoints);
+
+   // resolve the material once for the whole element
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
+   {
+      material.typed->EvalStateDerivBatch(trans, ir, states, values, derivs);
+      return;
+   }
+   derivs = 0.0;
+   if (material.coeff == nullptr)
+   {
+      values = 0.0;
+      return;
+   }
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+      values(i) = material.coeff->Eval(trans, ip);
+   }
+}
+
+bool isThreadSafe(const mfem::Coefficient &coeff)
+{
+   if (dynamic_cast<const mfem::ConstantCoefficient *>(&coeff) != nullptr)
+   {
+      return true;
+   }
+   const auto *state_coeff = dynamic_cast<const StateCoefficient *>(&coeff);
+   return state_coeff != nullptr && state_coeff->isThreadSafe();
+}
+
+bool MeshDependentCoefficient::isThreadSafe() const
+{
+   for (const auto &[attr, coeff] : material_map)
+   {
+      if (!miso::isThreadSafe(*coeff))
       {
-         default_coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
+         return false;
       }
    }
-   // if attribute not found and no default set, don't change PointMat_bar
+   return !default_coeff || miso::isThreadSafe(*default_coeff);
 }
 
 void MeshDependentCoefficient::setInputs(const MISOInputs &inputs)
@@ -490,25 +508,14 @@ std::unique_ptr<miso::MeshDependentCoefficient> constructMaterialCoefficient(
 double MeshDependentTwoStateCoefficient::Eval(ElementTransformation &trans,
                                               const IntegrationPoint &ip)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      value = coeff->Eval(trans, ip);
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      value = default_coeff->Eval(trans, ip);
+      return material.coeff->Eval(trans, ip);
    }
-   else  // if attribute not found and no default set, evaluate to zero
-   {
-      value = 0.0;
-   }
-   // std::cout << "val in eval: " << value << "\n";
-   return value;
+   // if attribute not found and no default set, evaluate to zero
+   return 0.0;
 }
 
 // MeshDependentCoefficient::Eval copied over and adapted for
@@ -518,42 +525,18 @@ double MeshDependentTwoStateCoefficient::Eval(ElementTransformation &trans,
                                               const double state1,
                                               const double state2)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *two_state_coeff = dynamic_cast<TwoStateCoefficient *>(coeff);
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = coeff->Eval(trans, ip);
-      }
+      return material.typed->Eval(trans, ip, state1, state2);
    }
-   else if (default_coeff)
+   if (material.coeff != nullptr)
    {
-      auto *two_state_coeff =
-          dynamic_cast<TwoStateCoefficient *>(default_coeff.get());
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = default_coeff->Eval(trans, ip);
-      }
+      return material.coeff->Eval(trans, ip);
    }
-   else  // if attribute not found and no default set, evaluate to zero
-   {
-      value = 0.0;
-   }
-   // std::cout << "val in eval: " << value << "\n";
-   return value;
+   // if attribute not found and no default set, evaluate to zero
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalStateDeriv to make
@@ -564,41 +547,13 @@ double MeshDependentTwoStateCoefficient::EvalDerivS1(
     const double state1,
     const double state2)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *two_state_coeff = dynamic_cast<TwoStateCoefficient *>(coeff);
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->EvalDerivS1(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *two_state_coeff =
-          dynamic_cast<TwoStateCoefficient *>(default_coeff.get());
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->EvalDerivS1(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->EvalDerivS1(trans, ip, state1, state2);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentTwoStateCoefficient::EvalDerivS1 to make
@@ -609,41 +564,13 @@ double MeshDependentTwoStateCoefficient::EvalDerivS2(
     const double state1,
     const double state2)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *two_state_coeff = dynamic_cast<TwoStateCoefficient *>(coeff);
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->EvalDerivS2(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *two_state_coeff =
-          dynamic_cast<TwoStateCoefficient *>(default_coeff.get());
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->EvalDerivS2(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->EvalDerivS2(trans, ip, state1, state2);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -654,41 +581,13 @@ double MeshDependentTwoStateCoefficient::Eval2ndDerivS1(
     const double state1,
     const double state2)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *two_state_coeff = dynamic_cast<TwoStateCoefficient *>(coeff);
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS1(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *two_state_coeff =
-          dynamic_cast<TwoStateCoefficient *>(default_coeff.get());
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS1(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      value = 0.0;
+      return material.typed->Eval2ndDerivS1(trans, ip, state1, state2);
    }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -699,41 +598,13 @@ double MeshDependentTwoStateCoefficient::Eval2ndDerivS2(
     const double state1,
     const double state2)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *two_state_coeff = dynamic_cast<TwoStateCoefficient *>(coeff);
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS2(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *two_state_coeff =
-          dynamic_cast<TwoStateCoefficient *>(default_coeff.get());
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS2(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS2(trans, ip, state1, state2);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -744,41 +615,13 @@ double MeshDependentTwoStateCoefficient::Eval2ndDerivS1S2(
     const double state1,
     const double state2)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *two_state_coeff = dynamic_cast<TwoStateCoefficient *>(coeff);
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS1S2(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *two_state_coeff =
-          dynamic_cast<TwoStateCoefficient *>(default_coeff.get());
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS1S2(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS1S2(trans, ip, state1, state2);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 /// TODO: Likely not necessary because of Eval2ndDerivS1S2
@@ -790,41 +633,13 @@ double MeshDependentTwoStateCoefficient::Eval2ndDerivS2S1(
     const double state1,
     const double state2)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *two_state_coeff = dynamic_cast<TwoStateCoefficient *>(coeff);
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS2S1(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *two_state_coeff =
-          dynamic_cast<TwoStateCoefficient *>(default_coeff.get());
-      if (two_state_coeff != nullptr)
-      {
-         value = two_state_coeff->Eval2ndDerivS2S1(trans, ip, state1, state2);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS2S1(trans, ip, state1, state2);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Copied over from MeshDependentCoefficient::EvalRevDiff. No changes needed
@@ -833,18 +648,11 @@ void MeshDependentTwoStateCoefficient::EvalRevDiff(const double Q_bar,
                                                    const IntegrationPoint &ip,
                                                    DenseMatrix &PointMat_bar)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   Coefficient *coeff = nullptr;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      coeff = it->second.get();
-      coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      default_coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
+      material.coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
    }
    // if attribute not found and no default set, don't change PointMat_bar
 }
@@ -910,25 +718,14 @@ constructMaterialTwoStateCoefficient(const std::string &name,
 double MeshDependentThreeStateCoefficient::Eval(ElementTransformation &trans,
                                                 const IntegrationPoint &ip)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      auto *coeff = it->second.get();
-      value = coeff->Eval(trans, ip);
+      return material.coeff->Eval(trans, ip);
    }
-   else if (default_coeff)
-   {
-      value = default_coeff->Eval(trans, ip);
-   }
-   else  // if attribute not found and no default set, evaluate to zero
-   {
-      value = 0.0;
-   }
-   // std::cout << "val in eval: " << value << "\n";
-   return value;
+   // if attribute not found and no default set, evaluate to zero
+   return 0.0;
 }
 
 // MeshDependentCoefficient::Eval copied over and adapted for
@@ -939,42 +736,18 @@ double MeshDependentThreeStateCoefficient::Eval(ElementTransformation &trans,
                                                 const double state2,
                                                 const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = coeff->Eval(trans, ip);
-      }
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = default_coeff->Eval(trans, ip);
-      }
+      return material.typed->Eval(trans, ip, state1, state2, state3);
    }
-   else  // if attribute not found and no default set, evaluate to zero
+   if (material.coeff != nullptr)
    {
-      value = 0.0;
+      return material.coeff->Eval(trans, ip);
    }
-   // std::cout << "val in eval: " << value << "\n";
-   return value;
+   // if attribute not found and no default set, evaluate to zero
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalStateDeriv to make
@@ -986,43 +759,13 @@ double MeshDependentThreeStateCoefficient::EvalDerivS1(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value =
-             three_state_coeff->EvalDerivS1(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->EvalDerivS1(trans, ip, state1, state2, state3);
    }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value =
-             three_state_coeff->EvalDerivS1(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentThreeStateCoefficient::EvalDerivS1 to make
@@ -1034,43 +777,13 @@ double MeshDependentThreeStateCoefficient::EvalDerivS2(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value =
-             three_state_coeff->EvalDerivS2(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value =
-             three_state_coeff->EvalDerivS2(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      value = 0.0;
+      return material.typed->EvalDerivS2(trans, ip, state1, state2, state3);
    }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentThreeStateCoefficient::EvalDerivS1 to make
@@ -1082,43 +795,13 @@ double MeshDependentThreeStateCoefficient::EvalDerivS3(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value =
-             three_state_coeff->EvalDerivS3(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value =
-             three_state_coeff->EvalDerivS3(trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      value = 0.0;
+      return material.typed->EvalDerivS3(trans, ip, state1, state2, state3);
    }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -1130,43 +813,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS1(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS1(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS1(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      value = 0.0;
+      return material.typed->Eval2ndDerivS1(
+          trans, ip, state1, state2, state3);
    }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -1178,43 +832,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS2(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS2(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS2(
+          trans, ip, state1, state2, state3);
    }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS2(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -1226,43 +851,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS3(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS3(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS3(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS3(
+          trans, ip, state1, state2, state3);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -1274,43 +870,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS1S2(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS1S2(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS1S2(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS1S2(
+          trans, ip, state1, state2, state3);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -1322,43 +889,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS1S3(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS1S3(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS1S3(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      value = 0.0;
+      return material.typed->Eval2ndDerivS1S3(
+          trans, ip, state1, state2, state3);
    }
-   return value;
+   return 0.0;
 }
 
 // Adapted MeshDependentCoefficient::EvalState2ndDeriv to make
@@ -1370,43 +908,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS2S3(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS2S3(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS2S3(
+          trans, ip, state1, state2, state3);
    }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS2S3(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 /// TODO: Likely not necessary because of Eval2ndDerivS1S2
@@ -1419,43 +928,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS2S1(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS2S1(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS2S1(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS2S1(
+          trans, ip, state1, state2, state3);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 /// TODO: Likely not necessary because of Eval2ndDerivS1S3
@@ -1468,43 +948,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS3S1(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS3S1(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS3S1(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
+      return material.typed->Eval2ndDerivS3S1(
+          trans, ip, state1, state2, state3);
    }
-   else  // if attribute not found in material map default to zero
-   {
-      value = 0.0;
-   }
-   return value;
+   return 0.0;
 }
 
 /// TODO: Likely not necessary because of Eval2ndDerivS2S3
@@ -1517,43 +968,14 @@ double MeshDependentThreeStateCoefficient::Eval2ndDerivS3S2(
     const double state2,
     const double state3)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   double value = NAN;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *three_state_coeff = dynamic_cast<ThreeStateCoefficient *>(coeff);
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS3S2(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else if (default_coeff)
-   {
-      auto *three_state_coeff =
-          dynamic_cast<ThreeStateCoefficient *>(default_coeff.get());
-      if (three_state_coeff != nullptr)
-      {
-         value = three_state_coeff->Eval2ndDerivS3S2(
-             trans, ip, state1, state2, state3);
-      }
-      else
-      {
-         value = 0.0;
-      }
-   }
-   else  // if attribute not found in material map default to zero
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      value = 0.0;
+      return material.typed->Eval2ndDerivS3S2(
+          trans, ip, state1, state2, state3);
    }
-   return value;
+   return 0.0;
 }
 
 // Copied over from MeshDependentCoefficient::EvalRevDiff. No changes needed
@@ -1563,20 +985,44 @@ void MeshDependentThreeStateCoefficient::EvalRevDiff(
     const IntegrationPoint &ip,
     DenseMatrix &PointMat_bar)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   Coefficient *coeff = nullptr;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
+   {
+      material.coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
+   }
+   // if attribute not found and no default set, don't change PointMat_bar
+}
+
+void MeshDependentThreeStateCoefficient::EvalBatch(
+    ElementTransformation &trans,
+    const IntegrationRule &ir,
+    const Vector &states1,
+    const Vector &states2,
+    const Vector &states3,
+    Vector &values)
+{
+   const int npoints = ir.GetNPoints();
+   values.SetSize(npoints);
+
+   // resolve the material once for the whole element
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      coeff = it->second.get();
-      coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
+      material.typed->EvalBatch(trans, ir, states1, states2, states3, values);
+      return;
    }
-   else if (default_coeff)
+   if (material.coeff == nullptr)
    {
-      default_coeff->EvalRevDiff(Q_bar, trans, ip, PointMat_bar);
+      values = 0.0;
+      return;
+   }
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+      values(i) = material.coeff->Eval(trans, ip);
    }
-   // if attribute not found and no default set, don't change PointMat_bar
 }
 
 /// Copied from MeshDependentCoefficient and adapted for
@@ -1802,20 +1248,13 @@ void VectorMeshDependentCoefficient::Eval(Vector &vec,
                                           ElementTransformation &trans,
                                           const IntegrationPoint &ip)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   VectorCoefficient *coeff = nullptr;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      coeff = it->second.get();
-      coeff->Eval(vec, trans, ip);
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      default_coeff->Eval(vec, trans, ip);
+      material.coeff->Eval(vec, trans, ip);
    }
-   else  // if attribute not found and no default set, set the output to be zero
+   else
    {
       vec = 0.0;
    }
@@ -1826,18 +1265,11 @@ void VectorMeshDependentCoefficient::EvalRevDiff(const Vector &V_bar,
                                                  const IntegrationPoint &ip,
                                                  DenseMatrix &PointMat_bar)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   VectorCoefficient *coeff = nullptr;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      coeff = it->second.get();
-      coeff->EvalRevDiff(V_bar, trans, ip, PointMat_bar);
-   }
-   else if (default_coeff)
-   {
-      default_coeff->EvalRevDiff(V_bar, trans, ip, PointMat_bar);
+      material.coeff->EvalRevDiff(V_bar, trans, ip, PointMat_bar);
    }
    // if attribute not found and no default set, don't change PointMat_bar
 }
@@ -1858,23 +1290,13 @@ void VectorMeshDependentStateCoefficient::Eval(Vector &vec,
                                                ElementTransformation &trans,
                                                const IntegrationPoint &ip)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   VectorCoefficient *coeff = nullptr;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.coeff != nullptr)
    {
-      // std::cout << "attr found\n";
-      coeff = it->second.get();
-      coeff->Eval(vec, trans, ip);
-      // std::cout << "mag_vec in eval: ";
-      // vec.Print();
+      material.coeff->Eval(vec, trans, ip);
    }
-   else if (default_coeff)
-   {
-      default_coeff->Eval(vec, trans, ip);
-   }
-   else  // if attribute not found and no default set, set the output to be zero
+   else
    {
       vec = 0.0;
    }
@@ -1885,37 +1307,17 @@ void VectorMeshDependentStateCoefficient::Eval(Vector &vec,
                                                const IntegrationPoint &ip,
                                                double state)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   VectorCoefficient *coeff = nullptr;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      coeff = it->second.get();
-      auto *state_coeff = dynamic_cast<VectorStateCoefficient *>(coeff);
-      if (state_coeff != nullptr)
-      {
-         state_coeff->Eval(vec, trans, ip, state);
-      }
-      else
-      {
-         coeff->Eval(vec, trans, ip);
-      }
+      material.typed->Eval(vec, trans, ip, state);
    }
-   else if (default_coeff)
+   else if (material.coeff != nullptr)
    {
-      auto state_coeff =
-          dynamic_cast<VectorStateCoefficient *>(default_coeff.get());
-      if (state_coeff != nullptr)
-      {
-         state_coeff->Eval(vec, trans, ip, state);
-      }
-      else
-      {
-         default_coeff->Eval(vec, trans, ip);
-      }
+      material.coeff->Eval(vec, trans, ip);
    }
-   else  // if attribute not found and no default set, set the output to be zero
+   else
    {
       vec = 0.0;
    }
@@ -1927,36 +1329,13 @@ void VectorMeshDependentStateCoefficient::EvalStateDeriv(
     const mfem::IntegrationPoint &ip,
     double state)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
-   {
-      auto *coeff = it->second.get();
-      auto *state_coeff = dynamic_cast<VectorStateCoefficient *>(coeff);
-      if (state_coeff != nullptr)
-      {
-         state_coeff->EvalStateDeriv(vec_dot, trans, ip, state);
-      }
-      else
-      {
-         vec_dot = 0.0;
-      }
-   }
-   else if (default_coeff)
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *state_coeff =
-          dynamic_cast<VectorStateCoefficient *>(default_coeff.get());
-      if (state_coeff != nullptr)
-      {
-         state_coeff->EvalStateDeriv(vec_dot, trans, ip, state);
-      }
-      else
-      {
-         vec_dot = 0.0;
-      }
+      material.typed->EvalStateDeriv(vec_dot, trans, ip, state);
    }
-   else  // if attribute not found in material map default to zero
+   else
    {
       vec_dot = 0.0;
    }
@@ -1969,34 +1348,15 @@ void VectorMeshDependentStateCoefficient::EvalRevDiff(
     double state,
     DenseMatrix &PointMat_bar)
 {
-   // given the attribute, extract the coefficient value from the map
-   int this_att = trans.Attribute;
-   auto it = material_map.find(this_att);
-   if (it != material_map.end())
+   // given the attribute, look up the coefficient to evaluate
+   const auto &material = material_table.lookup(trans.Attribute);
+   if (material.typed != nullptr)
    {
-      auto *coeff = it->second.get();
-      auto *state_coeff = dynamic_cast<VectorStateCoefficient *>(coeff);
-      if (state_coeff != nullptr)
-      {
-         state_coeff->EvalRevDiff(V_bar, trans, ip, state, PointMat_bar);
-      }
-      else
-      {
-         coeff->EvalRevDiff(V_bar, trans, ip, PointMat_bar);
-      }
+      material.typed->EvalRevDiff(V_bar, trans, ip, state, PointMat_bar);
    }
-   else if (default_coeff)
+   else if (material.coeff != nullptr)
    {
-      auto *state_coeff =
-          dynamic_cast<VectorStateCoefficient *>(default_coeff.get());
-      if (state_coeff != nullptr)
-      {
-         state_coeff->EvalRevDiff(V_bar, trans, ip, state, PointMat_bar);
-      }
-      else
-      {
-         default_coeff->EvalRevDiff(V_bar, trans, ip, PointMat_bar);
-      }
+      material.coeff->EvalRevDiff(V_bar, trans, ip, PointMat_bar);
    }
    // if attribute not found and no default set, don't change PointMat_bar
 }
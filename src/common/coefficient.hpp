@@ -2,6 +2,7 @@
 #define MISO_COEFFICIENT
 
 #include <map>
+#include <vector>
 
 #include "mfem.hpp"
 
@@ -61,9 +62,52 @@ public:
                             double state,
                             mfem::DenseMatrix &PointMat_bar);
 
+   /// \brief Evaluate the coefficient at every integration point in `ir`
+   /// \param[in] trans - element transformation relating real element to
+   ///                    reference element
+   /// \param[in] ir - the integration points to evaluate the coefficient at
+   /// \param[in] states - the state at each integration point
+   /// \param[out] values - the coefficient value at each integration point
+   /// \note The default implementation calls the pointwise `Eval` at each
+   /// point. Derived classes may override this to resolve per-element data
+   /// once and evaluate all of the points in a single loop. The
+   /// IntegrationPoint associated with trans is unspecified on return.
+   virtual void EvalBatch(mfem::ElementTransformation &trans,
+                          const mfem::IntegrationRule &ir,
+                          const mfem::Vector &states,
+                          mfem::Vector &values);
+
+   /// \brief Evaluate the coefficient and its derivative with respect to the
+   /// state at every integration point in `ir`
+   /// \param[in] trans - element transformation relating real element to
+   ///                    reference element
+   /// \param[in] ir - the integration points to evaluate the coefficient at
+   /// \param[in] states - the state at each integration point
+   /// \param[out] values - the coefficient value at each integration point
+   /// \param[out] derivs - the derivative of the coefficient with respect to
+   ///                     the state at each integration point
+   /// \note The default implementation calls the pointwise `Eval` and
+   /// `EvalStateDeriv` at each point. The IntegrationPoint associated with
+   /// trans is unspecified on return.
+   virtual void EvalStateDerivBatch(mfem::ElementTransformation &trans,
+                                    const mfem::IntegrationRule &ir,
+                                    const mfem::Vector &states,
+                                    mfem::Vector &values,
+                                    mfem::Vector &derivs);
+
    virtual void setInputs(const MISOInputs &inputs) { }
+
+   /// \return true if the coefficient and its derivatives may be evaluated by
+   /// several threads at once, each with its own ElementTransformation
+   /// \note Coefficients that cache values lazily, or evaluate a GridFunction
+   /// or the ElementTransformation's geometry, must return false
+   virtual bool isThreadSafe() const { return false; }
 };
 
+/// \return true if `coeff` may be evaluated by several threads at once; only
+/// constant and thread-safe state coefficients are
+bool isThreadSafe(const mfem::Coefficient &coeff);
+
 /// Abstract class TwoStateCoefficient
 /// Defines new signature for Eval() and new methods for State Derivatives that
 /// subclasses must implement.
@@ -244,6 +288,24 @@ public:
    {
       return 0.0;
    }
+
+   /// \brief Evaluate the coefficient at every integration point in `ir`
+   /// \param[in] trans - element transformation relating real element to
+   ///                    reference element
+   /// \param[in] ir - the integration points to evaluate the coefficient at
+   /// \param[in] states1 - the first state at each integration point
+   /// \param[in] states2 - the second state at each integration point
+   /// \param[in] states3 - the third state at each integration point
+   /// \param[out] values - the coefficient value at each integration point
+   /// \note The default implementation calls the pointwise `Eval` at each
+   /// point. The IntegrationPoint associated with trans is unspecified on
+   /// return.
+   virtual void EvalBatch(mfem::ElementTransformation &trans,
+                          const mfem::IntegrationRule &ir,
+                          const mfem::Vector &states1,
+                          const mfem::Vector &states2,
+                          const mfem::Vector &states3,
+                          mfem::Vector &values);
 };
 
 class HashinShtrikmanWeightedCoefficient : public miso::StateCoefficient
@@ -462,6 +524,66 @@ private:
    std::unique_ptr<StateCoefficient> nonlinear;
 };
 
+/// MaterialDispatchTable
+/// A dense table, indexed by element attribute, of the coefficients held by
+/// the mesh-dependent coefficients below. Each entry also stores the
+/// coefficient already cast to its state-dependent interface `Typed` (or
+/// nullptr if it does not implement it), so evaluating a material is a single
+/// array access rather than a map search followed by a `dynamic_cast`.
+/// \note The table does not own the coefficients; it points into the
+/// `material_map` and `default_coeff` of the owning class.
+template <typename Base, typename Typed = Base>
+class MaterialDispatchTable
+{
+public:
+   struct Entry
+   {
+      Base *coeff = nullptr;
+      Typed *typed = nullptr;
+   };
+
+   /// \brief Set the coefficient evaluated on attributes without an entry
+   /// \param[in] coeff - the default coefficient, may be nullptr
+   void setDefault(Base *coeff) { dflt = makeEntry(coeff); }
+
+   /// \brief Set the coefficient evaluated on elements with attribute `attr`
+   /// \param[in] attr - the (non-negative) element attribute
+   /// \param[in] coeff - the coefficient to evaluate on those elements
+   void insert(int attr, Base *coeff)
+   {
+      if (attr < 0)
+      {
+         mfem::mfem_error("Material attributes must be non-negative!");
+      }
+      if (attr >= static_cast<int>(entries.size()))
+      {
+         entries.resize(attr + 1);
+      }
+      entries[attr] = makeEntry(coeff);
+   }
+
+   /// \brief Get the entry for elements with attribute `attr`, falling back
+   /// to the default entry if there is none
+   const Entry &lookup(int attr) const
+   {
+      if (attr >= 0 && attr < static_cast<int>(entries.size()) &&
+          entries[attr].coeff != nullptr)
+      {
+         return entries[attr];
+      }
+      return dflt;
+   }
+
+private:
+   static Entry makeEntry(Base *coeff)
+   {
+      return {coeff, dynamic_cast<Typed *>(coeff)};
+   }
+
+   std::vector<Entry> entries;
+   Entry dflt;
+};
+
 /// MeshDependentCoefficient
 /// A class that contains a map of material attributes and coefficients to
 /// evaluate on for each attribute.
@@ -474,7 +596,9 @@ public:
    ///						  to zero
    MeshDependentCoefficient(std::unique_ptr<mfem::Coefficient> dflt = nullptr)
     : default_coeff(move(dflt))
-   { }
+   {
+      material_table.setDefault(default_coeff.get());
+   }
 
    /// Adds <int, std::unique_ptr<mfem::Coefficient> pair to material_map
    /// \param[in] attr - attribute integer indicating which elements coeff
@@ -490,6 +614,7 @@ public:
       {
          mfem::mfem_error("Key already present in map!");
       }
+      material_table.insert(attr, status.first->second.get());
    }
 
    /// \brief Search the map of coefficients and evaluate the one whose key is
@@ -573,9 +698,39 @@ public:
                     double state,
                     mfem::DenseMatrix &PointMat_bar) override;
 
+   /// \brief Find the coefficient for the element's `Attribute` once and
+   ///        evaluate it at every integration point in `ir`
+   /// \param[in] trans - element transformation relating real element to
+   ///                    reference element
+   /// \param[in] ir - the integration points to evaluate the coefficient at
+   /// \param[in] states - the state at each integration point
+   /// \param[out] values - the coefficient value at each integration point
+   void EvalBatch(mfem::ElementTransformation &trans,
+                  const mfem::IntegrationRule &ir,
+                  const mfem::Vector &states,
+                  mfem::Vector &values) override;
+
+   /// \brief Find the coefficient for the element's `Attribute` once and
+   ///        evaluate it and its state derivative at every integration point
+   ///        in `ir`
+   /// \param[in] trans - element transformation relating real element to
+   ///                    reference element
+   /// \param[in] ir - the integration points to evaluate the coefficient at
+   /// \param[in] states - the state at each integration point
+   /// \param[out] values - the coefficient value at each integration point
+   /// \param[out] derivs - the derivative of the coefficient with respect to
+   ///                     the state at each integration point
+   void EvalStateDerivBatch(mfem::ElementTransformation &trans,
+                            const mfem::IntegrationRule &ir,
+                            const mfem::Vector &states,
+                            mfem::Vector &values,
+                            mfem::Vector &derivs) override;
+
    void setInputs(const MISOInputs &inputs) override;
 
-protected:
+   /// \return true if every material's coefficient is thread-safe
+   bool isThreadSafe() const override;
+
    // /// \brief Method to be called if a coefficient matching the element's
    // /// 		  attribute is a subclass of `StateCoefficient and
    // ///		  thus implements `Eval()` with state argument
@@ -765,6 +920,8 @@ protected:
 private:
    std::unique_ptr<mfem::Coefficient> default_coeff;
    std::map<const int, std::unique_ptr<mfem::Coefficient>> material_map;
+   /// attribute-indexed view of `material_map` and `default_coeff`
+   MaterialDispatchTable<mfem::Coefficient, StateCoefficient> material_table;
 };
 
 std::unique_ptr<miso::MeshDependentCoefficient> constructMaterialCoefficient(
@@ -787,7 +944,9 @@ public:
    MeshDependentTwoStateCoefficient(
        std::unique_ptr<mfem::Coefficient> dflt = nullptr)
     : default_coeff(move(dflt))
-   { }
+   {
+      material_table.setDefault(default_coeff.get());
+   }
 
    /// Adds <int, std::unique_ptr<mfem::Coefficient> pair to material_map
    /// \param[in] attr - attribute integer indicating which elements coeff
@@ -803,6 +962,7 @@ public:
       {
          mfem::mfem_error("Key already present in map!");
       }
+      material_table.insert(attr, status.first->second.get());
    }
 
    /// \brief Search the map of coefficients and evaluate the one whose key is
@@ -896,6 +1056,9 @@ public:
 private:
    std::unique_ptr<mfem::Coefficient> default_coeff;
    std::map<const int, std::unique_ptr<mfem::Coefficient>> material_map;
+   /// attribute-indexed view of `material_map` and `default_coeff`
+   MaterialDispatchTable<mfem::Coefficient, TwoStateCoefficient>
+       material_table;
 };
 
 /// Copied from MeshDependentCoefficient and adapted for
@@ -920,7 +1083,9 @@ public:
    MeshDependentThreeStateCoefficient(
        std::unique_ptr<mfem::Coefficient> dflt = nullptr)
     : default_coeff(move(dflt))
-   { }
+   {
+      material_table.setDefault(default_coeff.get());
+   }
 
    /// Adds <int, std::unique_ptr<mfem::Coefficient> pair to material_map
    /// \param[in] attr - attribute integer indicating which elements coeff
@@ -936,6 +1101,7 @@ public:
       {
          mfem::mfem_error("Key already present in map!");
       }
+      material_table.insert(attr, status.first->second.get());
    }
 
    /// \brief Search the map of coefficients and evaluate the one whose key is
@@ -1072,9 +1238,28 @@ public:
                     const mfem::IntegrationPoint &ip,
                     mfem::DenseMatrix &PointMat_bar) override;
 
+   /// \brief Find the coefficient for the element's `Attribute` once and
+   ///        evaluate it at every integration point in `ir`
+   /// \param[in] trans - element transformation relating real element to
+   ///                    reference element
+   /// \param[in] ir - the integration points to evaluate the coefficient at
+   /// \param[in] states1 - the first state at each integration point
+   /// \param[in] states2 - the second state at each integration point
+   /// \param[in] states3 - the third state at each integration point
+   /// \param[out] values - the coefficient value at each integration point
+   void EvalBatch(mfem::ElementTransformation &trans,
+                  const mfem::IntegrationRule &ir,
+                  const mfem::Vector &states1,
+                  const mfem::Vector &states2,
+                  const mfem::Vector &states3,
+                  mfem::Vector &values) override;
+
 private:
    std::unique_ptr<mfem::Coefficient> default_coeff;
    std::map<const int, std::unique_ptr<mfem::Coefficient>> material_map;
+   /// attribute-indexed view of `material_map` and `default_coeff`
+   MaterialDispatchTable<mfem::Coefficient, ThreeStateCoefficient>
+       material_table;
 };
 
 /// Copied from MeshDependentCoefficient and adapted for
@@ -1092,7 +1277,9 @@ public:
        const int dim = 3,
        std::unique_ptr<mfem::VectorCoefficient> dflt = nullptr)
     : VectorCoefficient(dim), default_coeff(move(dflt))
-   { }
+   {
+      material_table.setDefault(default_coeff.get());
+   }
 
    /// Adds <int, std::unique_ptr<mfem::VectorCoefficient> pair to material_map
    /// \param[in] attr - attribute integer indicating which elements coeff
@@ -1108,6 +1295,7 @@ public:
       {
          mfem::mfem_error("Key already present in map!");
       }
+      material_table.insert(attr, status.first->second.get());
    }
 
    /// \brief Search the map of coefficients and evaluate the one whose key is
@@ -1161,6 +1349,8 @@ public:
 protected:
    std::unique_ptr<mfem::VectorCoefficient> default_coeff;
    std::map<const int, std::unique_ptr<mfem::VectorCoefficient>> material_map;
+   /// attribute-indexed view of `material_map` and `default_coeff`
+   MaterialDispatchTable<mfem::VectorCoefficient> material_table;
 };
 
 /// Abstract class VectorStateCoefficient
@@ -1218,7 +1408,9 @@ public:
        const int dim = 3,
        std::unique_ptr<VectorStateCoefficient> dflt = nullptr)
     : VectorStateCoefficient(dim), default_coeff(move(dflt))
-   { }
+   {
+      material_table.setDefault(default_coeff.get());
+   }
 
    // addCoefficient should be same for MeshDependentVectorStateCoefficient as
    // it is for MeshDependentVectorCoefficient
@@ -1236,6 +1428,7 @@ public:
       {
          mfem::mfem_error("Key already present in map!");
       }
+      material_table.insert(attr, status.first->second.get());
    }
 
    /// \brief Search the map of coefficients and evaluate the one whose key is
@@ -1294,6 +1487,9 @@ public:
 protected:
    std::unique_ptr<VectorStateCoefficient> default_coeff;
    std::map<const int, std::unique_ptr<VectorCoefficient>> material_map;
+   /// attribute-indexed view of `material_map` and `default_coeff`
+   MaterialDispatchTable<mfem::VectorCoefficient, VectorStateCoefficient>
+       material_table;
 };
 
 /// TODO: If needed, add constructMaterialVectorStateCoefficient
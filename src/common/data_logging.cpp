@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "mfem.hpp"
+
+#include "data_logging.hpp"
+
+namespace miso
+{
+BackgroundWriter::BackgroundWriter() : thread([this] { run(); }) { }
+
+BackgroundWriter::~BackgroundWriter()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+   }
+   job_posted.notify_one();
+   thread.join();
+}
+
+long BackgroundWriter::post(std::function<void()> job)
+{
+   long ticket = 0;
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      jobs.push(std::move(job));
+      ticket = posted++;
+   }
+   job_posted.notify_one();
+   return ticket;
+}
+
+void BackgroundWriter::wait(long ticket)
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   job_done.wait(lock, [&] { return completed > ticket; });
+}
+
+void BackgroundWriter::flush()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   job_done.wait(lock, [&] { return completed == posted; });
+}
+
+void BackgroundWriter::run()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   while (true)
+   {
+      job_posted.wait(lock, [&] { return stopping || !jobs.empty(); });
+      /// pending jobs are run before stopping
+      if (jobs.empty())
+      {
+         return;
+      }
+      auto job = std::move(jobs.front());
+      jobs.pop();
+      lock.unlock();
+      try
+      {
+         job();
+      }
+      catch (const std::exception &exception)
+      {
+         std::cerr << "BackgroundWriter: job failed: " << exception.what()
+                   << std::endl;
+      }
+      lock.lock();
+      ++completed;
+      job_done.notify_all();
+   }
+}
+
+AsyncParaViewWriter::AsyncParaViewWriter(const std::string &name,
+                                         mfem::ParMesh &mesh,
+                                         BackgroundWriter *writer,
+                                         int every,
+                                         int num_buffers)
+ : mesh(mesh),
+   every(every),
+   write_mesh(std::make_unique<mfem::Mesh>(mesh, true)),
+   pv(std::make_unique<mfem::ParaViewDataCollection>(name)),
+   buffers(std::max(num_buffers, 1)),
+   writer(writer)
+{
+   /// the communicator gives each rank's piece its name; it is only used
+   /// here, on the calling thread
+   pv->SetMesh(mesh.GetComm(), write_mesh.get());
+   pv->SetPrefixPath("ParaView");
+   pv->SetLevelsOfDetail(refine);
+   pv->SetDataFormat(mfem::VTKFormat::BINARY);
+   pv->SetHighOrderOutput(true);
+}
+
+void AsyncParaViewWriter::registerField(const std::string &name,
+                                        mfem::ParGridFunction &field)
+{
+   auto *pfes = field.ParFESpace();
+   write_spaces.push_back(
+       std::make_unique<mfem::FiniteElementSpace>(write_mesh.get(),
+                                                  pfes->FEColl(),
+                                                  pfes->GetVDim(),
+                                                  pfes->GetOrdering()));
+   write_fields.push_back(
+       std::make_unique<mfem::GridFunction>(write_spaces.back().get()));
+   pv->RegisterField(name, write_fields.back().get());
+   const int order = pfes->GetMaxElementOrder();
+   if (order > refine)
+   {
+      refine = order;
+      pv->SetLevelsOfDetail(refine);
+   }
+   fields.push_back(&field);
+}
+
+void AsyncParaViewWriter::save(double time)
+{
+   if (every < 1 || calls++ % every != 0)
+   {
+      return;
+   }
+   write(cycle++, time);
+}
+
+void AsyncParaViewWriter::write(int cycle, double time)
+{
+   /// wait for the buffer's previous snapshot to be written, then fill it
+   auto &buffer = buffers[next];
+   next = (next + 1) % buffers.size();
+   if (writer != nullptr)
+   {
+      writer->wait(buffer.job);
+   }
+   if (const auto *nodes = mesh.GetNodes())
+   {
+      buffer.nodes = *nodes;
+   }
+   buffer.fields.resize(fields.size());
+   for (std::size_t i = 0; i < fields.size(); ++i)
+   {
+      buffer.fields[i] = *fields[i];
+   }
+   buffer.time = time;
+   buffer.cycle = cycle;
+
+   auto job = [this, &buffer]
+   {
+      if (auto *nodes = write_mesh->GetNodes())
+      {
+         *nodes = buffer.nodes;
+      }
+      for (std::size_t i = 0; i < write_fields.size(); ++i)
+      {
+         *write_fields[i] = buffer.fields[i];
+      }
+      pv->SetCycle(buffer.cycle);
+      pv->SetTime(buffer.time);
+      pv->Save();
+   };
+   if (writer != nullptr)
+   {
+      buffer.job = writer->post(std::move(job));
+      last_job = buffer.job;
+   }
+   else
+   {
+      job();
+   }
+}
+
+AsyncStateLogger::AsyncStateLogger(BackgroundWriter &writer, int num_buffers)
+ : buffers(std::max(num_buffers, 1)), writer(writer)
+{ }
+
+void AsyncStateLogger::saveState(DataLogger &logger,
+                                 const mfem::Vector &state,
+                                 const std::string &fieldname,
+                                 int timestep,
+                                 double time,
+                                 int rank)
+{
+   std::visit(
+       [&](auto &&log)
+       {
+          using Logger = std::decay_t<decltype(log)>;
+          if constexpr (std::is_same_v<Logger, ParaViewLogger>)
+          {
+             log.saveState(state, fieldname, timestep, time, rank);
+          }
+          else
+          {
+             /// wait for the buffer's previous state to be written, then
+             /// fill it
+             auto &buffer = buffers[next];
+             next = (next + 1) % buffers.size();
+             writer.wait(buffer.job);
+             buffer.state = state;
+             buffer.fieldname = fieldname;
+             buffer.timestep = timestep;
+             buffer.time = time;
+             buffer.rank = rank;
+
+             buffer.job = writer.post(
+                 [&buffer]
+                 {
+                    Logger::saveState(buffer.state,
+                                      buffer.fieldname,
+                                      buffer.timestep,
+                                      buffer.time,
+                                      buffer.rank);
+                 });
+             last_job = buffer.job;
+          }
+       },
+       logger);
+}
+
+void AsyncStateLogger::flush(DataLogger &logger)
+{
+   std::visit(
+       [&](auto &&log)
+       {
+          if constexpr (std::is_same_v<std::decay_t<decltype(log)>,
+                                       ParaViewLogger>)
+          {
+             log.flush();
+          }
+          else
+          {
+             writer.wait(last_job);
+          }
+       },
+       logger);
+}
+
+}  // namespace miso
@@ -1,11 +1,18 @@
 #ifndef MISO_DATA_LOGGING
 #define MISO_DATA_LOGGING
 
+#include <condition_variable>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
+#include <thread>
 #include <variant>
+#include <vector>
 
 #include "mfem.hpp"
 
@@ -67,6 +74,9 @@ private:
    inline static const std::string prefix = "ASCIILogger";
 };
 
+/// Saves each rank's part of a state to its own file
+/// \note The files can only be read back on the same number of ranks; to
+/// restart, use the checkpoints of `PDESolver::writeCheckpoint` instead
 class BinaryLogger
 {
 public:
@@ -111,6 +121,150 @@ private:
    inline static const std::string prefix = "BinaryLogger/";
 };
 
+/// Runs jobs, in the order they are posted, on a dedicated background thread
+/// \note Jobs must not call MPI, since MPI is usually initialized without
+/// thread support
+class BackgroundWriter
+{
+public:
+   BackgroundWriter();
+
+   /// Runs the jobs that are still pending, and stops the thread
+   ~BackgroundWriter();
+
+   BackgroundWriter(const BackgroundWriter &) = delete;
+   BackgroundWriter &operator=(const BackgroundWriter &) = delete;
+
+   /// \brief Queue `job` to run on the background thread
+   /// \return a ticket that can be passed to `wait`
+   long post(std::function<void()> job);
+
+   /// \brief Wait until the job with `ticket`, and those before it, have run
+   /// \note Negative tickets, i.e. no job, return immediately
+   void wait(long ticket);
+
+   /// \brief Wait until every posted job has run
+   void flush();
+
+private:
+   /// jobs that have been posted but have not started
+   std::queue<std::function<void()>> jobs;
+   /// number of jobs posted, which is the next job's ticket
+   long posted = 0;
+   /// number of jobs that have run
+   long completed = 0;
+   /// set by the destructor to stop the thread
+   bool stopping = false;
+   std::mutex mutex;
+   /// signalled when a job is posted or the thread should stop
+   std::condition_variable job_posted;
+   /// signalled when a job has run
+   std::condition_variable job_done;
+   /// declared last, so that it starts after the members it uses
+   std::thread thread;
+
+   /// \brief Run jobs until the writer is destroyed
+   void run();
+};
+
+/// Writes snapshots of fields to a ParaView collection on a background thread
+/// \note Each snapshot copies the fields, and the mesh nodes, into one of a
+/// ring of buffers, so the caller may change them as soon as `save` returns;
+/// `save` only blocks if every buffer is still waiting to be written
+/// \note Each rank writes its own piece from a rank-local copy of the mesh, so
+/// writing needs no MPI communication
+/// \note `mfem::ParaViewDataCollection::Save` refines elements with MFEM's
+/// global, non-thread-safe `GlobGeometryRefiner`, so every writer of a
+/// program must post to the same `BackgroundWriter`
+class AsyncParaViewWriter
+{
+public:
+   /// \param[in] name - name of the ParaView collection
+   /// \param[in] mesh - the mesh of the fields that will be registered
+   /// \param[in] writer - the thread that writes the snapshots (not owned); if
+   /// null, snapshots are written on the calling thread
+   /// \param[in] every - a snapshot is saved on every `every`-th call to
+   /// `save`, starting with the first; no snapshots are saved if `every` < 1
+   /// \param[in] num_buffers - number of snapshots that may wait to be written
+   AsyncParaViewWriter(const std::string &name,
+                       mfem::ParMesh &mesh,
+                       BackgroundWriter *writer,
+                       int every = 1,
+                       int num_buffers = 2);
+
+   /// Waits until every snapshot has been written
+   ~AsyncParaViewWriter() { flush(); }
+
+   AsyncParaViewWriter(const AsyncParaViewWriter &) = delete;
+   AsyncParaViewWriter &operator=(const AsyncParaViewWriter &) = delete;
+
+   /// \brief Add `field` to the fields saved in each snapshot
+   /// \note Must not be called once snapshots have been saved
+   void registerField(const std::string &name, mfem::ParGridFunction &field);
+
+   /// \brief Save a snapshot of the registered fields at `time`, if this call
+   /// is due given the cadence
+   void save(double time = 0.0);
+
+   /// \brief Save a snapshot of the registered fields as cycle `cycle` at
+   /// `time`, regardless of the cadence
+   void write(int cycle, double time);
+
+   /// \brief Wait until every snapshot has been written
+   void flush()
+   {
+      if (writer != nullptr)
+      {
+         writer->wait(last_job);
+      }
+   }
+
+private:
+   /// the mesh and fields whose snapshots are saved
+   mfem::ParMesh &mesh;
+   std::vector<mfem::ParGridFunction *> fields;
+   /// a snapshot is saved on every `every`-th call to `save`
+   int every;
+   /// number of calls to `save`
+   long calls = 0;
+   /// number of snapshots saved
+   int cycle = 0;
+
+   /// rank-local copies of the mesh and fields, which only the background
+   /// thread touches once snapshots are being saved
+   std::unique_ptr<mfem::Mesh> write_mesh;
+   std::vector<std::unique_ptr<mfem::FiniteElementSpace>> write_spaces;
+   std::vector<std::unique_ptr<mfem::GridFunction>> write_fields;
+   std::unique_ptr<mfem::ParaViewDataCollection> pv;
+   /// ParaView levels of refinement for field printing
+   int refine = 1;
+
+   /// the mesh nodes and field values of pending snapshots
+   struct Buffer
+   {
+      mfem::Vector nodes;
+      std::vector<mfem::Vector> fields;
+      double time = 0.0;
+      int cycle = 0;
+      /// ticket of the job writing the buffer, or -1
+      long job = -1;
+   };
+   /// ring of buffers, which are reused in order
+   std::vector<Buffer> buffers;
+   /// index of the next buffer to fill
+   std::size_t next = 0;
+
+   /// the thread that writes the snapshots, or null to write them in `write`
+   BackgroundWriter *writer;
+   /// ticket of the last job posted to `writer`, or -1
+   long last_job = -1;
+};
+
+/// Saves registered fields to a ParaView collection
+/// \note The fields are set from the state on the calling thread, and then
+/// written by an `AsyncParaViewWriter`. Once `setBackgroundWriter` has been
+/// called, `saveState` returns before the files are written; call `flush` to
+/// wait for them. Otherwise, the files are written by `saveState` itself.
 class ParaViewLogger
 {
 public:
@@ -123,47 +277,139 @@ public:
       if (fields.count(fieldname) > 0)
       {
          fields.at(fieldname)->SetFromTrueDofs(state);
-         pv.SetCycle(timestep);
-         pv.SetTime(time);
-         pv.Save();
+         getWriter().write(timestep, time);
       }
    }
 
    void registerField(const std::string &name, mfem::ParGridFunction &field)
    {
-      pv.RegisterField(name, &field);
-      fields.emplace(name, &field);
-      auto field_order = field.ParFESpace()->GetMaxElementOrder();
-      if (field_order > refine)
+      if (mesh == nullptr)
+      {
+         mesh = field.ParFESpace()->GetParMesh();
+      }
+      if (writer)
       {
-         refine = field_order;
-         pv.SetLevelsOfDetail(refine);
+         writer->registerField(name, field);
       }
+      fields.emplace(name, &field);
    }
 
-   /// \todo Is the mesh really optional here?  There is a SetMesh method for
-   /// ParaViewDataCollection, but it seems to take a serial mesh?
-   ParaViewLogger(const std::string &name, mfem::ParMesh *mesh = nullptr)
-    : pv(name, mesh)
+   /// \brief Write the saved states on `background` rather than in
+   /// `saveState`
+   /// \param[in] background - the thread that writes the states (not owned)
+   /// \param[in] buffers - number of saved states that may wait to be written
+   /// \note Must be called before the first call to `saveState`
+   void setBackgroundWriter(BackgroundWriter &background, int buffers)
    {
-      pv.SetPrefixPath("ParaView");
-      pv.SetLevelsOfDetail(refine);
-      pv.SetDataFormat(mfem::VTKFormat::BINARY);
-      pv.SetHighOrderOutput(true);
+      background_writer = &background;
+      num_buffers = buffers;
    }
 
+   /// \brief Wait until every saved state has been written
+   void flush()
+   {
+      if (writer)
+      {
+         writer->flush();
+      }
+   }
+
+   /// \param[in] name - name of the ParaView collection
+   /// \param[in] mesh - mesh of the fields; if null, the mesh of the first
+   /// registered field is used
+   ParaViewLogger(const std::string &name, mfem::ParMesh *mesh = nullptr)
+    : name_(name), mesh(mesh)
+   { }
+
 private:
-   /// ParaView object for saving fields
-   mfem::ParaViewDataCollection pv;
+   /// name of the ParaView collection
+   std::string name_;
+   /// mesh of the fields
+   mfem::ParMesh *mesh;
+   /// the thread that writes the saved states, or null to write them in
+   /// `saveState`
+   BackgroundWriter *background_writer = nullptr;
+   /// number of saved states that may wait to be written
+   int num_buffers = 2;
+   /// writes the fields; constructed by the first `saveState`
+   std::unique_ptr<AsyncParaViewWriter> writer;
    /// Map of all state vectors that may be saved by ParaView
    std::map<std::string, mfem::ParGridFunction *> fields;
-   /// Paraview levels of refinement for field printing
-   int refine = 1;
+
+   /// \brief Construct `writer`, if necessary, and return it
+   AsyncParaViewWriter &getWriter()
+   {
+      if (!writer)
+      {
+         writer = std::make_unique<AsyncParaViewWriter>(
+             name_, *mesh, background_writer, 1, num_buffers);
+         for (auto &[name, field] : fields)
+         {
+            writer->registerField(name, *field);
+         }
+      }
+      return *writer;
+   }
 };
 
 using DataLogger = std::variant<ASCIILogger, BinaryLogger, ParaViewLogger>;
 using DataLoggerWithOpts = std::pair<DataLogger, LoggingOptions>;
 
+/// Saves states with data loggers on a background thread
+/// \note Each state is copied into one of a fixed ring of buffers, so the
+/// caller may change it as soon as `saveState` returns; `saveState` only
+/// blocks, which bounds the memory used, when every buffer is still waiting
+/// to be written
+/// \note `ParaViewLogger`s buffer and write their own snapshots, since
+/// setting their fields needs MPI, which is only called from this thread
+class AsyncStateLogger
+{
+public:
+   /// \param[in] writer - the thread that writes the states (not owned)
+   /// \param[in] num_buffers - number of states that may wait to be written
+   AsyncStateLogger(BackgroundWriter &writer, int num_buffers = 2);
+
+   /// Waits until every state has been written
+   ~AsyncStateLogger() { writer.wait(last_job); }
+
+   AsyncStateLogger(const AsyncStateLogger &) = delete;
+   AsyncStateLogger &operator=(const AsyncStateLogger &) = delete;
+
+   /// \brief Save `state` with `logger`, as `logger.saveState` would, but
+   /// serialize and write it in the background
+   void saveState(DataLogger &logger,
+                  const mfem::Vector &state,
+                  const std::string &fieldname,
+                  int timestep,
+                  double time,
+                  int rank);
+
+   /// \brief Wait until every state saved with `logger` has been written
+   void flush(DataLogger &logger);
+
+private:
+   /// the states waiting to be written
+   struct Buffer
+   {
+      mfem::Vector state;
+      std::string fieldname;
+      int timestep = 0;
+      double time = 0.0;
+      int rank = 0;
+      /// ticket of the job writing the buffer, or -1
+      long job = -1;
+   };
+   /// ring of buffers, which are reused in order
+   std::vector<Buffer> buffers;
+   /// index of the next buffer to fill
+   std::size_t next = 0;
+
+   /// the thread that writes the states
+   BackgroundWriter &writer;
+   /// ticket of the last job posted to `writer`, or -1
+   long last_job = -1;
+};
+
 }  // namespace miso
 
 #endif
@@ -13,9 +13,28 @@ const nlohmann::json default_options{
          {"directory", "solver"},
          {"log", true},  // if false, disable all paraview logging
          {"fields", {"state"}},
-         {"each-timestep", false}  // if true, paraview file is saved each step
+         {"each-timestep", false},  // if true, paraview file is saved each step
+         {"diagnostics-every", 1}  // save diagnostic fields every n outputs
+     }},
+    {"timing-file", ""},  // if set, timers are written here as JSON
+    {"log-buffers", 2},  // states that may wait to be logged, 0 = synchronous
+    {"checkpoint",  // single-file checkpoints to restart unsteady runs from
+     {
+         {"every", 0},  // write a checkpoint every n time steps, 0 = never
+         {"prefix", "checkpoint"}  // files are <prefix>_<step>.ckpt
+     }},
+    {"time-history",  // stores every state of unsteady solves
+     {
+         {"file", ""},  // each rank writes <file>_<rank>; empty = not stored
+         {"compression", "none"}  // or "zstd", if built with MISO_USE_ZSTD
      }},
     {"test-ode", false},  // if true, use a simple conservative controller
+    {"geometric-cache", false},  // if true, cache element geometric factors
+    {"assembly-threads", 1},  // threads per rank for element assembly, 0 = all
+    {"jacobian-assembly", "full"},  // "full" matrix or matrix-free "partial"
+    {"reuse-jacobian-structure", false},  // if true, keep Jacobian sparsity
+    {"fused-linearization", false},  // assemble the Jacobian with the residual
+    {"adjoint-jacobian", "transpose"},  // or "symmetric", "implicit", "auto"
     {"flow-param",        // options related to flow simulations
      {
          {"entropy-state", false},  // if true, the states are entropy variables
@@ -65,6 +84,10 @@ const nlohmann::json default_options{
          {"reltol", 1e-14},   // solver relative tolerance
          {"abstol", 1e-14},   // solver absolute tolerance
          {"abort", true},     // should program abort if Newton doesn't converge
+         {"jacobian-free", false},  // apply the Jacobian by finite differences
+         {"jfnk-prec-operator", "low-order"},  // or "full", "element-block"
+         {"state-extrapolation", false},  // guess the state from the last two
+                                          // converged states
      }},
 
     {"lin-solver",
@@ -74,7 +97,8 @@ const nlohmann::json default_options{
          {"maxiter", 100},   // default to 100 iterations
          {"reltol", 1e-12},  // solver relative tolerance
          {"abstol", 1e-12},  // solver absolute tolerance
-         {"kdim", 100}       // default restart value
+         {"kdim", 100},      // default restart value
+         {"recycle-dim", 10}  // vectors "gcrot" keeps between solves
      }},
 
     {"lin-prec",
@@ -83,7 +107,10 @@ const nlohmann::json default_options{
          {"lev-fill", 1},       // ILU(k) fill level
          {"ilu-type", 0},       // ILU type (see mfem HypreILU doc)
          {"ilu-reorder", 1},    // 0 = no reordering, 1 = RCM
-         {"printlevel", 0}  // 0 = none, 1 = setup, 2 = solve, 3 = setup+solve
+         {"printlevel", 0},  // 0 = none, 1 = setup, 2 = solve, 3 = setup+solve
+         {"rebuild-every", 1},  // Newton iterations per setup (< 1: no limit)
+         {"rebuild-iter-threshold", 0}  // set up again after a linear solve
+                                        // takes more iterations (< 1: never)
      }},
 
     {"adj-solver",
@@ -93,7 +120,8 @@ const nlohmann::json default_options{
          {"maxiter", 100},   // maximum number of solver iterations
          {"reltol", 1e-8},   // adjoint solver relative tolerance
          {"abstol", 1e-10},  // adjoint solver absolute tolerance
-         {"kdim", 100}       // default restart value
+         {"kdim", 100},      // default restart value
+         {"recycle-dim", 10}  // vectors "gcrot" keeps between solves
      }},
 
     {"adj-prec",
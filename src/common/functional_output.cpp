@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include "mfem.hpp"
 
 #include "miso_input.hpp"
 #include "miso_integrator.hpp"
+#include "utils.hpp"
 #include "functional_output.hpp"
 
 using namespace mfem;
@@ -50,18 +53,123 @@ void setOptions(FunctionalOutput &output, const nlohmann::json &options)
    }
 }
 
+double FunctionalOutput::calcEnergy(const MISOInputs &inputs)
+{
+   Vector state;
+   setVectorFromInputs(inputs, state_name, state);
+   if (state.Size() != output.ParFESpace()->GetTrueVSize())
+   {
+      scratch.SetSize(output.ParFESpace()->GetTrueVSize());
+      state.NewDataAndSize(scratch.GetData(),
+                           output.ParFESpace()->GetTrueVSize());
+   }
+   return output.GetEnergy(state);
+}
+
 double calcOutput(FunctionalOutput &output, const MISOInputs &inputs)
 {
    setInputs(output, inputs);
-   Vector state;
-   setVectorFromInputs(inputs, output.state_name, state);
-   if (state.Size() != output.output.ParFESpace()->GetTrueVSize())
+   return output.calcEnergy(inputs);
+}
+
+void calcOutputs(const std::vector<FunctionalOutput *> &outputs,
+                 const MISOInputs &inputs,
+                 Vector &values,
+                 bool inputs_set)
+{
+   const int num_outputs = static_cast<int>(outputs.size());
+   values.SetSize(num_outputs);
+   values = 0.0;
+
+   /// group the functionals that share the sweep by the field they integrate
+   std::vector<ParGridFunction *> states;
+   std::vector<std::vector<int>> groups;
+   std::vector<int> unfused;
+   ParMesh *mesh = nullptr;
+   for (int i = 0; i < num_outputs; ++i)
+   {
+      auto &output = *outputs[i];
+      if (output.func_fields == nullptr || output.has_face_integs ||
+          output.func_fields->count(output.state_name) == 0)
+      {
+         unfused.push_back(i);
+         continue;
+      }
+      if (!inputs_set)
+      {
+         setInputs(output, inputs);
+      }
+
+      auto *state = &output.func_fields->at(output.state_name).gridFunc();
+      auto *state_mesh = state->ParFESpace()->GetParMesh();
+      if (mesh == nullptr)
+      {
+         mesh = state_mesh;
+      }
+      else if (state_mesh != mesh)
+      {
+         throw MISOException(
+             "calcOutputs: fused functionals must share the same mesh!\n");
+      }
+      auto group = std::find(states.begin(), states.end(), state);
+      if (group == states.end())
+      {
+         states.push_back(state);
+         groups.emplace_back();
+         group = states.end() - 1;
+      }
+      groups[group - states.begin()].push_back(i);
+   }
+
+   if (mesh != nullptr)
    {
-      output.scratch.SetSize(output.output.ParFESpace()->GetTrueVSize());
-      state.NewDataAndSize(output.scratch.GetData(),
-                           output.output.ParFESpace()->GetTrueVSize());
+      IsoparametricTransformation trans;
+      Array<int> vdofs;
+      Vector elfun;
+      for (int e = 0; e < mesh->GetNE(); ++e)
+      {
+         mesh->GetElementTransformation(e, &trans);
+         const int attr = mesh->GetAttribute(e);
+         for (int g = 0; g < static_cast<int>(states.size()); ++g)
+         {
+            auto &state = *states[g];
+            auto &fes = *state.ParFESpace();
+            const auto &el = *fes.GetFE(e);
+            auto *dof_tr = fes.GetElementVDofs(e, vdofs);
+            state.GetSubVector(vdofs, elfun);
+            if (dof_tr != nullptr)
+            {
+               dof_tr->InvTransformPrimal(elfun);
+            }
+            for (int i : groups[g])
+            {
+               for (const auto &[integ, marker] : outputs[i]->domain_integs)
+               {
+                  if (marker != nullptr && (*marker)[attr - 1] == 0)
+                  {
+                     continue;
+                  }
+                  values(i) += integ->GetElementEnergy(el, trans, elfun);
+               }
+            }
+         }
+      }
+      MPI_Allreduce(MPI_IN_PLACE,
+                    values.GetData(),
+                    num_outputs,
+                    MPI_DOUBLE,
+                    MPI_SUM,
+                    mesh->GetComm());
+   }
+
+   for (int i : unfused)
+   {
+      if (!inputs_set)
+      {
+         setInputs(*outputs[i], inputs);
+      }
+      values(i) = outputs[i]->calcEnergy(inputs);
    }
-   return output.output.GetEnergy(state);
 }
 
 double calcOutputPartial(FunctionalOutput &output,
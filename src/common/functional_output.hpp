@@ -4,6 +4,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "mfem.hpp"
@@ -48,6 +49,23 @@ public:
                                      const std::string &wrt,
                                      mfem::Vector &wrt_bar);
 
+   /// \brief Evaluate several functionals together in one sweep over the
+   /// elements
+   /// \param[in] outputs - the functionals to evaluate
+   /// \param[in] inputs - inputs set on every functional before evaluating
+   /// \param[out] values - the value of each functional, resized as needed
+   /// \param[in] inputs_set - true if `inputs` have already been set on every
+   /// functional, so they are not set again
+   /// \note Each element's transformation is computed once and its state is
+   /// gathered once per field, and both are then shared by the domain
+   /// integrators of all of the functionals; the local sums are added over all
+   /// ranks by a single `MPI_Allreduce`. Functionals with face integrators, or
+   /// built without fields, are evaluated on their own with `calcOutput`.
+   friend void calcOutputs(const std::vector<FunctionalOutput *> &outputs,
+                           const MISOInputs &inputs,
+                           mfem::Vector &values,
+                           bool inputs_set);
+
    /// Adds domain integrator to the nonlinear form that backs this output,
    /// and adds a reference to it to in integs as a MISOIntegrator
    /// \param[in] integrator - integrator to add to functional
@@ -128,6 +146,10 @@ public:
    { }
 
 protected:
+   /// \return the value of the functional at the state in `inputs`
+   /// \note the inputs must already have been set on the functional
+   double calcEnergy(const MISOInputs &inputs);
+
    /// underlying nonlinear form object
    mfem::ParNonlinearForm output;
    /// work vector
@@ -148,6 +170,14 @@ protected:
    /// Collection of boundary markers for boundary integrators
    std::list<mfem::Array<int>> bdr_markers;
 
+   /// domain integrators and their element attribute markers (nullptr for all
+   /// elements), used to evaluate the functional within a shared sweep
+   std::vector<std::pair<mfem::NonlinearFormIntegrator *, mfem::Array<int> *>>
+       domain_integs;
+   /// true if the form has face integrators, which a shared element sweep
+   /// cannot evaluate
+   bool has_face_integs = false;
+
    /// map of linear forms that will compute \frac{\partial J}{\partial field}
    /// for each field the functional depends on
    std::map<std::string, mfem::ParLinearForm> output_sens;
@@ -156,13 +186,31 @@ protected:
    std::map<std::string, mfem::ParNonlinearForm> output_scalar_sens;
 };
 
+void calcOutputs(const std::vector<FunctionalOutput *> &outputs,
+                 const MISOInputs &inputs,
+                 mfem::Vector &values,
+                 bool inputs_set = false);
+
 inline int getSize(const FunctionalOutput &output) { return 1; }
 
+inline void addFunctionals(FunctionalOutput &output,
+                           std::vector<FunctionalOutput *> &functionals)
+{
+   functionals.push_back(&output);
+}
+
+inline double calcOutputFromFunctionals(FunctionalOutput &output,
+                                        const double *values)
+{
+   return values[0];
+}
+
 template <typename T>
 void FunctionalOutput::addOutputDomainIntegrator(T *integrator)
 {
    integs.emplace_back(*integrator);
    output.AddDomainIntegrator(integrator);
+   domain_integs.emplace_back(integrator, nullptr);
    addDomainSensitivityIntegrator(*integrator,
                                   *func_fields,
                                   output_sens,
@@ -183,6 +231,7 @@ void FunctionalOutput::addOutputDomainIntegrator(
    auto &marker = domain_markers.emplace_back(mesh_attr_size);
    attrVecToArray(attr_marker, marker);
    output.AddDomainIntegrator(integrator, marker);
+   domain_integs.emplace_back(integrator, &marker);
    addDomainSensitivityIntegrator(*integrator,
                                   *func_fields,
                                   output_sens,
@@ -196,6 +245,7 @@ void FunctionalOutput::addOutputInteriorFaceIntegrator(T *integrator)
 {
    integs.emplace_back(*integrator);
    output.AddInteriorFaceIntegrator(integrator);
+   has_face_integs = true;
    addInteriorFaceSensitivityIntegrator(
        *integrator, *func_fields, output_sens, output_scalar_sens, state_name);
 }
@@ -205,6 +255,7 @@ void FunctionalOutput::addOutputBdrFaceIntegrator(T *integrator)
 {
    integs.emplace_back(*integrator);
    output.AddBdrFaceIntegrator(integrator);
+   has_face_integs = true;
    addBdrSensitivityIntegrator(*integrator,
                                *func_fields,
                                output_sens,
@@ -225,6 +276,7 @@ void FunctionalOutput::addOutputBdrFaceIntegrator(
    attrVecToArray(bdr_attr_marker, marker);
 
    output.AddBdrFaceIntegrator(integrator, marker);
+   has_face_integs = true;
    addBdrSensitivityIntegrator(*integrator,
                                *func_fields,
                                output_sens,
@@ -238,6 +290,7 @@ void FunctionalOutput::addInternalBoundaryFaceIntegrator(T *integrator)
 {
    integs.emplace_back(*integrator);
    output.AddInternalBoundaryFaceIntegrator(integrator);
+   has_face_integs = true;
    addInternalBoundarySensitivityIntegrator(*integrator,
                                             *func_fields,
                                             output_sens,
@@ -257,6 +310,7 @@ void FunctionalOutput::addInternalBoundaryFaceIntegrator(
    attrVecToArray(bdr_attr_marker, marker);
 
    output.AddInternalBoundaryFaceIntegrator(integrator, marker);
+   has_face_integs = true;
    addInternalBoundarySensitivityIntegrator(*integrator,
                                             *func_fields,
                                             output_sens,
@@ -158,6 +158,35 @@ mfem::Operator &JacobianFree::getDiagonalBlock(int i) const
        "incompatible operators/matrices!\n");
 }
 
+mfem::Operator &JacobianFree::getPreconditionerMatrix() const
+{
+   // We assume that `state` holds where the Jacobian is to be evaluated
+   auto inputs = MISOInputs({{"state", state}});
+   auto *jac =
+       dynamic_cast<HypreParMatrix *>(&getPreconditionerJacobian(res, inputs));
+   auto *hypre_exp = dynamic_cast<HypreParMatrix *>(explicit_part);
+   if (jac == nullptr || (explicit_part != nullptr && hypre_exp == nullptr))
+   {
+      throw MISOException(
+          "JacobianFree::getPreconditionerMatrix:\n"
+          "preconditioner Jacobian and explicit part of operator must be "
+          "castable to HypreParMatrix!\n");
+   }
+   // a new matrix is assembled, since preconditioners may still reference
+   // the old one until they are set up again
+   if (hypre_exp != nullptr)
+   {
+      prec_mat = std::make_unique<HypreParMatrix>(*hypre_exp);
+      prec_mat->Add(scale, *jac);
+   }
+   else
+   {
+      prec_mat = std::make_unique<HypreParMatrix>(*jac);
+      *prec_mat *= scale;
+   }
+   return *prec_mat;
+}
+
 double JacobianFree::getStepSize(const mfem::Vector &baseline,
                                  const mfem::Vector &pert) const
 {
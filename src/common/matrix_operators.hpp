@@ -1,6 +1,8 @@
 #ifndef MISO_MATRIX_OPERATORS
 #define MISO_MATRIX_OPERATORS
 
+#include <memory>
+
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
 
@@ -241,6 +243,13 @@ public:
    /// exception will be thrown by MISOResidual.
    mfem::Operator &getDiagonalBlock(int i) const;
 
+   /// Assemble the matrix used to precondition this operator
+   /// \returns the scaled Jacobian given by `getPreconditionerJacobian` for
+   /// the residual, plus the explicit part of the operator if there is one
+   /// \note Both must be `mfem::HypreParMatrix`s, and the returned matrix is
+   /// owned by this operator and replaced by the next call
+   mfem::Operator &getPreconditionerMatrix() const;
+
    /// Write a file with the explicit matrix entries
    /// \param[in] file_name - file name to open and write to
    void print(std::string file_name) const;
@@ -261,6 +270,8 @@ private:
    mfem::Vector res_at_state;
    /// work vector needed to compute the Jacobian-free product
    mutable mfem::Vector state_pert;
+   /// matrix assembled by `getPreconditionerMatrix`
+   mutable std::unique_ptr<mfem::HypreParMatrix> prec_mat;
 
    /// Returns a (hopefully) appropriate forward-difference step size
    /// \param[in] baseline - the state at which the Jacobian is computed
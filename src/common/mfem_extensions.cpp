@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "mfem.hpp"
 #include "relaxed_newton.hpp"
@@ -7,6 +11,7 @@
 #include "utils.hpp"
 #include "matrix_operators.hpp"
 #include "mfem_extensions.hpp"
+#include "timers.hpp"
 
 using namespace mfem;
 
@@ -294,6 +299,30 @@ void BlockJacobiPreconditioner::SetOperator(const Operator &input_op)
       }
       return;
    }
+   auto hypre_op = dynamic_cast<const HypreParMatrix *>(&input_op);
+   if (hypre_op != nullptr)
+   {
+      // input op is a HypreParMatrix, whose diagonal blocks are copied out of
+      // its local (processor-diagonal) part
+      SparseMatrix diag;
+      hypre_op->GetDiag(diag);
+      local_blocks.resize(nBlocks);
+      Array<int> dofs;
+      for (int i = 0; i < nBlocks; ++i)
+      {
+         if (op[i] != nullptr)
+         {
+            dofs.SetSize(offsets[i + 1] - offsets[i]);
+            for (int k = 0; k < dofs.Size(); ++k)
+            {
+               dofs[k] = offsets[i] + k;
+            }
+            diag.GetSubMatrix(dofs, dofs, local_blocks[i]);
+            op[i]->SetOperator(local_blocks[i]);
+         }
+      }
+      return;
+   }
    auto jacfree_op = dynamic_cast<const JacobianFree *>(&input_op);
    if (jacfree_op != nullptr)
    {
@@ -310,11 +339,12 @@ void BlockJacobiPreconditioner::SetOperator(const Operator &input_op)
       }
       return;
    }
-   // if we get here, input_op was neither a BlockOperator nor a JacobianFree
+   // if we get here, input_op was not a BlockOperator, HypreParMatrix, or
+   // JacobianFree
    throw MISOException(
        "BlockJacobiPreconditioner::SetOperator:\n"
-       "input operator must be castable to"
-       "mfem::BlockOperator or JacobianFree!\n");
+       "input operator must be castable to mfem::BlockOperator,"
+       " mfem::HypreParMatrix, or JacobianFree!\n");
 }
 
 void BlockJacobiPreconditioner::Mult(const Vector &x, Vector &y) const
@@ -389,6 +419,489 @@ BlockJacobiPreconditioner::~BlockJacobiPreconditioner()
    }
 }
 
+bool supportsTranspose(const mfem::Solver &prec)
+{
+   if (dynamic_cast<const OperatorJacobiSmoother *>(&prec) != nullptr)
+   {
+      return true;
+   }
+#ifdef MFEM_USE_SUITESPARSE
+   if (dynamic_cast<const UMFPackSolver *>(&prec) != nullptr)
+   {
+      return true;
+   }
+#endif
+   const auto *block_prec =
+       dynamic_cast<const BlockJacobiPreconditioner *>(&prec);
+   if (block_prec == nullptr)
+   {
+      return false;
+   }
+   for (int i = 0; i < block_prec->NumBlocks(); ++i)
+   {
+      const auto *block =
+          dynamic_cast<const Solver *>(&block_prec->GetDiagonalBlock(i));
+      if (block == nullptr || !supportsTranspose(*block))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void AdjointPreconditioner::SetOperator(const mfem::Operator &op)
+{
+   height = op.Height();
+   width = op.Width();
+
+   const auto *op_trans = dynamic_cast<const ImplicitTransposeOperator *>(&op);
+   transpose = op_trans != nullptr;
+   if (transpose && !supportsTranspose(prec))
+   {
+      throw MISOException(
+          "AdjointPreconditioner: the forward preconditioner does not "
+          "implement MultTranspose, so it cannot precondition an implicit "
+          "transpose; use \"adjoint-jacobian\": \"transpose\"!\n");
+   }
+   if (!forward_set_up)
+   {
+      prec.SetOperator(transpose ? op_trans->forward() : op);
+      forward_set_up = true;
+   }
+}
+
+void AdjointPreconditioner::Mult(const mfem::Vector &x, mfem::Vector &y) const
+{
+   if (transpose)
+   {
+      prec.MultTranspose(x, y);
+   }
+   else
+   {
+      prec.Mult(x, y);
+   }
+}
+
+FixedOperatorSolver::FixedOperatorSolver(mfem::Solver &solver)
+ : mfem::Solver(solver.Height(), solver.Width()), solver(solver)
+{ }
+
+void FixedOperatorSolver::Mult(const mfem::Vector &x, mfem::Vector &y) const
+{
+   solver.Mult(x, y);
+}
+
+namespace
+{
+/// \return true if the local blocks of `a` and `b` have the same sparsity
+bool sameLocalPattern(hypre_CSRMatrix *a, hypre_CSRMatrix *b)
+{
+   const HYPRE_Int rows = hypre_CSRMatrixNumRows(a);
+   if (rows != hypre_CSRMatrixNumRows(b) ||
+       hypre_CSRMatrixNumCols(a) != hypre_CSRMatrixNumCols(b) ||
+       hypre_CSRMatrixNumNonzeros(a) != hypre_CSRMatrixNumNonzeros(b))
+   {
+      return false;
+   }
+   const HYPRE_Int *a_i = hypre_CSRMatrixI(a);
+   const HYPRE_Int *a_j = hypre_CSRMatrixJ(a);
+   return std::equal(a_i, a_i + rows + 1, hypre_CSRMatrixI(b)) &&
+          std::equal(a_j, a_j + a_i[rows], hypre_CSRMatrixJ(b));
+}
+
+}  // anonymous namespace
+
+bool LaggedPreconditioner::copyValues(const mfem::HypreParMatrix &src,
+                                      mfem::HypreParMatrix &dest)
+{
+   hypre_ParCSRMatrix *src_mat = src;
+   hypre_ParCSRMatrix *dest_mat = dest;
+   auto *src_diag = hypre_ParCSRMatrixDiag(src_mat);
+   auto *src_offd = hypre_ParCSRMatrixOffd(src_mat);
+   auto *dest_diag = hypre_ParCSRMatrixDiag(dest_mat);
+   auto *dest_offd = hypre_ParCSRMatrixOffd(dest_mat);
+   int same = static_cast<int>(
+       src.GetGlobalNumRows() == dest.GetGlobalNumRows() &&
+       src.GetGlobalNumCols() == dest.GetGlobalNumCols() &&
+       sameLocalPattern(src_diag, dest_diag) &&
+       sameLocalPattern(src_offd, dest_offd));
+   if (same != 0)
+   {
+      const auto *src_map = hypre_ParCSRMatrixColMapOffd(src_mat);
+      const auto num_offd = hypre_CSRMatrixNumCols(src_offd);
+      same = static_cast<int>(std::equal(
+          src_map, src_map + num_offd, hypre_ParCSRMatrixColMapOffd(dest_mat)));
+   }
+   /// every rank must agree, since copying the whole matrix is collective
+   MPI_Allreduce(MPI_IN_PLACE, &same, 1, MPI_INT, MPI_MIN, src.GetComm());
+   if (same == 0)
+   {
+      return false;
+   }
+   std::copy(hypre_CSRMatrixData(src_diag),
+             hypre_CSRMatrixData(src_diag) +
+                 hypre_CSRMatrixNumNonzeros(src_diag),
+             hypre_CSRMatrixData(dest_diag));
+   std::copy(hypre_CSRMatrixData(src_offd),
+             hypre_CSRMatrixData(src_offd) +
+                 hypre_CSRMatrixNumNonzeros(src_offd),
+             hypre_CSRMatrixData(dest_offd));
+   return true;
+}
+
+void LaggedPreconditioner::SetOperator(const mfem::Operator &op)
+{
+   height = op.Height();
+   width = op.Width();
+
+   const bool stale =
+       (rebuild_every > 0 && operators_since_setup >= rebuild_every) ||
+       (max_krylov_iters > 0 && applications > max_krylov_iters);
+   if (needs_setup || stale)
+   {
+      /// nested under the linear solver's "preconditioner-setup" timer, this
+      /// separates the setups that are rebuilt from those that are reused
+      ScopedTimer timer("rebuild");
+      const double start = MPI_Wtime();
+      const auto *mat = dynamic_cast<const mfem::HypreParMatrix *>(&op);
+      if (mat != nullptr)
+      {
+         /// the copy's storage is kept when the sparsity does not change
+         if (setup_mat == nullptr || !copyValues(*mat, *setup_mat))
+         {
+            setup_mat = std::make_unique<mfem::HypreParMatrix>(*mat);
+         }
+         prec.SetOperator(*setup_mat);
+      }
+      else
+      {
+         setup_mat.reset();
+         prec.SetOperator(op);
+      }
+      setup_time += MPI_Wtime() - start;
+      ++setups;
+      timers().count("preconditioner-setups");
+      needs_setup = false;
+      operators_since_setup = 0;
+   }
+   else
+   {
+      ++reuses;
+      timers().count("preconditioner-reuses");
+   }
+   ++operators_since_setup;
+   applications = 0;
+}
+
+void LaggedPreconditioner::Mult(const mfem::Vector &x, mfem::Vector &y) const
+{
+   const double start = MPI_Wtime();
+   prec.Mult(x, y);
+   const double elapsed = MPI_Wtime() - start;
+   /// the first application after a setup includes any lazy setup
+   if (applications == 0 && operators_since_setup == 1)
+   {
+      setup_time += elapsed;
+   }
+   else
+   {
+      apply_time += elapsed;
+   }
+   ++applications;
+}
+
+void JacobianFreePreconditioner::SetOperator(const mfem::Operator &op)
+{
+   height = op.Height();
+   width = op.Width();
+   const auto *jac_free = dynamic_cast<const JacobianFree *>(&op);
+   if (jac_free != nullptr)
+   {
+      prec.SetOperator(jac_free->getPreconditionerMatrix());
+   }
+   else
+   {
+      prec.SetOperator(op);
+   }
+}
+
+void RecyclingGMRESSolver::setRecycleDim(int dim)
+{
+   recycle_dim = dim;
+   if (recycledSize() > recycle_dim)
+   {
+      const int num_dropped = recycledSize() - std::max(recycle_dim, 0);
+      recycled_u.erase(recycled_u.begin(), recycled_u.begin() + num_dropped);
+      recycled_c.erase(recycled_c.begin(), recycled_c.begin() + num_dropped);
+   }
+}
+
+void RecyclingGMRESSolver::clearRecycledSpace() const
+{
+   recycled_u.clear();
+   recycled_c.clear();
+   recycled_stale = false;
+}
+
+void RecyclingGMRESSolver::SetOperator(const mfem::Operator &op)
+{
+   if (op.Height() != height)
+   {
+      clearRecycledSpace();
+   }
+   mfem::IterativeSolver::SetOperator(op);
+   recycled_stale = !recycled_u.empty();
+}
+
+void RecyclingGMRESSolver::Mult(const mfem::Vector &b, mfem::Vector &x) const
+{
+   const int size = height;
+   if (!iterative_mode)
+   {
+      x = 0.0;
+   }
+   if (recycled_stale)
+   {
+      updateRecycledProducts();
+   }
+
+   mfem::Vector r(size);
+   mfem::Vector w(size);
+   std::vector<mfem::Vector> v(kdim + 1);
+   std::vector<mfem::Vector> z(kdim);
+   mfem::DenseMatrix h(kdim + 1, kdim);
+   mfem::DenseMatrix bmat(std::max(recycle_dim, 1), kdim);
+   mfem::Vector g(kdim + 1);
+   mfem::Vector cs(kdim);
+   mfem::Vector sn(kdim);
+   mfem::Vector y(kdim);
+
+   double tol = -1.0;
+   final_iter = 0;
+   converged = false;
+   while (true)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r);
+      if (tol < 0.0)
+      {
+         tol = std::max(rel_tol * Norm(r), abs_tol);
+      }
+
+      /// the best correction in the recycled subspace
+      for (int i = 0; i < recycledSize(); ++i)
+      {
+         const double alpha = Dot(recycled_c[i], r);
+         x.Add(alpha, recycled_u[i]);
+         r.Add(-alpha, recycled_c[i]);
+      }
+      final_norm = Norm(r);
+      if (print_options.iterations)
+      {
+         mfem::out << "   Iteration : " << final_iter
+                   << "  ||r|| = " << final_norm << '\n';
+      }
+      if (final_norm <= tol)
+      {
+         converged = true;
+         break;
+      }
+      if (final_iter >= max_iter)
+      {
+         break;
+      }
+
+      /// a restart cycle of GMRES with the recycled subspace projected out
+      const int num_recycled = recycledSize();
+      v[0].SetSize(size);
+      v[0].Set(1.0 / final_norm, r);
+      g = 0.0;
+      g(0) = final_norm;
+      int j = 0;
+      while (j < kdim && final_iter < max_iter)
+      {
+         z[j].SetSize(size);
+         if (prec != nullptr)
+         {
+            prec->Mult(v[j], z[j]);
+         }
+         else
+         {
+            z[j] = v[j];
+         }
+         oper->Mult(z[j], w);
+         for (int i = 0; i < num_recycled; ++i)
+         {
+            bmat(i, j) = Dot(recycled_c[i], w);
+            w.Add(-bmat(i, j), recycled_c[i]);
+         }
+         for (int i = 0; i <= j; ++i)
+         {
+            h(i, j) = Dot(v[i], w);
+            w.Add(-h(i, j), v[i]);
+         }
+         h(j + 1, j) = Norm(w);
+         if (h(j + 1, j) > 0.0)
+         {
+            v[j + 1].SetSize(size);
+            v[j + 1].Set(1.0 / h(j + 1, j), w);
+         }
+
+         /// reduce the Hessenberg matrix with Givens rotations
+         for (int i = 0; i < j; ++i)
+         {
+            const double temp = cs(i) * h(i, j) + sn(i) * h(i + 1, j);
+            h(i + 1, j) = -sn(i) * h(i, j) + cs(i) * h(i + 1, j);
+            h(i, j) = temp;
+         }
+         const double denom = std::hypot(h(j, j), h(j + 1, j));
+         cs(j) = h(j, j) / denom;
+         sn(j) = h(j + 1, j) / denom;
+         h(j, j) = denom;
+         h(j + 1, j) = 0.0;
+         g(j + 1) = -sn(j) * g(j);
+         g(j) = cs(j) * g(j);
+
+         ++j;
+         ++final_iter;
+         if (print_options.iterations)
+         {
+            mfem::out << "   Iteration : " << final_iter
+                      << "  ||r|| = " << std::abs(g(j)) << '\n';
+         }
+         if (std::abs(g(j)) <= tol)
+         {
+            break;
+         }
+      }
+
+      for (int i = j - 1; i >= 0; --i)
+      {
+         y(i) = g(i);
+         for (int l = i + 1; l < j; ++l)
+         {
+            y(i) -= h(i, l) * y(l);
+         }
+         y(i) /= h(i, i);
+      }
+
+      /// the cycle's correction, z y - U B y, keeps the residual orthogonal
+      /// to the recycled subspace
+      mfem::Vector correction(size);
+      correction = 0.0;
+      for (int l = 0; l < j; ++l)
+      {
+         correction.Add(y(l), z[l]);
+      }
+      for (int i = 0; i < num_recycled; ++i)
+      {
+         double by = 0.0;
+         for (int l = 0; l < j; ++l)
+         {
+            by += bmat(i, l) * y(l);
+         }
+         correction.Add(-by, recycled_u[i]);
+      }
+      x += correction;
+
+      mfem::Vector op_correction(size);
+      oper->Mult(correction, op_correction);
+      addRecycledVector(std::move(correction), std::move(op_correction));
+   }
+
+   if (print_options.summary || (print_options.warnings && !converged))
+   {
+      mfem::out << "RecyclingGMRES: Number of iterations: " << final_iter
+                << ", recycled vectors: " << recycledSize() << '\n';
+   }
+   if (print_options.warnings && !converged)
+   {
+      mfem::out << "RecyclingGMRES: No convergence!\n";
+   }
+}
+
+void RecyclingGMRESSolver::addRecycledVector(mfem::Vector u,
+                                             mfem::Vector c) const
+{
+   if (recycle_dim < 1)
+   {
+      return;
+   }
+   const double initial_norm = Norm(c);
+   for (int i = 0; i < recycledSize(); ++i)
+   {
+      const double alpha = Dot(recycled_c[i], c);
+      c.Add(-alpha, recycled_c[i]);
+      u.Add(-alpha, recycled_u[i]);
+   }
+   const double norm = Norm(c);
+   if (norm <= 1e-12 * initial_norm)
+   {
+      return;
+   }
+   c /= norm;
+   u /= norm;
+   recycled_u.push_back(std::move(u));
+   recycled_c.push_back(std::move(c));
+   if (recycledSize() > recycle_dim)
+   {
+      recycled_u.erase(recycled_u.begin());
+      recycled_c.erase(recycled_c.begin());
+   }
+}
+
+void RecyclingGMRESSolver::updateRecycledProducts() const
+{
+   auto old_u = std::move(recycled_u);
+   clearRecycledSpace();
+   for (auto &u : old_u)
+   {
+      mfem::Vector c(u.Size());
+      oper->Mult(u, c);
+      addRecycledVector(std::move(u), std::move(c));
+   }
+}
+
+void ProfiledLinearSolver::SetOperator(const mfem::Operator &op)
+{
+   ScopedTimer timer("preconditioner-setup");
+   height = op.Height();
+   width = op.Width();
+   solver.SetOperator(op);
+}
+
+void ProfiledLinearSolver::Mult(const mfem::Vector &x, mfem::Vector &y) const
+{
+   {
+      ScopedTimer timer("linear-solve");
+      solver.iterative_mode = iterative_mode;
+      solver.Mult(x, y);
+   }
+   timers().count("krylov-iterations", getNumIterations(solver));
+}
+
+int getNumIterations(mfem::Solver &solver)
+{
+   int num_iterations = 0;
+   if (auto *iterative = dynamic_cast<mfem::IterativeSolver *>(&solver))
+   {
+      num_iterations = iterative->GetNumIterations();
+   }
+   else if (auto *gmres = dynamic_cast<mfem::HypreGMRES *>(&solver))
+   {
+      gmres->GetNumIterations(num_iterations);
+   }
+   else if (auto *fgmres = dynamic_cast<mfem::HypreFGMRES *>(&solver))
+   {
+      fgmres->GetNumIterations(num_iterations);
+   }
+   else if (auto *pcg = dynamic_cast<mfem::HyprePCG *>(&solver))
+   {
+      pcg->GetNumIterations(num_iterations);
+   }
+   return num_iterations;
+}
+
 std::unique_ptr<mfem::Solver> constructLinearSolver(
     MPI_Comm comm,
     const nlohmann::json &lin_options,
@@ -471,6 +984,27 @@ std::unique_ptr<mfem::Solver> constructLinearSolver(
       }
       return fgmres;
    }
+   else if (solver_type == "gcrot")
+   {
+      auto gcrot = std::make_unique<RecyclingGMRESSolver>(comm);
+      gcrot->SetRelTol(reltol);
+      gcrot->SetAbsTol(abstol);
+      gcrot->SetMaxIter(maxiter);
+      if (ptl > 0)
+      {
+         gcrot->SetPrintLevel(IterativeSolver::PrintLevel().Iterations());
+      }
+      if (kdim != -1)
+      {
+         gcrot->SetKDim(kdim);  // set subspace size between restarts
+      }
+      gcrot->setRecycleDim(lin_options.value("recycle-dim", 10));
+      if (prec != nullptr)
+      {
+         gcrot->SetPreconditioner(*prec);
+      }
+      return gcrot;
+   }
    else if (solver_type == "hyprepcg")
    {
       auto pcg = std::make_unique<mfem::HyprePCG>(comm);
@@ -515,7 +1049,7 @@ std::unique_ptr<mfem::Solver> constructLinearSolver(
       throw MISOException(
           "Unsupported iterative solver type!\n"
           "\tavilable options are: hypregmres, gmres, hyprefgmres, fgmres,\n"
-          "\thyprepcg, pcg, minres");
+          "\tgcrot, hyprepcg, pcg, minres");
    }
 }
 
@@ -1,6 +1,9 @@
 #ifndef MFEM_EXTENSIONS
 #define MFEM_EXTENSIONS
 
+#include <memory>
+#include <vector>
+
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
 
@@ -120,6 +123,9 @@ public:
 
    /// Calls SetOperator on the diagonal block operators
    /// \param[in] op - a BlockOperator whose diagonal entries are used
+   /// \note `op` may also be a HypreParMatrix, in which case the blocks are
+   /// the square `mfem::DenseMatrix` submatrices of its local diagonal part
+   /// given by the offsets, e.g. the element blocks of a DSBP Jacobian
    virtual void SetOperator(const mfem::Operator &op) override;
 
    /// Return the number of blocks
@@ -176,11 +182,297 @@ private:
    mfem::Array<int> offsets;
    /// 1D array that stores each block of the operator.
    mfem::Array<Solver *> op;
+   /// diagonal blocks extracted when set up with a HypreParMatrix
+   std::vector<mfem::DenseMatrix> local_blocks;
    /// Temporary Vectors used to efficiently apply the Mult and MultTranspose
    mutable mfem::BlockVector xblock;
    mutable mfem::BlockVector yblock;
 };
 
+/// Applies the transpose of an operator through its `MultTranspose`, so that
+/// the transpose never has to be formed
+class ImplicitTransposeOperator : public mfem::Operator
+{
+public:
+   /// \param[in] op - the operator whose transpose is applied (not owned)
+   explicit ImplicitTransposeOperator(const mfem::Operator &op)
+    : mfem::Operator(op.Width(), op.Height()), op(op)
+   { }
+
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override
+   {
+      op.MultTranspose(x, y);
+   }
+
+   void MultTranspose(const mfem::Vector &x, mfem::Vector &y) const override
+   {
+      op.Mult(x, y);
+   }
+
+   /// \return the operator whose transpose is applied
+   const mfem::Operator &forward() const { return op; }
+
+private:
+   /// the operator whose transpose is applied
+   const mfem::Operator &op;
+};
+
+/// \return true if `prec` implements `MultTranspose`, so that it can
+/// precondition the transpose of the operator it was set up for
+/// \note hypre's preconditioners (BoomerAMG, AMS, Euclid, ILU, ...) do not
+bool supportsTranspose(const mfem::Solver &prec);
+
+/// Applies a preconditioner that was set up for a forward operator to systems
+/// with that operator or, through `MultTranspose`, with its transpose, without
+/// setting the preconditioner up again
+/// \note The preconditioner is only set up in `SetOperator` if it has not
+/// already been set up for the forward operator, e.g. by a Newton solve
+/// \note The transpose is applied when the operator given to `SetOperator` is
+/// an `ImplicitTransposeOperator`, so the wrapped preconditioner must then
+/// implement `MultTranspose`; `SetOperator` throws if it does not
+class AdjointPreconditioner : public mfem::Solver
+{
+public:
+   /// \param[in] prec - the preconditioner of the forward operator (not owned)
+   explicit AdjointPreconditioner(mfem::Solver &prec) : prec(prec) { }
+
+   /// Tell the preconditioner whether `prec` is already set up for the
+   /// forward operator
+   void setForwardSetUp(bool set_up) { forward_set_up = set_up; }
+
+   /// Sizes the preconditioner for `op`, and sets up the wrapped
+   /// preconditioner with the forward operator of `op` if needed
+   /// \param[in] op - the forward operator or its `ImplicitTransposeOperator`
+   void SetOperator(const mfem::Operator &op) override;
+
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override;
+
+private:
+   /// the preconditioner of the forward operator
+   mfem::Solver &prec;
+   /// if true, `prec` is applied through its `MultTranspose`
+   bool transpose = false;
+   /// if true, `prec` has been set up for the forward operator
+   bool forward_set_up = false;
+};
+
+/// Applies a solver whose operator has already been set, and ignores later
+/// `SetOperator` calls so the solver's preconditioner is not set up again
+/// \note Used to solve several right-hand sides with the same operator, e.g.
+/// the adjoints of several outputs, through functions that set the operator
+class FixedOperatorSolver : public mfem::Solver
+{
+public:
+   /// \param[in] solver - the solver whose operator is kept (not owned)
+   explicit FixedOperatorSolver(mfem::Solver &solver);
+
+   /// Does nothing; `op` must be the operator `solver` already has
+   void SetOperator(const mfem::Operator & /*op*/) override { }
+
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override;
+
+private:
+   /// the solver whose operator is kept
+   mfem::Solver &solver;
+};
+
+/// Reuses the setup of a preconditioner across several operators, e.g. the
+/// Jacobians of successive Newton iterations, and sets it up again only once
+/// it is considered stale
+/// \note The preconditioner is set up again after `rebuild_every` operators,
+/// or when the last linear solve applied it more than `max_krylov_iters`
+/// times, which is how many Krylov iterations that solve took
+/// \note A `mfem::HypreParMatrix` operator is copied before the preconditioner
+/// is set up with it, since hypre's preconditioners keep using the matrix they
+/// were set up with while the Jacobian it came from may be reassembled
+/// \note hypre's preconditioners are set up the first time they are applied,
+/// so that first application is counted as setup time
+class LaggedPreconditioner : public mfem::Solver
+{
+public:
+   /// \param[in] prec - the preconditioner whose setup is reused (not owned)
+   /// \param[in] rebuild_every - number of operators a setup is used for; if
+   /// non-positive, setups are not limited by count
+   /// \param[in] max_krylov_iters - set up again if the last linear solve
+   /// took more iterations than this; if non-positive, this is not checked
+   LaggedPreconditioner(mfem::Solver &prec,
+                        int rebuild_every,
+                        int max_krylov_iters)
+    : prec(prec),
+      rebuild_every(rebuild_every),
+      max_krylov_iters(max_krylov_iters)
+   { }
+
+   /// Sets up the wrapped preconditioner with `op` if its current setup is
+   /// stale, and otherwise keeps using the current setup
+   void SetOperator(const mfem::Operator &op) override;
+
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override;
+
+   /// Force the wrapped preconditioner to be set up with the next operator,
+   /// e.g. because it has been set up with another operator elsewhere
+   void invalidate() { needs_setup = true; }
+
+   /// \return the number of times the wrapped preconditioner was set up
+   int numSetups() const { return setups; }
+   /// \return the number of operators the current setup was reused for
+   int numReuses() const { return reuses; }
+   /// \return the total time spent setting up the wrapped preconditioner
+   double setupTime() const { return setup_time; }
+   /// \return the total time spent applying the wrapped preconditioner
+   double applyTime() const { return apply_time; }
+
+private:
+   /// the preconditioner whose setup is reused
+   mfem::Solver &prec;
+   /// number of operators a setup is used for
+   int rebuild_every;
+   /// number of Krylov iterations above which a setup is stale
+   int max_krylov_iters;
+
+   /// copy of the matrix `prec` was last set up with, whose storage is
+   /// reused by later setups with the same sparsity
+   std::unique_ptr<mfem::HypreParMatrix> setup_mat;
+   /// true if `prec` must be set up with the next operator
+   bool needs_setup = true;
+   /// number of operators given since `prec` was last set up
+   int operators_since_setup = 0;
+   /// number of applications since the last operator was given
+   mutable int applications = 0;
+
+   /// statistics about setups and applications
+   int setups = 0;
+   int reuses = 0;
+   mutable double setup_time = 0.0;
+   mutable double apply_time = 0.0;
+
+   /// \brief Overwrite the values of `dest` with those of `src` if the two
+   /// matrices have the same parallel sparsity
+   /// \return true if the values were copied
+   /// \note Collective on the communicator of `src`
+   static bool copyValues(const mfem::HypreParMatrix &src,
+                          mfem::HypreParMatrix &dest);
+};
+
+/// Preconditions a `JacobianFree` operator with a preconditioner that needs an
+/// assembled matrix, which it is set up with instead of the operator
+/// \note The matrix is the one given by `JacobianFree::getPreconditionerMatrix`,
+/// so the Jacobian applied by the Krylov solver itself is never assembled
+/// \note Operators other than `JacobianFree` are passed on unchanged
+class JacobianFreePreconditioner : public mfem::Solver
+{
+public:
+   /// \param[in] prec - the preconditioner that is set up (not owned)
+   explicit JacobianFreePreconditioner(mfem::Solver &prec) : prec(prec) { }
+
+   /// Sets up the wrapped preconditioner with the preconditioning matrix of
+   /// `op` if it is a `JacobianFree` operator, and with `op` otherwise
+   void SetOperator(const mfem::Operator &op) override;
+
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override
+   {
+      prec.Mult(x, y);
+   }
+
+private:
+   /// the preconditioner that is set up
+   mfem::Solver &prec;
+};
+
+/// Flexible GMRES that recycles a subspace between solves, following the
+/// GCROT(m, k) method of Hicken and Zingg (SIAM J. Sci. Comput., 2010)
+/// \note Each restart cycle's correction is added to the recycled subspace,
+/// which drops its oldest vector once it holds `recycle_dim` vectors; later
+/// cycles and later solves deflate the subspace before iterating
+/// \note The subspace is kept across `SetOperator` calls, so solves with the
+/// slowly changing Jacobians of Newton iterations or design iterations reuse
+/// it; the first solve after `SetOperator` applies the new operator to the
+/// recycled vectors
+/// \note The preconditioner is applied on the right and may change between
+/// iterations, as in FGMRES
+class RecyclingGMRESSolver : public mfem::IterativeSolver
+{
+public:
+   /// \param[in] kdim - number of iterations between restarts
+   /// \param[in] recycle_dim - most vectors kept in the recycled subspace
+   explicit RecyclingGMRESSolver(int kdim = 50, int recycle_dim = 10)
+    : kdim(kdim), recycle_dim(recycle_dim)
+   { }
+
+   /// \param[in] comm - MPI communicator used for inner products
+   /// \param[in] kdim - number of iterations between restarts
+   /// \param[in] recycle_dim - most vectors kept in the recycled subspace
+   RecyclingGMRESSolver(MPI_Comm comm, int kdim = 50, int recycle_dim = 10)
+    : mfem::IterativeSolver(comm), kdim(kdim), recycle_dim(recycle_dim)
+   { }
+
+   void SetKDim(int dim) { kdim = dim; }
+
+   /// Set the most vectors kept in the recycled subspace; zero gives FGMRES
+   void setRecycleDim(int dim);
+
+   /// \return the number of vectors currently in the recycled subspace
+   int recycledSize() const { return static_cast<int>(recycled_u.size()); }
+
+   /// Discard the recycled subspace
+   void clearRecycledSpace() const;
+
+   /// Sets the operator, and the preconditioner's operator, keeping the
+   /// recycled subspace unless the operator's size changed
+   void SetOperator(const mfem::Operator &op) override;
+
+   void Mult(const mfem::Vector &b, mfem::Vector &x) const override;
+
+private:
+   /// number of iterations between restarts
+   int kdim;
+   /// most vectors kept in the recycled subspace
+   int recycle_dim;
+
+   /// the recycled solution directions
+   mutable std::vector<mfem::Vector> recycled_u;
+   /// the products of the operator with `recycled_u`; these are orthonormal
+   mutable std::vector<mfem::Vector> recycled_c;
+   /// if true, `recycled_c` was computed with a previous operator
+   mutable bool recycled_stale = false;
+
+   /// Orthonormalize `c` against `recycled_c`, applying the same operations
+   /// to `u`, and add both to the recycled subspace
+   /// \param[in] u - the new recycled direction
+   /// \param[in] c - the product of the operator with `u`
+   /// \note `u` is dropped if `c` is (numerically) in the recycled subspace
+   void addRecycledVector(mfem::Vector u, mfem::Vector c) const;
+
+   /// Apply the operator to the recycled directions again
+   void updateRecycledProducts() const;
+};
+
+/// Times the setup and solves of a linear solver and counts its iterations,
+/// using the timers returned by `timers()`
+/// \note hypre's Krylov solvers set up their preconditioner lazily, in their
+/// first solve, so for them preconditioner setup is timed as part of the solve
+class ProfiledLinearSolver : public mfem::Solver
+{
+public:
+   /// \param[in] solver - the linear solver to time (not owned)
+   explicit ProfiledLinearSolver(mfem::Solver &solver) : solver(solver) { }
+
+   /// Sets the operator of the wrapped solver, timed as "preconditioner-setup"
+   void SetOperator(const mfem::Operator &op) override;
+
+   /// Solves with the wrapped solver, timed as "linear-solve", and counts its
+   /// iterations as "krylov-iterations"
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override;
+
+private:
+   /// the linear solver being timed
+   mfem::Solver &solver;
+};
+
+/// \return the number of iterations of the last solve of `solver`, or zero if
+/// it is not an iterative solver
+int getNumIterations(mfem::Solver &solver);
+
 /// Constuct a linear system solver based on the given options
 /// \param[in] comm - MPI communicator used by linear solver
 /// \param[in] lin_options - options structure that determines the solver
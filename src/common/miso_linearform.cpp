@@ -5,6 +5,7 @@
 #include "miso_input.hpp"
 #include "miso_integrator.hpp"
 #include "miso_linearform.hpp"
+#include "timers.hpp"
 #include "utils.hpp"
 
 namespace miso
@@ -55,7 +56,10 @@ void setOptions(MISOLinearForm &load, const nlohmann::json &options)
 
 void addLoad(MISOLinearForm &load, mfem::Vector &tv)
 {
-   load.lf.Assemble();
+   {
+      ScopedTimer timer("load-assembly");
+      load.lf.Assemble();
+   }
    load.scratch.SetSize(tv.Size());
    load.lf.ParallelAssemble(load.scratch);
    load.scratch.SetSubVector(load.ess_tdof_list, 0.0);
@@ -124,7 +128,10 @@ void vectorJacobianProduct(MISOLinearForm &load,
 
       auto &wrt_rev_sens = load.rev_sens.at(wrt);
 
-      wrt_rev_sens.Assemble();
+      {
+         ScopedTimer timer("sensitivity-assembly:" + wrt);
+         assembleTimed(wrt_rev_sens);
+      }
       load.scratch.SetSize(wrt_bar.Size());
       load.scratch = 0.0;
       wrt_rev_sens.ParallelAssemble(load.scratch);
@@ -47,6 +47,21 @@ void calcOutput(T & /*unused*/,
    throw NotImplementedException("not specialized for concrete output type!\n");
 }
 
+class FunctionalOutput;
+
+/// By default an output is not built from functionals that can be evaluated
+/// together with those of other outputs, and adds none
+template <typename T>
+void addFunctionals(T & /*unused*/,
+                    std::vector<FunctionalOutput *> & /*unused*/)
+{ }
+
+template <typename T>
+double calcOutputFromFunctionals(T & /*unused*/, const double * /*unused*/)
+{
+   throw NotImplementedException("not specialized for concrete output type!\n");
+}
+
 /// Creates common interface for outputs computable by miso
 /// A MISOOutput can wrap any type `T` that has the interface of an output.
 class MISOOutput final
@@ -83,6 +98,23 @@ public:
                           const MISOInputs &inputs,
                           mfem::Vector &out_vec);
 
+   /// Add the functionals the scalar output is computed from to a list of
+   /// functionals that are evaluated together
+   /// \param[inout] output - the output whose functionals we want
+   /// \param[inout] functionals - the output's functionals are appended
+   /// \note An output that appends no functionals is evaluated on its own
+   friend void addFunctionals(MISOOutput &output,
+                              std::vector<FunctionalOutput *> &functionals);
+
+   /// Compute the scalar output from the values of the functionals it added
+   /// with `addFunctionals`
+   /// \param[inout] output - the output to compute
+   /// \param[in] values - values of the output's functionals, in the order
+   /// they were added
+   /// \return the output's value
+   friend double calcOutputFromFunctionals(MISOOutput &output,
+                                           const double *values);
+
    /// Compute a scalar output's sensitivity to @a wrt and contract it with
    /// wrt_dot
    /// \param[inout] output - the output whose sensitivity we want
@@ -155,6 +187,9 @@ private:
                                       mfem::Vector &partial) = 0;
       virtual void calcOutput_(const MISOInputs &inputs,
                                mfem::Vector &out_vec) = 0;
+      virtual void addFunctionals_(
+          std::vector<FunctionalOutput *> &functionals) = 0;
+      virtual double calcOutputFromFunctionals_(const double *values) = 0;
       virtual double jacobianVectorProduct_(const mfem::Vector &wrt_dot,
                                             const std::string &wrt) = 0;
       virtual void jacobianVectorProduct_(const mfem::Vector &wrt_dot,
@@ -200,6 +235,15 @@ private:
       {
          calcOutput(data_, inputs, out_vec);
       }
+      void addFunctionals_(
+          std::vector<FunctionalOutput *> &functionals) override
+      {
+         addFunctionals(data_, functionals);
+      }
+      double calcOutputFromFunctionals_(const double *values) override
+      {
+         return calcOutputFromFunctionals(data_, values);
+      }
       double jacobianVectorProduct_(const mfem::Vector &wrt_dot,
                                     const std::string &wrt) override
       {
@@ -271,6 +315,18 @@ inline void calcOutput(MISOOutput &output,
    output.self_->calcOutput_(inputs, out_vec);
 }
 
+inline void addFunctionals(MISOOutput &output,
+                           std::vector<FunctionalOutput *> &functionals)
+{
+   output.self_->addFunctionals_(functionals);
+}
+
+inline double calcOutputFromFunctionals(MISOOutput &output,
+                                        const double *values)
+{
+   return output.self_->calcOutputFromFunctionals_(values);
+}
+
 inline double jacobianVectorProduct(MISOOutput &output,
                                     const mfem::Vector &wrt_dot,
                                     const std::string &wrt)
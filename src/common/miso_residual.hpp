@@ -1,10 +1,13 @@
 #ifndef MISO_RESIDUAL
 #define MISO_RESIDUAL
 
+#include <algorithm>
+
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
 
 #include "miso_input.hpp"
+#include "timers.hpp"
 #include "utils.hpp"
 
 namespace miso
@@ -128,6 +131,23 @@ mfem::Operator &getJacobianBlock(T & /*unused*/,
        "getJacobianBlock not specialized for concrete residual type!\n");
 }
 
+template <typename T>
+mfem::Operator &getPreconditionerJacobian(T &residual, const MISOInputs &inputs)
+{
+   return getJacobian(residual, inputs, "state");
+}
+
+/// Default for residuals that cannot assemble their Jacobian while they are
+/// evaluated, which evaluates the residual and then its state Jacobian
+template <typename T>
+mfem::Operator &evaluateAndLinearize(T &residual,
+                                     const MISOInputs &inputs,
+                                     mfem::Vector &res_vec)
+{
+   evaluate(residual, inputs, res_vec);
+   return getJacobian(residual, inputs, "state");
+}
+
 /// Defines a common interface for residual functions used by miso.
 /// A MISOResidual can wrap any type `T` that has the interface of a residual
 /// function.  For example, one instance of `T` is given by `MISONonlinearForm`,
@@ -185,6 +205,17 @@ public:
                         const MISOInputs &inputs,
                         mfem::Vector &res_vec);
 
+   /// Evaluate the residual and compute its state Jacobian together
+   /// \param[inout] residual - the residual being evaluated
+   /// \param[in] inputs - the independent variables at which to evaluate `res`
+   /// \param[out] res_vec - the dependent variable, the output from `residual`
+   /// \returns a reference to the residual's Jacobian with respect to "state"
+   /// \note Residuals built on `MISONonlinearForm` assemble both in a single
+   /// sweep over the elements; others evaluate and then linearize
+   friend mfem::Operator &evaluateAndLinearize(MISOResidual &residual,
+                                               const MISOInputs &inputs,
+                                               mfem::Vector &res_vec);
+
    /// Cache inputs for the residual and internally store Jacobians
    /// \param[inout] residual - the residual being evaluated
    /// \param[in] inputs - the independent variables at which to evaluate `res`
@@ -221,6 +252,16 @@ public:
                                            const MISOInputs &inputs,
                                            int iblock);
 
+   /// Get the Jacobian used to set up the state Jacobian's preconditioner
+   /// \param[inout] residual - function whose preconditioner is being set up
+   /// \param[in] inputs - the variables needed to evaluate the Jacobian
+   /// \returns the Jacobian of a cheaper approximation of `residual`, if the
+   /// concrete residual type defines one, and otherwise its state Jacobian
+   /// \note Used by Jacobian-free Newton-Krylov, where the state Jacobian
+   /// itself is never assembled
+   friend mfem::Operator &getPreconditionerJacobian(MISOResidual &residual,
+                                                    const MISOInputs &inputs);
+
    friend void setUpAdjointSystem(MISOResidual &residual,
                                   mfem::Solver &adj_solver,
                                   const MISOInputs &inputs,
@@ -324,17 +365,36 @@ public:
 
    /// We need to support these overrides so that the MISOResidual type can be
    /// directly set as the operator for an MFEM NonlinearSolver
+   /// \note With the "fused-linearization" option the state Jacobian is
+   /// assembled along with the residual, and kept for `GetGradient`
    void Mult(const mfem::Vector &state, mfem::Vector &res_vec) const override
    {
       MISOInputs inputs{{"state", state}};
-      self_->eval_(inputs, res_vec);
+      if (!fuse_linearization)
+      {
+         ScopedTimer timer("residual-evaluation");
+         self_->eval_(inputs, res_vec);
+         return;
+      }
+      ScopedTimer timer("fused-assembly");
+      fused_jac = &self_->evalAndLinearize_(inputs, res_vec);
+      fused_state = state;
    }
 
    /// We need to support these overrides so that the MISOResidual type can be
    /// directly set as the operator for an MFEM NonlinearSolver
+   /// \note Returns the Jacobian assembled by the last `Mult` if it was at
+   /// the same state
    mfem::Operator &GetGradient(const mfem::Vector &state) const override
    {
+      if (fused_jac != nullptr && state.Size() == fused_state.Size() &&
+          std::equal(state.begin(), state.end(), fused_state.begin()))
+      {
+         return *fused_jac;
+      }
+      ScopedTimer timer("jacobian-assembly");
       MISOInputs inputs{{"state", state}};
+      fused_jac = nullptr;
       return self_->getJac_(inputs, "state");
    }
 
@@ -357,6 +417,8 @@ private:
       virtual void setInputs_(const MISOInputs &inputs) = 0;
       virtual void setOptions_(const nlohmann::json &options) = 0;
       virtual void eval_(const MISOInputs &inputs, mfem::Vector &res_vec) = 0;
+      virtual mfem::Operator &evalAndLinearize_(const MISOInputs &inputs,
+                                                mfem::Vector &res_vec) = 0;
       virtual void linearize_(const MISOInputs &inputs) = 0;
       virtual mfem::Operator &getJac_(const MISOInputs &inputs,
                                       const std::string &wrt) = 0;
@@ -364,6 +426,7 @@ private:
                                        const std::string &wrt) = 0;
       virtual mfem::Operator &getJacBlock_(const MISOInputs &inputs,
                                            int iblock) = 0;
+      virtual mfem::Operator &getPrecJac_(const MISOInputs &inputs) = 0;
       virtual void setUpAdjointSystem_(mfem::Solver &adj_solver,
                                        const MISOInputs &inputs,
                                        mfem::Vector &state_bar,
@@ -410,6 +473,11 @@ private:
       {
          evaluate(data_, inputs, res_vec);
       }
+      mfem::Operator &evalAndLinearize_(const MISOInputs &inputs,
+                                        mfem::Vector &res_vec) override
+      {
+         return evaluateAndLinearize(data_, inputs, res_vec);
+      }
       void linearize_(const MISOInputs &inputs) override
       {
          linearize(data_, inputs);
@@ -429,6 +497,10 @@ private:
       {
          return getJacobianBlock(data_, inputs, iblock);
       }
+      mfem::Operator &getPrecJac_(const MISOInputs &inputs) override
+      {
+         return getPreconditionerJacobian(data_, inputs);
+      }
       void setUpAdjointSystem_(mfem::Solver &adj_solver,
                                const MISOInputs &inputs,
                                mfem::Vector &state_bar,
@@ -488,6 +560,15 @@ private:
 
    /// Pointer to `model` via its abstract base class `concept_t`
    std::unique_ptr<concept_t> self_;
+
+   /// if true, `Mult` also assembles the state Jacobian; this saves a sweep
+   /// over the elements for each Newton iteration, but assembles a Jacobian
+   /// that is never used for the final residual and line-search evaluations
+   bool fuse_linearization = false;
+   /// Jacobian assembled by the last fused `Mult`, and the state it was
+   /// assembled at
+   mutable mfem::Operator *fused_jac = nullptr;
+   mutable mfem::Vector fused_state;
 };
 
 template <typename T>
@@ -533,6 +614,8 @@ inline void setInputs(MISOResidual &residual, const MISOInputs &inputs)
    // passes `inputs` on to the `setInputs` function for the concrete
    // residual type
    residual.self_->setInputs_(inputs);
+   // the inputs may change the Jacobian at the cached state
+   residual.fused_jac = nullptr;
 }
 
 inline void setOptions(MISOResidual &residual, const nlohmann::json &options)
@@ -540,6 +623,11 @@ inline void setOptions(MISOResidual &residual, const nlohmann::json &options)
    // passes `options` on to the `setOptions` function for the concrete
    // residual type
    residual.self_->setOptions_(options);
+   if (options.contains("fused-linearization"))
+   {
+      residual.fuse_linearization = options["fused-linearization"].get<bool>();
+   }
+   residual.fused_jac = nullptr;
 }
 
 inline void evaluate(MISOResidual &residual,
@@ -548,11 +636,23 @@ inline void evaluate(MISOResidual &residual,
 {
    // passes `inputs` and `res_vec` on to the `evaluate` function for the
    // concrete residual type
+   ScopedTimer timer("residual-evaluation");
    residual.self_->eval_(inputs, res_vec);
 }
 
+inline mfem::Operator &evaluateAndLinearize(MISOResidual &residual,
+                                            const MISOInputs &inputs,
+                                            mfem::Vector &res_vec)
+{
+   ScopedTimer timer("fused-assembly");
+   residual.fused_jac = nullptr;
+   return residual.self_->evalAndLinearize_(inputs, res_vec);
+}
+
 inline void linearize(MISOResidual &residual, const MISOInputs &inputs)
 {
+   ScopedTimer timer("jacobian-assembly");
+   residual.fused_jac = nullptr;
    residual.self_->linearize_(inputs);
 }
 
@@ -562,6 +662,9 @@ inline mfem::Operator &getJacobian(MISOResidual &residual,
 {
    // passes `inputs` and `res_vec` on to the `getJacobian` function for the
    // concrete residual type
+   ScopedTimer timer("jacobian-assembly");
+   // the Jacobian owned by the residual is reassembled, maybe elsewhere
+   residual.fused_jac = nullptr;
    return residual.self_->getJac_(inputs, wrt);
 }
 
@@ -571,6 +674,7 @@ inline mfem::Operator &getJacobianTranspose(MISOResidual &residual,
 {
    // passes `inputs` and `res_vec` on to the `getJacobianTranspose` function
    // for the concrete residual type
+   ScopedTimer timer("jacobian-transpose-assembly");
    return residual.self_->getJacT_(inputs, wrt);
 }
 
@@ -583,12 +687,20 @@ inline mfem::Operator &getJacobianBlock(MISOResidual &residual,
    return residual.self_->getJacBlock_(inputs, iblock);
 }
 
+inline mfem::Operator &getPreconditionerJacobian(MISOResidual &residual,
+                                                 const MISOInputs &inputs)
+{
+   ScopedTimer timer("preconditioner-jacobian-assembly");
+   return residual.self_->getPrecJac_(inputs);
+}
+
 inline void setUpAdjointSystem(MISOResidual &residual,
                                mfem::Solver &adj_solver,
                                const MISOInputs &inputs,
                                mfem::Vector &state_bar,
                                mfem::Vector &adjoint)
 {
+   ScopedTimer timer("adjoint-setup");
    residual.self_->setUpAdjointSystem_(adj_solver, inputs, state_bar, adjoint);
 }
 
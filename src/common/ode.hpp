@@ -53,10 +53,14 @@ public:
 
        \param[in] spatial_res - Reference to externally owned spatial residual
        \param[in] mass_matrix - Non-owning pointer to the optional mass matrix
+       \param[in] jacobian_free - if true, the Jacobian is a `JacobianFree`
+                  operator for any type of mass matrix
        \tparam T - The concrete type of the spatial residual
        \note If no mass matrix is provided an IdentityOperator will be used */
    template <typename T>
-   TimeDependentResidual(T &spatial_res, mfem::Operator *mass_matrix = nullptr)
+   TimeDependentResidual(T &spatial_res,
+                         mfem::Operator *mass_matrix = nullptr,
+                         bool jacobian_free = false)
     : spatial_res_(spatial_res),
       mass_matrix_(mass_matrix),
       work(getSize(spatial_res_))
@@ -74,7 +78,11 @@ public:
       auto *hypre_mass = dynamic_cast<mfem::HypreParMatrix *>(mass_matrix_);
       auto *iden_mass = dynamic_cast<mfem::IdentityOperator *>(mass_matrix_);
       auto *block_mass = dynamic_cast<mfem::BlockOperator *>(mass_matrix_);
-      if (hypre_mass != nullptr)
+      if (jacobian_free)
+      {
+         jac_ = std::make_unique<JacobianFree>(spatial_res_, *mass_matrix_);
+      }
+      else if (hypre_mass != nullptr)
       {
          jac_ = std::make_unique<mfem::HypreParMatrix>(*hypre_mass);
       }
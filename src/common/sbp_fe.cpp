@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "mfem.hpp"
 
 #include "utils.hpp"
@@ -99,31 +103,24 @@ void SBPFiniteElement::multWeakOperator(int di,
    MFEM_ASSERT(u.Width() == Qu.Width() && u.Width() == num_nodes, "");
    MFEM_ASSERT(u.Height() == Qu.Height(), "");
    int num_states = u.Height();
+   // only the nonzero entries (i, j, Q_{di}(i,j)) contribute
    if (trans)
    {
-      for (int i = 0; i < num_nodes; ++i)
+      for (const auto &entry : Q_nonzeros[di])
       {
-         for (int j = 0; j < num_nodes; ++j)
+         for (int n = 0; n < num_states; ++n)
          {
-            for (int n = 0; n < num_states; ++n)
-            {
-               // recall that Q[di] stores the transposed operator
-               Qu(n, i) -= Q[di](i, j) * u(n, j);
-            }
+            Qu(n, entry.j) -= entry.value * u(n, entry.i);
          }
       }
    }
    else  // trans == false
    {
-      for (int i = 0; i < num_nodes; ++i)
+      for (const auto &entry : Q_nonzeros[di])
       {
-         for (int j = 0; j < num_nodes; ++j)
+         for (int n = 0; n < num_states; ++n)
          {
-            for (int n = 0; n < num_states; ++n)
-            {
-               // recall that Q[di] stores the transposed operator
-               Qu(n, i) += Q[di](j, i) * u(n, j);
-            }
+            Qu(n, entry.i) += entry.value * u(n, entry.j);
          }
       }
    }
@@ -140,12 +137,12 @@ void SBPFiniteElement::multWeakOperator(int di,
    MFEM_ASSERT(u.Height() == Qu.Size(), "");
    int num_states = u.Height();
    Qu = 0.0;
-   for (int j = 0; j < num_nodes; ++j)
+   for (int k = Q_row_begin[di][i]; k < Q_row_begin[di][i + 1]; ++k)
    {
+      const auto &entry = Q_nonzeros[di][k];
       for (int n = 0; n < num_states; ++n)
       {
-         // recall that Q[di] stores the transposed operator
-         Qu(n) += Q[di](j, i) * u(n, j);
+         Qu(n) += entry.value * u(n, entry.j);
       }
    }
 }
@@ -179,6 +176,30 @@ double SBPFiniteElement::getSkewEntry(int di,
    return Sij;
 }
 
+void SBPFiniteElement::getSkewEntries(const std::vector<DenseMatrix> &adjJ,
+                                      DenseMatrix &S) const
+{
+   int dim = GetDim();
+   int num_pairs = static_cast<int>(skew_pairs.size());
+   MFEM_ASSERT(static_cast<int>(adjJ.size()) == GetDof(), "");
+   S.SetSize(num_pairs, dim);
+   for (int p = 0; p < num_pairs; ++p)
+   {
+      const auto &pair = skew_pairs[p];
+      const DenseMatrix &adjJ_i = adjJ[pair.i];
+      const DenseMatrix &adjJ_j = adjJ[pair.j];
+      for (int di = 0; di < dim; ++di)
+      {
+         double Sij = 0.0;
+         for (int k = 0; k < dim; ++k)
+         {
+            Sij += adjJ_i(k, di) * pair.Q_ij[k] - adjJ_j(k, di) * pair.Q_ji[k];
+         }
+         S(p, di) = Sij;
+      }
+   }
+}
+
 void SBPFiniteElement::getSkewEntryRevDiff(int di,
                                            int i,
                                            int j,
@@ -313,6 +334,67 @@ void SBPFiniteElement::multProjOperator(const DenseMatrix &u,
    }
 }
 
+void SBPFiniteElement::buildSparseOperators()
+{
+   int dim = GetDim();
+   int num_nodes = GetDof();
+   // entries this small relative to the largest one are roundoff in the
+   // tabulated operators, and are treated as zeros
+   double max_entry = 0.0;
+   for (int k = 0; k < dim; ++k)
+   {
+      max_entry = std::max(max_entry, Q[k].MaxMaxNorm());
+   }
+   const double drop_tol = 1e-14 * max_entry;
+   auto nonzero = [&](double value) { return fabs(value) > drop_tol; };
+
+   Q_nonzeros.assign(dim, {});
+   Q_row_begin.assign(dim, std::vector<int>(num_nodes + 1, 0));
+   for (int k = 0; k < dim; ++k)
+   {
+      for (int i = 0; i < num_nodes; ++i)
+      {
+         Q_row_begin[k][i] = Q_nonzeros[k].size();
+         for (int j = 0; j < num_nodes; ++j)
+         {
+            // recall that Q[k] stores the transposed operator
+            if (nonzero(Q[k](j, i)))
+            {
+               Q_nonzeros[k].push_back({i, j, Q[k](j, i)});
+            }
+         }
+      }
+      Q_row_begin[k][num_nodes] = Q_nonzeros[k].size();
+   }
+
+   skew_pairs.clear();
+   for (int i = 0; i < num_nodes; ++i)
+   {
+      for (int j = i + 1; j < num_nodes; ++j)
+      {
+         SkewPair pair{i, j, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+         bool keep = false;
+         for (int k = 0; k < dim; ++k)
+         {
+            if (nonzero(Q[k](j, i)))
+            {
+               pair.Q_ij[k] = Q[k](j, i);
+               keep = true;
+            }
+            if (nonzero(Q[k](i, j)))
+            {
+               pair.Q_ji[k] = Q[k](i, j);
+               keep = true;
+            }
+         }
+         if (keep)
+         {
+            skew_pairs.push_back(pair);
+         }
+      }
+   }
+}
+
 int SBPFiniteElement::getIntegrationPointIndex(const IntegrationPoint &ip) const
 {
    const double tol = 1e-12;
@@ -421,6 +503,7 @@ SBPSegmentElement::SBPSegmentElement(const int degree)
    miso::getVandermondeForSeg(xi, order, V);
    // scale V to account for the different reference elements
    V *= sqrt(2.0);
+   buildSparseOperators();
 }
 
 /// CalcShape outputs ndofx1 vector shape based on Kronecker \delta_{i, ip}
@@ -834,6 +917,7 @@ SBPTriangleElement::SBPTriangleElement(const int degree, const int num_nodes)
    miso::getVandermondeForTri(xi, eta, order, V);
    // scale V to account for the different reference elements
    V *= 2.0;
+   buildSparseOperators();
 }
 
 /// CalcShape outputs ndofx1 vector shape based on Kronecker \delta_{i, ip}
@@ -1025,6 +1109,7 @@ SBPTetrahedronElement::SBPTetrahedronElement(const int degree, const int num_nod
    miso::getVandermondeForTet(xi, eta, zeta, order, V);
    // scale V to account for the different reference elements
    V *= 2.0*sqrt(2.0);
+   buildSparseOperators();
  }
 
 /// CalcShape outputs ndofx1 vector shape based on Kronecker \delta_{i, ip}
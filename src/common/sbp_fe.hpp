@@ -2,6 +2,7 @@
 #define MFEM_SBP_FE
 
 #include <unordered_map>  // TODO: delete when we re-implement SBP elements?
+#include <vector>
 
 #include "mfem.hpp"
 
@@ -182,6 +183,67 @@ public:
                     const mfem::DenseMatrix &adjJ_i,
                     const mfem::DenseMatrix &adjJ_j) const;
 
+   /// Nonzero entry of a reference-space operator
+   struct OperatorEntry
+   {
+      /// row index
+      int i;
+      /// column index
+      int j;
+      /// value of the entry
+      double value;
+   };
+
+   /// Node pair `i < j` whose skew entries are nonzero in some direction,
+   /// with the reference-space operator entries that the skew entries need
+   struct SkewPair
+   {
+      /// row index
+      int i;
+      /// column index
+      int j;
+      /// \f$ (Q_{k})_{i,j} \f$ for each reference direction `k`
+      double Q_ij[3];
+      /// \f$ (Q_{k})_{j,i} \f$ for each reference direction `k`
+      double Q_ji[3];
+   };
+
+   /// Returns the nonzero entries of the weak derivative in direction `di`
+   /// \param[in] di - desired reference space direction of the operator
+   /// \returns the entries \f$ (i, j, (Q_{di})_{i,j}) \f$, ordered by row
+   /// \note Entries that are roundoff relative to the largest entry of the
+   /// operators are dropped
+   const std::vector<OperatorEntry> &getWeakOperatorNonzeros(int di) const
+   {
+      return Q_nonzeros[di];
+   }
+
+   /// Returns where row `i` starts in `getWeakOperatorNonzeros(di)`
+   /// \param[in] di - desired reference space direction of the operator
+   /// \param[in] i - row index, which may be the number of nodes
+   /// \returns the index of the first nonzero of row `i`; the row ends where
+   /// row `i + 1` starts
+   int getWeakOperatorRowBegin(int di, int i) const
+   {
+      return Q_row_begin[di][i];
+   }
+
+   /// Returns the node pairs with nonzero skew entries, ordered by `i`
+   const std::vector<SkewPair> &getSkewPairs() const { return skew_pairs; }
+
+   /// Skew entries of all node pairs of `getSkewPairs()` in physical space
+   /// \param[in] adjJ - adjugate of the mapping Jacobian at each node
+   /// \param[out] S - `num_pairs` x `dim` entries, where `S(p, di)` is
+   /// \f$ (S_{di})_{i,j} \f$ of pair `p`, as returned by `getSkewEntry`
+   /// \note Contracting the adjugates for the whole element at once saves
+   /// integrators from re-evaluating them for every pair and direction
+   /// \note The entries are recomputed on every call rather than cached per
+   /// element: they cost `dim` multiply-adds per pair and direction, far less
+   /// than the two-point flux evaluated for the same pair, and the flow
+   /// integrators have no hook that tells them when the mesh has moved
+   void getSkewEntries(const std::vector<DenseMatrix> &adjJ,
+                       DenseMatrix &S) const;
+
    /// Attempts to find the index corresponding to a given IntegrationPoint
    /// \param[in] ip - try to match the coordinates of this point
    /// \returns index - the index of the node corresponding to `ip`
@@ -199,6 +261,16 @@ protected:
    mutable std::vector<DenseMatrix> Q;
    /// generalized Vandermonde matrix; used for the projection operator in LPS
    mutable DenseMatrix V;
+   /// nonzero entries of the (untransposed) weak operators, ordered by row
+   std::vector<std::vector<OperatorEntry>> Q_nonzeros;
+   /// where each row starts in `Q_nonzeros`, with one extra entry at the end
+   std::vector<std::vector<int>> Q_row_begin;
+   /// node pairs with nonzero skew entries
+   std::vector<SkewPair> skew_pairs;
+
+   /// Builds `Q_nonzeros`, `Q_row_begin` and `skew_pairs` from `Q`
+   /// \note Must be called by derived constructors once `Q` is set
+   void buildSparseOperators();
 };
 
 // /// Class for summation-by-parts operator on interval
@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef MISO_USE_ZSTD
+#include "zstd.h"
+#endif
+
+#include "mfem.hpp"
+
+#include "utils.hpp"
+
+#include "time_history.hpp"
+
+namespace
+{
+/// first characters of every time-history file
+constexpr char magic[8] = {'M', 'I', 'S', 'O', 'H', 'I', 'S', 'T'};
+
+/// header of each stored state in the file
+struct RecordHeader
+{
+   std::uint64_t stored_bytes;
+   std::uint64_t size;
+   std::uint32_t codec;
+   std::uint32_t padding;
+   double time;
+};
+
+/// \return `offset` rounded up to a multiple of 8 bytes
+std::size_t align(std::size_t offset) { return (offset + 7) / 8 * 8; }
+
+/// \brief Write `bytes` bytes of `data` at `offset` in the file `fd`
+void writeAt(int fd,
+             const void *data,
+             std::size_t bytes,
+             std::size_t offset,
+             const std::string &filename)
+{
+   const auto *next = static_cast<const char *>(data);
+   while (bytes > 0)
+   {
+      const auto written = pwrite(fd, next, bytes, static_cast<off_t>(offset));
+      if (written < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+         throw miso::MISOException("TimeHistory: cannot write to \"" +
+                                   filename + "\"!\n");
+      }
+      next += written;
+      bytes -= written;
+      offset += written;
+   }
+}
+
+#ifdef MISO_USE_ZSTD
+/// zstd level; the fastest level keeps up with the time stepping
+constexpr int compression_level = 1;
+
+/// \brief Gather byte `b` of every value, for each `b` in turn
+/// \param[in] values - `size` doubles
+/// \param[in] size - number of values
+/// \param[out] shuffled - byte `b` of value `i` is put at `b * size + i`
+void shuffleBytes(const char *values, std::size_t size, char *shuffled)
+{
+   for (std::size_t i = 0; i < size; ++i)
+   {
+      for (std::size_t b = 0; b < sizeof(double); ++b)
+      {
+         shuffled[b * size + i] = values[i * sizeof(double) + b];
+      }
+   }
+}
+
+/// \brief Undo `shuffleBytes`
+void unshuffleBytes(const char *shuffled, std::size_t size, char *values)
+{
+   for (std::size_t i = 0; i < size; ++i)
+   {
+      for (std::size_t b = 0; b < sizeof(double); ++b)
+      {
+         values[i * sizeof(double) + b] = shuffled[b * size + i];
+      }
+   }
+}
+#endif
+
+/// \return binomial(s + t, s), the number of steps that can be reversed with
+/// `s` snapshots if no step is repeated more than `t` times, saturated at
+/// INT_MAX
+long long maxSteps(int s, int t)
+{
+   long long steps = 1;
+   for (int i = 1; i <= s; ++i)
+   {
+      steps = steps * (t + i) / i;
+      if (steps > INT_MAX)
+      {
+         return INT_MAX;
+      }
+   }
+   return steps;
+}
+
+/// \brief Schedule the reversal of the steps from `start` to `end`
+/// \param[in] start - first step to reverse, whose state is the current one
+/// and is stored in snapshot `slot`
+/// \param[in] end - one past the last step to reverse
+/// \param[in] slot - snapshot holding the state at `start`; the snapshots
+/// after it are free
+/// \param[in] num_snapshots - total number of snapshots
+/// \param[inout] actions - the schedule, which is appended to
+void reverseSteps(int start,
+                  int end,
+                  int slot,
+                  int num_snapshots,
+                  std::vector<miso::RevolveAction> &actions)
+{
+   using miso::RevolveAction;
+   while (end - start > 1)
+   {
+      const int snapshots = num_snapshots - slot;
+      if (snapshots == 1)
+      {
+         /// no free snapshots, so the last step is reached from `start`
+         actions.push_back({RevolveAction::advance, start, end - 1});
+         actions.push_back({RevolveAction::reverse, end - 1});
+         actions.push_back({RevolveAction::restore, start, -1, slot});
+         --end;
+         continue;
+      }
+
+      /// the right part can be reversed with one snapshot fewer, and the left
+      /// part, whose steps are advanced over once more, with one repetition
+      /// fewer
+      const int num_steps = end - start;
+      int repetitions = 0;
+      while (maxSteps(snapshots, repetitions) < num_steps)
+      {
+         ++repetitions;
+      }
+      const int right = static_cast<int>(
+          std::min<long long>(maxSteps(snapshots - 1, repetitions),
+                              num_steps - 1));
+      const int mid = end - right;
+      actions.push_back({RevolveAction::advance, start, mid});
+      actions.push_back({RevolveAction::store, mid, -1, slot + 1});
+      reverseSteps(mid, end, slot + 1, num_snapshots, actions);
+      actions.push_back({RevolveAction::restore, start, -1, slot});
+      end = mid;
+   }
+   actions.push_back({RevolveAction::reverse, start});
+}
+
+}  // namespace
+
+namespace miso
+{
+TimeHistory::TimeHistory(std::string filename,
+                         const std::string &compression,
+                         bool append)
+ : filename(std::move(filename)), compress(compression == "zstd")
+{
+   if (compression != "none" && compression != "zstd")
+   {
+      throw MISOException("TimeHistory: unknown compression \"" +
+                          compression + "\"!\n");
+   }
+#ifndef MISO_USE_ZSTD
+   if (compress)
+   {
+      throw MISOException(
+          "TimeHistory: \"zstd\" compression needs miso to be built with "
+          "MISO_USE_ZSTD!\n");
+   }
+#endif
+
+   const int flags = O_RDWR | O_CREAT | (append ? 0 : O_TRUNC);
+   fd = open(this->filename.c_str(), flags, 0644);
+   if (fd < 0)
+   {
+      throw MISOException("TimeHistory: cannot open \"" + this->filename +
+                          "\"!\n");
+   }
+   struct stat info = {};
+   fstat(fd, &info);
+   file_size = static_cast<std::size_t>(info.st_size);
+   if (file_size == 0)
+   {
+      writeAt(fd, magic, sizeof(magic), 0, this->filename);
+      file_size = sizeof(magic);
+   }
+   else
+   {
+      scan();
+   }
+}
+
+TimeHistory::~TimeHistory()
+{
+   if (map != nullptr)
+   {
+      munmap(const_cast<char *>(map), map_size);  // NOLINT
+   }
+   close(fd);
+}
+
+int TimeHistory::append(const mfem::Vector &state, double time)
+{
+   const auto size = static_cast<std::size_t>(state.Size());
+   const std::size_t raw_bytes = size * sizeof(double);
+   const auto *values = reinterpret_cast<const char *>(  // NOLINT
+       state.GetData());
+   RecordHeader header{raw_bytes, size, 0, 0, time};
+   const char *stored = values;
+#ifdef MISO_USE_ZSTD
+   if (compress)
+   {
+      shuffled.resize(raw_bytes);
+      shuffleBytes(values, size, shuffled.data());
+      packed.resize(ZSTD_compressBound(raw_bytes));
+      const auto packed_bytes = ZSTD_compress(packed.data(),
+                                              packed.size(),
+                                              shuffled.data(),
+                                              raw_bytes,
+                                              compression_level);
+      if (ZSTD_isError(packed_bytes) != 0U)
+      {
+         throw MISOException(std::string("TimeHistory: ") +
+                             ZSTD_getErrorName(packed_bytes) + "\n");
+      }
+      /// states that do not compress are stored raw
+      if (packed_bytes < raw_bytes)
+      {
+         header.stored_bytes = packed_bytes;
+         header.codec = 1;
+         stored = packed.data();
+      }
+   }
+#endif
+
+   const std::size_t offset = file_size + sizeof(RecordHeader);
+   const std::size_t end = offset + header.stored_bytes;
+   writeAt(fd, &header, sizeof(header), file_size, filename);
+   writeAt(fd, stored, header.stored_bytes, offset, filename);
+   /// records start at multiples of 8 bytes
+   const char zeros[8] = {};
+   writeAt(fd, zeros, align(end) - end, end, filename);
+   file_size = align(end);
+
+   records.push_back({offset, header.stored_bytes, size, header.codec, time});
+   return numSteps() - 1;
+}
+
+double TimeHistory::read(int step, mfem::Vector &state) const
+{
+   if (step < 0 || step >= numSteps())
+   {
+      throw MISOException("TimeHistory: step " + std::to_string(step) +
+                          " is not stored in \"" + filename + "\"!\n");
+   }
+   const auto &record = records[step];
+   remap();
+   state.SetSize(static_cast<int>(record.size));
+   auto *values = reinterpret_cast<char *>(state.GetData());  // NOLINT
+   const char *stored = map + record.offset;
+   if (record.codec == 0)
+   {
+      std::memcpy(values, stored, record.stored_bytes);
+      return record.time;
+   }
+#ifdef MISO_USE_ZSTD
+   shuffled.resize(record.size * sizeof(double));
+   const auto bytes = ZSTD_decompress(
+       shuffled.data(), shuffled.size(), stored, record.stored_bytes);
+   if (ZSTD_isError(bytes) != 0U || bytes != shuffled.size())
+   {
+      throw MISOException("TimeHistory: step " + std::to_string(step) +
+                          " of \"" + filename + "\" is corrupt!\n");
+   }
+   unshuffleBytes(shuffled.data(), record.size, values);
+   return record.time;
+#else
+   throw MISOException(
+       "TimeHistory: reading compressed states needs miso to be built with "
+       "MISO_USE_ZSTD!\n");
+#endif
+}
+
+void TimeHistory::scan()
+{
+   remap();
+   if (file_size < sizeof(magic) ||
+       std::memcmp(map, magic, sizeof(magic)) != 0)
+   {
+      throw MISOException("TimeHistory: \"" + filename +
+                          "\" is not a time history!\n");
+   }
+   std::size_t offset = sizeof(magic);
+   while (offset + sizeof(RecordHeader) <= file_size)
+   {
+      RecordHeader header{};
+      std::memcpy(&header, map + offset, sizeof(header));
+      const std::size_t data_offset = offset + sizeof(RecordHeader);
+      if (data_offset + header.stored_bytes > file_size)
+      {
+         break;
+      }
+      records.push_back({data_offset,
+                         header.stored_bytes,
+                         header.size,
+                         header.codec,
+                         header.time});
+      offset = align(data_offset + header.stored_bytes);
+   }
+   /// a state cut short, e.g. by a crash, is dropped and overwritten
+   if (offset < file_size)
+   {
+      munmap(const_cast<char *>(map), map_size);  // NOLINT
+      map = nullptr;
+      map_size = 0;
+      file_size = offset;
+      if (ftruncate(fd, static_cast<off_t>(file_size)) != 0)
+      {
+         throw MISOException("TimeHistory: cannot truncate \"" + filename +
+                             "\"!\n");
+      }
+   }
+}
+
+void TimeHistory::remap() const
+{
+   if (map_size >= file_size)
+   {
+      return;
+   }
+   if (map != nullptr)
+   {
+      munmap(const_cast<char *>(map), map_size);  // NOLINT
+   }
+   void *new_map = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+   if (new_map == MAP_FAILED)
+   {
+      map = nullptr;
+      map_size = 0;
+      throw MISOException("TimeHistory: cannot map \"" + filename + "\"!\n");
+   }
+   map = static_cast<const char *>(new_map);
+   map_size = file_size;
+}
+
+std::vector<RevolveAction> revolveSchedule(int num_steps, int num_snapshots)
+{
+   if (num_snapshots < 1)
+   {
+      throw MISOException(
+          "revolveSchedule: at least one snapshot is needed!\n");
+   }
+   std::vector<RevolveAction> actions;
+   if (num_steps < 1)
+   {
+      return actions;
+   }
+   actions.push_back({RevolveAction::store, 0, -1, 0});
+   reverseSteps(0, num_steps, 0, num_snapshots, actions);
+   return actions;
+}
+
+}  // namespace miso
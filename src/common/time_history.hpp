@@ -0,0 +1,135 @@
+#ifndef MISO_TIME_HISTORY
+#define MISO_TIME_HISTORY
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mfem.hpp"
+
+namespace miso
+{
+/// Stores a sequence of states in a file, read back through a memory map
+/// \note States are appended as records of a small header followed by their
+/// values; with "zstd" compression, which needs miso to be built with
+/// `MISO_USE_ZSTD`, the bytes of the values are first shuffled so that the
+/// sign, exponent and leading mantissa bytes of all values are adjacent,
+/// which makes smooth fields compress losslessly much better
+/// \note Each rank stores its own part of the states in its own file
+class TimeHistory
+{
+public:
+   /// \param[in] filename - the file to store the states in
+   /// \param[in] compression - "none", or "zstd" for shuffled and compressed
+   /// states
+   /// \param[in] append - if true, the states already in `filename` are kept
+   /// and new ones are appended after them; otherwise the file is truncated
+   TimeHistory(std::string filename,
+               const std::string &compression = "none",
+               bool append = false);
+
+   ~TimeHistory();
+
+   TimeHistory(const TimeHistory &) = delete;
+   TimeHistory &operator=(const TimeHistory &) = delete;
+
+   /// \brief Append `state` at `time` as the next step
+   /// \return the index of the step
+   int append(const mfem::Vector &state, double time);
+
+   /// \brief Read the state of step `step`
+   /// \param[in] step - index of the step, in [0, numSteps())
+   /// \param[out] state - the state, resized as needed
+   /// \return the time of the step
+   double read(int step, mfem::Vector &state) const;
+
+   /// \return the number of steps stored
+   int numSteps() const { return static_cast<int>(records.size()); }
+
+   /// \return the time of step `step`
+   double time(int step) const { return records.at(step).time; }
+
+   /// \return the number of bytes of the file, to compare with the
+   /// uncompressed size of the states
+   std::size_t storedBytes() const { return file_size; }
+
+private:
+   /// location and size of a stored state
+   struct Record
+   {
+      /// byte offset of the state's values in the file
+      std::size_t offset;
+      /// number of bytes stored
+      std::size_t stored_bytes;
+      /// number of values of the state
+      std::size_t size;
+      /// 0 for raw values, 1 for shuffled values compressed with zstd
+      std::uint32_t codec;
+      double time;
+   };
+
+   /// name of the file
+   std::string filename;
+   /// true if states are compressed
+   bool compress;
+   /// file descriptor of the open file
+   int fd = -1;
+   /// size of the file, which grows with each state
+   std::size_t file_size = 0;
+   /// the stored states, in order
+   std::vector<Record> records;
+   /// read-only map of the file, which is remapped when states are read
+   /// beyond its end
+   mutable const char *map = nullptr;
+   mutable std::size_t map_size = 0;
+   /// work space for shuffling and compressing
+   mutable std::vector<char> shuffled;
+   mutable std::vector<char> packed;
+
+   /// \brief Rebuild `records` from the states already in the file
+   void scan();
+
+   /// \brief Map the file if it has grown beyond the current map
+   void remap() const;
+};
+
+/// An action of a binomial checkpointing schedule for reversing time steps
+struct RevolveAction
+{
+   enum Type
+   {
+      /// take the forward steps from `step` to `to` without recording them
+      advance,
+      /// store the current state, at `step`, in snapshot `slot`
+      store,
+      /// restore the state at `step` from snapshot `slot`
+      restore,
+      /// take the forward step from `step`, recording what its adjoint needs,
+      /// and then the adjoint step back to `step`
+      reverse
+   };
+   Type type;
+   int step;
+   /// end of an `advance`; unused otherwise
+   int to = -1;
+   /// snapshot of a `store` or `restore`; unused otherwise
+   int slot = -1;
+};
+
+/// \brief Schedule the reversal of `num_steps` time steps with at most
+/// `num_snapshots` stored states, following the binomial checkpointing of
+/// Griewank and Walther's revolve
+/// \param[in] num_steps - number of forward time steps to reverse
+/// \param[in] num_snapshots - number of states that may be stored at once,
+/// including the initial state, which the schedule stores first in slot 0
+/// \return the actions, in order; the `reverse` actions visit the steps from
+/// `num_steps - 1` down to 0
+/// \note Fewer snapshots trade memory for recomputation: with `s` snapshots
+/// no step is taken forward more than `t + 1` times, where `t` is the
+/// smallest number with binomial(s + t, s) >= `num_steps`
+std::vector<RevolveAction> revolveSchedule(int num_steps, int num_snapshots);
+
+}  // namespace miso
+
+#endif
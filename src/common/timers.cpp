@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "utils.hpp"
+#include "timers.hpp"
+
+namespace
+{
+/// Takes the integrators out of a linear form, and gives them back when it
+/// goes out of scope, even if assembly throws
+class LinearFormIntegratorsGuard
+{
+public:
+   explicit LinearFormIntegratorsGuard(mfem::ParLinearForm &form) : form(form)
+   {
+      swapAll();
+   }
+   ~LinearFormIntegratorsGuard()
+   {
+      /// drop any integrator lent back to the form before restoring
+      form.GetDLFI()->SetSize(0);
+      form.GetDLFI_Marker()->SetSize(0);
+      form.GetBLFI()->SetSize(0);
+      form.GetBLFI_Marker()->SetSize(0);
+      form.GetFLFI()->SetSize(0);
+      form.GetFLFI_Marker()->SetSize(0);
+      form.GetIFLFI()->SetSize(0);
+      form.GetDLFI_Delta()->SetSize(0);
+      swapAll();
+   }
+
+   LinearFormIntegratorsGuard(const LinearFormIntegratorsGuard &) = delete;
+   LinearFormIntegratorsGuard &operator=(const LinearFormIntegratorsGuard &) =
+       delete;
+
+   mfem::Array<mfem::LinearFormIntegrator *> domain, bdr, bdr_face,
+       interior_face;
+   mfem::Array<mfem::Array<int> *> domain_marker, bdr_marker, bdr_face_marker;
+   mfem::Array<mfem::DeltaLFIntegrator *> delta;
+
+private:
+   mfem::ParLinearForm &form;
+
+   void swapAll()
+   {
+      mfem::Swap(domain, *form.GetDLFI());
+      mfem::Swap(domain_marker, *form.GetDLFI_Marker());
+      mfem::Swap(bdr, *form.GetBLFI());
+      mfem::Swap(bdr_marker, *form.GetBLFI_Marker());
+      mfem::Swap(bdr_face, *form.GetFLFI());
+      mfem::Swap(bdr_face_marker, *form.GetFLFI_Marker());
+      mfem::Swap(interior_face, *form.GetIFLFI());
+      mfem::Swap(delta, *form.GetDLFI_Delta());
+   }
+};
+
+/// \brief Assemble `form` with only the integrator `integs[i]`, and add the
+/// result to `total`
+/// \param[inout] form - linear form whose integrator lists are all empty
+/// \param[in] integs - integrators of the form's list `form_integs`
+/// \param[in] markers - attribute markers of `integs`, or nullptr if the list
+/// has none
+/// \param[inout] form_integs - the form's (empty) list `integs` belongs in
+/// \param[inout] form_markers - the form's (empty) list `markers` belongs in
+/// \param[in] i - index of the integrator to assemble
+/// \param[inout] total - sum of the integrators assembled so far
+template <typename Integ>
+void assembleOne(mfem::ParLinearForm &form,
+                 const mfem::Array<Integ *> &integs,
+                 const mfem::Array<mfem::Array<int> *> *markers,
+                 mfem::Array<Integ *> &form_integs,
+                 mfem::Array<mfem::Array<int> *> *form_markers,
+                 int i,
+                 mfem::Vector &total)
+{
+   form_integs.Append(integs[i]);
+   if (markers != nullptr)
+   {
+      form_markers->Append((*markers)[i]);
+   }
+   {
+      const auto *integ = integs[i];
+      miso::ScopedTimer timer(miso::readableTypeName(typeid(*integ).name()));
+      form.Assemble();
+   }
+   total += form;
+   form_integs.SetSize(0);
+   if (form_markers != nullptr)
+   {
+      form_markers->SetSize(0);
+   }
+}
+
+}  // anonymous namespace
+
+namespace miso
+{
+void TimerRegistry::start(const std::string &name)
+{
+   running.emplace_back(path(name), MPI_Wtime());
+}
+
+void TimerRegistry::stop()
+{
+   if (running.empty())
+   {
+      throw MISOException("TimerRegistry::stop: no timer is running!\n");
+   }
+   auto &timer = timers[running.back().first];
+   timer.time += MPI_Wtime() - running.back().second;
+   ++timer.calls;
+   running.pop_back();
+}
+
+void TimerRegistry::count(const std::string &name, long count)
+{
+   counters[path(name)] += count;
+}
+
+void TimerRegistry::reset()
+{
+   timers.clear();
+   counters.clear();
+}
+
+nlohmann::json TimerRegistry::local() const
+{
+   nlohmann::json local_timers = nlohmann::json::object();
+   for (const auto &[path, timer] : timers)
+   {
+      local_timers[path] = {{"time", timer.time}, {"calls", timer.calls}};
+   }
+   nlohmann::json local_counters = nlohmann::json::object();
+   for (const auto &[path, count] : counters)
+   {
+      local_counters[path] = count;
+   }
+   return {{"timers", local_timers}, {"counters", local_counters}};
+}
+
+nlohmann::json TimerRegistry::reduce(MPI_Comm comm) const
+{
+   int rank = 0;
+   int num_ranks = 1;
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &num_ranks);
+
+   /// ranks may know different timers, so gather everything on the root
+   const auto local_str = local().dump();
+   int local_size = static_cast<int>(local_str.size());
+   std::vector<int> sizes(num_ranks);
+   MPI_Gather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, comm);
+   std::vector<int> offsets(num_ranks, 0);
+   for (int i = 1; i < num_ranks; ++i)
+   {
+      offsets[i] = offsets[i - 1] + sizes[i - 1];
+   }
+   std::vector<char> all(rank == 0 ? offsets.back() + sizes.back() : 0);
+   MPI_Gatherv(local_str.data(),
+               local_size,
+               MPI_CHAR,
+               all.data(),
+               sizes.data(),
+               offsets.data(),
+               MPI_CHAR,
+               0,
+               comm);
+
+   std::string reduced_str;
+   if (rank == 0)
+   {
+      nlohmann::json reduced_timers = nlohmann::json::object();
+      nlohmann::json reduced_counters = nlohmann::json::object();
+      for (int i = 0; i < num_ranks; ++i)
+      {
+         auto rank_data = nlohmann::json::parse(
+             all.begin() + offsets[i], all.begin() + offsets[i] + sizes[i]);
+         for (const auto &[path, timer] : rank_data["timers"].items())
+         {
+            auto &reduced = reduced_timers[path];
+            const auto time = timer["time"].get<double>();
+            const auto calls = timer["calls"].get<long>();
+            if (reduced.is_null())
+            {
+               reduced = {{"calls", 0L},
+                          {"min", time},
+                          {"max", time},
+                          {"mean", 0.0},
+                          {"ranks", 0}};
+            }
+            reduced["calls"] = std::max(reduced["calls"].get<long>(), calls);
+            reduced["min"] = std::min(reduced["min"].get<double>(), time);
+            reduced["max"] = std::max(reduced["max"].get<double>(), time);
+            reduced["mean"] = reduced["mean"].get<double>() + time;
+            reduced["ranks"] = reduced["ranks"].get<int>() + 1;
+         }
+         for (const auto &[path, count] : rank_data["counters"].items())
+         {
+            auto &reduced = reduced_counters[path];
+            const auto value = count.get<long>();
+            if (reduced.is_null())
+            {
+               reduced = {{"min", value}, {"max", value}, {"sum", 0L},
+                          {"ranks", 0}};
+            }
+            reduced["min"] = std::min(reduced["min"].get<long>(), value);
+            reduced["max"] = std::max(reduced["max"].get<long>(), value);
+            reduced["sum"] = reduced["sum"].get<long>() + value;
+            reduced["ranks"] = reduced["ranks"].get<int>() + 1;
+         }
+      }
+
+      /// ranks that never used a timer or counter contribute zero to it
+      for (auto &[path, timer] : reduced_timers.items())
+      {
+         if (timer["ranks"].get<int>() < num_ranks)
+         {
+            timer["min"] = 0.0;
+         }
+         timer["mean"] = timer["mean"].get<double>() / num_ranks;
+         timer.erase("ranks");
+      }
+      for (auto &[path, count] : reduced_counters.items())
+      {
+         if (count["ranks"].get<int>() < num_ranks)
+         {
+            count["min"] = 0L;
+         }
+         count.erase("ranks");
+      }
+      nlohmann::json reduced{{"ranks", num_ranks},
+                             {"timers", reduced_timers},
+                             {"counters", reduced_counters}};
+      reduced_str = reduced.dump();
+   }
+
+   int reduced_size = static_cast<int>(reduced_str.size());
+   MPI_Bcast(&reduced_size, 1, MPI_INT, 0, comm);
+   reduced_str.resize(reduced_size);
+   MPI_Bcast(reduced_str.data(), reduced_size, MPI_CHAR, 0, comm);
+   return nlohmann::json::parse(reduced_str);
+}
+
+std::string TimerRegistry::path(const std::string &name) const
+{
+   if (running.empty())
+   {
+      return name;
+   }
+   return running.back().first + "/" + name;
+}
+
+TimerRegistry &timers()
+{
+   static TimerRegistry registry;
+   return registry;
+}
+
+std::string readableTypeName(const char *name)
+{
+   std::string readable = name;
+#ifdef __GNUG__
+   int status = 0;
+   char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+   if (status == 0 && demangled != nullptr)
+   {
+      readable = demangled;
+   }
+   std::free(demangled);
+#endif
+   /// drop namespace qualifiers outside of template arguments
+   const auto template_start = readable.find('<');
+   const auto qualifier = readable.rfind("::", template_start);
+   if (qualifier != std::string::npos)
+   {
+      readable = readable.substr(qualifier + 2);
+   }
+   return readable;
+}
+
+void assembleTimed(mfem::ParLinearForm &form)
+{
+   mfem::Vector total(form.Size());
+   total = 0.0;
+   {
+      LinearFormIntegratorsGuard saved(form);
+      for (int i = 0; i < saved.domain.Size(); ++i)
+      {
+         assembleOne(form,
+                     saved.domain,
+                     &saved.domain_marker,
+                     *form.GetDLFI(),
+                     form.GetDLFI_Marker(),
+                     i,
+                     total);
+      }
+      for (int i = 0; i < saved.delta.Size(); ++i)
+      {
+         assembleOne(form,
+                     saved.delta,
+                     nullptr,
+                     *form.GetDLFI_Delta(),
+                     nullptr,
+                     i,
+                     total);
+      }
+      for (int i = 0; i < saved.bdr.Size(); ++i)
+      {
+         assembleOne(form,
+                     saved.bdr,
+                     &saved.bdr_marker,
+                     *form.GetBLFI(),
+                     form.GetBLFI_Marker(),
+                     i,
+                     total);
+      }
+      for (int i = 0; i < saved.bdr_face.Size(); ++i)
+      {
+         assembleOne(form,
+                     saved.bdr_face,
+                     &saved.bdr_face_marker,
+                     *form.GetFLFI(),
+                     form.GetFLFI_Marker(),
+                     i,
+                     total);
+      }
+      for (int i = 0; i < saved.interior_face.Size(); ++i)
+      {
+         assembleOne(form,
+                     saved.interior_face,
+                     nullptr,
+                     *form.GetIFLFI(),
+                     nullptr,
+                     i,
+                     total);
+      }
+   }
+   static_cast<mfem::Vector &>(form) = total;
+}
+
+}  // namespace miso
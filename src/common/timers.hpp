@@ -0,0 +1,102 @@
+#ifndef MISO_TIMERS
+#define MISO_TIMERS
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+namespace miso
+{
+/// Registry of nested wall-clock timers and event counters
+/// \note Timers started while another timer runs are nested under it, and are
+/// identified by their path, e.g. "solveForState/evaluate"
+/// \note The registry is not thread safe, so it must only be used from the
+/// thread that drives the solver, and not from inside threaded assembly loops
+class TimerRegistry
+{
+public:
+   /// \brief Start the timer `name`, nested under the running timers
+   void start(const std::string &name);
+
+   /// \brief Stop the most recently started timer
+   void stop();
+
+   /// \brief Add `count` to the counter `name`, nested under the running
+   /// timers
+   void count(const std::string &name, long count = 1);
+
+   /// \brief Clear all timers and counters that are not running
+   void reset();
+
+   /// \return this rank's timers and counters, as
+   /// {"timers": {path: {"time", "calls"}}, "counters": {path: count}}
+   nlohmann::json local() const;
+
+   /// \brief Reduce the timers and counters over the ranks of `comm`
+   /// \return {"ranks", "timers": {path: {"calls", "min", "max", "mean"}},
+   /// "counters": {path: {"min", "max", "sum"}}}, the same on every rank
+   /// \note Collective on `comm`; a timer or counter missing on some ranks is
+   /// counted as zero there
+   nlohmann::json reduce(MPI_Comm comm) const;
+
+private:
+   struct Timer
+   {
+      double time = 0.0;
+      long calls = 0;
+   };
+   /// accumulated time and number of calls of each timer path
+   std::map<std::string, Timer> timers;
+   /// accumulated count of each counter path
+   std::map<std::string, long> counters;
+   /// paths and start times of the running timers, innermost last
+   std::vector<std::pair<std::string, double>> running;
+
+   /// \return the path of `name` nested under the running timers
+   std::string path(const std::string &name) const;
+};
+
+/// \return the registry shared by everything in miso
+TimerRegistry &timers();
+
+/// Times its own lifetime, or until `stop` is called, with the timer `name`
+/// of `timers()`
+class ScopedTimer
+{
+public:
+   explicit ScopedTimer(const std::string &name) { timers().start(name); }
+   ~ScopedTimer() { stop(); }
+
+   ScopedTimer(const ScopedTimer &) = delete;
+   ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+   /// \brief Stop the timer before the end of its scope
+   void stop()
+   {
+      if (running)
+      {
+         timers().stop();
+         running = false;
+      }
+   }
+
+private:
+   /// true until the timer is stopped
+   bool running = true;
+};
+
+/// \return a readable name for the type with `std::type_info` name `name`,
+/// without its namespace qualifiers
+std::string readableTypeName(const char *name);
+
+/// \brief Assemble `form`, timing each of its integrators under its type name
+/// \note Each integrator is assembled by its own pass over the mesh, so the
+/// timers record one call per integrator per assembly
+void assembleTimed(mfem::ParLinearForm &form);
+
+}  // namespace miso
+
+#endif
@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "finite_element_vector.hpp"
+#include "utils.hpp"
+
+#include "checkpoint.hpp"
+
+namespace
+{
+/// first characters of every checkpoint file
+constexpr char magic[8] = {'M', 'I', 'S', 'O', 'C', 'K', 'P', 'T'};
+/// bytes taken by the magic characters, header size and data offset
+constexpr std::size_t preamble_size = sizeof(magic) + 2 * sizeof(std::uint64_t);
+
+/// \return `offset` rounded up to a multiple of 8 bytes, so that the blocks
+/// of doubles are aligned in the memory-mapped file
+std::size_t align(std::size_t offset) { return (offset + 7) / 8 * 8; }
+
+/// \return the number of values in each element of `fes`
+/// \note Collective on the communicator of `fes`; throws unless every element
+/// has the same number of values
+int elementSize(const mfem::ParFiniteElementSpace &fes)
+{
+   int min_size = std::numeric_limits<int>::max();
+   int max_size = 0;
+   mfem::Array<int> vdofs;
+   for (int e = 0; e < fes.GetNE(); ++e)
+   {
+      fes.GetElementVDofs(e, vdofs);
+      min_size = std::min(min_size, vdofs.Size());
+      max_size = std::max(max_size, vdofs.Size());
+   }
+   auto comm = fes.GetComm();
+   MPI_Allreduce(MPI_IN_PLACE, &min_size, 1, MPI_INT, MPI_MIN, comm);
+   MPI_Allreduce(MPI_IN_PLACE, &max_size, 1, MPI_INT, MPI_MAX, comm);
+   if (min_size != max_size)
+   {
+      throw miso::MISOException(
+          "writeCheckpoint: every element must have the same number of "
+          "dofs!\n");
+   }
+   return max_size;
+}
+
+/// \brief Collectively write `block_size` values of `type` for each of this
+/// rank's elements, at the positions given by their serial indices
+/// \param[in] file - the open checkpoint file
+/// \param[in] offset - byte offset of the values of the first serial element
+/// \param[in] global_elements - serial index of each of this rank's elements,
+/// in increasing order
+/// \param[in] block_size - number of values in each element
+/// \param[in] type - MPI type of the values
+/// \param[in] values - the values of this rank's elements, element by element
+void writeElementBlocks(MPI_File file,
+                        MPI_Offset offset,
+                        const std::vector<int> &global_elements,
+                        int block_size,
+                        MPI_Datatype type,
+                        const void *values)
+{
+   const int num_elements = static_cast<int>(global_elements.size());
+   MPI_Datatype block;
+   MPI_Type_contiguous(block_size, type, &block);
+   MPI_Type_commit(&block);
+   MPI_Datatype view;
+   MPI_Type_create_indexed_block(
+       num_elements, 1, global_elements.data(), block, &view);
+   MPI_Type_commit(&view);
+
+   MPI_File_set_view(file, offset, type, view, "native", MPI_INFO_NULL);
+   MPI_File_write_all(
+       file, values, num_elements * block_size, type, MPI_STATUS_IGNORE);
+
+   MPI_Type_free(&view);
+   MPI_Type_free(&block);
+}
+
+}  // namespace
+
+namespace miso
+{
+void writeCheckpoint(const std::string &filename,
+                     mfem::ParMesh &mesh,
+                     const std::vector<int> &global_elements,
+                     const std::map<std::string, const FiniteElementVector *>
+                         &vectors,
+                     const nlohmann::json &metadata)
+{
+   auto comm = mesh.GetComm();
+   int rank = 0;
+   int num_ranks = 1;
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &num_ranks);
+
+   const int num_elements = mesh.GetNE();
+   if (static_cast<int>(global_elements.size()) != num_elements)
+   {
+      throw MISOException(
+          "writeCheckpoint: the serial index of each element is unknown!\n");
+   }
+   const auto global_num_elements =
+       static_cast<std::size_t>(mesh.GetGlobalNE());
+
+   /// the layout is computed on every rank, so that each knows where to write
+   std::vector<int> element_counts(num_ranks);
+   MPI_Allgather(&num_elements,
+                 1,
+                 MPI_INT,
+                 element_counts.data(),
+                 1,
+                 MPI_INT,
+                 comm);
+   nlohmann::json header{{"version", 1},
+                         {"metadata", metadata},
+                         {"elements", global_num_elements},
+                         {"partition",
+                          {{"ranks", num_ranks},
+                           {"elements", element_counts},
+                           {"offset", 0}}},
+                         {"vectors", nlohmann::json::object()}};
+   std::size_t offset = align(sizeof(int) * global_num_elements);
+   std::vector<int> element_sizes;
+   for (const auto &[name, vector] : vectors)
+   {
+      const auto &fes = vector->space();
+      element_sizes.push_back(elementSize(fes));
+
+      long long true_size = fes.GetTrueVSize();
+      std::vector<long long> true_offsets(num_ranks + 1, 0);
+      MPI_Allgather(&true_size,
+                    1,
+                    MPI_LONG_LONG,
+                    true_offsets.data() + 1,
+                    1,
+                    MPI_LONG_LONG,
+                    comm);
+      for (int i = 0; i < num_ranks; ++i)
+      {
+         true_offsets[i + 1] += true_offsets[i];
+      }
+
+      header["vectors"][name] = {{"offset", offset},
+                                 {"element-size", element_sizes.back()},
+                                 {"collection", fes.FEColl()->Name()},
+                                 {"vdim", fes.GetVDim()},
+                                 {"true-dof-offsets", true_offsets}};
+      offset += align(sizeof(double) * element_sizes.back() *
+                      global_num_elements);
+   }
+   const auto header_str = header.dump();
+   const std::size_t data_offset = align(preamble_size + header_str.size());
+
+   MPI_File file;
+   if (MPI_File_open(comm,
+                     filename.c_str(),
+                     MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                     MPI_INFO_NULL,
+                     &file) != MPI_SUCCESS)
+   {
+      throw MISOException("writeCheckpoint: cannot open \"" + filename +
+                          "\"!\n");
+   }
+   MPI_File_set_size(file, static_cast<MPI_Offset>(data_offset + offset));
+
+   if (rank == 0)
+   {
+      std::vector<char> preamble(data_offset, 0);
+      const std::uint64_t sizes[2] = {header_str.size(), data_offset};
+      std::memcpy(preamble.data(), magic, sizeof(magic));
+      std::memcpy(preamble.data() + sizeof(magic), sizes, sizeof(sizes));
+      std::memcpy(preamble.data() + preamble_size,
+                  header_str.data(),
+                  header_str.size());
+      MPI_File_write_at(file,
+                        0,
+                        preamble.data(),
+                        static_cast<int>(preamble.size()),
+                        MPI_CHAR,
+                        MPI_STATUS_IGNORE);
+   }
+
+   /// the rank of each element is the partition metadata
+   std::vector<int> ranks(num_elements, rank);
+   writeElementBlocks(
+       file, data_offset, global_elements, 1, MPI_INT, ranks.data());
+
+   /// the values of shared dofs are made consistent over the ranks before
+   /// they are gathered element by element
+   mfem::Array<int> vdofs;
+   mfem::Vector elvec;
+   int i = 0;
+   for (const auto &[name, vector] : vectors)
+   {
+      const auto &fes = vector->space();
+      const int element_size = element_sizes[i++];
+      mfem::Vector true_vec(fes.GetTrueVSize());
+      vector->setTrueVec(true_vec);
+      mfem::Vector local(fes.GetVSize());
+      fes.GetProlongationMatrix()->Mult(true_vec, local);
+
+      mfem::Vector values(num_elements * element_size);
+      for (int e = 0; e < num_elements; ++e)
+      {
+         fes.GetElementVDofs(e, vdofs);
+         local.GetSubVector(vdofs, elvec);
+         std::copy(
+             elvec.begin(), elvec.end(), values.begin() + e * element_size);
+      }
+      const auto vector_offset =
+          header["vectors"][name]["offset"].get<std::size_t>();
+      writeElementBlocks(file,
+                         static_cast<MPI_Offset>(data_offset + vector_offset),
+                         global_elements,
+                         element_size,
+                         MPI_DOUBLE,
+                         values.GetData());
+   }
+   MPI_File_close(&file);
+}
+
+CheckpointReader::CheckpointReader(const std::string &filename)
+ : filename(filename)
+{
+   const int fd = open(filename.c_str(), O_RDONLY);
+   if (fd < 0)
+   {
+      throw MISOException("CheckpointReader: cannot open \"" + filename +
+                          "\"!\n");
+   }
+   struct stat info = {};
+   const bool sized = fstat(fd, &info) == 0 &&
+                      static_cast<std::size_t>(info.st_size) >= preamble_size;
+   void *map = MAP_FAILED;
+   if (sized)
+   {
+      size = static_cast<std::size_t>(info.st_size);
+      map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+   }
+   /// the mapping outlives the file descriptor
+   close(fd);
+   if (map == MAP_FAILED)
+   {
+      throw MISOException("CheckpointReader: cannot map \"" + filename +
+                          "\"!\n");
+   }
+   data = static_cast<const char *>(map);
+
+   std::uint64_t sizes[2] = {0, 0};
+   std::memcpy(sizes, data + sizeof(magic), sizeof(sizes));
+   if (std::memcmp(data, magic, sizeof(magic)) != 0 ||
+       preamble_size + sizes[0] > size || sizes[1] > size)
+   {
+      munmap(const_cast<char *>(data), size);  // NOLINT
+      throw MISOException("CheckpointReader: \"" + filename +
+                          "\" is not a checkpoint!\n");
+   }
+   header = nlohmann::json::parse(data + preamble_size,
+                                  data + preamble_size + sizes[0]);
+   data_offset = sizes[1];
+}
+
+CheckpointReader::~CheckpointReader()
+{
+   munmap(const_cast<char *>(data), size);  // NOLINT
+}
+
+std::vector<int> CheckpointReader::partitioning() const
+{
+   const auto num_elements = header["elements"].get<std::size_t>();
+   const auto offset = header["partition"]["offset"].get<std::size_t>();
+   std::vector<int> ranks(num_elements);
+   std::memcpy(ranks.data(),
+               data + data_offset + offset,
+               sizeof(int) * num_elements);
+   return ranks;
+}
+
+void CheckpointReader::read(const std::string &name,
+                            const std::vector<int> &global_elements,
+                            FiniteElementVector &vector) const
+{
+   if (!contains(name))
+   {
+      throw MISOException("CheckpointReader: \"" + filename +
+                          "\" has no vector \"" + name + "\"!\n");
+   }
+   const auto &layout = header["vectors"][name];
+   const auto element_size = layout["element-size"].get<int>();
+   const auto num_elements = header["elements"].get<std::size_t>();
+   auto &fes = vector.space();
+   if (layout["vdim"].get<int>() != fes.GetVDim() ||
+       layout["collection"].get<std::string>() != fes.FEColl()->Name() ||
+       static_cast<int>(global_elements.size()) != fes.GetNE())
+   {
+      throw MISOException("CheckpointReader: the space of \"" + name +
+                          "\" does not match the one it was written with!\n");
+   }
+
+   /// only the pages of this rank's elements are touched
+   const char *values =
+       data + data_offset + layout["offset"].get<std::size_t>();
+   mfem::Vector local(fes.GetVSize());
+   mfem::Array<int> vdofs;
+   mfem::Vector elvec(element_size);
+   for (int e = 0; e < fes.GetNE(); ++e)
+   {
+      fes.GetElementVDofs(e, vdofs);
+      const auto global_element = static_cast<std::size_t>(global_elements[e]);
+      if (vdofs.Size() != element_size || global_element >= num_elements)
+      {
+         throw MISOException("CheckpointReader: the mesh of \"" + name +
+                             "\" does not match the one it was written "
+                             "with!\n");
+      }
+      std::memcpy(elvec.GetData(),
+                  values + sizeof(double) * element_size * global_element,
+                  sizeof(double) * element_size);
+      local.SetSubVector(vdofs, elvec);
+   }
+
+   mfem::Vector true_vec(fes.GetTrueVSize());
+   fes.GetRestrictionOperator()->Mult(local, true_vec);
+   vector.distributeSharedDofs(true_vec);
+}
+
+}  // namespace miso
@@ -0,0 +1,93 @@
+#ifndef MISO_CHECKPOINT
+#define MISO_CHECKPOINT
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "finite_element_vector.hpp"
+
+namespace miso
+{
+/// \brief Collectively write finite element vectors to one checkpoint file
+/// \param[in] filename - the checkpoint file, which is overwritten
+/// \param[in] mesh - the mesh the vectors are defined on
+/// \param[in] global_elements - index in the serial mesh of each of this
+/// rank's elements, in increasing order
+/// \param[in] vectors - the vectors to write, by name
+/// \param[in] metadata - written to the file's header, e.g. the time
+/// \note Each vector is stored element by element, in the order of the
+/// serial mesh, with the values of its shared dofs repeated in every element
+/// that has them; this makes the file independent of the partitioning, so it
+/// can be read back on any number of ranks
+/// \note The file starts with the characters "MISOCKPT", the size of its JSON
+/// header and the byte offset of its data, as 64-bit integers; the header
+/// holds `metadata`, the layout of each vector (with its global true-dof
+/// offsets), and the partitioning of the elements over the ranks
+void writeCheckpoint(const std::string &filename,
+                     mfem::ParMesh &mesh,
+                     const std::vector<int> &global_elements,
+                     const std::map<std::string, const FiniteElementVector *>
+                         &vectors,
+                     const nlohmann::json &metadata = {});
+
+/// Reads checkpoints written by `writeCheckpoint`
+/// \note The file is memory mapped, and only the header is parsed when it is
+/// opened; each rank only touches the pages of its own elements when it
+/// reads a vector
+class CheckpointReader
+{
+public:
+   /// \param[in] filename - the checkpoint file
+   explicit CheckpointReader(const std::string &filename);
+
+   ~CheckpointReader();
+
+   CheckpointReader(const CheckpointReader &) = delete;
+   CheckpointReader &operator=(const CheckpointReader &) = delete;
+
+   /// \return the metadata given to `writeCheckpoint`
+   const nlohmann::json &metadata() const { return header["metadata"]; }
+
+   /// \return true if the checkpoint holds a vector named `name`
+   bool contains(const std::string &name) const
+   {
+      return header["vectors"].contains(name);
+   }
+
+   /// \return the number of ranks that wrote the checkpoint
+   int numRanks() const { return header["partition"]["ranks"].get<int>(); }
+
+   /// \return the rank that owned each element of the serial mesh when the
+   /// checkpoint was written, e.g. to restart on the same partitioning
+   std::vector<int> partitioning() const;
+
+   /// \brief Set `vector` from the vector named `name` in the checkpoint
+   /// \param[in] name - name of the vector in the checkpoint
+   /// \param[in] global_elements - index in the serial mesh of each of this
+   /// rank's elements
+   /// \param[inout] vector - the vector to set, which must use the same
+   /// finite element space as the one written
+   void read(const std::string &name,
+             const std::vector<int> &global_elements,
+             FiniteElementVector &vector) const;
+
+private:
+   /// name of the checkpoint file
+   std::string filename;
+   /// the memory-mapped file
+   const char *data = nullptr;
+   std::size_t size = 0;
+   /// the file's JSON header
+   nlohmann::json header;
+   /// byte offset of the vectors' data in the file
+   std::size_t data_offset = 0;
+};
+
+}  // namespace miso
+
+#endif
@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <variant>
 
 #include "miso_load.hpp"
 #include "mfem.hpp"
@@ -13,8 +17,109 @@
 // Needed for IEAgg when considering demagnetization
 #include "demag_flux_coefficient.hpp"
 
+namespace
+{
+/// \brief Evaluate the numerator and denominator of an induced exponential
+/// aggregate at `inputs`, unless they are cached for the same inputs
+/// \param[in] integ - numerator integrator, which sums both in one sweep
+/// \param[in] state - the field that is aggregated
+/// \param[in] attr_marker - elements to sweep over; empty for all elements
+/// \param[inout] numerator - numerator output, given the inputs and shift
+/// \param[inout] denominator - denominator output, given the inputs and shift
+/// \param[in] inputs - the inputs to evaluate at
+/// \param[inout] cache - the cached sums and the inputs they were evaluated at
+/// \note The sums are shifted by the largest aggregated value over all ranks,
+/// which cancels in their ratio and in its derivatives; the shift is passed on
+/// to `numerator` and `denominator` as "true_max" so their sweeps agree
+template <typename NumeratorIntegrator>
+void updateIEAggregate(NumeratorIntegrator &integ,
+                       mfem::ParGridFunction &state,
+                       const mfem::Array<int> &attr_marker,
+                       miso::FunctionalOutput &numerator,
+                       miso::FunctionalOutput &denominator,
+                       const miso::MISOInputs &inputs,
+                       miso::IEAggregateCache &cache)
+{
+   miso::updateCachedInputs(inputs, cache);
+   if (cache.valid)
+   {
+      return;
+   }
+   setInputs(numerator, inputs);
+   setInputs(denominator, inputs);
+
+   auto &fes = *state.ParFESpace();
+   double max = std::numeric_limits<double>::lowest();
+   double sums[2] = {0.0, 0.0};
+   mfem::Array<int> vdofs;
+   mfem::Vector elfun;
+   for (int e = 0; e < fes.GetNE(); ++e)
+   {
+      if (attr_marker.Size() > 0 && attr_marker[fes.GetAttribute(e) - 1] == 0)
+      {
+         continue;
+      }
+      const auto &el = *fes.GetFE(e);
+      auto &trans = *fes.GetElementTransformation(e);
+      auto *dof_tr = fes.GetElementVDofs(e, vdofs);
+      state.GetSubVector(vdofs, elfun);
+      if (dof_tr != nullptr)
+      {
+         dof_tr->InvTransformPrimal(elfun);
+      }
+      integ.AddElementEnergies(el, trans, elfun, max, sums[0], sums[1]);
+   }
+
+   /// shift every rank's sums by the global maximum before adding them
+   double true_max = max;
+   MPI_Allreduce(&max, &true_max, 1, MPI_DOUBLE, MPI_MAX, fes.GetComm());
+   const double scale = integ.shiftScale(max, true_max);
+   sums[0] *= scale;
+   sums[1] *= scale;
+   MPI_Allreduce(MPI_IN_PLACE, sums, 2, MPI_DOUBLE, MPI_SUM, fes.GetComm());
+
+   cache.num = sums[0];
+   cache.denom = sums[1];
+   cache.valid = true;
+
+   const miso::MISOInputs shift{{"true_max", true_max}};
+   setInputs(numerator, shift);
+   setInputs(denominator, shift);
+}
+
+}  // namespace
+
 namespace miso
 {
+void updateCachedInputs(const MISOInputs &inputs, IEAggregateCache &cache)
+{
+   for (const auto &[name, input] : inputs)
+   {
+      if (std::holds_alternative<double>(input))
+      {
+         const double value = std::get<double>(input);
+         auto cached = cache.scalars.find(name);
+         if (cached != cache.scalars.end() && cached->second == value)
+         {
+            continue;
+         }
+         cache.scalars[name] = value;
+         cache.valid = false;
+         continue;
+      }
+      const auto &vec = std::get<InputVector>(input);
+      auto &copy = cache.inputs[name];
+      if (copy.Size() == vec.size &&
+          std::equal(vec.data, vec.data + vec.size, copy.GetData()))
+      {
+         continue;
+      }
+      copy.SetSize(vec.size);
+      copy = vec.data;
+      cache.valid = false;
+   }
+}
+
 VolumeFunctional::VolumeFunctional(
     std::map<std::string, FiniteElementState> &fields,
     const nlohmann::json &options)
@@ -144,24 +249,41 @@ AverageMagnitudeCurlState::AverageMagnitudeCurlState(
    }
 }
 
+double calcOutput(IEAggregateFunctional &output, const MISOInputs &inputs)
+{
+   updateIEAggregate(*output.fused_integ,
+                     *output.state,
+                     output.attr_marker,
+                     output.numerator,
+                     output.denominator,
+                     inputs,
+                     output.cache);
+   return output.cache.num / output.cache.denom;
+}
+
+void setOptions(IEAggregateFunctional &output, const nlohmann::json &options)
+{
+   setOptions(output.numerator, options);
+   setOptions(output.denominator, options);
+   if (options.contains("attributes") && output.attr_marker.Size() > 0)
+   {
+      auto attributes = options["attributes"].get<std::vector<int>>();
+      attrVecToArray(attributes, output.attr_marker);
+   }
+   output.cache.valid = false;
+}
+
 double jacobianVectorProduct(IEAggregateFunctional &output,
                              const mfem::Vector &wrt_dot,
                              const std::string &wrt)
 {
-   const MISOInputs &inputs = *output.inputs;
-   double num = calcOutput(output.numerator, inputs);
-   double denom = calcOutput(output.denominator, inputs);
-
-   auto out_dot_p =
-       denom * jacobianVectorProduct(output.numerator, wrt_dot, wrt);
-   auto out_dot_m =
-       num * jacobianVectorProduct(output.denominator, wrt_dot, wrt);
-   double out_dot = (out_dot_p - out_dot_m) / pow(denom, 2);
-
-   std::cout << "IEAggregateFunctional::jacobianVectorProduct\n";
-   std::cout << "num: " << num << " denom: " << denom << "\n";
-   std::cout << "out_dot_p: " << out_dot_p << " out_dot_m: " << out_dot_m
-             << " out_dot: " << out_dot << "\n";
+   calcOutput(output, *output.inputs);
+   const double num = output.cache.num;
+   const double denom = output.cache.denom;
+
+   auto out_dot = denom * jacobianVectorProduct(output.numerator, wrt_dot, wrt);
+   out_dot -= num * jacobianVectorProduct(output.denominator, wrt_dot, wrt);
+   out_dot /= pow(denom, 2);
    return out_dot;
 }
 
@@ -170,14 +292,9 @@ void vectorJacobianProduct(IEAggregateFunctional &output,
                            const std::string &wrt,
                            mfem::Vector &wrt_bar)
 {
-   const MISOInputs &inputs = *output.inputs;
-   double num = calcOutput(output.numerator, inputs);
-   double denom = calcOutput(output.denominator, inputs);
-
-   std::cout << "IEAggregateFunctional::vectorJacobianProduct\n";
-   std::cout << "out_bar: ";
-   out_bar.Print(mfem::out, out_bar.Size());
-   std::cout << "num: " << num << " denom: " << denom << "\n";
+   calcOutput(output, *output.inputs);
+   const double num = output.cache.num;
+   const double denom = output.cache.denom;
 
    output.scratch.SetSize(wrt_bar.Size());
 
@@ -185,12 +302,9 @@ void vectorJacobianProduct(IEAggregateFunctional &output,
    vectorJacobianProduct(output.numerator, out_bar, wrt, output.scratch);
    wrt_bar.Add(1 / denom, output.scratch);
 
-   std::cout << "num wrt norm: " << output.scratch.Norml2();
-
    output.scratch = 0.0;
    vectorJacobianProduct(output.denominator, out_bar, wrt, output.scratch);
    wrt_bar.Add(-num / pow(denom, 2), output.scratch);
-   std::cout << " denom wrt norm: " << output.scratch.Norml2() << "\n";
 }
 
 IEAggregateFunctional::IEAggregateFunctional(
@@ -198,35 +312,62 @@ IEAggregateFunctional::IEAggregateFunctional(
     std::map<std::string, FiniteElementState> &fields,
     const nlohmann::json &options)
  : numerator(fes, fields, options.value("state", "state")),
-   denominator(fes, fields, options.value("state", "state"))
+   denominator(fes, fields, options.value("state", "state")),
+   state(&fields.at(options.value("state", "state")).gridFunc())
 {
    auto rho = options.value("rho", 1.0);
-   // auto state_name = options.value("state", "state");
+   fused_integ = new IEAggregateIntegratorNumerator(rho);
 
    if (options.contains("attributes"))
    {
       auto attributes = options["attributes"].get<std::vector<int>>();
-      numerator.addOutputDomainIntegrator(
-          new IEAggregateIntegratorNumerator(rho), attributes);
+      numerator.addOutputDomainIntegrator(fused_integ, attributes);
       denominator.addOutputDomainIntegrator(
           new IEAggregateIntegratorDenominator(rho), attributes);
+      attr_marker.SetSize(fes.GetMesh()->attributes.Max());
+      attrVecToArray(attributes, attr_marker);
    }
    else
    {
-      numerator.addOutputDomainIntegrator(
-          new IEAggregateIntegratorNumerator(rho));
+      numerator.addOutputDomainIntegrator(fused_integ);
       denominator.addOutputDomainIntegrator(
           new IEAggregateIntegratorDenominator(rho));
    }
 }
 
+double calcOutput(IECurlMagnitudeAggregateFunctional &output,
+                  const MISOInputs &inputs)
+{
+   updateIEAggregate(*output.fused_integ,
+                     *output.state,
+                     output.attr_marker,
+                     output.numerator,
+                     output.denominator,
+                     inputs,
+                     output.cache);
+   return output.cache.num / output.cache.denom;
+}
+
+void setOptions(IECurlMagnitudeAggregateFunctional &output,
+                const nlohmann::json &options)
+{
+   setOptions(output.numerator, options);
+   setOptions(output.denominator, options);
+   if (options.contains("attributes") && output.attr_marker.Size() > 0)
+   {
+      auto attributes = options["attributes"].get<std::vector<int>>();
+      attrVecToArray(attributes, output.attr_marker);
+   }
+   output.cache.valid = false;
+}
+
 double jacobianVectorProduct(IECurlMagnitudeAggregateFunctional &output,
                              const mfem::Vector &wrt_dot,
                              const std::string &wrt)
 {
-   const MISOInputs &inputs = *output.inputs;
-   double num = calcOutput(output.numerator, inputs);
-   double denom = calcOutput(output.denominator, inputs);
+   calcOutput(output, *output.inputs);
+   const double num = output.cache.num;
+   const double denom = output.cache.denom;
 
    auto out_dot = denom * jacobianVectorProduct(output.numerator, wrt_dot, wrt);
    out_dot -= num * jacobianVectorProduct(output.denominator, wrt_dot, wrt);
@@ -239,9 +380,9 @@ void vectorJacobianProduct(IECurlMagnitudeAggregateFunctional &output,
                            const std::string &wrt,
                            mfem::Vector &wrt_bar)
 {
-   const MISOInputs &inputs = *output.inputs;
-   double num = calcOutput(output.numerator, inputs);
-   double denom = calcOutput(output.denominator, inputs);
+   calcOutput(output, *output.inputs);
+   const double num = output.cache.num;
+   const double denom = output.cache.denom;
 
    output.scratch.SetSize(wrt_bar.Size());
 
@@ -258,22 +399,25 @@ IECurlMagnitudeAggregateFunctional::IECurlMagnitudeAggregateFunctional(
     mfem::ParFiniteElementSpace &fes,
     std::map<std::string, FiniteElementState> &fields,
     const nlohmann::json &options)
- : numerator(fes, fields), denominator(fes, fields)
+ : numerator(fes, fields),
+   denominator(fes, fields),
+   state(&fields.at("state").gridFunc())
 {
    auto rho = options["rho"].get<double>();
+   fused_integ = new IECurlMagnitudeAggregateIntegratorNumerator(rho);
 
    if (options.contains("attributes"))
    {
       auto attributes = options["attributes"].get<std::vector<int>>();
-      numerator.addOutputDomainIntegrator(
-          new IECurlMagnitudeAggregateIntegratorNumerator(rho), attributes);
+      numerator.addOutputDomainIntegrator(fused_integ, attributes);
       denominator.addOutputDomainIntegrator(
           new IECurlMagnitudeAggregateIntegratorDenominator(rho), attributes);
+      attr_marker.SetSize(fes.GetMesh()->attributes.Max());
+      attrVecToArray(attributes, attr_marker);
    }
    else
    {
-      numerator.addOutputDomainIntegrator(
-          new IECurlMagnitudeAggregateIntegratorNumerator(rho));
+      numerator.addOutputDomainIntegrator(fused_integ);
       denominator.addOutputDomainIntegrator(
           new IECurlMagnitudeAggregateIntegratorDenominator(rho));
    }
@@ -1,6 +1,7 @@
 #ifndef MISO_COMMON_OUTPUTS
 #define MISO_COMMON_OUTPUTS
 
+#include <map>
 #include <string>
 #include <unordered_map>
 
@@ -13,6 +14,9 @@
 
 namespace miso
 {
+class IEAggregateIntegratorNumerator;
+class IECurlMagnitudeAggregateIntegratorNumerator;
+
 class VolumeFunctional final
 {
 public:
@@ -37,6 +41,18 @@ public:
       return calcOutput(output.output, inputs);
    }
 
+   friend void addFunctionals(VolumeFunctional &output,
+                              std::vector<FunctionalOutput *> &functionals)
+   {
+      functionals.push_back(&output.output);
+   }
+
+   friend double calcOutputFromFunctionals(VolumeFunctional &output,
+                                           const double *values)
+   {
+      return values[0];
+   }
+
    friend double jacobianVectorProduct(VolumeFunctional &output,
                                        const mfem::Vector &wrt_dot,
                                        const std::string &wrt)
@@ -87,6 +103,18 @@ public:
       return calcOutput(output.output, inputs);
    }
 
+   friend void addFunctionals(MassFunctional &output,
+                              std::vector<FunctionalOutput *> &functionals)
+   {
+      functionals.push_back(&output.output);
+   }
+
+   friend double calcOutputFromFunctionals(MassFunctional &output,
+                                           const double *values)
+   {
+      return values[0];
+   }
+
    friend double jacobianVectorProduct(MassFunctional &output,
                                        const mfem::Vector &wrt_dot,
                                        const std::string &wrt)
@@ -153,6 +181,19 @@ public:
       return state / volume;
    }
 
+   friend void addFunctionals(StateAverageFunctional &output,
+                              std::vector<FunctionalOutput *> &functionals)
+   {
+      functionals.push_back(&output.state_integ);
+      functionals.push_back(&output.volume);
+   }
+
+   friend double calcOutputFromFunctionals(StateAverageFunctional &output,
+                                           const double *values)
+   {
+      return values[0] / values[1];
+   }
+
    friend double jacobianVectorProduct(StateAverageFunctional &output,
                                        const mfem::Vector &wrt_dot,
                                        const std::string &wrt)
@@ -239,6 +280,19 @@ public:
       return state / volume;
    }
 
+   friend void addFunctionals(AverageMagnitudeCurlState &output,
+                              std::vector<FunctionalOutput *> &functionals)
+   {
+      functionals.push_back(&output.state_integ);
+      functionals.push_back(&output.volume);
+   }
+
+   friend double calcOutputFromFunctionals(AverageMagnitudeCurlState &output,
+                                           const double *values)
+   {
+      return values[0] / values[1];
+   }
+
    friend double jacobianVectorProduct(AverageMagnitudeCurlState &output,
                                        const mfem::Vector &wrt_dot,
                                        const std::string &wrt);
@@ -264,6 +318,32 @@ private:
    mfem::Vector scratch;
 };
 
+/// The numerator and denominator of an induced exponential aggregate, with
+/// copies of the inputs they were evaluated for
+struct IEAggregateCache
+{
+   /// vector inputs (e.g. "state", "mesh_coords") of the cached values
+   std::map<std::string, mfem::Vector> inputs;
+   /// scalar inputs (e.g. "rho") of the cached values
+   std::map<std::string, double> scalars;
+   /// sums shifted by the largest value of the aggregated quantity
+   double num = 0.0;
+   double denom = 1.0;
+   /// false until the sums are evaluated, and after the options or any
+   /// input change
+   bool valid = false;
+};
+
+/// \brief Copy the inputs that differ from those cached, and invalidate the
+/// cached sums if there were any
+/// \param[in] inputs - the inputs to compare
+/// \param[inout] cache - the cache whose copies are updated to `inputs`
+void updateCachedInputs(const MISOInputs &inputs, IEAggregateCache &cache);
+
+/// Smooth maximum of a scalar state by induced exponential aggregation
+/// \note The numerator and denominator are summed in a single sweep, shifted
+/// by the largest state value to keep the exponentials bounded, and are
+/// cached so the derivatives at the same inputs do not evaluate them again
 class IEAggregateFunctional
 {
 public:
@@ -273,36 +353,19 @@ public:
    }
 
    friend void setOptions(IEAggregateFunctional &output,
-                          const nlohmann::json &options)
-   {
-      setOptions(output.numerator, options);
-      setOptions(output.denominator, options);
-   }
+                          const nlohmann::json &options);
 
    friend void setInputs(IEAggregateFunctional &output,
                          const MISOInputs &inputs)
    {
       output.inputs = &inputs;
+      updateCachedInputs(inputs, output.cache);
       setInputs(output.numerator, inputs);
       setInputs(output.denominator, inputs);
    }
 
    friend double calcOutput(IEAggregateFunctional &output,
-                            const MISOInputs &inputs)
-   {
-      mfem::Vector state;
-      setVectorFromInputs(inputs, "state", state);
-      double true_max = state.Max();
-      setInputs(output, {{"true_max", true_max}});
-
-      double num = calcOutput(output.numerator, inputs);
-      double denom = calcOutput(output.denominator, inputs);
-
-      std::cout << "IEAggregateFunctional::calcOutput\n";
-      std::cout << "num: " << num << " denom: " << denom << "\n";
-
-      return num / denom;
-   }
+                            const MISOInputs &inputs);
 
    friend double jacobianVectorProduct(IEAggregateFunctional &output,
                                        const mfem::Vector &wrt_dot,
@@ -320,10 +383,21 @@ public:
 private:
    FunctionalOutput numerator;
    FunctionalOutput denominator;
+   /// numerator integrator, which also sums the denominator in its sweep
+   IEAggregateIntegratorNumerator *fused_integ = nullptr;
+   /// the aggregated state
+   mfem::ParGridFunction *state = nullptr;
+   /// elements to aggregate over; empty for all elements
+   mfem::Array<int> attr_marker;
+   IEAggregateCache cache;
    MISOInputs const *inputs = nullptr;
    mfem::Vector scratch;
 };
 
+/// Smooth maximum of the magnitude of the curl of the state by induced
+/// exponential aggregation
+/// \note Evaluated in a single, shifted sweep and cached like
+/// `IEAggregateFunctional`
 class IECurlMagnitudeAggregateFunctional
 {
 public:
@@ -333,27 +407,19 @@ public:
    }
 
    friend void setOptions(IECurlMagnitudeAggregateFunctional &output,
-                          const nlohmann::json &options)
-   {
-      setOptions(output.numerator, options);
-      setOptions(output.denominator, options);
-   }
+                          const nlohmann::json &options);
 
    friend void setInputs(IECurlMagnitudeAggregateFunctional &output,
                          const MISOInputs &inputs)
    {
       output.inputs = &inputs;
+      updateCachedInputs(inputs, output.cache);
       setInputs(output.numerator, inputs);
       setInputs(output.denominator, inputs);
    }
 
    friend double calcOutput(IECurlMagnitudeAggregateFunctional &output,
-                            const MISOInputs &inputs)
-   {
-      double num = calcOutput(output.numerator, inputs);
-      double denom = calcOutput(output.denominator, inputs);
-      return num / denom;
-   }
+                            const MISOInputs &inputs);
 
    friend double jacobianVectorProduct(
        IECurlMagnitudeAggregateFunctional &output,
@@ -373,6 +439,13 @@ public:
 private:
    FunctionalOutput numerator;
    FunctionalOutput denominator;
+   /// numerator integrator, which also sums the denominator in its sweep
+   IECurlMagnitudeAggregateIntegratorNumerator *fused_integ = nullptr;
+   /// the state whose curl is aggregated
+   mfem::ParGridFunction *state = nullptr;
+   /// elements to aggregate over; empty for all elements
+   mfem::Array<int> attr_marker;
+   IEAggregateCache cache;
    MISOInputs const *inputs = nullptr;
    mfem::Vector scratch;
 };
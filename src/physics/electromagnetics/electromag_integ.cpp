@@ -2,6 +2,7 @@
 #include "coefficient.hpp"
 #include "electromag_integ.hpp"
 #include "miso_input.hpp"
+#include "utils.hpp"
 
 #include "cal2_kh_coefficient.hpp"
 #include "cal2_ke_coefficient.hpp"
@@ -89,6 +90,75 @@ double calcMagneticEnergyDoubleDot(ElementTransformation &trans,
    return d2endB2;
 }
 
+namespace
+{
+/// \brief Shared implementation of `prepareThreads` for integrators that
+/// evaluate a material model with cached shape function derivatives
+/// \return true if the elements can be assembled by `num_threads` threads
+template <typename Workspaces>
+bool prepareModelThreads(const StateCoefficient &model,
+                         GeometricFactorCache &geom_cache,
+                         Workspaces &workspaces,
+                         int num_threads,
+                         int num_elements)
+{
+   if (geom_cache.isEnabled())
+   {
+      geom_cache.reserve(num_elements);
+   }
+   /// the material model is evaluated by every thread at once, so it must not
+   /// cache state lazily or evaluate shared GridFunctions
+   if (!model.isThreadSafe())
+   {
+      return false;
+   }
+#ifdef MFEM_THREAD_SAFE
+   return true;
+#else
+   workspaces.resize(num_threads);
+   /// MFEM's finite elements share scratch storage between shape function
+   /// evaluations, so elements can only be assembled concurrently once all of
+   /// their shape derivatives are cached
+   return geom_cache.isEnabled() && geom_cache.isFull(num_elements);
+#endif
+}
+
+}  // anonymous namespace
+
+bool NonlinearDiffusionIntegrator::prepareThreads(int num_threads,
+                                                  int num_elements)
+{
+   return prepareModelThreads(
+       model, geom_cache, workspaces, num_threads, num_elements);
+}
+
+const IntegrationRule &NonlinearDiffusionIntegrator::integrationRule(
+    const FiniteElement &el) const
+{
+   if (IntRule != nullptr)
+   {
+      return *IntRule;
+   }
+   int order = [&]()
+   {
+      if (el.Space() == FunctionSpace::Pk)
+      {
+         return 2 * el.GetOrder();
+      }
+      else
+      {
+         // order = 2*el.GetOrder() - 2;  // <-- this seems to work fine too
+         return 2 * el.GetOrder() + el.GetDim() - 1;
+      }
+   }();
+
+   if (el.Space() == FunctionSpace::rQk)
+   {
+      return RefinedIntRules.Get(el.GetGeomType(), order);
+   }
+   return IntRules.Get(el.GetGeomType(), order);
+}
+
 void NonlinearDiffusionIntegrator::AssembleElementVector(
     const FiniteElement &el,
     ElementTransformation &trans,
@@ -99,73 +169,51 @@ void NonlinearDiffusionIntegrator::AssembleElementVector(
    int ndof = el.GetDof();
    elvect.SetSize(ndof);
 
-   int dim = el.GetDim();
    int space_dim = trans.GetSpaceDim();
 
 #ifdef MFEM_THREAD_SAFE
-   DenseMatrix dshape;
-   DenseMatrix dshapedxt;
+   Workspace ws;
+#else
+   auto &ws = workspaces.local();
 #endif
-   dshape.SetSize(ndof, dim);
-   dshapedxt.SetSize(ndof, space_dim);
-
-   double pointflux_buffer[3] = {};
-   Vector pointflux(pointflux_buffer, space_dim);
+   auto &geom_scratch = ws.geom_scratch;
+   auto &pointfluxes = ws.pointfluxes;
+   auto &pointflux_mags = ws.pointflux_mags;
+   auto &model_vals = ws.model_vals;
 
-   const IntegrationRule *ir = IntRule;
-   if (ir == nullptr)
-   {
-      int order = [&]()
-      {
-         if (el.Space() == FunctionSpace::Pk)
-         {
-            return 2 * el.GetOrder();
-         }
-         else
-         {
-            // order = 2*el.GetOrder() - 2;  // <-- this seems to work fine too
-            return 2 * el.GetOrder() + el.GetDim() - 1;
-         }
-      }();
+   const IntegrationRule *ir = &integrationRule(el);
 
-      if (el.Space() == FunctionSpace::rQk)
-      {
-         ir = &RefinedIntRules.Get(el.GetGeomType(), order);
-      }
-      else
-      {
-         ir = &IntRules.Get(el.GetGeomType(), order);
-      }
-   }
+   const int npoints = ir->GetNPoints();
+   const auto &geom = getGeometricFactors(
+       geom_cache, calcDShapeFactors, el, trans, *ir, geom_scratch);
+   pointfluxes.SetSize(space_dim, npoints);
+   pointflux_mags.SetSize(npoints);
 
-   elvect = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   /// compute the flux at every integration point so the material model can
+   /// be evaluated for the whole element at once
+   for (int i = 0; i < npoints; i++)
    {
-      const IntegrationPoint &ip = ir->IntPoint(i);
-      trans.SetIntPoint(&ip);
-
-      double trans_weight = trans.Weight();
-
-      double w = alpha * ip.weight / trans_weight;
-
-      el.CalcDShape(ip, dshape);
-      Mult(dshape, trans.AdjugateJacobian(), dshapedxt);
-
-      dshapedxt.MultTranspose(elfun, pointflux);
+      Vector pointflux(pointfluxes.GetColumn(i), space_dim);
+      geom.shapes(i).MultTranspose(elfun, pointflux);
 
       const double pointflux_norm = pointflux.Norml2();
-      const double pointflux_mag = pointflux_norm / trans_weight;
+      pointflux_mags(i) = pointflux_norm / geom.dets(i);
+   }
 
-      double model_val = model.Eval(trans, ip, pointflux_mag);
+   model.EvalBatch(trans, *ir, pointflux_mags, model_vals);
 
-      pointflux *= w * model_val;
+   elvect = 0.0;
+   for (int i = 0; i < npoints; i++)
+   {
+      Vector pointflux(pointfluxes.GetColumn(i), space_dim);
+      pointflux *= alpha * geom.weights(i) * model_vals(i);
 
-      dshapedxt.AddMult(pointflux, elvect);
+      geom.shapes(i).AddMult(pointflux, elvect);
+   }
 
-      if (!isfinite(elvect.Norml2()))
-      {
-         std::cout << "nan!\n";
-      }
+   if (!isfinite(elvect.Norml2()))
+   {
+      std::cout << "nan!\n";
    }
 }
 
@@ -180,75 +228,63 @@ void NonlinearDiffusionIntegrator::AssembleElementGrad(
    elmat.SetSize(ndof);
    elmat = 0.0;
 
-   int dim = el.GetDim();
    int space_dim = trans.GetSpaceDim();
 
 #ifdef MFEM_THREAD_SAFE
-   DenseMatrix dshape;
-   DenseMatrix dshapedxt;
-   DenseMatrix point_flux_2_dot;
-   Vector scratch;
-#endif
-   dshape.SetSize(ndof, dim);
-   dshapedxt.SetSize(ndof, space_dim);
+   Workspace ws;
+#else
+   auto &ws = workspaces.local();
+#endif
+   auto &point_flux_2_dot = ws.point_flux_2_dot;
+   auto &pointflux_norm_dot = ws.pointflux_norm_dot;
+   auto &geom_scratch = ws.geom_scratch;
+   auto &pointfluxes = ws.pointfluxes;
+   auto &pointflux_mags = ws.pointflux_mags;
+   auto &model_vals = ws.model_vals;
+   auto &model_derivs = ws.model_derivs;
    point_flux_2_dot.SetSize(ndof, space_dim);
    pointflux_norm_dot.SetSize(ndof);
 
-   double pointflux_buffer[3] = {};
-   Vector pointflux(pointflux_buffer, space_dim);
+   const IntegrationRule *ir = &integrationRule(el);
 
-   const IntegrationRule *ir = IntRule;
-   if (ir == nullptr)
+   const int npoints = ir->GetNPoints();
+   const auto &geom = getGeometricFactors(
+       geom_cache, calcDShapeFactors, el, trans, *ir, geom_scratch);
+   pointfluxes.SetSize(space_dim, npoints);
+   pointflux_mags.SetSize(npoints);
+
+   /// compute the flux at every integration point so the material model can
+   /// be evaluated for the whole element at once
+   for (int i = 0; i < npoints; i++)
    {
-      int order = [&]()
-      {
-         if (el.Space() == FunctionSpace::Pk)
-         {
-            return 2 * el.GetOrder();
-         }
-         else
-         {
-            // order = 2*el.GetOrder() - 2;  // <-- this seems to work fine too
-            return 2 * el.GetOrder() + el.GetDim() - 1;
-         }
-      }();
+      Vector pointflux(pointfluxes.GetColumn(i), space_dim);
+      geom.shapes(i).MultTranspose(elfun, pointflux);
 
-      if (el.Space() == FunctionSpace::rQk)
-      {
-         ir = &RefinedIntRules.Get(el.GetGeomType(), order);
-      }
-      else
-      {
-         ir = &IntRules.Get(el.GetGeomType(), order);
-      }
+      pointflux_mags(i) = pointflux.Norml2() / geom.dets(i);
    }
 
+   model.EvalStateDerivBatch(
+       trans, *ir, pointflux_mags, model_vals, model_derivs);
+
    elmat = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   for (int i = 0; i < npoints; i++)
    {
-      const IntegrationPoint &ip = ir->IntPoint(i);
-      trans.SetIntPoint(&ip);
-
-      double trans_weight = trans.Weight();
+      const double trans_weight = geom.dets(i);
+      const double w = alpha * geom.weights(i);
 
-      double w = alpha * ip.weight / trans_weight;
-
-      el.CalcDShape(ip, dshape);
-      Mult(dshape, trans.AdjugateJacobian(), dshapedxt);
-
-      dshapedxt.MultTranspose(elfun, pointflux);
+      const auto &dshapedxt = geom.shapes(i);
+      Vector pointflux(pointfluxes.GetColumn(i), space_dim);
 
       const double pointflux_norm = pointflux.Norml2();
 
       pointflux_norm_dot = 0.0;
       dshapedxt.AddMult_a(1.0 / pointflux_norm, pointflux, pointflux_norm_dot);
 
-      const double pointflux_mag = pointflux_norm / trans_weight;
       pointflux_norm_dot /= trans_weight;
 
-      double model_val = model.Eval(trans, ip, pointflux_mag);
+      double model_val = model_vals(i);
 
-      double model_deriv = model.EvalStateDeriv(trans, ip, pointflux_mag);
+      double model_deriv = model_derivs(i);
       pointflux_norm_dot *= model_deriv;
 
       point_flux_2_dot = dshapedxt;
@@ -270,6 +306,86 @@ void NonlinearDiffusionIntegrator::AssembleElementGrad(
    }
 }
 
+void NonlinearDiffusionIntegrator::AssembleElementVectorAndGrad(
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::Vector &elfun,
+    mfem::Vector &elvect,
+    mfem::DenseMatrix &elmat)
+{
+   /// number of degrees of freedom
+   int ndof = el.GetDof();
+   elvect.SetSize(ndof);
+   elvect = 0.0;
+   elmat.SetSize(ndof);
+   elmat = 0.0;
+
+   int space_dim = trans.GetSpaceDim();
+
+#ifdef MFEM_THREAD_SAFE
+   Workspace ws;
+#else
+   auto &ws = workspaces.local();
+#endif
+   auto &point_flux_2_dot = ws.point_flux_2_dot;
+   auto &pointflux_norm_dot = ws.pointflux_norm_dot;
+   auto &geom_scratch = ws.geom_scratch;
+   auto &pointfluxes = ws.pointfluxes;
+   auto &pointflux_mags = ws.pointflux_mags;
+   auto &model_vals = ws.model_vals;
+   auto &model_derivs = ws.model_derivs;
+   point_flux_2_dot.SetSize(ndof, space_dim);
+   pointflux_norm_dot.SetSize(ndof);
+
+   const IntegrationRule *ir = &integrationRule(el);
+   const int npoints = ir->GetNPoints();
+   const auto &geom = getGeometricFactors(
+       geom_cache, calcDShapeFactors, el, trans, *ir, geom_scratch);
+   pointfluxes.SetSize(space_dim, npoints);
+   pointflux_mags.SetSize(npoints);
+
+   /// the flux and the material model are evaluated once for both the
+   /// residual and the Jacobian
+   for (int i = 0; i < npoints; i++)
+   {
+      Vector pointflux(pointfluxes.GetColumn(i), space_dim);
+      geom.shapes(i).MultTranspose(elfun, pointflux);
+
+      pointflux_mags(i) = pointflux.Norml2() / geom.dets(i);
+   }
+
+   model.EvalStateDerivBatch(
+       trans, *ir, pointflux_mags, model_vals, model_derivs);
+
+   for (int i = 0; i < npoints; i++)
+   {
+      const double trans_weight = geom.dets(i);
+      const double w = alpha * geom.weights(i);
+
+      const auto &dshapedxt = geom.shapes(i);
+      Vector pointflux(pointfluxes.GetColumn(i), space_dim);
+      const double pointflux_norm = pointflux.Norml2();
+      const double model_val = model_vals(i);
+
+      dshapedxt.AddMult_a(w * model_val, pointflux, elvect);
+
+      pointflux_norm_dot = 0.0;
+      dshapedxt.AddMult_a(1.0 / pointflux_norm, pointflux, pointflux_norm_dot);
+      pointflux_norm_dot *= model_derivs(i) / trans_weight;
+
+      point_flux_2_dot = dshapedxt;
+      point_flux_2_dot *= model_val;
+
+      if (abs(pointflux_norm) > 1e-14)
+      {
+         AddMultVWt(pointflux_norm_dot, pointflux, point_flux_2_dot);
+      }
+      point_flux_2_dot *= w;
+
+      AddMultABt(dshapedxt, point_flux_2_dot, elmat);
+   }
+}
+
 void NonlinearDiffusionIntegratorMeshRevSens::AssembleRHSElementVect(
     const FiniteElement &mesh_el,
     ElementTransformation &mesh_trans,
@@ -311,8 +427,8 @@ void NonlinearDiffusionIntegratorMeshRevSens::AssembleRHSElementVect(
    DenseMatrix dshapedxt_bar;
    DenseMatrix PointMat_bar;
 #else
-   auto &dshape = integ.dshape;
-   auto &dshapedxt = integ.dshapedxt;
+   auto &dshape = integ.workspaces.local().dshape;
+   auto &dshapedxt = integ.workspaces.local().dshapedxt;
 #endif
 
    dshape.SetSize(ndof, dim);
@@ -3194,6 +3310,34 @@ void MagnetizationSource2DIntegratorTemperatureSens::AssembleRHSElementVect(
    }
 }
 
+bool CurlCurlNLFIntegrator::prepareThreads(int num_threads, int num_elements)
+{
+   return prepareModelThreads(
+       model, geom_cache, workspaces, num_threads, num_elements);
+}
+
+const IntegrationRule &CurlCurlNLFIntegrator::integrationRule(
+    const FiniteElement &el) const
+{
+   if (IntRule != nullptr)
+   {
+      return *IntRule;
+   }
+   int order = [&]()
+   {
+      if (el.Space() == FunctionSpace::Pk)
+      {
+         return 2 * el.GetOrder() - 1;
+      }
+      else
+      {
+         return 2 * el.GetOrder();
+      }
+   }();
+
+   return IntRules.Get(el.GetGeomType(), order);
+}
+
 void CurlCurlNLFIntegrator::AssembleElementVector(const FiniteElement &el,
                                                   ElementTransformation &trans,
                                                   const Vector &elfun,
@@ -3207,63 +3351,41 @@ void CurlCurlNLFIntegrator::AssembleElementVector(const FiniteElement &el,
    elvect = 0.0;
 
 #ifdef MFEM_THREAD_SAFE
-   DenseMatrix curlshape(ndof, dimc), curlshape_dFt(ndof, dimc), M;
-   // Vector b_vec(dimc);
+   Workspace ws;
 #else
-   curlshape.SetSize(ndof, dimc);
-   curlshape_dFt.SetSize(ndof, dimc);
-   // b_vec.SetSize(dimc);
+   auto &ws = workspaces.local();
 #endif
+   auto &geom_scratch = ws.geom_scratch;
+   auto &b_vecs = ws.b_vecs;
+   auto &b_mags = ws.b_mags;
+   auto &model_vals = ws.model_vals;
 
-   double b_vec_buffer[3] = {};
-   Vector b_vec(b_vec_buffer, dimc);
+   const IntegrationRule *ir = &integrationRule(el);
 
-   const IntegrationRule *ir = IntRule;
-   if (ir == nullptr)
-   {
-      int order = [&]()
-      {
-         if (el.Space() == FunctionSpace::Pk)
-         {
-            return 2 * el.GetOrder() - 1;
-         }
-         else
-         {
-            return 2 * el.GetOrder();
-         }
-      }();
+   const int npoints = ir->GetNPoints();
+   const auto &geom = getGeometricFactors(
+       geom_cache, calcCurlShapeFactors, el, trans, *ir, geom_scratch);
+   b_vecs.SetSize(dimc, npoints);
+   b_mags.SetSize(npoints);
 
-      ir = &IntRules.Get(el.GetGeomType(), order);
-   }
-
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   /// compute B = curl(A) at every integration point so the material model
+   /// can be evaluated for the whole element at once
+   for (int i = 0; i < npoints; i++)
    {
-      b_vec = 0.0;
-      const IntegrationPoint &ip = ir->IntPoint(i);
-
-      trans.SetIntPoint(&ip);
-
-      double w = ip.weight / trans.Weight();
-      w *= alpha;
-
-      if (dim == 3)
-      {
-         el.CalcCurlShape(ip, curlshape);
-         MultABt(curlshape, trans.Jacobian(), curlshape_dFt);
-      }
-      else
-      {
-         el.CalcCurlShape(ip, curlshape_dFt);
-      }
-      curlshape_dFt.AddMultTranspose(elfun, b_vec);
+      Vector b_vec(b_vecs.GetColumn(i), dimc);
+      geom.shapes(i).MultTranspose(elfun, b_vec);
       const double b_vec_norm = b_vec.Norml2();
-      const double b_mag = b_vec_norm / trans.Weight();
+      b_mags(i) = b_vec_norm / geom.dets(i);
+   }
 
-      double model_val = model.Eval(trans, ip, b_mag);
-      model_val *= w;
-      b_vec *= model_val;
+   model.EvalBatch(trans, *ir, b_mags, model_vals);
+
+   for (int i = 0; i < npoints; i++)
+   {
+      Vector b_vec(b_vecs.GetColumn(i), dimc);
+      b_vec *= model_vals(i) * alpha * geom.weights(i);
 
-      curlshape_dFt.AddMult(b_vec, elvect);
+      geom.shapes(i).AddMult(b_vec, elvect);
    }
 }
 
@@ -3281,66 +3403,52 @@ void CurlCurlNLFIntegrator::AssembleElementGrad(
    elmat = 0.0;
 
 #ifdef MFEM_THREAD_SAFE
-   DenseMatrix curlshape(ndof, dimc), curlshape_dFt(ndof, dimc);
-   Vector scratch(ndof);
+   Workspace ws;
 #else
-   curlshape.SetSize(ndof, dimc);
-   curlshape_dFt.SetSize(ndof, dimc);
+   auto &ws = workspaces.local();
+#endif
+   auto &scratch = ws.scratch;
+   auto &geom_scratch = ws.geom_scratch;
+   auto &b_vecs = ws.b_vecs;
+   auto &b_mags = ws.b_mags;
+   auto &model_vals = ws.model_vals;
+   auto &model_derivs = ws.model_derivs;
    scratch.SetSize(ndof);
-#endif
-
-   double b_vec_buffer[3] = {};
-   Vector b_vec(b_vec_buffer, dimc);
 
-   const IntegrationRule *ir = IntRule;
-   if (ir == nullptr)
-   {
-      int order = [&]()
-      {
-         if (el.Space() == FunctionSpace::Pk)
-         {
-            return 2 * el.GetOrder() - 1;
-         }
-         else
-         {
-            return 2 * el.GetOrder();
-         }
-      }();
+   const IntegrationRule *ir = &integrationRule(el);
 
-      ir = &IntRules.Get(el.GetGeomType(), order);
-   }
+   const int npoints = ir->GetNPoints();
+   const auto &geom = getGeometricFactors(
+       geom_cache, calcCurlShapeFactors, el, trans, *ir, geom_scratch);
+   b_vecs.SetSize(dimc, npoints);
+   b_mags.SetSize(npoints);
 
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   /// compute B = curl(A) at every integration point so the material model
+   /// and its derivative can be evaluated for the whole element at once
+   for (int i = 0; i < npoints; i++)
    {
-      const IntegrationPoint &ip = ir->IntPoint(i);
-
-      trans.SetIntPoint(&ip);
-
-      double w = ip.weight / trans.Weight();
-      w *= alpha;
+      /// calculate B = curl(A)
+      Vector b_vec(b_vecs.GetColumn(i), dimc);
+      geom.shapes(i).MultTranspose(elfun, b_vec);
+      b_vec /= geom.dets(i);
+      b_mags(i) = b_vec.Norml2();
+   }
 
-      if (dim == 3)
-      {
-         el.CalcCurlShape(ip, curlshape);
-         MultABt(curlshape, trans.Jacobian(), curlshape_dFt);
-      }
-      else
-      {
-         el.CalcCurlShape(ip, curlshape_dFt);
-      }
+   model.EvalStateDerivBatch(trans, *ir, b_mags, model_vals, model_derivs);
 
-      /// calculate B = curl(A)
-      b_vec = 0.0;
-      curlshape_dFt.MultTranspose(elfun, b_vec);
-      b_vec /= trans.Weight();
-      const double b_mag = b_vec.Norml2();
+   for (int i = 0; i < npoints; i++)
+   {
+      const double w = alpha * geom.weights(i);
+      const auto &curlshape_dFt = geom.shapes(i);
+      Vector b_vec(b_vecs.GetColumn(i), dimc);
+      const double b_mag = b_mags(i);
 
       /////////////////////////////////////////////////////////////////////////
       /// calculate first term of Jacobian
       /////////////////////////////////////////////////////////////////////////
 
-      /// evaluate material model at ip
-      double model_val = model.Eval(trans, ip, b_mag);
+      /// material model at ip
+      double model_val = model_vals(i);
       /// multiply material value by integration weight
       model_val *= w;
       /// add first term to elmat
@@ -3357,10 +3465,10 @@ void CurlCurlNLFIntegrator::AssembleElementGrad(
          scratch = 0.0;
          curlshape_dFt.Mult(b_vec, scratch);
 
-         /// evaluate the derivative of the material model with respect to
-         /// the norm of the grid function associated with the model at the
-         /// point defined by ip, and scale by integration point weight
-         double model_deriv = model.EvalStateDeriv(trans, ip, b_mag);
+         /// derivative of the material model with respect to the norm of
+         /// the grid function associated with the model at the point defined
+         /// by ip, scaled by integration point weight
+         double model_deriv = model_derivs(i);
          model_deriv *= w;
          model_deriv /= b_mag;
 
@@ -3389,6 +3497,210 @@ void CurlCurlNLFIntegrator::AssembleElementGrad(
    }
 }
 
+void CurlCurlNLFIntegrator::AssembleElementVectorAndGrad(
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::Vector &elfun,
+    mfem::Vector &elvect,
+    mfem::DenseMatrix &elmat)
+{
+   /// number of degrees of freedom
+   int ndof = el.GetDof();
+   int dim = el.GetDim();
+   int dimc = (dim == 3) ? 3 : 1;
+   elvect.SetSize(ndof);
+   elvect = 0.0;
+   elmat.SetSize(ndof);
+   elmat = 0.0;
+
+#ifdef MFEM_THREAD_SAFE
+   Workspace ws;
+#else
+   auto &ws = workspaces.local();
+#endif
+   auto &scratch = ws.scratch;
+   auto &geom_scratch = ws.geom_scratch;
+   auto &b_vecs = ws.b_vecs;
+   auto &b_mags = ws.b_mags;
+   auto &model_vals = ws.model_vals;
+   auto &model_derivs = ws.model_derivs;
+   scratch.SetSize(ndof);
+
+   const IntegrationRule *ir = &integrationRule(el);
+   const int npoints = ir->GetNPoints();
+   const auto &geom = getGeometricFactors(
+       geom_cache, calcCurlShapeFactors, el, trans, *ir, geom_scratch);
+   b_vecs.SetSize(dimc, npoints);
+   b_mags.SetSize(npoints);
+
+   /// B = curl(A), nu(|B|) and dnu/d|B| are evaluated once for both the
+   /// residual and the Jacobian
+   for (int i = 0; i < npoints; i++)
+   {
+      Vector b_vec(b_vecs.GetColumn(i), dimc);
+      geom.shapes(i).MultTranspose(elfun, b_vec);
+      b_vec /= geom.dets(i);
+      b_mags(i) = b_vec.Norml2();
+   }
+
+   model.EvalStateDerivBatch(trans, *ir, b_mags, model_vals, model_derivs);
+
+   for (int i = 0; i < npoints; i++)
+   {
+      const double w = alpha * geom.weights(i);
+      const auto &curlshape_dFt = geom.shapes(i);
+      Vector b_vec(b_vecs.GetColumn(i), dimc);
+      const double b_mag = b_mags(i);
+      const double model_val = model_vals(i) * w;
+
+      /// the residual uses curl(A) before it is divided by the determinant
+      curlshape_dFt.AddMult_a(model_val * geom.dets(i), b_vec, elvect);
+
+      AddMult_a_AAt(model_val, curlshape_dFt, elmat);
+      if (abs(b_mag) > 1e-14)
+      {
+         scratch = 0.0;
+         curlshape_dFt.Mult(b_vec, scratch);
+         AddMult_a_VVt(model_derivs(i) * w / b_mag, scratch, elmat);
+      }
+   }
+}
+
+void CurlCurlNLFIntegrator::AssembleGradPA(const mfem::Vector &x,
+                                           const mfem::FiniteElementSpace &fes)
+{
+   auto &mesh = *fes.GetMesh();
+   if (mesh.Dimension() != 3)
+   {
+      throw MISOException(
+          "CurlCurlNLFIntegrator::AssembleGradPA only supports 3D meshes!\n");
+   }
+   if (mesh.GetNumGeometries(3) > 1)
+   {
+      throw MISOException(
+          "CurlCurlNLFIntegrator::AssembleGradPA does not support meshes with "
+          "mixed element types!\n");
+   }
+
+   const int num_elements = fes.GetNE();
+   pa_element_nu.SetSize(num_elements);
+   if (num_elements == 0)
+   {
+      pa_qdata.SetSize(0);
+      return;
+   }
+
+   const auto &el = *fes.GetFE(0);
+   const int ndof = el.GetDof();
+
+   /// use the same rule as the assembled Jacobian so the two agree
+   const IntegrationRule *ir = &integrationRule(el);
+   const int npoints = ir->GetNPoints();
+
+   /// the reference curl shapes are the same for every element; orientation
+   /// is handled by the dof transformations applied to the element vectors
+   pa_curlshapes.SetSize(ndof, 3, npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      el.CalcCurlShape(ir->IntPoint(i), pa_curlshapes(i));
+   }
+   pa_qdata.SetSize(6 * npoints * num_elements);
+
+   DenseTensor jacobians(3, 3, npoints);
+   DenseMatrix b_vecs(3, npoints);
+   Vector dets(npoints);
+   Vector b_mags(npoints);
+   Vector model_vals;
+   Vector model_derivs;
+   Vector b_hat(3);
+   Vector jt_b(3);
+   for (int e = 0; e < num_elements; ++e)
+   {
+      auto &trans = *fes.GetElementTransformation(e);
+      const Vector elfun(x.GetData() + e * ndof, ndof);
+
+      /// compute B = J curl_hat(A) / det(J) at every integration point so the
+      /// material model can be evaluated for the whole element at once
+      for (int i = 0; i < npoints; ++i)
+      {
+         trans.SetIntPoint(&ir->IntPoint(i));
+         jacobians(i) = trans.Jacobian();
+         dets(i) = trans.Weight();
+
+         Vector b_vec(b_vecs.GetColumn(i), 3);
+         pa_curlshapes(i).MultTranspose(elfun, b_hat);
+         jacobians(i).Mult(b_hat, b_vec);
+         b_vec /= dets(i);
+         b_mags(i) = b_vec.Norml2();
+      }
+
+      model.EvalStateDerivBatch(trans, *ir, b_mags, model_vals, model_derivs);
+
+      double nu_sum = 0.0;
+      double weight_sum = 0.0;
+      for (int i = 0; i < npoints; ++i)
+      {
+         const auto &ip = ir->IntPoint(i);
+         const auto &jac = jacobians(i);
+         const double w = alpha * ip.weight / dets(i);
+         const double nu_w = w * model_vals(i);
+         const double dnu_w =
+             (abs(b_mags(i)) > 1e-14) ? w * model_derivs(i) / b_mags(i) : 0.0;
+
+         Vector b_vec(b_vecs.GetColumn(i), 3);
+         jac.MultTranspose(b_vec, jt_b);
+
+         double *qdata = pa_qdata.GetData() + 6 * (e * npoints + i);
+         int k = 0;
+         for (int r = 0; r < 3; ++r)
+         {
+            for (int c = r; c < 3; ++c)
+            {
+               double jt_j = 0.0;
+               for (int m = 0; m < 3; ++m)
+               {
+                  jt_j += jac(m, r) * jac(m, c);
+               }
+               qdata[k++] = nu_w * jt_j + dnu_w * jt_b(r) * jt_b(c);
+            }
+         }
+
+         nu_sum += ip.weight * model_vals(i);
+         weight_sum += ip.weight;
+      }
+      pa_element_nu(e) = nu_sum / weight_sum;
+   }
+}
+
+void CurlCurlNLFIntegrator::AddMultGradPA(const mfem::Vector &x,
+                                          mfem::Vector &y) const
+{
+   const int ndof = pa_curlshapes.SizeI();
+   const int npoints = pa_curlshapes.SizeK();
+   const int num_elements = pa_element_nu.Size();
+
+   double u_data[3];
+   double v_data[3];
+   Vector u(u_data, 3);
+   Vector v(v_data, 3);
+   for (int e = 0; e < num_elements; ++e)
+   {
+      const Vector x_e(x.GetData() + e * ndof, ndof);
+      Vector y_e(y.GetData() + e * ndof, ndof);
+      for (int i = 0; i < npoints; ++i)
+      {
+         const auto &curlshape = pa_curlshapes(i);
+         const double *qdata = pa_qdata.GetData() + 6 * (e * npoints + i);
+
+         curlshape.MultTranspose(x_e, u);
+         v(0) = qdata[0] * u(0) + qdata[1] * u(1) + qdata[2] * u(2);
+         v(1) = qdata[1] * u(0) + qdata[3] * u(1) + qdata[4] * u(2);
+         v(2) = qdata[2] * u(0) + qdata[4] * u(1) + qdata[5] * u(2);
+         curlshape.AddMult(v, y_e);
+      }
+   }
+}
+
 void CurlCurlNLFIntegratorStateRevSens::AssembleRHSElementVect(
     const mfem::FiniteElement &el,
     mfem::ElementTransformation &trans,
@@ -11641,6 +11953,12 @@ double CAL2CoreLossIntegrator::GetElementEnergy(
 #ifdef MFEM_THREAD_SAFE
    mfem::Vector flux_shape;
    mfem::Vector temp_shape;
+   mfem::Vector temperatures;
+   mfem::Vector peak_fluxes;
+   mfem::Vector freqs;
+   mfem::Vector ip_weights;
+   mfem::Vector kh_vals;
+   mfem::Vector ke_vals;
 #endif
    flux_shape.SetSize(flux_ndof);
    temp_shape.SetSize(temp_ndof);
@@ -11664,34 +11982,44 @@ double CAL2CoreLossIntegrator::GetElementEnergy(
       ir = &IntRules.Get(trans.GetGeometryType(), order);
    }
 
-   // Loop over all integration points and evaluate the CAL2 core losses
-   double fun = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   const int npoints = ir->GetNPoints();
+   temperatures.SetSize(npoints);
+   peak_fluxes.SetSize(npoints);
+   freqs.SetSize(npoints);
+   freqs = freq;
+   ip_weights.SetSize(npoints);
+
+   // Loop over all integration points and interpolate the states, scaling the
+   // quadrature weight by the (constant) material density
+   for (int i = 0; i < npoints; i++)
    {
       // Set the current integration point and quadrature weight
       const IntegrationPoint &ip = ir->IntPoint(i);
       trans.SetIntPoint(&ip);
 
       const double trans_weight = trans.Weight();
-      const double w = ip.weight * trans_weight;
+      const double rho_v = rho.Eval(trans, ip);
+      ip_weights(i) = ip.weight * trans_weight * rho_v;
 
       flux_el.CalcPhysShape(trans, flux_shape);
-      const double B_pk = flux_shape * flux_elfun;
+      peak_fluxes(i) = flux_shape * flux_elfun;
 
       temp_el.CalcPhysShape(trans, temp_shape);
-      const double temperature = temp_shape * temp_elfun;
-
-      const double kh_v = CAL2_kh.Eval(trans, ip, temperature, freq, B_pk);
-      const double ke_v = CAL2_ke.Eval(trans, ip, temperature, freq, B_pk);
+      temperatures(i) = temp_shape * temp_elfun;
+   }
 
-      // Evaluate the material density (constant)
-      const double rho_v = rho.Eval(trans, ip);
+   // Evaluate the CAL2 coefficients for the whole element at once
+   CAL2_kh.EvalBatch(trans, *ir, temperatures, freqs, peak_fluxes, kh_vals);
+   CAL2_ke.EvalBatch(trans, *ir, temperatures, freqs, peak_fluxes, ke_vals);
 
-      // Calculate the CAL2 Core Losses at the integration point
-      const double loss =
-          rho_v * (kh_v * freq * std::pow(B_pk, 2) +
-                   ke_v * std::pow(freq, 2) * std::pow(B_pk, 2));
-      fun += loss * w;
+   // Sum the CAL2 Core Losses over the integration points
+   double fun = 0.0;
+   for (int i = 0; i < npoints; i++)
+   {
+      const double B_pk = peak_fluxes(i);
+      const double loss = kh_vals(i) * freq * std::pow(B_pk, 2) +
+                          ke_vals(i) * std::pow(freq, 2) * std::pow(B_pk, 2);
+      fun += loss * ip_weights(i);
    }
    return fun;
 }
@@ -12288,10 +12616,15 @@ void CAL2CoreLossDistributionIntegrator::AssembleRHSElementVect(
 
 #ifdef MFEM_THREAD_SAFE
    Vector flux_shape;
-   Vector temp_shape;
+   DenseMatrix temp_shapes;
+   Vector temperatures;
+   Vector peak_fluxes;
+   Vector freqs;
+   Vector ip_weights;
+   Vector kh_vals;
+   Vector ke_vals;
 #endif
    flux_shape.SetSize(flux_ndof);
-   temp_shape.SetSize(temp_ndof);
 
    // Set the integration rule
    const IntegrationRule *ir = IntRule;
@@ -12312,39 +12645,54 @@ void CAL2CoreLossDistributionIntegrator::AssembleRHSElementVect(
       ir = &IntRules.Get(temp_el.GetGeomType(), order);
    }
 
-   // Loop over all integration points to get element contributions to heat
-   // flux
-   elvect.SetSize(temp_ndof);
-   elvect = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   const int npoints = ir->GetNPoints();
+   temp_shapes.SetSize(temp_ndof, npoints);
+   temperatures.SetSize(npoints);
+   peak_fluxes.SetSize(npoints);
+   freqs.SetSize(npoints);
+   freqs = freq;
+   ip_weights.SetSize(npoints);
+
+   // Loop over all integration points and interpolate the states, scaling the
+   // quadrature weight by the (constant) material density
+   for (int i = 0; i < npoints; i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
       trans.SetIntPoint(&ip);
 
       const double trans_weight = trans.Weight();
-
-      const double w = ip.weight * trans_weight;
+      const double rho_v = rho.Eval(trans, ip);
+      ip_weights(i) = ip.weight * trans_weight * rho_v;
 
       flux_el.CalcPhysShape(trans, flux_shape);
-      const auto b_mag = flux_shape * flux_elfun;
+      peak_fluxes(i) = flux_shape * flux_elfun;
 
-      temp_el.CalcPhysShape(trans, temp_shape);
-      const double temperature = temp_shape * temp_elfun;
+      Vector temp_shape_ip(temp_shapes.GetColumn(i), temp_ndof);
+      temp_el.CalcPhysShape(trans, temp_shape_ip);
+      temperatures(i) = temp_shape_ip * temp_elfun;
+   }
 
-      auto kh_v = CAL2_kh.Eval(trans, ip, temperature, freq, b_mag);
-      auto ke_v = CAL2_ke.Eval(trans, ip, temperature, freq, b_mag);
+   // Evaluate the CAL2 coefficients for the whole element at once
+   CAL2_kh.EvalBatch(trans, *ir, temperatures, freqs, peak_fluxes, kh_vals);
+   CAL2_ke.EvalBatch(trans, *ir, temperatures, freqs, peak_fluxes, ke_vals);
 
-      // Evaluate the material density (constant)
-      auto rho_v = rho.Eval(trans, ip);
+   // Loop over all integration points to get element contributions to heat
+   // flux
+   elvect.SetSize(temp_ndof);
+   elvect = 0.0;
+   for (int i = 0; i < npoints; i++)
+   {
+      const double b_mag = peak_fluxes(i);
 
       /// TODO: Ensure that the loss (the integrand) is consistent with
       /// conservation of energy
       // The core losses in the element are the local element heat flux
       // contributions
-      double loss = rho_v * kh_v * freq * std::pow(b_mag, 2) +
-                    rho_v * ke_v * std::pow(freq, 2) * std::pow(b_mag, 2);
+      double loss = kh_vals(i) * freq * std::pow(b_mag, 2) +
+                    ke_vals(i) * std::pow(freq, 2) * std::pow(b_mag, 2);
 
-      elvect.Add(loss * w, temp_shape);
+      Vector temp_shape_ip(temp_shapes.GetColumn(i), temp_ndof);
+      elvect.Add(loss * ip_weights(i), temp_shape_ip);
    }
 }
 
@@ -7,9 +7,11 @@
 
 #include "mfem.hpp"
 
+#include "geometric_factor_cache.hpp"
 #include "miso_types.hpp"
 #include "miso_input.hpp"
 #include "miso_integrator.hpp"
+#include "thread_workspaces.hpp"
 
 namespace miso
 {
@@ -55,6 +57,51 @@ double calcMagneticEnergyDoubleDot(mfem::ElementTransformation &trans,
 class NonlinearDiffusionIntegrator : public mfem::NonlinearFormIntegrator
 {
 public:
+   /// \brief Clears the geometric factor cache if the mesh has moved
+   friend void setInputs(NonlinearDiffusionIntegrator &integ,
+                         const MISOInputs &inputs)
+   {
+      setInputs(integ.geom_cache, inputs);
+   }
+
+   /// \brief Enables the geometric factor cache if "geometric-cache" is set
+   friend void setOptions(NonlinearDiffusionIntegrator &integ,
+                          const nlohmann::json &options)
+   {
+      if (options.contains("geometric-cache"))
+      {
+         integ.geom_cache.enable(options["geometric-cache"].get<bool>());
+      }
+   }
+
+   /// \return the number of bytes used by the geometric factor cache
+   friend std::size_t getGeometricCacheMemory(
+       const NonlinearDiffusionIntegrator &integ)
+   {
+      return integ.geom_cache.memoryUsage();
+   }
+
+   /// \brief Give each assembly thread its own workspace
+   /// \return true if elements can be assembled concurrently
+   friend bool prepareThreadedAssembly(NonlinearDiffusionIntegrator &integ,
+                                       int num_threads,
+                                       int num_elements)
+   {
+      return integ.prepareThreads(num_threads, num_elements);
+   }
+
+   /// \brief Assemble the element residual and Jacobian together, evaluating
+   /// the flux and the material model once for both
+   friend void assembleElementVectorAndGrad(NonlinearDiffusionIntegrator &integ,
+                                            const mfem::FiniteElement &el,
+                                            mfem::ElementTransformation &trans,
+                                            const mfem::Vector &elfun,
+                                            mfem::Vector &elvect,
+                                            mfem::DenseMatrix &elmat)
+   {
+      integ.AssembleElementVectorAndGrad(el, trans, elfun, elvect, elmat);
+   }
+
    NonlinearDiffusionIntegrator(StateCoefficient &m, double a = 1.0)
     : model(m), alpha(a)
    { }
@@ -79,16 +126,57 @@ public:
                             const mfem::Vector &elfun,
                             mfem::DenseMatrix &elmat) override;
 
+   /// Construct the element local residual and Jacobian in one pass
+   /// \param[in] el - the finite element whose residual we want
+   /// \param[in] trans - defines the reference to physical element mapping
+   /// \param[in] elfun - element local state vector
+   /// \param[out] elvect - element local residual
+   /// \param[out] elmat - element local Jacobian
+   void AssembleElementVectorAndGrad(const mfem::FiniteElement &el,
+                                     mfem::ElementTransformation &trans,
+                                     const mfem::Vector &elfun,
+                                     mfem::Vector &elvect,
+                                     mfem::DenseMatrix &elmat);
+
 private:
    /// material (thus mesh) dependent model describing electromagnetic behavior
    StateCoefficient &model;
    /// scales the terms; can be used to move to rhs/lhs
    double alpha;
 
+   /// optional per-element store of shape gradients and weights
+   GeometricFactorCache geom_cache;
+
+   /// scratch storage used while assembling a single element
+   struct Workspace
+   {
+      mfem::DenseMatrix point_flux_2_dot;
+      mfem::Vector pointflux_norm_dot;
+      /// geometric factors of the current element when they are not cached
+      ElementGeometricFactors geom_scratch;
+      /// flux and flux magnitude at every integration point
+      mfem::DenseMatrix pointfluxes;
+      mfem::Vector pointflux_mags;
+      /// material model values and derivatives at every integration point
+      mfem::Vector model_vals, model_derivs;
+      /// shape gradients, used by NonlinearDiffusionIntegratorMeshRevSens
+      mfem::DenseMatrix dshape, dshapedxt;
+   };
+
 #ifndef MFEM_THREAD_SAFE
-   mfem::DenseMatrix dshape, dshapedxt, point_flux_2_dot;
-   mfem::Vector pointflux_norm_dot;
+   /// one workspace for each thread assembling elements
+   ThreadWorkspaces<Workspace> workspaces;
 #endif
+
+   /// \brief Set up workspaces and the geometric factor cache for assembly by
+   /// `num_threads` threads
+   /// \return true if elements can be assembled concurrently
+   bool prepareThreads(int num_threads, int num_elements);
+
+   /// \return `IntRule` if set, otherwise the default rule for `el`
+   const mfem::IntegrationRule &integrationRule(
+       const mfem::FiniteElement &el) const;
+
    friend class NonlinearDiffusionIntegratorMeshRevSens;
 };
 
@@ -816,6 +904,58 @@ inline void addDomainSensitivityIntegrator(
 class CurlCurlNLFIntegrator : public mfem::NonlinearFormIntegrator
 {
 public:
+   /// \brief Clears the geometric factor cache if the mesh has moved
+   friend void setInputs(CurlCurlNLFIntegrator &integ, const MISOInputs &inputs)
+   {
+      setInputs(integ.geom_cache, inputs);
+   }
+
+   /// \brief Enables the geometric factor cache if "geometric-cache" is set
+   friend void setOptions(CurlCurlNLFIntegrator &integ,
+                          const nlohmann::json &options)
+   {
+      if (options.contains("geometric-cache"))
+      {
+         integ.geom_cache.enable(options["geometric-cache"].get<bool>());
+      }
+   }
+
+   /// \return the number of bytes used by the geometric factor cache
+   friend std::size_t getGeometricCacheMemory(
+       const CurlCurlNLFIntegrator &integ)
+   {
+      return integ.geom_cache.memoryUsage();
+   }
+
+   /// \brief Give each assembly thread its own workspace
+   /// \return true if elements can be assembled concurrently
+   friend bool prepareThreadedAssembly(CurlCurlNLFIntegrator &integ,
+                                       int num_threads,
+                                       int num_elements)
+   {
+      return integ.prepareThreads(num_threads, num_elements);
+   }
+
+   /// \brief Assemble the element residual and Jacobian together, evaluating
+   /// B, nu(|B|) and dnu/d|B| once for both
+   friend void assembleElementVectorAndGrad(CurlCurlNLFIntegrator &integ,
+                                            const mfem::FiniteElement &el,
+                                            mfem::ElementTransformation &trans,
+                                            const mfem::Vector &elfun,
+                                            mfem::Vector &elvect,
+                                            mfem::DenseMatrix &elmat)
+   {
+      integ.AssembleElementVectorAndGrad(el, trans, elfun, elvect, elmat);
+   }
+
+   /// \return the integration-weighted mean reluctivity of each element at
+   /// the state last passed to `AssembleGradPA`
+   friend const mfem::Vector &getElementReluctivity(
+       const CurlCurlNLFIntegrator &integ)
+   {
+      return integ.pa_element_nu;
+   }
+
    /// Construct a curl curl nonlinear form integrator for Nedelec elements
    /// \param[in] m - model describing nonlinear material parameter
    /// \param[in] a - used to move to lhs or rhs
@@ -843,17 +983,79 @@ public:
                             const mfem::Vector &elfun,
                             mfem::DenseMatrix &elmat) override;
 
+   /// Construct the element local residual and Jacobian in one pass
+   /// \param[in] el - the finite element whose residual we want
+   /// \param[in] trans - defines the reference to physical element mapping
+   /// \param[in] elfun - element local state vector
+   /// \param[out] elvect - element local residual
+   /// \param[out] elmat - element local Jacobian
+   void AssembleElementVectorAndGrad(const mfem::FiniteElement &el,
+                                     mfem::ElementTransformation &trans,
+                                     const mfem::Vector &elfun,
+                                     mfem::Vector &elvect,
+                                     mfem::DenseMatrix &elmat);
+
+   /// Store the quadrature point data needed to apply the Jacobian without
+   /// assembling element matrices
+   /// \param[in] x - element local state vectors of every element of `fes`,
+   /// stored one after another
+   /// \param[in] fes - the finite element space the state lives in
+   /// \note Only 3D meshes made up of a single element type are supported
+   void AssembleGradPA(const mfem::Vector &x,
+                       const mfem::FiniteElementSpace &fes) override;
+
+   /// Apply the Jacobian stored by `AssembleGradPA`
+   /// \param[in] x - element local vectors to apply the Jacobian to, laid out
+   /// like the state given to `AssembleGradPA`
+   /// \param[inout] y - element local vectors the Jacobian's action is added to
+   void AddMultGradPA(const mfem::Vector &x, mfem::Vector &y) const override;
+
 private:
    /// material (thus mesh) dependent model describing electromagnetic behavior
    StateCoefficient &model;
    /// scales the terms; can be used to move to rhs/lhs
    double alpha;
 
+   /// optional per-element store of curl shapes and weights
+   GeometricFactorCache geom_cache;
+
+   /// reference curl shapes at every integration point, stored as an
+   /// (ndof x 3 x npoints) tensor shared by all elements
+   mfem::DenseTensor pa_curlshapes;
+   /// symmetric 3x3 matrix J^T (nu I + dnu/dB / |B| B B^T) J, scaled by the
+   /// integration weight, at every integration point of every element; only
+   /// the six upper triangle entries are stored
+   mfem::Vector pa_qdata;
+   /// integration-weighted mean reluctivity of each element
+   mfem::Vector pa_element_nu;
+
+   /// scratch storage used while assembling a single element
+   struct Workspace
+   {
+      mfem::Vector scratch;
+      /// geometric factors of the current element when they are not cached
+      ElementGeometricFactors geom_scratch;
+      /// flux density and its magnitude at every integration point
+      mfem::DenseMatrix b_vecs;
+      mfem::Vector b_mags;
+      /// material model values and derivatives at every integration point
+      mfem::Vector model_vals, model_derivs;
+   };
+
 #ifndef MFEM_THREAD_SAFE
-   mfem::DenseMatrix curlshape, curlshape_dFt;
-   // mfem::Vector b_vec, b_hat, temp_vec;
-   mfem::Vector scratch;
+   /// one workspace for each thread assembling elements
+   ThreadWorkspaces<Workspace> workspaces;
 #endif
+
+   /// \brief Set up workspaces and the geometric factor cache for assembly by
+   /// `num_threads` threads
+   /// \return true if elements can be assembled concurrently
+   bool prepareThreads(int num_threads, int num_elements);
+
+   /// \return `IntRule` if set, otherwise the default rule for `el`
+   const mfem::IntegrationRule &integrationRule(
+       const mfem::FiniteElement &el) const;
+
    friend class CurlCurlNLFIntegratorMeshRevSens;
 };
 
@@ -3489,6 +3691,9 @@ private:
    mfem::Vector temp_elfun;
    mfem::Vector flux_shape;
    mfem::Vector temp_shape;
+   /// states, integration weights, and CAL2 coefficient values at every
+   /// integration point of the element
+   mfem::Vector temperatures, peak_fluxes, freqs, ip_weights, kh_vals, ke_vals;
 #endif
 
    /// implements frequency sensitivities for CAL2CoreLossIntegrator
@@ -3699,6 +3904,10 @@ private:
    mfem::Vector temp_elfun;
    mfem::Vector flux_shape;
    mfem::Vector temp_shape;
+   /// temperature shape functions, states, integration weights, and CAL2
+   /// coefficient values at every integration point of the element
+   mfem::DenseMatrix temp_shapes;
+   mfem::Vector temperatures, peak_fluxes, freqs, ip_weights, kh_vals, ke_vals;
 #endif
 
    friend class CAL2CoreLossDistributionIntegratorMeshRevSens;
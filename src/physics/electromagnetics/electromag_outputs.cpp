@@ -86,14 +86,29 @@ double calcOutput(DCLossFunctional &output, const MISOInputs &inputs)
 {
    setInputs(output, inputs);
 
-   double rho = calcOutput(output.resistivity, inputs);
+   const double values[] = {calcOutput(output.resistivity, inputs),
+                            calcOutput(output.volume, inputs)};
+   return calcOutputFromFunctionals(output, values);
+}
+
+void addFunctionals(DCLossFunctional &output,
+                    std::vector<FunctionalOutput *> &functionals)
+{
+   functionals.push_back(&output.resistivity);
+   addFunctionals(output.volume, functionals);
+}
+
+double calcOutputFromFunctionals(DCLossFunctional &output,
+                                 const double *values)
+{
+   double rho = values[0];
 
    double strand_area = M_PI * pow(output.strand_radius, 2);
    double R = output.wire_length * rho / (strand_area * output.strands_in_hand);
 
    double loss = pow(output.rms_current, 2) * R * sqrt(2);
 
-   double volume = calcOutput(output.volume, inputs);
+   double volume = values[1];
 
    return loss / volume;
 }
@@ -700,7 +715,22 @@ double calcOutput(ACLossFunctional &output, const MISOInputs &inputs)
    // pv.RegisterField("FluxMag", &flux_mag.gridFunc());
    // pv.Save();
 
-   double sigma_b2 = calcOutput(output.output, output.inputs);
+   const double values[] = {calcOutput(output.output, output.inputs),
+                            calcOutput(output.volume, output.inputs)};
+   return calcOutputFromFunctionals(output, values);
+}
+
+void addFunctionals(ACLossFunctional &output,
+                    std::vector<FunctionalOutput *> &functionals)
+{
+   functionals.push_back(&output.output);
+   addFunctionals(output.volume, functionals);
+}
+
+double calcOutputFromFunctionals(ACLossFunctional &output,
+                                 const double *values)
+{
+   double sigma_b2 = values[0];
 
    double strand_loss = sigma_b2 * output.stack_length * M_PI *
                         pow(output.radius, 4) * pow(2 * M_PI * output.freq, 2) /
@@ -711,7 +741,7 @@ double calcOutput(ACLossFunctional &output, const MISOInputs &inputs)
 
    double loss = num_strands * strand_loss;
 
-   double volume = calcOutput(output.volume, output.inputs);
+   double volume = values[1];
 
    return loss / volume;
 }
@@ -1594,6 +1624,18 @@ double calcOutput(CoreLossFunctional &output, const MISOInputs &inputs)
    return calcOutput(output.output, inputs);
 }
 
+void addFunctionals(CoreLossFunctional &output,
+                    std::vector<FunctionalOutput *> &functionals)
+{
+   functionals.push_back(&output.output);
+}
+
+double calcOutputFromFunctionals(CoreLossFunctional &output,
+                                 const double *values)
+{
+   return values[0];
+}
+
 double jacobianVectorProduct(CoreLossFunctional &output,
                              const mfem::Vector &wrt_dot,
                              const std::string &wrt)
@@ -1769,10 +1811,10 @@ void calcOutput(EMHeatSourceOutput &output,
    out_vec += output.scratch;
    // std::cout << "out_vec norml2 " << out_vec.Norml2() << "\n";
 
-   auto &peak_flux = output.fields.at("peak_flux");
-   miso::ParaViewLogger paraview("peak_flux", &peak_flux.mesh());
-   paraview.registerField("peak_flux", peak_flux.gridFunc());
-   paraview.saveState(peak_flux.gridFunc(), "peak_flux", 0, 0, 0);
+   if (output.diagnostics != nullptr)
+   {
+      output.diagnostics->save();
+   }
 }
 
 void jacobianVectorProduct(EMHeatSourceOutput &output,
@@ -1810,12 +1852,14 @@ EMHeatSourceOutput::EMHeatSourceOutput(
     StateCoefficient &sigma,
     const nlohmann::json &components,
     const nlohmann::json &materials,
-    const nlohmann::json &options)
+    const nlohmann::json &options,
+    AsyncParaViewWriter *diagnostics)
  : dc_loss(fields, sigma, options["dc_loss"]),
    ac_loss(fields, sigma, options["ac_loss"]),
    core_loss(fields, components, materials, options["core_loss"]),
    fields(fields),
-   scratch(getSize(dc_loss))
+   scratch(getSize(dc_loss)),
+   diagnostics(diagnostics)
 { }
 
 void setOptions(PMDemagOutput &output, const nlohmann::json &options)
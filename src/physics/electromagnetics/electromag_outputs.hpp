@@ -11,6 +11,7 @@
 #include "nlohmann/json.hpp"
 
 #include "common_outputs.hpp"
+#include "data_logging.hpp"
 #include "electromag_integ.hpp"
 #include "functional_output.hpp"
 #include "miso_input.hpp"
@@ -41,6 +42,19 @@ public:
       return calcOutput(output.output, inputs);
    }
 
+   friend inline void addFunctionals(
+       ForceFunctional &output,
+       std::vector<FunctionalOutput *> &functionals)
+   {
+      functionals.push_back(&output.output);
+   }
+
+   friend inline double calcOutputFromFunctionals(ForceFunctional &output,
+                                                  const double *values)
+   {
+      return values[0];
+   }
+
    friend inline double calcOutputPartial(ForceFunctional &output,
                                           const std::string &wrt,
                                           const MISOInputs &inputs)
@@ -113,6 +127,19 @@ public:
       return calcOutput(output.output, inputs);
    }
 
+   friend inline void addFunctionals(
+       TorqueFunctional &output,
+       std::vector<FunctionalOutput *> &functionals)
+   {
+      functionals.push_back(&output.output);
+   }
+
+   friend inline double calcOutputFromFunctionals(TorqueFunctional &output,
+                                                  const double *values)
+   {
+      return values[0];
+   }
+
    friend inline double calcOutputPartial(TorqueFunctional &output,
                                           const std::string &wrt,
                                           const MISOInputs &inputs)
@@ -247,6 +274,12 @@ public:
 
    friend double calcOutput(DCLossFunctional &output, const MISOInputs &inputs);
 
+   friend void addFunctionals(DCLossFunctional &output,
+                              std::vector<FunctionalOutput *> &functionals);
+
+   friend double calcOutputFromFunctionals(DCLossFunctional &output,
+                                           const double *values);
+
    friend double jacobianVectorProduct(DCLossFunctional &output,
                                        const mfem::Vector &wrt_dot,
                                        const std::string &wrt);
@@ -354,6 +387,12 @@ public:
 
    friend double calcOutput(ACLossFunctional &output, const MISOInputs &inputs);
 
+   friend void addFunctionals(ACLossFunctional &output,
+                              std::vector<FunctionalOutput *> &functionals);
+
+   friend double calcOutputFromFunctionals(ACLossFunctional &output,
+                                           const double *values);
+
    friend double jacobianVectorProduct(ACLossFunctional &output,
                                        const mfem::Vector &wrt_dot,
                                        const std::string &wrt);
@@ -460,6 +499,12 @@ public:
    friend double calcOutput(CoreLossFunctional &output,
                             const MISOInputs &inputs);
 
+   friend void addFunctionals(CoreLossFunctional &output,
+                              std::vector<FunctionalOutput *> &functionals);
+
+   friend double calcOutputFromFunctionals(CoreLossFunctional &output,
+                                           const double *values);
+
    friend double jacobianVectorProduct(CoreLossFunctional &output,
                                        const mfem::Vector &wrt_dot,
                                        const std::string &wrt);
@@ -605,11 +650,15 @@ public:
                                      const std::string &wrt,
                                      mfem::Vector &wrt_bar);
 
+   /// \param[in] diagnostics - if not null, saves snapshots of the
+   /// "peak_flux" field computed by the core loss; it is not owned, and the
+   /// field must already be registered with it
    EMHeatSourceOutput(std::map<std::string, FiniteElementState> &fields,
                       StateCoefficient &sigma,
                       const nlohmann::json &components,
                       const nlohmann::json &materials,
-                      const nlohmann::json &options);
+                      const nlohmann::json &options,
+                      AsyncParaViewWriter *diagnostics = nullptr);
 
 private:
    DCLossDistribution dc_loss;
@@ -618,6 +667,8 @@ private:
 
    std::map<std::string, FiniteElementState> &fields;
    mfem::Vector scratch;
+   /// saves the peak flux at the cadence it was given, off the calling thread
+   AsyncParaViewWriter *diagnostics;
 };
 
 // Adding an output for the permanent magnet demagnetization constraint equation
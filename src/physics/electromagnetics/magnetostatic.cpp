@@ -1,7 +1,10 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <variant>
+#include <vector>
 
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
@@ -15,6 +18,7 @@
 #include "functional_output.hpp"
 #include "l2_transfer_operator.hpp"
 #include "pde_solver.hpp"
+#include "timers.hpp"
 
 #include "magnetostatic.hpp"
 
@@ -65,6 +69,31 @@ std::vector<int> getCurrentAttributes(nlohmann::json &options)
    return attributes;
 }
 
+/// \return the rotor angles, in degrees, defined by the sweep options
+std::vector<double> getSweepAngles(const nlohmann::json &sweep_options)
+{
+   if (sweep_options.contains("angles"))
+   {
+      return sweep_options["angles"].get<std::vector<double>>();
+   }
+   if (!sweep_options.contains("num-positions") ||
+       !sweep_options.contains("step"))
+   {
+      throw miso::MISOException(
+          "rotor sweep options must contain \"angles\", or "
+          "\"num-positions\" and \"step\"!\n");
+   }
+   const auto num_positions = sweep_options["num-positions"].get<int>();
+   const auto start = sweep_options.value("start", 0.0);
+   const auto step = sweep_options["step"].get<double>();
+   std::vector<double> angles(num_positions);
+   for (int i = 0; i < num_positions; ++i)
+   {
+      angles[i] = start + i * step;
+   }
+   return angles;
+}
+
 }  // anonymous namespace
 
 namespace miso
@@ -98,7 +127,7 @@ MagnetostaticSolver::MagnetostaticSolver(MPI_Comm comm,
        diff_stack, fes(), fields, options, materials, nu));
    miso::setOptions(*spatial_res, options);
 
-   auto *prec = getPreconditioner(*spatial_res);
+   auto *prec = lagPreconditioner(getPreconditioner(*spatial_res));
    auto lin_solver_opts = options["lin-solver"];
    linear_solver = miso::constructLinearSolver(comm, lin_solver_opts, prec);
    auto nonlin_solver_opts = options["nonlin-solver"];
@@ -375,11 +404,27 @@ void MagnetostaticSolver::addOutput(const std::string &fun,
       //    fields.at("peak_flux").gridFunc());
       // }
 
+      // the peak flux is saved off the calling thread, at the cadence set
+      // by "diagnostics-every", and only if ParaView logging is on
+      const auto &paraview = AbstractSolver2::options["paraview"];
+      const int every = paraview.value("diagnostics-every", 1);
+      if (paraview["log"].get<bool>() && every > 0 && !peak_flux_writer)
+      {
+         peak_flux_writer = std::make_unique<AsyncParaViewWriter>(
+             "peak_flux",
+             mesh(),
+             &background_writer,
+             every,
+             AbstractSolver2::options["log-buffers"].get<int>());
+         peak_flux_writer->registerField("peak_flux",
+                                         fields.at("peak_flux").gridFunc());
+      }
       EMHeatSourceOutput out(fields,
                              sigma,
                              AbstractSolver2::options["components"],
                              materials,
-                             options);
+                             options,
+                             peak_flux_writer.get());
       outputs.emplace(fun, std::move(out));
    }
    // else if (fun.rfind("pm_demag", 0) == 0)
@@ -485,6 +530,249 @@ void MagnetostaticSolver::addOutput(const std::string &fun,
    }
 }
 
+std::vector<int> findNodesOfAttributes(mfem::ParFiniteElementSpace &mesh_fes,
+                                       const std::vector<int> &attributes)
+{
+   auto &mesh = *mesh_fes.GetParMesh();
+   mfem::ParGridFunction marker(&mesh_fes);
+   marker = 0.0;
+   mfem::Array<int> vdofs;
+   for (int e = 0; e < mesh.GetNE(); ++e)
+   {
+      if (std::find(attributes.begin(),
+                    attributes.end(),
+                    mesh.GetAttribute(e)) == attributes.end())
+      {
+         continue;
+      }
+      mesh_fes.GetElementVDofs(e, vdofs);
+      for (int vdof : vdofs)
+      {
+         marker(vdof >= 0 ? vdof : -1 - vdof) = 1.0;
+      }
+   }
+   // a node on a processor boundary may only touch the marked elements of
+   // another rank, so sum the markers over the ranks sharing it
+   mfem::Vector marker_tv(mesh_fes.GetTrueVSize());
+   marker.ParallelAssemble(marker_tv);
+   marker.Distribute(marker_tv);
+
+   std::vector<int> dofs;
+   for (int dof = 0; dof < mesh_fes.GetNDofs(); ++dof)
+   {
+      if (marker(mesh_fes.DofToVDof(dof, 0)) > 0.0)
+      {
+         dofs.push_back(dof);
+      }
+   }
+   return dofs;
+}
+
+void rotateNodes(const mfem::ParFiniteElementSpace &mesh_fes,
+                 const std::vector<int> &dofs,
+                 const std::vector<double> &center,
+                 double angle,
+                 const mfem::Vector &ref_coords,
+                 mfem::Vector &coords)
+{
+   coords = ref_coords;
+   const double cos_angle = std::cos(angle * M_PI / 180.0);
+   const double sin_angle = std::sin(angle * M_PI / 180.0);
+   for (int dof : dofs)
+   {
+      const int x_vdof = mesh_fes.DofToVDof(dof, 0);
+      const int y_vdof = mesh_fes.DofToVDof(dof, 1);
+      const double dx = ref_coords(x_vdof) - center[0];
+      const double dy = ref_coords(y_vdof) - center[1];
+      coords(x_vdof) = center[0] + cos_angle * dx - sin_angle * dy;
+      coords(y_vdof) = center[1] + sin_angle * dx + cos_angle * dy;
+   }
+}
+
+nlohmann::json calcSweepStatistics(const std::vector<double> &values)
+{
+   nlohmann::json result{{"values", values},
+                         {"mean", 0.0},
+                         {"min", 0.0},
+                         {"max", 0.0},
+                         {"ripple", 0.0}};
+   if (values.empty())
+   {
+      return result;
+   }
+   double mean = 0.0;
+   for (double value : values)
+   {
+      mean += value;
+   }
+   mean /= static_cast<double>(values.size());
+   const auto [min, max] = std::minmax_element(values.begin(), values.end());
+   result["mean"] = mean;
+   result["min"] = *min;
+   result["max"] = *max;
+   if (std::abs(mean) > 0.0)
+   {
+      result["ripple"] = (*max - *min) / std::abs(mean);
+   }
+   return result;
+}
+
+nlohmann::json MagnetostaticSolver::solveAtRotorPositions(
+    const nlohmann::json &sweep_options,
+    const std::vector<double> &angles,
+    const MISOInputs &inputs,
+    mfem::Vector &state)
+{
+   ScopedTimer timer("solveAtRotorPositions");
+
+   auto &mesh_coords = fields.at("mesh_coords");
+   auto &mesh_fes = mesh_coords.space();
+   if (mesh_fes.GetVDim() < 2)
+   {
+      throw MISOException(
+          "MagnetostaticSolver::solveAtRotorPositions: the rotor can only be "
+          "rotated in 2D or 3D!\n");
+   }
+   // angles are relative to the mesh as it was at the first sweep
+   if (rotor_ref_coords.Size() == 0)
+   {
+      rotor_ref_coords = mesh_coords.gridFunc();
+      rotor_dofs = findNodesOfAttributes(
+          mesh_fes, sweep_options["rotor-attributes"].get<std::vector<int>>());
+   }
+   const auto center =
+       sweep_options.value("center", std::vector<double>{0.0, 0.0});
+
+   const auto &output_options = sweep_options["outputs"];
+   for (const auto &[name, opts] : output_options.items())
+   {
+      if (outputs.count(name) == 0)
+      {
+         createOutput(name, opts);
+      }
+   }
+
+   mfem::ParGridFunction coords(&mesh_fes);
+   mfem::Vector coords_tv(mesh_fes.GetTrueVSize());
+   nlohmann::json values = nlohmann::json::object();
+   for (double angle : angles)
+   {
+      ScopedTimer position_timer("rotor-position");
+
+      rotateNodes(
+          mesh_fes, rotor_dofs, center, angle, rotor_ref_coords, coords);
+      coords.ParallelProject(coords_tv);
+
+      // the state of the previous position is the initial guess
+      auto position_inputs = inputs;
+      position_inputs["state"] = state;
+      position_inputs["mesh_coords"] = coords_tv;
+      solveForState(position_inputs, state);
+
+      for (const auto &[name, opts] : output_options.items())
+      {
+         // the virtual displacements of forces and torques depend on where
+         // the nodes are, so they are projected again
+         if (name.rfind("torque", 0) == 0 || name.rfind("force", 0) == 0)
+         {
+            setOutputOptions(name, opts);
+         }
+         values[name].push_back(calcOutput(name, position_inputs));
+      }
+   }
+   return values;
+}
+
+nlohmann::json sweepRotorPositions(MPI_Comm comm,
+                                   const nlohmann::json &solver_options,
+                                   const nlohmann::json &sweep_options,
+                                   const MISOInputs &inputs,
+                                   std::unique_ptr<mfem::Mesh> smesh)
+{
+   for (const auto &[name, input] : inputs)
+   {
+      if (!std::holds_alternative<double>(input))
+      {
+         throw MISOException(
+             "sweepRotorPositions: input \"" + name +
+             "\" is a vector, but only scalar inputs can be given to the "
+             "solvers of a sweep!\n");
+      }
+   }
+   const auto angles = getSweepAngles(sweep_options);
+   const int num_positions = static_cast<int>(angles.size());
+
+   // split the ranks into groups of consecutive ranks, each of which sweeps
+   // a block of consecutive angles
+   int rank = 0;
+   int num_ranks = 1;
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &num_ranks);
+   const int num_groups = std::max(
+       1,
+       std::min({sweep_options.value("num-groups", 1),
+                 num_ranks,
+                 num_positions}));
+   const int group = rank * num_groups / num_ranks;
+   MPI_Comm group_comm = MPI_COMM_NULL;
+   MPI_Comm_split(comm, group, rank, &group_comm);
+   int group_rank = 0;
+   MPI_Comm_rank(group_comm, &group_rank);
+
+   const int first = group * num_positions / num_groups;
+   const int last = (group + 1) * num_positions / num_groups;
+   const std::vector<double> group_angles(angles.begin() + first,
+                                          angles.begin() + last);
+
+   nlohmann::json group_values;
+   {
+      MagnetostaticSolver solver(group_comm, solver_options, std::move(smesh));
+      mfem::Vector state(solver.getStateSize());
+      state = 0.0;
+      group_values =
+          solver.solveAtRotorPositions(sweep_options, group_angles, inputs,
+                                       state);
+   }
+   MPI_Comm_free(&group_comm);
+
+   // each group's first rank contributes its positions' values
+   const auto &output_options = sweep_options["outputs"];
+   const int num_outputs = static_cast<int>(output_options.size());
+   std::vector<double> all_values(num_outputs * num_positions, 0.0);
+   if (group_rank == 0)
+   {
+      int i = 0;
+      for (const auto &[name, opts] : output_options.items())
+      {
+         for (int j = first; j < last; ++j)
+         {
+            all_values[i * num_positions + j] =
+                group_values[name][j - first].get<double>();
+         }
+         ++i;
+      }
+   }
+   MPI_Allreduce(MPI_IN_PLACE,
+                 all_values.data(),
+                 num_outputs * num_positions,
+                 MPI_DOUBLE,
+                 MPI_SUM,
+                 comm);
+
+   nlohmann::json results{{"angles", angles},
+                          {"outputs", nlohmann::json::object()}};
+   int i = 0;
+   for (const auto &[name, opts] : output_options.items())
+   {
+      const std::vector<double> values(
+          all_values.begin() + i * num_positions,
+          all_values.begin() + (i + 1) * num_positions);
+      results["outputs"][name] = calcSweepStatistics(values);
+      ++i;
+   }
+   return results;
+}
+
 void MagnetostaticSolver::derivedPDETerminalHook(int iter,
                                                  double t_final,
                                                  const mfem::Vector &state)
@@ -2,9 +2,11 @@
 #define MISO_MAGNETOSTATIC
 
 #include <memory>
+#include <vector>
 #include <mpi.h>
 
 #include "coefficient.hpp"
+#include "data_logging.hpp"
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
 
@@ -29,7 +31,34 @@ public:
                        const nlohmann::json &solver_options,
                        std::unique_ptr<mfem::Mesh> smesh = nullptr);
 
+   /// Solve for the state at a sequence of rotor positions, and evaluate the
+   /// sweep's outputs at each of them
+   /// \param[in] sweep_options - defines the rotor and the outputs; see
+   /// `sweepRotorPositions`
+   /// \param[in] angles - rotor angles, in degrees, relative to the mesh as it
+   /// was at the first call
+   /// \param[in] inputs - inputs other than "state" and "mesh_coords", e.g.
+   /// current densities
+   /// \param[inout] state - initial guess for the first position; on exit, the
+   /// state at the last position
+   /// \return the values of each output at each angle, as {output: [values]}
+   /// \note Each Newton solve is warm started from the previous position's
+   /// state, and the forms, linear solver and (lagged) preconditioner are
+   /// reused from one position to the next
+   nlohmann::json solveAtRotorPositions(const nlohmann::json &sweep_options,
+                                        const std::vector<double> &angles,
+                                        const MISOInputs &inputs,
+                                        mfem::Vector &state);
+
 private:
+   /// mesh node coordinates at zero rotor angle, as a local vector
+   mfem::Vector rotor_ref_coords;
+   /// local (scalar) dofs of the mesh nodes that move with the rotor
+   std::vector<int> rotor_dofs;
+   /// saves the peak flux computed by heat source outputs, off the calling
+   /// thread; null unless ParaView logging is on
+   std::unique_ptr<AsyncParaViewWriter> peak_flux_writer;
+
    /// Coefficient representing the potentially nonlinear magnetic reluctivity
    ReluctivityCoefficient nu;
    // /// Material dependent coefficient representing density
@@ -103,6 +132,64 @@ private:
                   const nlohmann::json &options) override;
 };
 
+/// Find the mesh nodes that belong to elements with the given attributes
+/// \param[in] mesh_fes - the space of the mesh nodes
+/// \param[in] attributes - attributes of the elements whose nodes are sought
+/// \return the local scalar dofs of the nodes
+/// \note Collective on the communicator of `mesh_fes`
+std::vector<int> findNodesOfAttributes(mfem::ParFiniteElementSpace &mesh_fes,
+                                       const std::vector<int> &attributes);
+
+/// Rotate some of the mesh nodes rigidly in the x-y plane
+/// \param[in] mesh_fes - the space of the mesh nodes
+/// \param[in] dofs - local scalar dofs of the nodes to rotate
+/// \param[in] center - point in the x-y plane the nodes rotate about
+/// \param[in] angle - rotation angle, in degrees, counterclockwise
+/// \param[in] ref_coords - local node coordinates before the rotation
+/// \param[out] coords - `ref_coords` with the nodes in `dofs` rotated
+void rotateNodes(const mfem::ParFiniteElementSpace &mesh_fes,
+                 const std::vector<int> &dofs,
+                 const std::vector<double> &center,
+                 double angle,
+                 const mfem::Vector &ref_coords,
+                 mfem::Vector &coords);
+
+/// \return {"values", "mean", "min", "max", "ripple"} of an output's values
+/// over a sweep, where "ripple" is (max - min) / |mean|, or zero if the mean is
+/// zero
+nlohmann::json calcSweepStatistics(const std::vector<double> &values);
+
+/// Solve a magnetostatic problem at a sweep of rotor positions, and average
+/// its outputs, e.g. torque and losses, over the positions
+/// \param[in] comm - communicator whose ranks share the sweep
+/// \param[in] solver_options - options for the `MagnetostaticSolver`s
+/// \param[in] sweep_options - defines the sweep, with keys
+///   "rotor-attributes" - attributes of the elements that rotate rigidly;
+///                        elements with other attributes keep their nodes,
+///                        so an air-gap band between them must deform
+///   "center" - point in the x-y plane the rotor rotates about (default 0)
+///   "angles" - rotor angles in degrees, or else "num-positions" angles
+///              from "start" (default 0) in increments of "step"
+///   "outputs" - {name: options} of the outputs to evaluate, e.g. "torque",
+///               "ac_loss" and "core_loss"
+///   "num-groups" - number of sub-communicators that sweep disjoint blocks of
+///                  consecutive angles concurrently (default 1)
+/// \param[in] inputs - scalar inputs to the solvers, e.g. current densities
+/// \param[in] smesh - serial mesh for the solvers (optional)
+/// \return {"angles": [...], "outputs": {name: {"values": [...], "mean",
+/// "min", "max", "ripple"}}}, the same on every rank of `comm`, where
+/// "ripple" is (max - min) / |mean|
+/// \note Each group constructs one solver and warm starts each position from
+/// the last, so groups should hold several consecutive positions each
+/// \note Rotating the rotor deforms the air-gap band, so the angles should
+/// stay within what the band's elements can absorb
+/// \note Collective on `comm`
+nlohmann::json sweepRotorPositions(MPI_Comm comm,
+                                   const nlohmann::json &solver_options,
+                                   const nlohmann::json &sweep_options,
+                                   const MISOInputs &inputs,
+                                   std::unique_ptr<mfem::Mesh> smesh = nullptr);
+
 //    /// Class constructor.
 //    /// \param[in] opt_file_name - file where options are stored
 //    /// \param[in] smesh - if provided, defines the mesh for the problem
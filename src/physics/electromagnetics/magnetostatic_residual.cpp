@@ -46,6 +46,113 @@ std::unique_ptr<mfem::Solver> constructPreconditioner(
    return nullptr;
 }
 
+/// Piecewise constant coefficient that gives every element of a low-order
+/// refined mesh the value of the high-order element it was refined from
+/// \note Relies on `mfem::ParMesh::MakeRefined` numbering the refined
+/// elements of each high-order element consecutively
+class ParentElementCoefficient : public mfem::Coefficient
+{
+public:
+   /// \param[in] values - the value of each high-order element
+   explicit ParentElementCoefficient(const mfem::Vector &values)
+    : values(values)
+   { }
+
+   double Eval(mfem::ElementTransformation &trans,
+               const mfem::IntegrationPoint &ip) override
+   {
+      const int num_elements = trans.mesh->GetNE();
+      const int children = num_elements / values.Size();
+      return values(trans.ElementNo / children);
+   }
+
+private:
+   const mfem::Vector &values;
+};
+
+/// AMS applied to a low-order refined curl-curl operator whose reluctivity is
+/// frozen, element by element, at its value from the last linearization of a
+/// partially assembled Jacobian
+class LORCurlCurlPreconditioner : public mfem::Solver
+{
+public:
+   /// \param[in] fes - the high-order Nedelec space the state lives in
+   /// \param[in] prec_options - the "lin-prec" options
+   /// \param[in] element_nu - reluctivity of each element, updated whenever
+   /// the Jacobian is linearized
+   /// \param[in] ess_tdof_list - the essential true dofs of the state
+   LORCurlCurlPreconditioner(mfem::ParFiniteElementSpace &fes,
+                             const nlohmann::json &prec_options,
+                             const mfem::Vector &element_nu,
+                             const mfem::Array<int> &ess_tdof_list)
+    : mfem::Solver(fes.GetTrueVSize()),
+      fes(fes),
+      printlevel(prec_options["printlevel"].get<int>()),
+      element_nu(element_nu),
+      nu(element_nu),
+      ess_tdof_list(ess_tdof_list),
+      curl_curl(&fes)
+   { }
+
+   /// \brief Reassemble the low-order refined operator at the current
+   /// `element_nu` and set AMS up again; `op` itself is only used to check the
+   /// size of the system
+   /// \note The low-order refined mesh and space, and AMS's discrete gradient,
+   /// are built on the first call and reused afterwards
+   void SetOperator(const mfem::Operator &op) override
+   {
+      if (op.Height() != height)
+      {
+         throw miso::MISOException(
+             "LORCurlCurlPreconditioner: operator size does not match the "
+             "state's finite element space!\n");
+      }
+      if (element_nu.Size() != fes.GetNE())
+      {
+         throw miso::MISOException(
+             "The \"lor-ams\" preconditioner requires the Jacobian to be "
+             "linearized with \"jacobian-assembly\": \"partial\"!\n");
+      }
+
+      if (lor == nullptr)
+      {
+         curl_curl.AddDomainIntegrator(new mfem::CurlCurlIntegrator(nu));
+         lor = std::make_unique<mfem::ParLORDiscretization>(curl_curl,
+                                                            ess_tdof_list);
+         ams = std::make_unique<mfem::HypreAMS>(lor->GetAssembledMatrix(),
+                                                &lor->GetParFESpace());
+         ams->SetPrintLevel(printlevel);
+         ams->SetSingularProblem();
+         return;
+      }
+      lor->AssembleSystem(curl_curl, ess_tdof_list);
+      ams->SetOperator(lor->GetAssembledMatrix());
+   }
+
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override
+   {
+      ams->Mult(x, y);
+   }
+
+private:
+   /// the high-order Nedelec space the state lives in
+   mfem::ParFiniteElementSpace &fes;
+   /// AMS print level
+   int printlevel;
+   /// reluctivity of each high-order element
+   const mfem::Vector &element_nu;
+   /// `element_nu` mapped onto the low-order refined elements
+   ParentElementCoefficient nu;
+   /// the essential true dofs of the state
+   const mfem::Array<int> &ess_tdof_list;
+   /// high-order curl-curl form the low-order refined operator is built from
+   mfem::ParBilinearForm curl_curl;
+   /// low-order refined mesh, space, and operator
+   std::unique_ptr<mfem::ParLORDiscretization> lor;
+   /// AMS on the low-order refined operator
+   std::unique_ptr<mfem::HypreAMS> ams;
+};
+
 std::vector<int> getCurrentAttributes(const nlohmann::json &options)
 {
    std::vector<int> attributes;
@@ -99,6 +206,11 @@ void setOptions(MagnetostaticResidual &residual, const nlohmann::json &options)
    setOptions(*residual.load, options);
 }
 
+std::size_t getGeometricCacheMemory(const MagnetostaticResidual &residual)
+{
+   return getGeometricCacheMemory(residual.res);
+}
+
 void evaluate(MagnetostaticResidual &residual,
               const miso::MISOInputs &inputs,
               mfem::Vector &res_vec)
@@ -120,6 +232,20 @@ void evaluate(MagnetostaticResidual &residual,
    // }
 }
 
+mfem::Operator &evaluateAndLinearize(MagnetostaticResidual &residual,
+                                     const miso::MISOInputs &inputs,
+                                     mfem::Vector &res_vec)
+{
+   auto &jac = evaluateAndLinearize(residual.res, inputs, res_vec);
+   setInputs(*residual.load, inputs);
+   if (residual.current_coeff != nullptr)
+   {
+      setInputs(*residual.current_coeff, inputs);
+   }
+   addLoad(*residual.load, res_vec);
+   return jac;
+}
+
 void linearize(MagnetostaticResidual &residual, const miso::MISOInputs &inputs)
 {
    linearize(residual.res, inputs);
@@ -253,7 +379,16 @@ MagnetostaticResidual::MagnetostaticResidual(
    {
       mesh->RemoveInternalBoundaries();
 
-      res.addDomainIntegrator(new CurlCurlNLFIntegrator(nu));
+      auto *curl_curl = new CurlCurlNLFIntegrator(nu);
+      res.addDomainIntegrator(curl_curl);
+      if (options["lin-prec"]["type"].get<std::string>() == "lor-ams")
+      {
+         prec = std::make_unique<LORCurlCurlPreconditioner>(
+             fes,
+             options["lin-prec"],
+             getElementReluctivity(*curl_curl),
+             res.getEssentialDofs());
+      }
       load = std::make_unique<MISOLoad>(
           MagnetostaticLoad(diff_stack, fes, fields, options, materials, nu));
    }
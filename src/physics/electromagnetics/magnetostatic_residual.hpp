@@ -30,10 +30,19 @@ public:
    friend void setOptions(MagnetostaticResidual &residual,
                           const nlohmann::json &options);
 
+   /// Get the memory used by the residual's geometric factor caches, in bytes
+   friend std::size_t getGeometricCacheMemory(
+       const MagnetostaticResidual &residual);
+
    friend void evaluate(MagnetostaticResidual &residual,
                         const MISOInputs &inputs,
                         mfem::Vector &res_vec);
 
+   /// Evaluate the residual and compute its state Jacobian in one sweep
+   friend mfem::Operator &evaluateAndLinearize(MagnetostaticResidual &residual,
+                                               const MISOInputs &inputs,
+                                               mfem::Vector &res_vec);
+
    friend void linearize(MagnetostaticResidual &residual,
                          const miso::MISOInputs &inputs);
 
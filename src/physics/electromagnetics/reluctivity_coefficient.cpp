@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <string>
@@ -16,6 +17,38 @@ namespace
 constexpr double mu_0 = 4e-7 * M_PI;
 constexpr double nu0 = 1 / mu_0;
 
+/// Piecewise polynomial representation of a scalar B-spline
+/// \note The B-spline is converted to a Taylor expansion about the midpoint of
+/// each non-degenerate knot span, so evaluating the spline and its first two
+/// derivatives only requires locating the span and a single Horner sweep. No
+/// memory is allocated during evaluation.
+class PiecewisePolynomialSpline
+{
+public:
+   /// \brief Tabulate the polynomial pieces of a scalar B-spline
+   /// \param[in] spline - the B-spline to tabulate
+   explicit PiecewisePolynomialSpline(const tinyspline::BSpline &spline);
+
+   /// \brief Evaluate the spline and its first two derivatives at x
+   /// \param[in] x - the location to evaluate the spline at
+   /// \param[out] f - the value of the spline at x
+   /// \param[out] dfdx - the first derivative of the spline at x
+   /// \param[out] d2fdx2 - the second derivative of the spline at x
+   /// \note values of x outside of the spline's domain are extrapolated using
+   /// the polynomial from the nearest knot span
+   void eval(double x, double &f, double &dfdx, double &d2fdx2) const;
+
+private:
+   /// degree of the polynomial on each knot span
+   int degree;
+   /// left end of each knot span, followed by the right end of the last span
+   std::vector<double> breaks;
+   /// midpoint of each knot span, the expansion point for its polynomial
+   std::vector<double> mids;
+   /// Taylor coefficients for each knot span, stored contiguously by span
+   std::vector<double> coeffs;
+};
+
 class logNuBBSplineReluctivityCoefficient : public miso::StateCoefficient
 {
 public:
@@ -24,9 +57,12 @@ public:
    /// \param[in] cps - spline control points -> nu ~ exp(cps)
    /// \param[in] knots - spline knot vector -> B ~ knots
    /// \param[in] degree - degree of B-Spline curve
+   /// \param[in] tabulate - if true, evaluate the spline using a precomputed
+   /// piecewise polynomial table instead of de Boor's algorithm
    logNuBBSplineReluctivityCoefficient(const std::vector<double> &cps,
                                        const std::vector<double> &knots,
-                                       int degree = 3);
+                                       int degree = 3,
+                                       bool tabulate = false);
 
    /// \brief Evaluate the reluctivity in the element described by trans at the
    /// point ip.
@@ -57,6 +93,25 @@ public:
                     mfem::DenseMatrix &PointMat_bar) override
    { }
 
+   /// \brief Evaluate the reluctivity at every integration point in ir
+   /// \note If the spline has been tabulated the evaluation does not depend on
+   /// trans, and the points are evaluated in a single loop over the table
+   void EvalBatch(mfem::ElementTransformation &trans,
+                  const mfem::IntegrationRule &ir,
+                  const mfem::Vector &states,
+                  mfem::Vector &values) override;
+
+   /// \brief Evaluate the reluctivity and its derivative with respect to B at
+   /// every integration point in ir
+   void EvalStateDerivBatch(mfem::ElementTransformation &trans,
+                            const mfem::IntegrationRule &ir,
+                            const mfem::Vector &states,
+                            mfem::Vector &values,
+                            mfem::Vector &derivs) override;
+
+   /// \brief Evaluation only reads the splines, so it is thread-safe
+   bool isThreadSafe() const override { return true; }
+
 protected:
    /// max nu value in the data
    double lognu_max;
@@ -68,6 +123,9 @@ protected:
    std::unique_ptr<tinyspline::BSpline> dlognudb;
    /// spline representing d2log(nu)/dB2
    std::unique_ptr<tinyspline::BSpline> d2lognudb2;
+   /// optional piecewise polynomial table representing log(nu) and its
+   /// derivatives
+   std::unique_ptr<PiecewisePolynomialSpline> lognu_table;
 };
 
 class BHBSplineReluctivityCoefficient : public miso::StateCoefficient
@@ -77,9 +135,12 @@ public:
    /// extrapolation at the far end
    /// \param[in] B - magnetic flux density values from B-H curve
    /// \param[in] H - magnetic field intensity valyes from B-H curve
+   /// \param[in] tabulate - if true, evaluate the spline using a precomputed
+   /// piecewise polynomial table instead of de Boor's algorithm
    BHBSplineReluctivityCoefficient(const std::vector<double> &cps,
                                    const std::vector<double> &knots,
-                                   int degree = 3);
+                                   int degree = 3,
+                                   bool tabulate = false);
 
    /// \brief Evaluate the reluctivity in the element described by trans at the
    /// point ip.
@@ -106,6 +167,25 @@ public:
                     mfem::DenseMatrix &PointMat_bar) override
    { }
 
+   /// \brief Evaluate the reluctivity at every integration point in ir
+   /// \note If the spline has been tabulated the evaluation does not depend on
+   /// trans, and the points are evaluated in a single loop over the table
+   void EvalBatch(mfem::ElementTransformation &trans,
+                  const mfem::IntegrationRule &ir,
+                  const mfem::Vector &states,
+                  mfem::Vector &values) override;
+
+   /// \brief Evaluate the reluctivity and its derivative with respect to
+   /// magnetic flux at every integration point in ir
+   void EvalStateDerivBatch(mfem::ElementTransformation &trans,
+                            const mfem::IntegrationRule &ir,
+                            const mfem::Vector &states,
+                            mfem::Vector &values,
+                            mfem::Vector &derivs) override;
+
+   /// \brief Evaluation only reads the splines, so it is thread-safe
+   bool isThreadSafe() const override { return true; }
+
    // ~BHBSplineReluctivityCoefficient() override;
 
 protected:
@@ -117,6 +197,9 @@ protected:
    std::unique_ptr<tinyspline::BSpline> bh;
    /// spline representing dH(B)/dB
    std::unique_ptr<tinyspline::BSpline> dbdh;
+   /// optional piecewise polynomial table representing H(B) and its
+   /// derivatives
+   std::unique_ptr<PiecewisePolynomialSpline> bh_table;
 };
 
 class team13ReluctivityCoefficient : public miso::StateCoefficient
@@ -225,8 +308,9 @@ std::unique_ptr<mfem::Coefficient> constructReluctivityCoeff(
             int degree = 0;
             getCpsKnotsAndDegree(
                 material, materials, nu_model, cps, knots, degree);
+            auto tabulate = material["reluctivity"].value("tabulate", false);
             temp_coeff = std::make_unique<logNuBBSplineReluctivityCoefficient>(
-                cps, knots, degree);
+                cps, knots, degree, tabulate);
          }
          else if (nu_model == "bh")
          {
@@ -235,8 +319,9 @@ std::unique_ptr<mfem::Coefficient> constructReluctivityCoeff(
             int degree = 0;
             getCpsKnotsAndDegree(
                 material, materials, nu_model, cps, knots, degree);
+            auto tabulate = material["reluctivity"].value("tabulate", false);
             temp_coeff = std::make_unique<BHBSplineReluctivityCoefficient>(
-                cps, knots, degree);
+                cps, knots, degree, tabulate);
          }
          else if (nu_model == "team13")
          {
@@ -338,6 +423,24 @@ void ReluctivityCoefficient::EvalRevDiff(const double Q_bar,
    nu.EvalRevDiff(Q_bar, trans, ip, state, PointMat_bar);
 }
 
+void ReluctivityCoefficient::EvalBatch(mfem::ElementTransformation &trans,
+                                       const mfem::IntegrationRule &ir,
+                                       const mfem::Vector &states,
+                                       mfem::Vector &values)
+{
+   nu.EvalBatch(trans, ir, states, values);
+}
+
+void ReluctivityCoefficient::EvalStateDerivBatch(
+    mfem::ElementTransformation &trans,
+    const mfem::IntegrationRule &ir,
+    const mfem::Vector &states,
+    mfem::Vector &values,
+    mfem::Vector &derivs)
+{
+   nu.EvalStateDerivBatch(trans, ir, states, values, derivs);
+}
+
 ReluctivityCoefficient::ReluctivityCoefficient(const nlohmann::json &nu_options,
                                                const nlohmann::json &materials)
  : nu(std::make_unique<mfem::ConstantCoefficient>(1.0 / mu_0))
@@ -369,10 +472,80 @@ ReluctivityCoefficient::ReluctivityCoefficient(const nlohmann::json &nu_options,
 
 namespace
 {
+PiecewisePolynomialSpline::PiecewisePolynomialSpline(
+    const tinyspline::BSpline &spline)
+ : degree(static_cast<int>(spline.degree()))
+{
+   const auto knots = spline.knots();
+   const auto n_cps = knots.size() - degree - 1;
+
+   /// Taylor coefficients are f^(k)(mid) / k!, so evaluate the spline and
+   /// each of its derivatives at the midpoint of every non-degenerate span
+   std::vector<tinyspline::BSpline> derivs{spline};
+   for (int k = 1; k <= degree; ++k)
+   {
+      derivs.push_back(derivs.back().derive());
+   }
+
+   for (std::size_t i = degree; i < n_cps; ++i)
+   {
+      if (knots[i + 1] <= knots[i])
+      {
+         continue;
+      }
+      const double mid = 0.5 * (knots[i] + knots[i + 1]);
+      breaks.push_back(knots[i]);
+      mids.push_back(mid);
+
+      double factorial = 1.0;
+      for (int k = 0; k <= degree; ++k)
+      {
+         if (k > 0)
+         {
+            factorial *= k;
+         }
+         coeffs.push_back(derivs[k].eval(mid).result()[0] / factorial);
+      }
+   }
+   if (mids.empty())
+   {
+      throw miso::MISOException(
+          "PiecewisePolynomialSpline: spline has no non-degenerate knot "
+          "spans!\n");
+   }
+   breaks.push_back(knots[n_cps]);
+}
+
+void PiecewisePolynomialSpline::eval(double x,
+                                     double &f,
+                                     double &dfdx,
+                                     double &d2fdx2) const
+{
+   /// find the knot span containing x, clamping to the first and last spans
+   const auto span_begin = breaks.begin() + 1;
+   const auto span_end = breaks.end() - 1;
+   const auto span = std::upper_bound(span_begin, span_end, x) - span_begin;
+
+   const double s = x - mids[span];
+   const double *c = coeffs.data() + span * (degree + 1);
+
+   /// Horner's rule for the polynomial and its first two derivatives
+   f = 0.0;
+   dfdx = 0.0;
+   d2fdx2 = 0.0;
+   for (int k = degree; k >= 0; --k)
+   {
+      d2fdx2 = d2fdx2 * s + 2.0 * dfdx;
+      dfdx = dfdx * s + f;
+      f = f * s + c[k];
+   }
+}
+
 logNuBBSplineReluctivityCoefficient::logNuBBSplineReluctivityCoefficient(
     const std::vector<double> &cps,
     const std::vector<double> &knots,
-    int degree)
+    int degree,
+    bool tabulate)
  : lognu_max(cps[cps.size() - 1]),
    b_max(knots[knots.size() - 1]),
    lognu(std::make_unique<tinyspline::BSpline>(cps.size(), 1, degree))
@@ -381,6 +554,12 @@ logNuBBSplineReluctivityCoefficient::logNuBBSplineReluctivityCoefficient(
    lognu->setKnots(knots);
 
    dlognudb = std::make_unique<tinyspline::BSpline>(lognu->derive());
+   d2lognudb2 = std::make_unique<tinyspline::BSpline>(dlognudb->derive());
+
+   if (tabulate)
+   {
+      lognu_table = std::make_unique<PiecewisePolynomialSpline>(*lognu);
+   }
 }
 
 double logNuBBSplineReluctivityCoefficient::Eval(
@@ -390,6 +569,14 @@ double logNuBBSplineReluctivityCoefficient::Eval(
 {
    if (state <= b_max)
    {
+      if (lognu_table != nullptr)
+      {
+         double lognu_val = 0.0;
+         double dlognudb_val = 0.0;
+         double d2lognudb2_val = 0.0;
+         lognu_table->eval(state, lognu_val, dlognudb_val, d2lognudb2_val);
+         return exp(lognu_val);
+      }
       double nu = exp(lognu->eval(state).result()[0]);
       return nu;
    }
@@ -413,6 +600,14 @@ double logNuBBSplineReluctivityCoefficient::EvalStateDeriv(
 
    if (state <= b_max)
    {
+      if (lognu_table != nullptr)
+      {
+         double lognu_val = 0.0;
+         double dlognudb_val = 0.0;
+         double d2lognudb2_val = 0.0;
+         lognu_table->eval(state, lognu_val, dlognudb_val, d2lognudb2_val);
+         return exp(lognu_val) * dlognudb_val;
+      }
       double nu = exp(lognu->eval(state).result()[0]);
       double dnudb = nu * dlognudb->eval(state).result()[0];
       return dnudb;
@@ -428,10 +623,6 @@ double logNuBBSplineReluctivityCoefficient::EvalState2ndDeriv(
     const mfem::IntegrationPoint &ip,
     const double state)
 {
-   if (d2lognudb2 == nullptr)
-   {
-      d2lognudb2 = std::make_unique<tinyspline::BSpline>(dlognudb->derive());
-   }
    if (state > b_max)
    {
       std::cout << "lognu state: " << state;
@@ -439,6 +630,15 @@ double logNuBBSplineReluctivityCoefficient::EvalState2ndDeriv(
       std::cout << "\n";
    }
 
+   if (state <= b_max && lognu_table != nullptr)
+   {
+      double lognu_val = 0.0;
+      double dlognudb_val = 0.0;
+      double d2lognudb2_val = 0.0;
+      lognu_table->eval(state, lognu_val, dlognudb_val, d2lognudb2_val);
+      return exp(lognu_val) * (d2lognudb2_val + pow(dlognudb_val, 2));
+   }
+
    if (state <= b_max)
    {
       double lognu_val = lognu->eval(state).result()[0];
@@ -458,6 +658,74 @@ double logNuBBSplineReluctivityCoefficient::EvalState2ndDeriv(
    }
 }
 
+void logNuBBSplineReluctivityCoefficient::EvalBatch(
+    mfem::ElementTransformation &trans,
+    const mfem::IntegrationRule &ir,
+    const mfem::Vector &states,
+    mfem::Vector &values)
+{
+   if (lognu_table == nullptr)
+   {
+      StateCoefficient::EvalBatch(trans, ir, states, values);
+      return;
+   }
+
+   const int npoints = states.Size();
+   values.SetSize(npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const double state = states(i);
+      if (state <= b_max)
+      {
+         double lognu_val = 0.0;
+         double dlognudb_val = 0.0;
+         double d2lognudb2_val = 0.0;
+         lognu_table->eval(state, lognu_val, dlognudb_val, d2lognudb2_val);
+         values(i) = exp(lognu_val);
+      }
+      else
+      {
+         values(i) = nu0;
+      }
+   }
+}
+
+void logNuBBSplineReluctivityCoefficient::EvalStateDerivBatch(
+    mfem::ElementTransformation &trans,
+    const mfem::IntegrationRule &ir,
+    const mfem::Vector &states,
+    mfem::Vector &values,
+    mfem::Vector &derivs)
+{
+   if (lognu_table == nullptr)
+   {
+      StateCoefficient::EvalStateDerivBatch(trans, ir, states, values, derivs);
+      return;
+   }
+
+   const int npoints = states.Size();
+   values.SetSize(npoints);
+   derivs.SetSize(npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const double state = states(i);
+      if (state <= b_max)
+      {
+         double lognu_val = 0.0;
+         double dlognudb_val = 0.0;
+         double d2lognudb2_val = 0.0;
+         lognu_table->eval(state, lognu_val, dlognudb_val, d2lognudb2_val);
+         values(i) = exp(lognu_val);
+         derivs(i) = values(i) * dlognudb_val;
+      }
+      else
+      {
+         values(i) = nu0;
+         derivs(i) = 0.0;
+      }
+   }
+}
+
 // double logNuBBSplineReluctivityCoefficient::EvalState2ndDeriv(
 //     mfem::ElementTransformation &trans,
 //     const mfem::IntegrationPoint &ip,
@@ -481,7 +749,8 @@ double logNuBBSplineReluctivityCoefficient::EvalState2ndDeriv(
 BHBSplineReluctivityCoefficient::BHBSplineReluctivityCoefficient(
     const std::vector<double> &cps,
     const std::vector<double> &knots,
-    int degree)
+    int degree,
+    bool tabulate)
  // : b_max(B[B.size()-1]), nu(H.size(), 1, 3)
  : h_max(cps[cps.size() - 1]),
    b_max(knots[knots.size() - 1]),
@@ -497,6 +766,11 @@ BHBSplineReluctivityCoefficient::BHBSplineReluctivityCoefficient(
 
    dbdh = std::make_unique<tinyspline::BSpline>(bh->derive());
    // dnudb = nu.derive();
+
+   if (tabulate)
+   {
+      bh_table = std::make_unique<PiecewisePolynomialSpline>(*bh);
+   }
 }
 
 double BHBSplineReluctivityCoefficient::Eval(mfem::ElementTransformation &trans,
@@ -505,6 +779,19 @@ double BHBSplineReluctivityCoefficient::Eval(mfem::ElementTransformation &trans,
 {
    constexpr double nu0 = 1 / (4e-7 * M_PI);
    // std::cout << "eval state state: " << state << "\n";
+   if (state <= b_max && bh_table != nullptr)
+   {
+      double t = state / b_max;
+      double h = 0.0;
+      double dhdt = 0.0;
+      double d2hdt2 = 0.0;
+      bh_table->eval(t, h, dhdt, d2hdt2);
+      if (state <= 1e-14)
+      {
+         return dhdt / b_max;
+      }
+      return h / state;
+   }
    if (state <= 1e-14)
    {
       double t = state / b_max;
@@ -532,6 +819,15 @@ double BHBSplineReluctivityCoefficient::EvalStateDeriv(
    constexpr double nu0 = 1 / (4e-7 * M_PI);
 
    /// TODO: handle state == 0
+   if (state <= b_max && bh_table != nullptr)
+   {
+      double t = state / b_max;
+      double h = 0.0;
+      double dhdt = 0.0;
+      double d2hdt2 = 0.0;
+      bh_table->eval(t, h, dhdt, d2hdt2);
+      return dhdt / (state * b_max) - h / pow(state, 2);
+   }
    if (state <= b_max)
    {
       double t = state / b_max;
@@ -544,6 +840,76 @@ double BHBSplineReluctivityCoefficient::EvalStateDeriv(
    }
 }
 
+void BHBSplineReluctivityCoefficient::EvalBatch(
+    mfem::ElementTransformation &trans,
+    const mfem::IntegrationRule &ir,
+    const mfem::Vector &states,
+    mfem::Vector &values)
+{
+   if (bh_table == nullptr)
+   {
+      StateCoefficient::EvalBatch(trans, ir, states, values);
+      return;
+   }
+
+   const int npoints = states.Size();
+   values.SetSize(npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const double state = states(i);
+      if (state <= b_max)
+      {
+         double t = state / b_max;
+         double h = 0.0;
+         double dhdt = 0.0;
+         double d2hdt2 = 0.0;
+         bh_table->eval(t, h, dhdt, d2hdt2);
+         values(i) = state <= 1e-14 ? dhdt / b_max : h / state;
+      }
+      else
+      {
+         values(i) = (h_max - nu0 * b_max) / state + nu0;
+      }
+   }
+}
+
+void BHBSplineReluctivityCoefficient::EvalStateDerivBatch(
+    mfem::ElementTransformation &trans,
+    const mfem::IntegrationRule &ir,
+    const mfem::Vector &states,
+    mfem::Vector &values,
+    mfem::Vector &derivs)
+{
+   if (bh_table == nullptr)
+   {
+      StateCoefficient::EvalStateDerivBatch(trans, ir, states, values, derivs);
+      return;
+   }
+
+   const int npoints = states.Size();
+   values.SetSize(npoints);
+   derivs.SetSize(npoints);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const double state = states(i);
+      if (state <= b_max)
+      {
+         double t = state / b_max;
+         double h = 0.0;
+         double dhdt = 0.0;
+         double d2hdt2 = 0.0;
+         bh_table->eval(t, h, dhdt, d2hdt2);
+         values(i) = state <= 1e-14 ? dhdt / b_max : h / state;
+         derivs(i) = dhdt / (state * b_max) - h / pow(state, 2);
+      }
+      else
+      {
+         values(i) = (h_max - nu0 * b_max) / state + nu0;
+         derivs(i) = -(h_max - nu0 * b_max) / pow(state, 2);
+      }
+   }
+}
+
 // BHBSplineReluctivityCoefficient::~BHBSplineReluctivityCoefficient() =
 // default;
 
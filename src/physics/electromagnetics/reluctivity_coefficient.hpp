@@ -40,6 +40,19 @@ public:
                     double state,
                     mfem::DenseMatrix &PointMat_bar) override;
 
+   void EvalBatch(mfem::ElementTransformation &trans,
+                  const mfem::IntegrationRule &ir,
+                  const mfem::Vector &states,
+                  mfem::Vector &values) override;
+
+   void EvalStateDerivBatch(mfem::ElementTransformation &trans,
+                            const mfem::IntegrationRule &ir,
+                            const mfem::Vector &states,
+                            mfem::Vector &values,
+                            mfem::Vector &derivs) override;
+
+   bool isThreadSafe() const override { return nu.isThreadSafe(); }
+
    ReluctivityCoefficient(const nlohmann::json &nu_options,
                           const nlohmann::json &materials);
 
@@ -0,0 +1,212 @@
+#include <algorithm>
+
+#include "mfem.hpp"
+
+#include "utils.hpp"
+#include "fixed_sparsity_par_matrix.hpp"
+
+namespace miso
+{
+FixedSparsityParMatrix::FixedSparsityParMatrix(
+    mfem::ParFiniteElementSpace &fes,
+    bool transpose)
+ : fes(fes), transpose(transpose)
+{
+   if (fes.GetParMesh()->Nonconforming())
+   {
+      throw MISOException(
+          "FixedSparsityParMatrix does not support nonconforming meshes!\n");
+   }
+}
+
+FixedSparsityParMatrix::~FixedSparsityParMatrix()
+{
+   mat.reset();
+   if (ij != nullptr)
+   {
+      HYPRE_IJMatrixDestroy(ij);
+   }
+}
+
+mfem::HypreParMatrix &FixedSparsityParMatrix::assemble(
+    const mfem::SparseMatrix &local)
+{
+   if (ij == nullptr || !samePattern(local))
+   {
+      create(local);
+   }
+   else
+   {
+      /// keep the structure, and with it the communication pattern, of the
+      /// assembled matrix; only its values are reset
+      HYPRE_IJMatrixSetConstantValues(ij, 0.0);
+      HYPRE_IJMatrixInitialize(ij);
+   }
+
+   const double *values = local.GetData();
+   if (transpose)
+   {
+      /// gather the values in the row order of the transposed matrix
+      ij_values.SetSize(trans_perm.Size());
+      for (int k = 0; k < trans_perm.Size(); ++k)
+      {
+         ij_values(k) = values[trans_perm[k]];
+      }
+      values = ij_values.GetData();
+   }
+   if (ij_rows.Size() > 0)
+   {
+      HYPRE_IJMatrixAddToValues(ij,
+                                ij_rows.Size(),
+                                ij_ncols.GetData(),
+                                ij_rows.GetData(),
+                                ij_cols.GetData(),
+                                values);
+   }
+   HYPRE_IJMatrixAssemble(ij);
+   wrap();
+   return *mat;
+}
+
+bool FixedSparsityParMatrix::samePattern(const mfem::SparseMatrix &local) const
+{
+   const int height = local.Height();
+   if (height != local_I.Size() - 1)
+   {
+      return false;
+   }
+   const int *row_ptr = local.GetI();
+   if (!std::equal(row_ptr, row_ptr + height + 1, local_I.begin()))
+   {
+      return false;
+   }
+   const int *col_ind = local.GetJ();
+   return std::equal(col_ind, col_ind + row_ptr[height], local_J.begin());
+}
+
+void FixedSparsityParMatrix::create(const mfem::SparseMatrix &local)
+{
+   if (ij != nullptr)
+   {
+      HYPRE_IJMatrixDestroy(ij);
+   }
+
+   const int local_height = local.Height();
+   const int local_nnz = local.GetI()[local_height];
+   local_I.SetSize(local_height + 1);
+   std::copy(local.GetI(), local.GetI() + local_height + 1, local_I.begin());
+   local_J.SetSize(local_nnz);
+   std::copy(local.GetJ(), local.GetJ() + local_nnz, local_J.begin());
+
+   global_tdofs.SetSize(local_height);
+   for (int i = 0; i < local_height; ++i)
+   {
+      global_tdofs[i] = fes.GetGlobalTDofNumber(i);
+   }
+   if (transpose)
+   {
+      buildTransposedRows(local);
+   }
+   else
+   {
+      buildRows(local);
+   }
+
+   const HYPRE_BigInt first = fes.GetMyTDofOffset();
+   const HYPRE_BigInt last = first + fes.GetTrueVSize() - 1;
+   HYPRE_IJMatrixCreate(fes.GetComm(), first, last, first, last, &ij);
+   HYPRE_IJMatrixSetObjectType(ij, HYPRE_PARCSR);
+   HYPRE_IJMatrixInitialize(ij);
+   ++structure_builds;
+}
+
+void FixedSparsityParMatrix::buildRows(const mfem::SparseMatrix &local)
+{
+   const int *row_ptr = local.GetI();
+   const int *col_ind = local.GetJ();
+   ij_rows.SetSize(0);
+   ij_ncols.SetSize(0);
+   ij_cols.SetSize(row_ptr[local.Height()]);
+   for (int i = 0; i < local.Height(); ++i)
+   {
+      const int ncols = row_ptr[i + 1] - row_ptr[i];
+      if (ncols == 0)
+      {
+         continue;
+      }
+      ij_rows.Append(global_tdofs[i]);
+      ij_ncols.Append(ncols);
+      for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k)
+      {
+         ij_cols[k] = global_tdofs[col_ind[k]];
+      }
+   }
+   trans_perm.SetSize(0);
+}
+
+void FixedSparsityParMatrix::buildTransposedRows(
+    const mfem::SparseMatrix &local)
+{
+   const int height = local.Height();
+   const int *row_ptr = local.GetI();
+   const int *col_ind = local.GetJ();
+   const int nnz = row_ptr[height];
+
+   /// row pointers of the transposed local matrix, from the column counts
+   mfem::Array<int> trans_ptr(local.Width() + 1);
+   trans_ptr = 0;
+   for (int k = 0; k < nnz; ++k)
+   {
+      ++trans_ptr[col_ind[k] + 1];
+   }
+   for (int j = 0; j < local.Width(); ++j)
+   {
+      trans_ptr[j + 1] += trans_ptr[j];
+   }
+
+   /// scatter each entry to its place in the transposed rows, remembering
+   /// where its value comes from
+   mfem::Array<int> next(local.Width());
+   std::copy(trans_ptr.begin(), trans_ptr.end() - 1, next.begin());
+   ij_cols.SetSize(nnz);
+   trans_perm.SetSize(nnz);
+   for (int i = 0; i < height; ++i)
+   {
+      for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k)
+      {
+         const int dest = next[col_ind[k]]++;
+         ij_cols[dest] = global_tdofs[i];
+         trans_perm[dest] = k;
+      }
+   }
+
+   ij_rows.SetSize(0);
+   ij_ncols.SetSize(0);
+   for (int j = 0; j < local.Width(); ++j)
+   {
+      const int ncols = trans_ptr[j + 1] - trans_ptr[j];
+      if (ncols > 0)
+      {
+         ij_rows.Append(global_tdofs[j]);
+         ij_ncols.Append(ncols);
+      }
+   }
+}
+
+void FixedSparsityParMatrix::wrap()
+{
+   hypre_ParCSRMatrix *par_mat = nullptr;
+   HYPRE_IJMatrixGetObject(ij, reinterpret_cast<void **>(&par_mat));
+   if (mat == nullptr)
+   {
+      mat = std::make_unique<mfem::HypreParMatrix>(par_mat, false);
+   }
+   else if (static_cast<hypre_ParCSRMatrix *>(*mat) != par_mat)
+   {
+      /// the structure was rebuilt; point the existing wrapper at the new
+      /// matrix so that references handed out by earlier assemblies stay valid
+      mat->WrapHypreParCSRMatrix(par_mat, false);
+   }
+}
+
+}  // namespace miso
@@ -0,0 +1,94 @@
+#ifndef MISO_FIXED_SPARSITY_PAR_MATRIX
+#define MISO_FIXED_SPARSITY_PAR_MATRIX
+
+#include <memory>
+
+#include "mfem.hpp"
+
+namespace miso
+{
+/// \brief Parallel matrix P^T A P (or its transpose) assembled from a matrix A
+/// on the local dofs through hypre's IJ interface
+/// \note After the first assembly the CSR structure and communication pattern
+/// of the parallel matrix are kept, and later assemblies only overwrite its
+/// values in place. The structure is rebuilt if the sparsity of A changes.
+/// The HypreParMatrix returned by `assemble` is the same object every time, so
+/// references to it stay valid across assemblies.
+/// \note Only conforming spaces are supported, whose prolongation P maps each
+/// local dof to exactly one true dof
+class FixedSparsityParMatrix
+{
+public:
+   /// \param[in] fes - the finite element space of the rows and columns
+   /// \param[in] transpose - if true, assemble (P^T A P)^T
+   FixedSparsityParMatrix(mfem::ParFiniteElementSpace &fes,
+                          bool transpose = false);
+
+   ~FixedSparsityParMatrix();
+
+   FixedSparsityParMatrix(const FixedSparsityParMatrix &) = delete;
+   FixedSparsityParMatrix &operator=(const FixedSparsityParMatrix &) = delete;
+
+   /// \brief Overwrite the parallel matrix's values with those of `local`
+   /// \param[in] local - finalized matrix on the local dofs
+   /// \return the parallel matrix, which stays owned by this object
+   mfem::HypreParMatrix &assemble(const mfem::SparseMatrix &local);
+
+   /// \return the parallel matrix from the last call to `assemble`
+   mfem::HypreParMatrix &matrix() { return *mat; }
+
+   /// \return the number of times the parallel structure has been built
+   int numStructureBuilds() const { return structure_builds; }
+
+private:
+   /// the finite element space of the rows and columns
+   mfem::ParFiniteElementSpace &fes;
+   /// if true, the transposed matrix is assembled
+   bool transpose;
+
+   /// hypre's assembly object, which owns the parallel matrix
+   HYPRE_IJMatrix ij = nullptr;
+   /// MFEM wrapper of the parallel matrix owned by `ij`
+   std::unique_ptr<mfem::HypreParMatrix> mat;
+   /// the global true dof of each local dof
+   mfem::Array<HYPRE_BigInt> global_tdofs;
+   /// row pointers and column indices of the local matrix the structure was
+   /// built for
+   mfem::Array<int> local_I;
+   mfem::Array<int> local_J;
+   /// number of times the parallel structure has been built
+   int structure_builds = 0;
+
+   /// the local matrix's entries batched by row of the parallel matrix, so
+   /// that each assembly adds all of them with one call into hypre: the
+   /// global index and number of entries of each nonempty row, and the global
+   /// column index of each entry
+   mfem::Array<HYPRE_BigInt> ij_rows;
+   mfem::Array<HYPRE_Int> ij_ncols;
+   mfem::Array<HYPRE_BigInt> ij_cols;
+   /// for the transpose, the index in the local matrix's values of each entry
+   /// in `ij_cols`
+   mfem::Array<int> trans_perm;
+   /// work storage for the values of the transpose, in the order of `ij_cols`
+   mfem::Vector ij_values;
+
+   /// \return true if `local` has the sparsity the structure was built for
+   bool samePattern(const mfem::SparseMatrix &local) const;
+
+   /// \brief Create a new, empty hypre IJ matrix
+   void create(const mfem::SparseMatrix &local);
+
+   /// \brief Batch the entries of `local` by row of the parallel matrix
+   void buildRows(const mfem::SparseMatrix &local);
+
+   /// \brief Batch the entries of `local` by row of the transposed parallel
+   /// matrix
+   void buildTransposedRows(const mfem::SparseMatrix &local);
+
+   /// \brief Point `mat` at the parallel matrix currently owned by `ij`
+   void wrap();
+};
+
+}  // namespace miso
+
+#endif
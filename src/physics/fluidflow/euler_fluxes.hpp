@@ -7,6 +7,7 @@
 
 #include "adept.h"
 
+#include "simd_pack.hpp"
 #include "utils.hpp"
 
 using adept::adouble;
@@ -361,6 +362,26 @@ xdouble logavg(const xdouble &aL, const xdouble &aR)
    return (aL + aR) / (2.0 * F);
 }
 
+namespace simd
+{
+/// Log-average of each lane of `aL` and `aR`
+/// \note Found by argument-dependent lookup when the flux functions are
+/// instantiated with `Pack<W>`; both branches of the scalar version are
+/// evaluated and the lanes are selected without branching
+template <int W>
+Pack<W> logavg(const Pack<W> &aL, const Pack<W> &aR)
+{
+   Pack<W> xi = aL / aR;
+   Pack<W> f = (xi - 1.0) / (xi + 1.0);
+   Pack<W> u = f * f;
+   Pack<W> F_series =
+       1.0 + u * (1. / 3. + u * (1. / 5. + u * (1. / 7. + u / 9.)));
+   Pack<W> F_log = (log(xi) / 2.0) / f;
+   Pack<W> F = selectLess(u, 1.0e-3, F_series, F_log);
+   return (aL + aR) / (2.0 * F);
+}
+}  // namespace simd
+
 /// Ismail-Roe two-point (dyadic) entropy conservative flux function
 /// \param[in] di - physical coordinate direction in which flux is wanted
 /// \param[in] qL - conservative variables at "left" state
@@ -1212,6 +1233,131 @@ void calcIsmailRoeFaceFluxWithDissUsingEntVars(const xdouble *dir,
    }
 }
 
+/// Load `n` packs from structure-of-arrays data
+/// \param[in] data - `data[k * W + l]` is entry `k` of problem `l`
+/// \param[in] n - number of entries of each problem
+/// \param[out] packs - `packs[k]` holds entry `k` of the `W` problems
+template <int W>
+inline void loadPacks(const double *data, int n, simd::Pack<W> *packs)
+{
+   for (int k = 0; k < n; ++k)
+   {
+      packs[k] = simd::Pack<W>::load(data + k * W);
+   }
+}
+
+/// Store `n` packs as structure-of-arrays data; the inverse of `loadPacks`
+template <int W>
+inline void storePacks(const simd::Pack<W> *packs, int n, double *data)
+{
+   for (int k = 0; k < n; ++k)
+   {
+      packs[k].store(data + k * W);
+   }
+}
+
+/// Ismail-Roe flux function for `W` pairs of states at once
+/// \param[in] di - physical coordinate direction in which flux is wanted
+/// \param[in] qL - "left" states; `qL[k * W + l]` is variable `k` of pair `l`
+/// \param[in] qR - "right" states, in the same layout as `qL`
+/// \param[out] flux - fluxes in the direction `di`, in the same layout
+/// \tparam dim - number of spatial dimensions (1, 2, or 3)
+/// \tparam entvar - if true, the states are entropy variables
+/// \tparam W - number of pairs, i.e. of SIMD lanes
+template <int dim, bool entvar = false, int W = simd::default_width>
+void calcIsmailRoeFluxBatch(int di,
+                            const double *qL,
+                            const double *qR,
+                            double *flux)
+{
+   using pack = simd::Pack<W>;
+   pack qL_p[dim + 2];
+   pack qR_p[dim + 2];
+   pack flux_p[dim + 2];
+   loadPacks(qL, dim + 2, qL_p);
+   loadPacks(qR, dim + 2, qR_p);
+   if constexpr (entvar)
+   {
+      calcIsmailRoeFluxUsingEntVars<pack, dim>(di, qL_p, qR_p, flux_p);
+   }
+   else
+   {
+      calcIsmailRoeFlux<pack, dim>(di, qL_p, qR_p, flux_p);
+   }
+   storePacks(flux_p, dim + 2, flux);
+}
+
+/// Ismail-Roe face flux with dissipation for `W` pairs of states at once
+/// \param[in] dir - directions; `dir[k * W + l]` is component `k` of pair `l`
+/// \param[in] diss_coeff - scales the dissipation (must be non-negative!)
+/// \param[in] qL - "left" states, in the same layout as `dir`
+/// \param[in] qR - "right" states, in the same layout as `dir`
+/// \param[out] flux - fluxes in the directions `dir`, in the same layout
+/// \tparam dim - number of spatial dimensions (1, 2, or 3)
+/// \tparam entvar - if true, the states are entropy variables
+/// \tparam W - number of pairs, i.e. of SIMD lanes
+template <int dim, bool entvar = false, int W = simd::default_width>
+void calcIsmailRoeFaceFluxWithDissBatch(const double *dir,
+                                        double diss_coeff,
+                                        const double *qL,
+                                        const double *qR,
+                                        double *flux)
+{
+   using pack = simd::Pack<W>;
+   pack dir_p[dim];
+   pack qL_p[dim + 2];
+   pack qR_p[dim + 2];
+   pack flux_p[dim + 2];
+   loadPacks(dir, dim, dir_p);
+   loadPacks(qL, dim + 2, qL_p);
+   loadPacks(qR, dim + 2, qR_p);
+   if constexpr (entvar)
+   {
+      calcIsmailRoeFaceFluxWithDissUsingEntVars<pack, dim>(
+          dir_p, diss_coeff, qL_p, qR_p, flux_p);
+   }
+   else
+   {
+      calcIsmailRoeFaceFluxWithDiss<pack, dim>(
+          dir_p, diss_coeff, qL_p, qR_p, flux_p);
+   }
+   storePacks(flux_p, dim + 2, flux);
+}
+
+/// Applies the LPS scaling of `applyLPSScaling` to `W` nodes at once
+/// \param[in] adjJ - transposed adjugates of the mapping Jacobian;
+/// `adjJ[k * W + l]` is entry `k` of node `l`
+/// \param[in] q - states at the nodes, in the same layout as `adjJ`
+/// \param[in] vec - the vectors being multiplied, in the same layout
+/// \param[out] mat_vec - the results, in the same layout
+/// \tparam dim - number of spatial dimensions (1, 2, or 3)
+/// \tparam entvar - if true, the states are entropy variables
+/// \tparam W - number of nodes, i.e. of SIMD lanes
+template <int dim, bool entvar = false, int W = simd::default_width>
+void applyLPSScalingBatch(const double *adjJ,
+                          const double *q,
+                          const double *vec,
+                          double *mat_vec)
+{
+   using pack = simd::Pack<W>;
+   pack adjJ_p[dim * dim];
+   pack q_p[dim + 2];
+   pack vec_p[dim + 2];
+   pack mat_vec_p[dim + 2];
+   loadPacks(adjJ, dim * dim, adjJ_p);
+   loadPacks(q, dim + 2, q_p);
+   loadPacks(vec, dim + 2, vec_p);
+   if constexpr (entvar)
+   {
+      applyLPSScalingUsingEntVars<pack, dim>(adjJ_p, q_p, vec_p, mat_vec_p);
+   }
+   else
+   {
+      applyLPSScaling<pack, dim>(adjJ_p, q_p, vec_p, mat_vec_p);
+   }
+   storePacks(mat_vec_p, dim + 2, mat_vec);
+}
+
 template <typename xdouble, int dim, bool entvar = false>
 void calcFarFieldFlux2(const xdouble *dir,
                        const xdouble *qbnd,
@@ -7,6 +7,7 @@
 #include "inviscid_integ.hpp"
 #include "euler_fluxes.hpp"
 #include "miso_input.hpp"
+#include "sbp_fe.hpp"
 
 namespace miso
 {
@@ -50,6 +51,16 @@ public:
                          const mfem::Vector &q,
                          mfem::DenseMatrix &flux_jac);
 
+   /// Compute the Euler flux and its Jacobian w.r.t. `q` in one evaluation
+   /// \param[in] dir - desired direction (scaled) for the flux
+   /// \param[in] q - state at which to evaluate the flux and its Jacobian
+   /// \param[out] flux - fluxes in the direction `dir`
+   /// \param[out] flux_jac - Jacobian of the flux function w.r.t. `q`
+   void calcFluxAndJacState(const mfem::Vector &dir,
+                            const mfem::Vector &q,
+                            mfem::Vector &flux,
+                            mfem::DenseMatrix &flux_jac);
+
    /// Compute the Jacobian of the flux function `flux` w.r.t. `dir`
    /// \parma[in] dir - desired direction for the flux
    /// \param[in] q - state at which to evaluate the flux Jacobian
@@ -86,6 +97,16 @@ public:
                            mfem::ElementTransformation &trans,
                            const mfem::Vector &elfun) override;
 
+   /// Construct the element local residual with the batched flux kernel
+   /// \param[in] el - the finite element whose residual we want
+   /// \param[in] trans - defines the reference to physical element mapping
+   /// \param[in] elfun - element local state function
+   /// \param[out] elvect - element local residual
+   void AssembleElementVector(const mfem::FiniteElement &el,
+                              mfem::ElementTransformation &trans,
+                              const mfem::Vector &elfun,
+                              mfem::Vector &elvect) override;
+
    /// Ismail-Roe two-point (dyadic) entropy conservative flux function
    /// \param[in] di - physical coordinate direction in which flux is wanted
    /// \param[in] qL - state variables at "left" state
@@ -108,8 +129,40 @@ public:
                           const mfem::Vector &qR,
                           mfem::DenseMatrix &jacL,
                           mfem::DenseMatrix &jacR);
+
+   /// Compute the Ismail-Roe flux and its Jacobians in one evaluation
+   /// \param[in] di - desired coordinate direction for flux
+   /// \param[in] qL - the "left" state
+   /// \param[in] qR - the "right" state
+   /// \param[out] flux - fluxes in the direction `di`
+   /// \param[out] jacL - Jacobian of `flux` w.r.t. `qL`
+   /// \param[out] jacR - Jacobian of `flux` w.r.t. `qR`
+   void calcFluxAndJacStates(int di,
+                             const mfem::Vector &qL,
+                             const mfem::Vector &qR,
+                             mfem::Vector &flux,
+                             mfem::DenseMatrix &jacL,
+                             mfem::DenseMatrix &jacR);
 };
 
+/// Add the Ismail-Roe volume residual of an SBP element to `res`, evaluating
+/// the fluxes of `W` node pairs at a time with `calcIsmailRoeFluxBatch`
+/// \param[in] sbp - the SBP element
+/// \param[in] skew - skew entries of the element's node pairs, as computed
+/// by `SBPFiniteElement::getSkewEntries`
+/// \param[in] u - `num_nodes` x `dim + 2` states at the nodes
+/// \param[in] alpha - scales the residual
+/// \param[in,out] res - `num_nodes` x `dim + 2` residual that is added to
+/// \tparam dim - number of spatial dimensions (1, 2, or 3)
+/// \tparam entvar - if true, the states are entropy variables
+/// \tparam W - number of node pairs evaluated at once
+template <int dim, bool entvar = false, int W = simd::default_width>
+void addIsmailRoeElementResidual(const mfem::SBPFiniteElement &sbp,
+                                 const mfem::DenseMatrix &skew,
+                                 const mfem::DenseMatrix &u,
+                                 double alpha,
+                                 mfem::DenseMatrix &res);
+
 /// Integrator for entropy stable local-projection stabilization
 /// \tparam dim - number of spatial dimensions (1, 2, or 3)
 /// \tparam entvar - if true, the state variables are the entropy variables
@@ -163,6 +216,17 @@ public:
                      const mfem::Vector &vec,
                      mfem::Vector &mat_vec);
 
+   /// Applies `applyScaling` at every node of an element, `W` nodes at a time
+   /// \param[in] adjJ - adjugates of the mapping Jacobian at the nodes
+   /// \param[in] q - `num_nodes` x `num_states` states at the nodes
+   /// \param[in] vec - `num_states` x `num_nodes` vectors being multiplied
+   /// \param[out] mat_vec - `num_states` x `num_nodes` results
+   /// \note a wrapper for `applyLPSScalingBatch` in `euler_fluxes.hpp`
+   void applyScalingNodes(const std::vector<mfem::DenseMatrix> &adjJ,
+                          const mfem::DenseMatrix &q,
+                          const mfem::DenseMatrix &vec,
+                          mfem::DenseMatrix &mat_vec);
+
    /// Computes the Jacobian of the product `A(adjJ,q)*v` w.r.t. `q`
    /// \param[in] adjJ - adjugate of the mapping Jacobian
    /// \param[in] q - state at which `dQ/dW` and radius are evaluated
@@ -717,6 +781,17 @@ public:
                  const mfem::Vector &qR,
                  mfem::Vector &flux);
 
+   /// Compute the interface flux at every face node, `W` nodes at a time
+   /// \param[in] dir - `dim` x `num_nodes` vectors normal to the interface
+   /// \param[in] qL - `num_states` x `num_nodes` "left" states
+   /// \param[in] qR - `num_states` x `num_nodes` "right" states
+   /// \param[out] flux - `num_states` x `num_nodes` values of the flux
+   /// \note wrapper for `calcIsmailRoeFaceFluxWithDissBatch`
+   void calcFluxNodes(const mfem::DenseMatrix &dir,
+                      const mfem::DenseMatrix &qL,
+                      const mfem::DenseMatrix &qR,
+                      mfem::DenseMatrix &flux);
+
    /// Compute the Jacobian of the interface flux function w.r.t. states
    /// \param[in] dir - vector normal to the face
    /// \param[in] qL - "left" state at which to evaluate the flux
@@ -1,9 +1,13 @@
 #ifndef MISO_EULER_INTEG_DEF
 #define MISO_EULER_INTEG_DEF
 
+#include <algorithm>
+#include <vector>
+
 #include "adept.h"
 #include "mfem.hpp"
 
+#include "dual_number.hpp"
 #include "inviscid_integ.hpp"
 #include "euler_fluxes.hpp"
 #include "euler_integ.hpp"
@@ -17,22 +21,34 @@ void EulerIntegrator<dim>::calcFluxJacState(const mfem::Vector &dir,
                                             const mfem::Vector &q,
                                             mfem::DenseMatrix &flux_jac)
 {
-   // declare vectors of active input variables
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // copy data from mfem::Vector
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start recording
-   this->stack.new_recording();
-   // the depedent variable must be declared after the recording
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcEulerFlux<adouble, dim>(dir_a.data(), q_a.data(), flux_a.data());
-   // set the independent and dependent variable
-   this->stack.independent(q_a.data(), q.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   // calculate the jacobian w.r.t state vaiables
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers avoid recording an Adept tape; the q
+   // derivatives are seeded and the Jacobian is read off the flux
+   using dual_t = Dual<dim + 2>;
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcEulerFlux<dual_t, dim>(dir_d, q_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, flux_jac.GetData());
+}
+
+template <int dim>
+void EulerIntegrator<dim>::calcFluxAndJacState(const mfem::Vector &dir,
+                                               const mfem::Vector &q,
+                                               mfem::Vector &flux,
+                                               mfem::DenseMatrix &flux_jac)
+{
+   // the values of the dual flux are the flux itself
+   using dual_t = Dual<dim + 2>;
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcEulerFlux<dual_t, dim>(dir_d, q_d, flux_d);
+   getDualValues(flux_d, dim + 2, flux.GetData());
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, flux_jac.GetData());
 }
 
 template <int dim>
@@ -40,21 +56,15 @@ void EulerIntegrator<dim>::calcFluxJacDir(const mfem::Vector &dir,
                                           const mfem::Vector &q,
                                           mfem::DenseMatrix &flux_jac)
 {
-   // declare vectors of active input variables
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // copy data from mfem::Vector
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start recording
-   this->stack.new_recording();
-   // the depedent variable must be declared after the recording
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcEulerFlux<adouble, dim>(dir_a.data(), q_a.data(), flux_a.data());
-   this->stack.independent(dir_a.data(), dir.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   // calculate the jacobian w.r.t state vaiables
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the dir derivatives seeded
+   using dual_t = Dual<dim>;
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   seedDual(dir.GetData(), dim, 0, dir_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcEulerFlux<dual_t, dim>(dir_d, q_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -83,6 +93,32 @@ double IsmailRoeIntegrator<dim, entvar>::GetElementEnergy(
    return ent_change;
 }
 
+template <int dim, bool entvar>
+void IsmailRoeIntegrator<dim, entvar>::AssembleElementVector(
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::Vector &elfun,
+    mfem::Vector &elvect)
+{
+   const auto &sbp = dynamic_cast<const mfem::SBPFiniteElement &>(el);
+   int num_nodes = sbp.GetDof();
+#ifdef MFEM_THREAD_SAFE
+   std::vector<mfem::DenseMatrix> adjJ_nodes;
+   mfem::DenseMatrix skew;
+#else
+   auto &adjJ_nodes = this->adjJ_nodes;
+   auto &skew = this->skew;
+#endif
+   // contract the adjugates with the operators once for the whole element
+   calcNodalAdjugates(el, trans, adjJ_nodes);
+   sbp.getSkewEntries(adjJ_nodes, skew);
+   elvect.SetSize((dim + 2) * num_nodes);
+   elvect = 0.0;
+   mfem::DenseMatrix u(elfun.GetData(), num_nodes, dim + 2);
+   mfem::DenseMatrix res(elvect.GetData(), num_nodes, dim + 2);
+   addIsmailRoeElementResidual<dim, entvar>(sbp, skew, u, this->alpha, res);
+}
+
 template <int dim, bool entvar>
 void IsmailRoeIntegrator<dim, entvar>::calcFlux(int di,
                                                 const mfem::Vector &qL,
@@ -109,39 +145,105 @@ void IsmailRoeIntegrator<dim, entvar>::calcFluxJacStates(
     mfem::DenseMatrix &jacL,
     mfem::DenseMatrix &jacR)
 {
-   // store the full jacobian in jac
-   mfem::DenseMatrix jac(dim + 2, 2 * (dim + 2));
-   // vector of active input variables
-   std::vector<adouble> qL_a(qL.Size());
-   std::vector<adouble> qR_a(qR.Size());
-   // initialize adouble inputs
-   adept::set_values(qL_a.data(), qL.Size(), qL.GetData());
-   adept::set_values(qR_a.data(), qR.Size(), qR.GetData());
-   // start recording
-   this->stack.new_recording();
-   // create vector of active output variables
-   std::vector<adouble> flux_a(qL.Size());
-   // run algorithm
+   // forward-mode dual numbers with the derivatives of both states seeded
+   using dual_t = Dual<2 * (dim + 2)>;
+   dual_t qL_d[dim + 2];
+   dual_t qR_d[dim + 2];
+   seedDual(qL.GetData(), dim + 2, 0, qL_d);
+   seedDual(qR.GetData(), dim + 2, dim + 2, qR_d);
+   dual_t flux_d[dim + 2];
    if constexpr (entvar)
    {
-      miso::calcIsmailRoeFluxUsingEntVars<adouble, dim>(
-          di, qL_a.data(), qR_a.data(), flux_a.data());
+      miso::calcIsmailRoeFluxUsingEntVars<dual_t, dim>(di, qL_d, qR_d, flux_d);
    }
    else
    {
-      miso::calcIsmailRoeFlux<adouble, dim>(
-          di, qL_a.data(), qR_a.data(), flux_a.data());
+      miso::calcIsmailRoeFlux<dual_t, dim>(di, qL_d, qR_d, flux_d);
    }
-   // identify independent and dependent variables
-   this->stack.independent(qL_a.data(), qL.Size());
-   this->stack.independent(qR_a.data(), qR.Size());
-   this->stack.dependent(flux_a.data(), qL.Size());
-   // compute and store jacobian in jac
-   this->stack.jacobian_reverse(jac.GetData());
-   // retrieve the jacobian w.r.t left state
-   jacL.CopyCols(jac, 0, dim + 1);
-   // retrieve the jacobian w.r.t right state
-   jacR.CopyCols(jac, dim + 2, 2 * (dim + 2) - 1);
+   // retrieve the jacobians w.r.t the left and right states
+   jacL.SetSize(dim + 2);
+   jacR.SetSize(dim + 2);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, jacL.GetData());
+   getDualJacobian(flux_d, dim + 2, dim + 2, dim + 2, jacR.GetData());
+}
+
+template <int dim, bool entvar>
+void IsmailRoeIntegrator<dim, entvar>::calcFluxAndJacStates(
+    int di,
+    const mfem::Vector &qL,
+    const mfem::Vector &qR,
+    mfem::Vector &flux,
+    mfem::DenseMatrix &jacL,
+    mfem::DenseMatrix &jacR)
+{
+   // as calcFluxJacStates, but the flux is also read off the dual values
+   using dual_t = Dual<2 * (dim + 2)>;
+   dual_t qL_d[dim + 2];
+   dual_t qR_d[dim + 2];
+   seedDual(qL.GetData(), dim + 2, 0, qL_d);
+   seedDual(qR.GetData(), dim + 2, dim + 2, qR_d);
+   dual_t flux_d[dim + 2];
+   if constexpr (entvar)
+   {
+      miso::calcIsmailRoeFluxUsingEntVars<dual_t, dim>(di, qL_d, qR_d, flux_d);
+   }
+   else
+   {
+      miso::calcIsmailRoeFlux<dual_t, dim>(di, qL_d, qR_d, flux_d);
+   }
+   flux.SetSize(dim + 2);
+   jacL.SetSize(dim + 2);
+   jacR.SetSize(dim + 2);
+   getDualValues(flux_d, dim + 2, flux.GetData());
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, jacL.GetData());
+   getDualJacobian(flux_d, dim + 2, dim + 2, dim + 2, jacR.GetData());
+}
+
+template <int dim, bool entvar, int W>
+void addIsmailRoeElementResidual(const mfem::SBPFiniteElement &sbp,
+                                 const mfem::DenseMatrix &skew,
+                                 const mfem::DenseMatrix &u,
+                                 double alpha,
+                                 mfem::DenseMatrix &res)
+{
+   constexpr int num_states = dim + 2;
+   const auto &pairs = sbp.getSkewPairs();
+   const int num_pairs = static_cast<int>(pairs.size());
+   // the nodes of pairs p0, ..., p0 + W - 1 fill the lanes
+   double qL[num_states * W];
+   double qR[num_states * W];
+   double flux[num_states * W];
+   double Sij[W];
+   for (int p0 = 0; p0 < num_pairs; p0 += W)
+   {
+      // unused lanes repeat the last pair, and get a zero operator entry
+      const int lanes = std::min(W, num_pairs - p0);
+      for (int n = 0; n < num_states; ++n)
+      {
+         for (int l = 0; l < W; ++l)
+         {
+            const auto &pair = pairs[p0 + std::min(l, lanes - 1)];
+            qL[n * W + l] = u(pair.i, n);
+            qR[n * W + l] = u(pair.j, n);
+         }
+      }
+      for (int di = 0; di < dim; ++di)
+      {
+         for (int l = 0; l < W; ++l)
+         {
+            Sij[l] = l < lanes ? alpha * skew(p0 + l, di) : 0.0;
+         }
+         calcIsmailRoeFluxBatch<dim, entvar, W>(di, qL, qR, flux);
+         for (int n = 0; n < num_states; ++n)
+         {
+            for (int l = 0; l < lanes; ++l)
+            {
+               res(pairs[p0 + l].i, n) += Sij[l] * flux[n * W + l];
+               res(pairs[p0 + l].j, n) -= Sij[l] * flux[n * W + l];
+            }
+         }
+      }  // di loop
+   }     // pair batch loop
 }
 
 template <int dim, bool entvar>
@@ -192,21 +294,13 @@ void EntStableLPSIntegrator<dim, entvar>::convertVarsJacState(
    }
    else
    {
-      // vector of active input variables
-      std::vector<adouble> q_a(q.Size());
-      // initialize adouble inputs
-      adept::set_values(q_a.data(), q.Size(), q.GetData());
-      // start recording
-      this->stack.new_recording();
-      // create vector of active output variables
-      std::vector<adouble> w_a(q.Size());
-      // run algorithm
-      calcEntropyVars<adouble, dim, entvar>(q_a.data(), w_a.data());
-      // identify independent and dependent variables
-      this->stack.independent(q_a.data(), q.Size());
-      this->stack.dependent(w_a.data(), q.Size());
-      // compute and store jacobian in dwdu
-      this->stack.jacobian(dwdu.GetData());
+      // forward-mode dual numbers with the q derivatives seeded
+      using dual_t = Dual<dim + 2>;
+      dual_t q_d[dim + 2];
+      seedDual(q.GetData(), dim + 2, 0, q_d);
+      dual_t w_d[dim + 2];
+      calcEntropyVars<dual_t, dim, entvar>(q_d, w_d);
+      getDualJacobian(w_d, dim + 2, 0, dim + 2, dwdu.GetData());
    }
 }
 
@@ -229,6 +323,50 @@ void EntStableLPSIntegrator<dim, entvar>::applyScaling(
    }
 }
 
+template <int dim, bool entvar>
+void EntStableLPSIntegrator<dim, entvar>::applyScalingNodes(
+    const std::vector<mfem::DenseMatrix> &adjJ,
+    const mfem::DenseMatrix &q,
+    const mfem::DenseMatrix &vec,
+    mfem::DenseMatrix &mat_vec)
+{
+   constexpr int num_states = dim + 2;
+   constexpr int W = simd::default_width;
+   const int num_nodes = vec.Width();
+   double adjJ_batch[dim * dim * W];
+   double q_batch[num_states * W];
+   double vec_batch[num_states * W];
+   double mat_vec_batch[num_states * W];
+   for (int i0 = 0; i0 < num_nodes; i0 += W)
+   {
+      // lanes past the last node repeat it; their results are discarded
+      const int num_lanes = std::min(W, num_nodes - i0);
+      for (int l = 0; l < W; ++l)
+      {
+         const int i = i0 + std::min(l, num_lanes - 1);
+         const double *adjJ_i = adjJ[i].GetData();
+         for (int k = 0; k < dim * dim; ++k)
+         {
+            adjJ_batch[k * W + l] = adjJ_i[k];
+         }
+         for (int k = 0; k < num_states; ++k)
+         {
+            q_batch[k * W + l] = q(i, k);
+            vec_batch[k * W + l] = vec(k, i);
+         }
+      }
+      applyLPSScalingBatch<dim, entvar, W>(
+          adjJ_batch, q_batch, vec_batch, mat_vec_batch);
+      for (int l = 0; l < num_lanes; ++l)
+      {
+         for (int k = 0; k < num_states; ++k)
+         {
+            mat_vec(k, i0 + l) = mat_vec_batch[k * W + l];
+         }
+      }
+   }
+}
+
 template <int dim, bool entvar>
 void EntStableLPSIntegrator<dim, entvar>::applyScalingJacState(
     const mfem::DenseMatrix &adjJ,
@@ -236,34 +374,24 @@ void EntStableLPSIntegrator<dim, entvar>::applyScalingJacState(
     const mfem::Vector &vec,
     mfem::DenseMatrix &mat_vec_jac)
 {
-   // declare vectors of active input variables
-   int adjJ_a_size = adjJ.Height() * adjJ.Width();
-   std::vector<adouble> adjJ_a(adjJ_a_size);
-   std::vector<adouble> q_a(q.Size());
-   std::vector<adouble> vec_a(vec.Size());
-   // copy data from mfem::Vector
-   adept::set_values(adjJ_a.data(), adjJ_a_size, adjJ.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   adept::set_values(vec_a.data(), vec.Size(), vec.GetData());
-   // start recording
-   this->stack.new_recording();
-   // the dependent variable must be declared after the recording
-   std::vector<adouble> mat_vec_a(q.Size());
-   if (entvar)
+   // forward-mode dual numbers with the q derivatives seeded
+   using dual_t = Dual<dim + 2>;
+   dual_t adjJ_d[dim * dim];
+   dual_t q_d[dim + 2];
+   dual_t vec_d[dim + 2];
+   setDualValues(adjJ.GetData(), dim * dim, adjJ_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   setDualValues(vec.GetData(), dim + 2, vec_d);
+   dual_t mat_vec_d[dim + 2];
+   if constexpr (entvar)
    {
-      applyLPSScalingUsingEntVars<adouble, dim>(
-          adjJ_a.data(), q_a.data(), vec_a.data(), mat_vec_a.data());
+      applyLPSScalingUsingEntVars<dual_t, dim>(adjJ_d, q_d, vec_d, mat_vec_d);
    }
    else
    {
-      applyLPSScaling<adouble, dim>(
-          adjJ_a.data(), q_a.data(), vec_a.data(), mat_vec_a.data());
+      applyLPSScaling<dual_t, dim>(adjJ_d, q_d, vec_d, mat_vec_d);
    }
-   // set the independent and dependent variable
-   this->stack.independent(q_a.data(), q.Size());
-   this->stack.dependent(mat_vec_a.data(), q.Size());
-   // Calculate the jabobian
-   this->stack.jacobian(mat_vec_jac.GetData());
+   getDualJacobian(mat_vec_d, dim + 2, 0, dim + 2, mat_vec_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -273,32 +401,24 @@ void EntStableLPSIntegrator<dim, entvar>::applyScalingJacAdjJ(
     const mfem::Vector &vec,
     mfem::DenseMatrix &mat_vec_jac)
 {
-   // create containers for active double objects
-   std::vector<adouble> adjJ_a(adjJ.Height() * adjJ.Width());
-   std::vector<adouble> q_a(q.Size());
-   std::vector<adouble> vec_a(vec.Size());
-   // initialize active double containers with input data
-   adept::set_values(
-       adjJ_a.data(), adjJ.Height() * adjJ.Width(), adjJ.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   adept::set_values(vec_a.data(), vec.Size(), vec.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double mat_vec output
-   std::vector<adouble> mat_vec_a(q.Size());
-   if (entvar)
+   // forward-mode dual numbers with the adjJ derivatives seeded
+   using dual_t = Dual<dim * dim>;
+   dual_t adjJ_d[dim * dim];
+   dual_t q_d[dim + 2];
+   dual_t vec_d[dim + 2];
+   seedDual(adjJ.GetData(), dim * dim, 0, adjJ_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   setDualValues(vec.GetData(), dim + 2, vec_d);
+   dual_t mat_vec_d[dim + 2];
+   if constexpr (entvar)
    {
-      applyLPSScalingUsingEntVars<adouble, dim>(
-          adjJ_a.data(), q_a.data(), vec_a.data(), mat_vec_a.data());
+      applyLPSScalingUsingEntVars<dual_t, dim>(adjJ_d, q_d, vec_d, mat_vec_d);
    }
    else
    {
-      applyLPSScaling<adouble, dim>(
-          adjJ_a.data(), q_a.data(), vec_a.data(), mat_vec_a.data());
+      applyLPSScaling<dual_t, dim>(adjJ_d, q_d, vec_d, mat_vec_d);
    }
-   this->stack.independent(adjJ_a.data(), adjJ.Height() * adjJ.Width());
-   this->stack.dependent(mat_vec_a.data(), q.Size());
-   this->stack.jacobian(mat_vec_jac.GetData());
+   getDualJacobian(mat_vec_d, dim + 2, 0, dim * dim, mat_vec_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -307,35 +427,25 @@ void EntStableLPSIntegrator<dim, entvar>::applyScalingJacV(
     const mfem::Vector &q,
     mfem::DenseMatrix &mat_vec_jac)
 {
-   // declare vectors of active input variables
-   int adjJ_a_size = adjJ.Height() * adjJ.Width();
-   std::vector<adouble> adjJ_a(adjJ_a_size);
-   std::vector<adouble> q_a(q.Size());
-   std::vector<adouble> vec_a(q.Size());
-   // copy data from mfem::Vector
-   adept::set_values(adjJ_a.data(), adjJ_a_size, adjJ.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // dependence on vec is linear, so any value is ok; use q
-   adept::set_values(vec_a.data(), q.Size(), q.GetData());
-   // start recording
-   this->stack.new_recording();
-   // the dependent variable must be declared after the recording
-   std::vector<adouble> mat_vec_a(q.Size());
-   if (entvar)
+   // forward-mode dual numbers with the vec derivatives seeded; dependence
+   // on vec is linear, so any value is ok; use q
+   using dual_t = Dual<dim + 2>;
+   dual_t adjJ_d[dim * dim];
+   dual_t q_d[dim + 2];
+   dual_t vec_d[dim + 2];
+   setDualValues(adjJ.GetData(), dim * dim, adjJ_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   seedDual(q.GetData(), dim + 2, 0, vec_d);
+   dual_t mat_vec_d[dim + 2];
+   if constexpr (entvar)
    {
-      applyLPSScalingUsingEntVars<adouble, dim>(
-          adjJ_a.data(), q_a.data(), vec_a.data(), mat_vec_a.data());
+      applyLPSScalingUsingEntVars<dual_t, dim>(adjJ_d, q_d, vec_d, mat_vec_d);
    }
    else
    {
-      applyLPSScaling<adouble, dim>(
-          adjJ_a.data(), q_a.data(), vec_a.data(), mat_vec_a.data());
+      applyLPSScaling<dual_t, dim>(adjJ_d, q_d, vec_d, mat_vec_d);
    }
-   // set the independent and dependent variable
-   this->stack.independent(vec_a.data(), q.Size());
-   this->stack.dependent(mat_vec_a.data(), q.Size());
-   // Calculate the jabobian
-   this->stack.jacobian(mat_vec_jac.GetData());
+   getDualJacobian(mat_vec_d, dim + 2, 0, dim + 2, mat_vec_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -351,21 +461,13 @@ void MassIntegrator<dim, entvar>::convertVarsJacState(const mfem::Vector &u,
 {
    if constexpr (entvar)
    {
-      // vector of active input variables
-      std::vector<adouble> u_a(u.Size());
-      // initialize adouble inputs
-      adept::set_values(u_a.data(), u.Size(), u.GetData());
-      // start recording
-      this->stack.new_recording();
-      // create vector of active output variables
-      std::vector<adouble> q_a(u.Size());
-      // run algorithm
-      calcConservativeVars<adouble, dim, true>(u_a.data(), q_a.data());
-      // identify independent and dependent variables
-      this->stack.independent(u_a.data(), u.Size());
-      this->stack.dependent(q_a.data(), u.Size());
-      // compute and store jacobian in dwdu
-      this->stack.jacobian(dqdu.GetData());
+      // forward-mode dual numbers with the u derivatives seeded
+      using dual_t = Dual<dim + 2>;
+      dual_t u_d[dim + 2];
+      seedDual(u.GetData(), dim + 2, 0, u_d);
+      dual_t q_d[dim + 2];
+      calcConservativeVars<dual_t, dim, true>(u_d, q_d);
+      getDualJacobian(q_d, dim + 2, 0, dim + 2, dqdu.GetData());
    }
    else
    {
@@ -406,23 +508,17 @@ void IsentropicVortexBC<dim, entvar>::calcFluxJacState(
     const mfem::Vector &q,
     mfem::DenseMatrix &flux_jac)
 {
-   // create containers for active double objects for each input
-   std::vector<adouble> x_a(x.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(x_a.data(), x.Size(), x.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcIsentropicVortexFlux<adouble, entvar>(
-       x_a.data(), dir_a.data(), q_a.data(), flux_a.data());
-   this->stack.independent(q_a.data(), q.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the q derivatives seeded
+   using dual_t = Dual<dim + 2>;
+   dual_t x_d[dim];
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(x.GetData(), dim, x_d);
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcIsentropicVortexFlux<dual_t, entvar>(x_d, dir_d, q_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -432,23 +528,17 @@ void IsentropicVortexBC<dim, entvar>::calcFluxJacDir(
     const mfem::Vector &q,
     mfem::DenseMatrix &flux_jac)
 {
-   // create containers for active double objects for each input
-   std::vector<adouble> x_a(x.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(x_a.data(), x.Size(), x.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcIsentropicVortexFlux<adouble, entvar>(
-       x_a.data(), dir_a.data(), q_a.data(), flux_a.data());
-   this->stack.independent(dir_a.data(), dir.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the dir derivatives seeded
+   using dual_t = Dual<dim>;
+   dual_t x_d[dim];
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(x.GetData(), dim, x_d);
+   seedDual(dir.GetData(), dim, 0, dir_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcIsentropicVortexFlux<dual_t, entvar>(x_d, dir_d, q_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -479,23 +569,17 @@ void SlipWallBC<dim, entvar>::calcFluxJacState(const mfem::Vector &x,
                                                const mfem::Vector &q,
                                                mfem::DenseMatrix &flux_jac)
 {
-   // create containers for active double objects for each input
-   std::vector<adouble> x_a(x.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(x_a.data(), x.Size(), x.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcSlipWallFlux<adouble, dim, entvar>(
-       x_a.data(), dir_a.data(), q_a.data(), flux_a.data());
-   this->stack.independent(q_a.data(), q.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the q derivatives seeded
+   using dual_t = Dual<dim + 2>;
+   dual_t x_d[dim];
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(x.GetData(), dim, x_d);
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcSlipWallFlux<dual_t, dim, entvar>(x_d, dir_d, q_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -504,23 +588,17 @@ void SlipWallBC<dim, entvar>::calcFluxJacDir(const mfem::Vector &x,
                                              const mfem::Vector &q,
                                              mfem::DenseMatrix &flux_jac)
 {
-   // create containers for active double objects for each input
-   std::vector<adouble> x_a(x.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(x_a.data(), x.Size(), x.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcSlipWallFlux<adouble, dim, entvar>(
-       x_a.data(), dir_a.data(), q_a.data(), flux_a.data());
-   this->stack.independent(dir_a.data(), dir.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the dir derivatives seeded
+   using dual_t = Dual<dim>;
+   dual_t x_d[dim];
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(x.GetData(), dim, x_d);
+   seedDual(dir.GetData(), dim, 0, dir_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcSlipWallFlux<dual_t, dim, entvar>(x_d, dir_d, q_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -554,27 +632,19 @@ void FarFieldBC<dim, entvar>::calcFluxJacState(const mfem::Vector &x,
                                                const mfem::Vector &q,
                                                mfem::DenseMatrix &flux_jac)
 {
-   // create containers for active double objects for each input
-   std::vector<adouble> qfs_a(qfs.Size());
-   std::vector<adouble> work_vec_a(work_vec.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(qfs_a.data(), qfs.Size(), qfs.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcFarFieldFlux<adouble, dim, entvar>(dir_a.data(),
-                                                qfs_a.data(),
-                                                q_a.data(),
-                                                work_vec_a.data(),
-                                                flux_a.data());
-   this->stack.independent(q_a.data(), q.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the q derivatives seeded
+   using dual_t = Dual<dim + 2>;
+   dual_t qfs_d[dim + 2];
+   dual_t work_vec_d[dim + 2];
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(qfs.GetData(), dim + 2, qfs_d);
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcFarFieldFlux<dual_t, dim, entvar>(
+       dir_d, qfs_d, q_d, work_vec_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -583,27 +653,19 @@ void FarFieldBC<dim, entvar>::calcFluxJacDir(const mfem::Vector &x,
                                              const mfem::Vector &q,
                                              mfem::DenseMatrix &flux_jac)
 {
-   // create containers for active double objects for each input
-   std::vector<adouble> qfs_a(qfs.Size());
-   std::vector<adouble> work_vec_a(work_vec.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(qfs_a.data(), qfs.Size(), qfs.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcFarFieldFlux<adouble, dim, entvar>(dir_a.data(),
-                                                qfs_a.data(),
-                                                q_a.data(),
-                                                work_vec_a.data(),
-                                                flux_a.data());
-   this->stack.independent(dir_a.data(), dir.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the dir derivatives seeded
+   using dual_t = Dual<dim>;
+   dual_t qfs_d[dim + 2];
+   dual_t work_vec_d[dim + 2];
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(qfs.GetData(), dim + 2, qfs_d);
+   seedDual(dir.GetData(), dim, 0, dir_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcFarFieldFlux<dual_t, dim, entvar>(
+       dir_d, qfs_d, q_d, work_vec_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -645,28 +707,21 @@ void EntropyConserveBC<dim, entvar>::calcFluxJacState(
 {
    // evaluate the boundary state, which does not depend on state
    bc_fun(t, x, work1);
-   // create containers for active double objects for each input
-   std::vector<adouble> work1_a(work1.Size());
-   std::vector<adouble> work2_a(work2.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(work1_a.data(), work1.Size(), work1.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   calcConservativeVars<adouble, dim, entvar>(q_a.data(), work2_a.data());
-   adouble Un_a =
-       dot<adouble, dim>(work1_a.data() + 1, dir_a.data()) / work1_a[0];
-   adouble entflux_a = Un_a * entropy<adouble, dim>(work1_a.data());
-   calcBoundaryFluxEC<adouble, dim>(
-       dir_a.data(), work1_a.data(), work2_a.data(), entflux_a, flux_a.data());
-   this->stack.independent(q_a.data(), q.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the q derivatives seeded
+   using dual_t = Dual<dim + 2>;
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   dual_t work1_d[dim + 2];
+   dual_t work2_d[dim + 2];
+   setDualValues(work1.GetData(), dim + 2, work1_d);
+   calcConservativeVars<dual_t, dim, entvar>(q_d, work2_d);
+   dual_t Un_d = dot<dual_t, dim>(work1_d + 1, dir_d) / work1_d[0];
+   dual_t entflux_d = Un_d * entropy<dual_t, dim>(work1_d);
+   calcBoundaryFluxEC<dual_t, dim>(dir_d, work1_d, work2_d, entflux_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -677,28 +732,21 @@ void EntropyConserveBC<dim, entvar>::calcFluxJacDir(const mfem::Vector &x,
 {
    // evaluate the boundary state, which does not depend on state
    bc_fun(t, x, work1);
-   // create containers for active double objects for each input
-   std::vector<adouble> work1_a(work1.Size());
-   std::vector<adouble> work2_a(work2.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(work1_a.data(), work1.Size(), work1.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   calcConservativeVars<adouble, dim, entvar>(q_a.data(), work2_a.data());
-   adouble Un_a =
-       dot<adouble, dim>(work1_a.data() + 1, dir_a.data()) / work1_a[0];
-   adouble entflux_a = Un_a * entropy<adouble, dim>(work1_a.data());
-   calcBoundaryFluxEC<adouble, dim>(
-       dir_a.data(), work1_a.data(), work2_a.data(), entflux_a, flux_a.data());
-   this->stack.independent(dir_a.data(), dir.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   // forward-mode dual numbers with the dir derivatives seeded
+   using dual_t = Dual<dim>;
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   seedDual(dir.GetData(), dim, 0, dir_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   dual_t flux_d[dim + 2];
+   dual_t work1_d[dim + 2];
+   dual_t work2_d[dim + 2];
+   setDualValues(work1.GetData(), dim + 2, work1_d);
+   calcConservativeVars<dual_t, dim, entvar>(q_d, work2_d);
+   dual_t Un_d = dot<dual_t, dim>(work1_d + 1, dir_d) / work1_d[0];
+   dual_t entflux_d = Un_d * entropy<dual_t, dim>(work1_d);
+   calcBoundaryFluxEC<dual_t, dim>(dir_d, work1_d, work2_d, entflux_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -734,25 +782,18 @@ void ControlBC<dim, entvar>::calcFluxJacState(const mfem::Vector &x,
                                               mfem::DenseMatrix &flux_jac)
 {
    // evaluate the scaled control, which does not depend on the flow state
-   adouble uc_a = control * control_scale(len_scale, x_actuator, x);
-   // create containers for active double objects for each input
-   std::vector<adouble> work1_a(work1.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(work1_a.data(), work1.Size(), work1.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   calcConservativeVars<adouble, dim, entvar>(q_a.data(), work1_a.data());
-   calcControlFlux<adouble, dim>(
-       dir_a.data(), work1_a.data(), uc_a, flux_a.data());
-   this->stack.independent(q_a.data(), q.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   using dual_t = Dual<dim + 2>;
+   const dual_t uc_d = control * control_scale(len_scale, x_actuator, x);
+   // forward-mode dual numbers with the q derivatives seeded
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   dual_t work1_d[dim + 2];
+   calcConservativeVars<dual_t, dim, entvar>(q_d, work1_d);
+   calcControlFlux<dual_t, dim>(dir_d, work1_d, uc_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -762,25 +803,18 @@ void ControlBC<dim, entvar>::calcFluxJacDir(const mfem::Vector &x,
                                             mfem::DenseMatrix &flux_jac)
 {
    // evaluate the scaled control, which does not depend on dir
-   adouble uc_a = control * control_scale(len_scale, x_actuator, x);
-   // create containers for active double objects for each input
-   std::vector<adouble> work1_a(work1.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(work1_a.data(), work1.Size(), work1.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   calcConservativeVars<adouble, dim, entvar>(q_a.data(), work1_a.data());
-   calcControlFlux<adouble, dim>(
-       dir_a.data(), work1_a.data(), uc_a, flux_a.data());
-   this->stack.independent(dir_a.data(), dir.Size());
-   this->stack.dependent(flux_a.data(), q.Size());
-   this->stack.jacobian(flux_jac.GetData());
+   using dual_t = Dual<dim>;
+   const dual_t uc_d = control * control_scale(len_scale, x_actuator, x);
+   // forward-mode dual numbers with the dir derivatives seeded
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   seedDual(dir.GetData(), dim, 0, dir_d);
+   setDualValues(q.GetData(), dim + 2, q_d);
+   dual_t flux_d[dim + 2];
+   dual_t work1_d[dim + 2];
+   calcConservativeVars<dual_t, dim, entvar>(q_d, work1_d);
+   calcControlFlux<dual_t, dim>(dir_d, work1_d, uc_d, flux_d);
+   getDualJacobian(flux_d, dim + 2, 0, dim, flux_jac.GetData());
 }
 
 template <int dim, bool entvar>
@@ -839,6 +873,49 @@ void InterfaceIntegrator<dim, entvar>::calcFlux(const mfem::Vector &dir,
    }
 }
 
+template <int dim, bool entvar>
+void InterfaceIntegrator<dim, entvar>::calcFluxNodes(
+    const mfem::DenseMatrix &dir,
+    const mfem::DenseMatrix &qL,
+    const mfem::DenseMatrix &qR,
+    mfem::DenseMatrix &flux)
+{
+   constexpr int num_states = dim + 2;
+   constexpr int W = simd::default_width;
+   const int num_nodes = dir.Width();
+   double dir_batch[dim * W];
+   double qL_batch[num_states * W];
+   double qR_batch[num_states * W];
+   double flux_batch[num_states * W];
+   for (int i0 = 0; i0 < num_nodes; i0 += W)
+   {
+      // lanes past the last node repeat it; their results are discarded
+      const int num_lanes = std::min(W, num_nodes - i0);
+      for (int l = 0; l < W; ++l)
+      {
+         const int i = i0 + std::min(l, num_lanes - 1);
+         for (int k = 0; k < dim; ++k)
+         {
+            dir_batch[k * W + l] = dir(k, i);
+         }
+         for (int k = 0; k < num_states; ++k)
+         {
+            qL_batch[k * W + l] = qL(k, i);
+            qR_batch[k * W + l] = qR(k, i);
+         }
+      }
+      calcIsmailRoeFaceFluxWithDissBatch<dim, entvar, W>(
+          dir_batch, diss_coeff, qL_batch, qR_batch, flux_batch);
+      for (int l = 0; l < num_lanes; ++l)
+      {
+         for (int k = 0; k < num_states; ++k)
+         {
+            flux(k, i0 + l) = flux_batch[k * W + l];
+         }
+      }
+   }
+}
+
 template <int dim, bool entvar>
 void InterfaceIntegrator<dim, entvar>::calcFluxJacState(const mfem::Vector &dir,
                                                         const mfem::Vector &qL,
@@ -846,40 +923,31 @@ void InterfaceIntegrator<dim, entvar>::calcFluxJacState(const mfem::Vector &dir,
                                                         mfem::DenseMatrix &jacL,
                                                         mfem::DenseMatrix &jacR)
 {
-   // full size jacobian stores both left the right jac state
-   mfem::DenseMatrix jac(qL.Size(), 2 * qL.Size());
-   // vector of active input variables
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> qR_a(qR.Size());
-   std::vector<adouble> qL_a(qL.Size());
-   // initialize the values
-   adouble diss_coeff_a = diss_coeff;
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(qL_a.data(), qL.Size(), qL.GetData());
-   adept::set_values(qR_a.data(), qR.Size(), qR.GetData());
-   // start new recording
-   this->stack.new_recording();
-   // create vector of active output variables
-   std::vector<adouble> flux_a(qL.Size());
-   if (entvar)
+   // forward-mode dual numbers with the derivatives of both states seeded
+   using dual_t = Dual<2 * (dim + 2)>;
+   dual_t dir_d[dim];
+   dual_t qL_d[dim + 2];
+   dual_t qR_d[dim + 2];
+   const dual_t diss_coeff_d = diss_coeff;
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(qL.GetData(), dim + 2, 0, qL_d);
+   seedDual(qR.GetData(), dim + 2, dim + 2, qR_d);
+   dual_t flux_d[dim + 2];
+   if constexpr (entvar)
    {
-      miso::calcIsmailRoeFaceFluxWithDissUsingEntVars<adouble, dim>(
-          dir_a.data(), diss_coeff_a, qL_a.data(), qR_a.data(), flux_a.data());
+      miso::calcIsmailRoeFaceFluxWithDissUsingEntVars<dual_t, dim>(
+          dir_d, diss_coeff_d, qL_d, qR_d, flux_d);
    }
    else
    {
-      miso::calcIsmailRoeFaceFluxWithDiss<adouble, dim>(
-          dir_a.data(), diss_coeff_a, qL_a.data(), qR_a.data(), flux_a.data());
+      miso::calcIsmailRoeFaceFluxWithDiss<dual_t, dim>(
+          dir_d, diss_coeff_d, qL_d, qR_d, flux_d);
    }
-   // set the independent and dependent variables
-   this->stack.independent(qL_a.data(), qL.Size());
-   this->stack.independent(qR_a.data(), qR.Size());
-   this->stack.dependent(flux_a.data(), qL.Size());
-   // compute the jacobian
-   this->stack.jacobian_reverse(jac.GetData());
    // retrieve the left the right jacobians
-   jacL.CopyCols(jac, 0, qL.Size() - 1);
-   jacR.CopyCols(jac, qL.Size(), 2 * qL.Size() - 1);
+   jacL.SetSize(dim + 2);
+   jacR.SetSize(dim + 2);
+   getDualJacobian(flux_d, dim + 2, 0, dim + 2, jacL.GetData());
+   getDualJacobian(flux_d, dim + 2, dim + 2, dim + 2, jacR.GetData());
 }
 
 template <int dim, bool entvar>
@@ -889,34 +957,28 @@ void InterfaceIntegrator<dim, entvar>::calcFluxJacDir(
     const mfem::Vector &qR,
     mfem::DenseMatrix &jac_dir)
 {
-   // vector of active input variables
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> qR_a(qR.Size());
-   std::vector<adouble> qL_a(qL.Size());
-   // initialize the values
-   adouble diss_coeff_a = diss_coeff;
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(qL_a.data(), qL.Size(), qL.GetData());
-   adept::set_values(qR_a.data(), qR.Size(), qR.GetData());
-   // start new recording
-   this->stack.new_recording();
-   // create vector of active output variables
-   std::vector<adouble> flux_a(qL.Size());
-   if (entvar)
+   // forward-mode dual numbers with the dir derivatives seeded
+   using dual_t = Dual<dim>;
+   dual_t dir_d[dim];
+   dual_t qL_d[dim + 2];
+   dual_t qR_d[dim + 2];
+   const dual_t diss_coeff_d = diss_coeff;
+   seedDual(dir.GetData(), dim, 0, dir_d);
+   setDualValues(qL.GetData(), dim + 2, qL_d);
+   setDualValues(qR.GetData(), dim + 2, qR_d);
+   dual_t flux_d[dim + 2];
+   if constexpr (entvar)
    {
-      miso::calcIsmailRoeFaceFluxWithDissUsingEntVars<adouble, dim>(
-          dir_a.data(), diss_coeff_a, qL_a.data(), qR_a.data(), flux_a.data());
+      miso::calcIsmailRoeFaceFluxWithDissUsingEntVars<dual_t, dim>(
+          dir_d, diss_coeff_d, qL_d, qR_d, flux_d);
    }
    else
    {
-      miso::calcIsmailRoeFaceFluxWithDiss<adouble, dim>(
-          dir_a.data(), diss_coeff_a, qL_a.data(), qR_a.data(), flux_a.data());
+      miso::calcIsmailRoeFaceFluxWithDiss<dual_t, dim>(
+          dir_d, diss_coeff_d, qL_d, qR_d, flux_d);
    }
-   // set the independent and dependent variables
-   this->stack.independent(dir_a.data(), dir.Size());
-   this->stack.dependent(flux_a.data(), qL.Size());
    // compute the jacobian w.r.t dir
-   this->stack.jacobian(jac_dir.GetData());
+   getDualJacobian(flux_d, dim + 2, 0, dim, jac_dir.GetData());
 }
 
 template <int dim, bool entvar>
@@ -935,26 +997,26 @@ void PressureForce<dim, entvar>::calcFlux(const mfem::Vector &x,
                                           const mfem::Vector &q,
                                           mfem::Vector &flux_vec)
 {
-   // create containers for active double objects for each input
-   std::vector<adouble> x_a(x.Size());
-   std::vector<adouble> dir_a(dir.Size());
-   std::vector<adouble> q_a(q.Size());
-   std::vector<adouble> force_nrm_a(force_nrm.Size());
-   // initialize active double containers with data from inputs
-   adept::set_values(x_a.data(), x.Size(), x.GetData());
-   adept::set_values(dir_a.data(), dir.Size(), dir.GetData());
-   adept::set_values(q_a.data(), q.Size(), q.GetData());
-   adept::set_values(force_nrm_a.data(), force_nrm.Size(), force_nrm.GetData());
-   // start new stack recording
-   this->stack.new_recording();
-   // create container for active double flux output
-   std::vector<adouble> flux_a(q.Size());
-   miso::calcSlipWallFlux<adouble, dim, entvar>(
-       x_a.data(), dir_a.data(), q_a.data(), flux_a.data());
-   auto fun_a = dot<adouble, dim>(force_nrm_a.data(), flux_a.data() + 1);
-   fun_a.set_gradient(1.0);
-   this->stack.compute_adjoint();
-   adept::get_gradients(q_a.data(), q.Size(), flux_vec.GetData());
+   // the gradient of the force with respect to q, from forward-mode dual
+   // numbers with the q derivatives seeded
+   using dual_t = Dual<dim + 2>;
+   dual_t x_d[dim];
+   dual_t dir_d[dim];
+   dual_t q_d[dim + 2];
+   setDualValues(x.GetData(), dim, x_d);
+   setDualValues(dir.GetData(), dim, dir_d);
+   seedDual(q.GetData(), dim + 2, 0, q_d);
+   dual_t flux_d[dim + 2];
+   miso::calcSlipWallFlux<dual_t, dim, entvar>(x_d, dir_d, q_d, flux_d);
+   dual_t fun_d = 0.0;
+   for (int i = 0; i < dim; ++i)
+   {
+      fun_d += force_nrm(i) * flux_d[i + 1];
+   }
+   for (int i = 0; i < dim + 2; ++i)
+   {
+      flux_vec(i) = fun_d.der[i];
+   }
 }
 
 template <int dim, bool entvar>
@@ -146,7 +146,7 @@ FlowControlSolver<dim, entvar>::FlowControlSolver(
 
    // get the preconditioner, and construct the linear solver and nonlinear
    // solver
-   auto *prec = getPreconditioner(*spatial_res);
+   auto *prec = lagPreconditioner(getPreconditioner(*spatial_res));
    const auto &lin_solver_opts = options["lin-solver"];
    linear_solver = constructLinearSolver(comm, lin_solver_opts, prec);
    const auto &nonlin_solver_opts = options["nonlin-solver"];
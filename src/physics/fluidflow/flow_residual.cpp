@@ -7,6 +7,7 @@
 #include "euler_fluxes.hpp"
 #include "euler_integ.hpp"
 #include "euler_integ_mms.hpp"
+#include "mfem_extensions.hpp"
 #include "navier_stokes_integ.hpp"
 #include "utils.hpp"
 
@@ -78,6 +79,48 @@ std::unique_ptr<mfem::Solver> constructPreconditioner(
    return prec;
 }
 
+/// Constructs a block-Jacobi preconditioner that inverts the diagonal block of
+/// each element exactly
+/// \param[in] fes - the discontinuous space whose element blocks are inverted
+/// \param[out] offsets - start of each element's block of true dofs; must
+/// outlive the returned preconditioner, which references it
+/// \return the constructed preconditioner
+/// \note Each element's dofs must be a contiguous range of true dofs, which is
+/// the case for DSBP spaces ordered by vdim
+std::unique_ptr<mfem::Solver> constructElementBlockPreconditioner(
+    mfem::ParFiniteElementSpace &fes,
+    mfem::Array<int> &offsets)
+{
+   offsets.SetSize(fes.GetNE() + 1);
+   offsets[0] = 0;
+   mfem::Array<int> vdofs;
+   for (int e = 0; e < fes.GetNE(); ++e)
+   {
+      fes.GetElementVDofs(e, vdofs);
+      offsets[e + 1] = offsets[e] + vdofs.Size();
+      if (vdofs.Min() != offsets[e] || vdofs.Max() != offsets[e + 1] - 1)
+      {
+         throw miso::MISOException(
+             "constructElementBlockPreconditioner:\n"
+             "\telement dofs are not contiguous; the space must be DSBP and"
+             " ordered by vdim!\n");
+      }
+   }
+   if (offsets.Last() != fes.GetTrueVSize())
+   {
+      throw miso::MISOException(
+          "constructElementBlockPreconditioner:\n"
+          "\tthe element dofs must be the true dofs!\n");
+   }
+   auto prec = std::make_unique<miso::BlockJacobiPreconditioner>(offsets);
+   prec->owns_blocks = true;
+   for (int e = 0; e < fes.GetNE(); ++e)
+   {
+      prec->SetDiagonalBlock(e, new mfem::DenseMatrixInverse);
+   }
+   return prec;
+}
+
 }  // namespace
 
 namespace miso
@@ -109,12 +152,63 @@ FlowResidual<dim, entvar>::FlowResidual(
    }
    nlohmann::json flow = options["flow-param"];
    nlohmann::json space_dis = options["space-dis"];
-   addFlowDomainIntegrators(flow, space_dis);
-   addFlowInterfaceIntegrators(flow, space_dis);
+   addFlowDomainIntegrators(res, flow, space_dis);
+   addFlowInterfaceIntegrators(res, flow, space_dis);
    if (options.contains("bcs"))
    {
       nlohmann::json bcs = options["bcs"];
-      addFlowBoundaryIntegrators(flow, space_dis, bcs);
+      addFlowBoundaryIntegrators(res, flow, space_dis, bcs);
+   }
+
+   // set up the cheaper form whose Jacobian preconditions Jacobian-free
+   // Newton-Krylov, if necessary
+   auto nonlin_opts = options.value("nonlin-solver", nlohmann::json::object());
+   if (nonlin_opts.value("jacobian-free", false))
+   {
+      auto prec_operator =
+          nonlin_opts.value("jfnk-prec-operator", std::string("low-order"));
+      if (entvar && prec_operator != "full")
+      {
+         throw MISOException(
+             "FlowResidual: the \"" + prec_operator +
+             "\" jfnk-prec-operator uses conservative variables;\n"
+             "\tuse \"full\" with entropy-variable states.\n");
+      }
+      if (prec_operator == "element-block" &&
+          space_dis["basis-type"] != "dsbp")
+      {
+         throw MISOException(
+             "FlowResidual: the \"element-block\" jfnk-prec-operator needs"
+             " a dsbp basis;\n\tcontinuous SBP elements share nodes, so"
+             " their Jacobian has no element blocks.\n");
+      }
+      if (prec_operator == "low-order" || prec_operator == "element-block")
+      {
+         // the two-point volume flux is replaced by the one-point flux, whose
+         // Jacobian needs one flux linearization per node instead of per pair
+         nlohmann::json low_order_dis = space_dis;
+         low_order_dis["flux-fun"] = "Euler";
+         prec_res = std::make_unique<MISONonlinearForm>(fes, fields);
+         addFlowDomainIntegrators(*prec_res, flow, low_order_dis);
+         // without the interface terms, the DSBP Jacobian is block diagonal,
+         // with one block per element
+         if (prec_operator == "low-order")
+         {
+            addFlowInterfaceIntegrators(*prec_res, flow, low_order_dis);
+         }
+         element_block_prec = prec_operator == "element-block";
+         if (options.contains("bcs"))
+         {
+            nlohmann::json bcs = options["bcs"];
+            addFlowBoundaryIntegrators(*prec_res, flow, low_order_dis, bcs);
+         }
+      }
+      else if (prec_operator != "full")
+      {
+         throw MISOException(
+             "FlowResidual: unknown \"jfnk-prec-operator\" " + prec_operator +
+             "!\n\tavailable options are: full, low-order, element-block.\n");
+      }
    }
 
    // set up the mass bilinear form, but do not construct the matrix unless
@@ -137,13 +231,14 @@ FlowResidual<dim, entvar>::FlowResidual(
 
 template <int dim, bool entvar>
 void FlowResidual<dim, entvar>::addFlowDomainIntegrators(
+    MISONonlinearForm &form,
     const nlohmann::json &flow,
     const nlohmann::json &space_dis)
 {
    auto flux = space_dis["flux-fun"];
    if (flux == "IR")
    {
-      res.addDomainIntegrator(new IsmailRoeIntegrator<dim, entvar>(stack));
+      form.addDomainIntegrator(new IsmailRoeIntegrator<dim, entvar>(stack));
    }
    else
    {
@@ -153,36 +248,36 @@ void FlowResidual<dim, entvar>::addFlowDomainIntegrators(
              "Invalid inviscid integrator for entropy"
              " state!\n");
       }
-      res.addDomainIntegrator(new EulerIntegrator<dim>(stack));
+      form.addDomainIntegrator(new EulerIntegrator<dim>(stack));
    }
 
    if (flow.value("inviscid-mms", false))
    {  
-      res.addDomainIntegrator(new InviscidMMSIntegrator(-1.0,dim));
+      form.addDomainIntegrator(new InviscidMMSIntegrator(-1.0,dim));
    }
    
    // add the LPS stabilization, if necessary
    auto lps_coeff = space_dis["lps-coeff"];
    if (lps_coeff > 0.0)
    {  
-      res.addDomainIntegrator(
+      form.addDomainIntegrator(
           new EntStableLPSIntegrator<dim, entvar>(stack, lps_coeff));
    }
    // add viscous volume integrators, if necessary
    if (flow["viscous"])
    {  
-      res.addDomainIntegrator(
+      form.addDomainIntegrator(
           new ESViscousIntegrator<dim>(stack, re_fs, pr_fs, mu));
       if (flow.value("viscous-mms", false))
       {
          if (dim != 2)
          {  
-            res.addDomainIntegrator(new NavierStokesMMSIntegrator(re_fs, pr_fs, -1., 3));
+            form.addDomainIntegrator(new NavierStokesMMSIntegrator(re_fs, pr_fs, -1., 3));
             // throw MISOException("Viscous MMS problem only available for 2D!");
          }
          else
          {
-            res.addDomainIntegrator(new NavierStokesMMSIntegrator(re_fs, pr_fs));
+            form.addDomainIntegrator(new NavierStokesMMSIntegrator(re_fs, pr_fs));
          }
          
       }
@@ -191,6 +286,7 @@ void FlowResidual<dim, entvar>::addFlowDomainIntegrators(
 
 template <int dim, bool entvar>
 void FlowResidual<dim, entvar>::addFlowInterfaceIntegrators(
+    MISONonlinearForm &form,
     const nlohmann::json &flow,
     const nlohmann::json &space_dis)
 {
@@ -198,7 +294,7 @@ void FlowResidual<dim, entvar>::addFlowInterfaceIntegrators(
    if (space_dis["basis-type"] == "dsbp")
    {
       auto iface_coeff = space_dis["iface-coeff"];
-      res.addInteriorFaceIntegrator(new InterfaceIntegrator<dim, entvar>(
+      form.addInteriorFaceIntegrator(new InterfaceIntegrator<dim, entvar>(
           stack, iface_coeff, fes.FEColl()));
       if (flow["viscous"])
       {
@@ -211,22 +307,24 @@ void FlowResidual<dim, entvar>::addFlowInterfaceIntegrators(
 
 template <int dim, bool entvar>
 void FlowResidual<dim, entvar>::addFlowBoundaryIntegrators(
+    MISONonlinearForm &form,
     const nlohmann::json &flow,
     const nlohmann::json &space_dis,
     const nlohmann::json &bcs)
 {
    if (flow["viscous"])
    {
-      addViscousBoundaryIntegrators(flow, space_dis, bcs);
+      addViscousBoundaryIntegrators(form, flow, space_dis, bcs);
    }
    else
    {  
-      addInviscidBoundaryIntegrators(flow, space_dis, bcs);
+      addInviscidBoundaryIntegrators(form, flow, space_dis, bcs);
    }
 }
 
 template <int dim, bool entvar>
 void FlowResidual<dim, entvar>::addInviscidBoundaryIntegrators(
+    MISONonlinearForm &form,
     const nlohmann::json &flow,
     const nlohmann::json &space_dis,
     const nlohmann::json &bcs)
@@ -240,14 +338,14 @@ void FlowResidual<dim, entvar>::addInviscidBoundaryIntegrators(
              "\tisentropic vortex BC must use 2D mesh!");
       }
       vector<int> bdr_attr_marker = bcs["vortex"].get<vector<int>>();
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new IsentropicVortexBC<dim, entvar>(stack, fes.FEColl()),
           bdr_attr_marker);
    }
    if (bcs.contains("slip-wall"))
    {  // slip-wall boundary condition
       vector<int> bdr_attr_marker = bcs["slip-wall"].get<vector<int>>();
-      res.addBdrFaceIntegrator(new SlipWallBC<dim, entvar>(stack, fes.FEColl()),
+      form.addBdrFaceIntegrator(new SlipWallBC<dim, entvar>(stack, fes.FEColl()),
                                bdr_attr_marker);
    }
    if (bcs.contains("far-field"))
@@ -256,7 +354,7 @@ void FlowResidual<dim, entvar>::addInviscidBoundaryIntegrators(
       vector<int> bdr_attr_marker = bcs["far-field"].get<vector<int>>();
       mfem::Vector qfar(dim + 2);
       getFreeStreamState(qfar);
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new FarFieldBC<dim, entvar>(stack, fes.FEColl(), qfar),
           bdr_attr_marker);
    }
@@ -276,7 +374,7 @@ void FlowResidual<dim, entvar>::addInviscidBoundaryIntegrators(
          double press = pow(q[0], miso::euler::gamma);
          q[3] = press / miso::euler::gami + 0.5 * q[1] * q[1] / q[0];
       };
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new EntropyConserveBC<dim, entvar>(stack, fes.FEColl(), pump),
           bdr_attr_marker);
    }
@@ -290,7 +388,7 @@ void FlowResidual<dim, entvar>::addInviscidBoundaryIntegrators(
       // Should pass in xc and len...
       double len = 0.1;
       Vector xc({0.5, 0.0});
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new ControlBC<dim, entvar>(stack, fes.FEColl(), scale, xc, len),
           bdr_attr_marker);
    }
@@ -299,13 +397,14 @@ void FlowResidual<dim, entvar>::addInviscidBoundaryIntegrators(
    //    auto exactbc = [](const Vector &x, Vector &u)
    //    { InviscidMMSExact<double>(dim, x.GetData(), u.GetData()); };
    //       vector<int> bdr_attr_marker = bcs["inviscid-mms"].get<vector<int>>();
-   //       res.addBdrFaceIntegrator(new InviscidExactBC<dim>(stack, fes.FEColl(),exactbc), 
+   //       form.addBdrFaceIntegrator(new InviscidExactBC<dim>(stack, fes.FEColl(),exactbc), 
    //       bdr_attr_marker);
    // }
 }
 
 template <int dim, bool entvar>
 void FlowResidual<dim, entvar>::addViscousBoundaryIntegrators(
+    MISONonlinearForm &form,
     const nlohmann::json &flow,
     const nlohmann::json &space_dis,
     const nlohmann::json &bcs)
@@ -314,7 +413,7 @@ void FlowResidual<dim, entvar>::addViscousBoundaryIntegrators(
    {
       // slip-wall boundary condition with appropriate Neumann BCs
       vector<int> bdr_attr_marker = bcs["slip-wall"].get<vector<int>>();
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new ViscousSlipWallBC<dim>(stack, fes.FEColl(), re_fs, pr_fs, mu),
           bdr_attr_marker);
    }
@@ -325,7 +424,7 @@ void FlowResidual<dim, entvar>::addViscousBoundaryIntegrators(
       // reference state needed by penalty flux
       Vector q_ref(dim + 2);
       getFreeStreamState(q_ref);
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new NoSlipAdiabaticWallBC<dim>(
               stack, fes.FEColl(), re_fs, pr_fs, q_ref, mu),
           bdr_attr_marker);
@@ -336,7 +435,7 @@ void FlowResidual<dim, entvar>::addViscousBoundaryIntegrators(
       vector<int> bdr_attr_marker = bcs["far-field"].get<vector<int>>();
       Vector qfar(dim + 2);
       getFreeStreamState(qfar);
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new FarFieldBC<dim, entvar>(stack, fes.FEColl(), qfar),
           bdr_attr_marker);
    }
@@ -346,7 +445,7 @@ void FlowResidual<dim, entvar>::addViscousBoundaryIntegrators(
       auto exactbc = [](const Vector &x, Vector &u)
       { viscousMMSExact<double>(dim, x.GetData(), u.GetData()); };
       vector<int> bdr_attr_marker = bcs["viscous-mms"].get<vector<int>>();
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new ViscousExactBC<dim>(
               stack, fes.FEColl(), re_fs, pr_fs, exactbc, mu),
           bdr_attr_marker);
@@ -364,7 +463,7 @@ void FlowResidual<dim, entvar>::addViscousBoundaryIntegrators(
       // Should pass in xc and len...
       double len = 0.1;
       Vector xc({0.5, 0.0});
-      res.addBdrFaceIntegrator(
+      form.addBdrFaceIntegrator(
           new ViscousControlBC<dim>(
               stack, fes.FEColl(), re_fs, pr_fs, q_ref, scale, xc, len, mu),
           bdr_attr_marker);
@@ -388,6 +487,10 @@ void FlowResidual<dim, entvar>::setInputs_(const MISOInputs &inputs)
 {
    // What if aoa_fs or mach_fs are being changed?
    setInputs(res, inputs);
+   if (prec_res)
+   {
+      setInputs(*prec_res, inputs);
+   }
 }
 
 template <int dim, bool entvar>
@@ -417,6 +520,10 @@ void FlowResidual<dim, entvar>::setOptions_(const nlohmann::json &options)
       throw MISOException("ipitch axis must be between 0 and 2!");
    }
    setOptions(res, options);
+   if (prec_res)
+   {
+      setOptions(*prec_res, options);
+   }
 }
 
 template <int dim, bool entvar>
@@ -435,6 +542,26 @@ mfem::Operator &FlowResidual<dim, entvar>::getJacobian_(
    return getJacobian(res, inputs, wrt);
 }
 
+template <int dim, bool entvar>
+mfem::Operator &FlowResidual<dim, entvar>::evaluateAndLinearize_(
+    const MISOInputs &inputs,
+    Vector &res_vec)
+{
+   setInputs(res, inputs);
+   return evaluateAndLinearize(res, inputs, res_vec);
+}
+
+template <int dim, bool entvar>
+mfem::Operator &FlowResidual<dim, entvar>::getPreconditionerJacobian_(
+    const MISOInputs &inputs)
+{
+   if (prec_res)
+   {
+      return getJacobian(*prec_res, inputs, "state");
+   }
+   return getJacobian(res, inputs, "state");
+}
+
 template <int dim, bool entvar>
 double FlowResidual<dim, entvar>::calcEntropy_(const MISOInputs &inputs)
 {
@@ -573,7 +700,14 @@ Solver *FlowResidual<dim, entvar>::getPreconditioner_()
 {
    if (prec == nullptr)
    {
-      prec = constructPreconditioner(fes, this->options["lin-prec"]);
+      if (element_block_prec)
+      {
+         prec = constructElementBlockPreconditioner(fes, element_offsets);
+      }
+      else
+      {
+         prec = constructPreconditioner(fes, this->options["lin-prec"]);
+      }
    }
    return prec.get();
 }
@@ -1,6 +1,8 @@
 #ifndef MISO_FLOW_RESIDUAL
 #define MISO_FLOW_RESIDUAL
 
+#include <memory>
+
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
 #include "adept.h"
@@ -67,6 +69,25 @@ public:
    mfem::Operator &getJacobian_(const MISOInputs &inputs,
                                 const std::string &wrt);
 
+   /// Evaluate the flow residual and return its state Jacobian, assembling
+   /// both in one sweep over the elements
+   /// \param[in] inputs - defines values and fields needed for the evaluation
+   /// \param[out] res_vec - where the resulting residual is stored
+   /// \returns a reference to an mfem Operator that defines the Jacobian
+   mfem::Operator &evaluateAndLinearize_(const MISOInputs &inputs,
+                                         mfem::Vector &res_vec);
+
+   /// Returns the state Jacobian used to precondition Jacobian-free
+   /// Newton-Krylov
+   /// \param[in] inputs - defines values and fields needed for the Jacobian
+   /// \returns the Jacobian of the cheaper form selected by
+   /// `options["nonlin-solver"]["jfnk-prec-operator"]`, or the full state
+   /// Jacobian if it is "full"
+   /// \note Only the "element-block" Jacobian is smaller than the full one;
+   /// the "low-order" Jacobian has the same sparsity and is only cheaper to
+   /// assemble
+   mfem::Operator &getPreconditionerJacobian_(const MISOInputs &inputs);
+
    /// Returns the total integrated entropy over the domain
    /// \param[in] inputs - defines values and fields needed for the entropy
    /// \returns the total entropy over the domain
@@ -92,6 +113,8 @@ public:
    /// Return a preconditioner for the flow residual's state Jacobian
    /// \return pointer to preconditioner for the state Jacobian
    /// \note the returned pointer is owned by the residual
+   /// \note with the "element-block" JFNK preconditioner operator, this is a
+   /// block-Jacobi preconditioner with one dense block per element
    mfem::Solver *getPreconditioner_();
 
    /// Returns the minimum time step for a given state and CFL number
@@ -167,32 +190,46 @@ private:
    std::map<std::string, FiniteElementState> &fields;
    /// Defines the nonlinear form used to compute the residual and its Jacobian
    miso::MISONonlinearForm res;
+   /// Cheaper form whose Jacobian preconditions Jacobian-free Newton-Krylov;
+   /// null unless "jfnk-prec-operator" is "low-order" or "element-block"
+   std::unique_ptr<miso::MISONonlinearForm> prec_res;
    /// Bilinear form for the mass-matrix operator (make a MISONonlinearForm?)
    mfem::ParBilinearForm mass;
    /// Mass matrix as HypreParMatrix
    std::unique_ptr<mfem::Operator> mass_mat;
    /// Preconditioner for the spatial Jacobian
    std::unique_ptr<mfem::Solver> prec;
+   /// if true, `prec` inverts the element blocks of the "element-block"
+   /// Jacobian exactly instead of being given by `options["lin-prec"]`
+   bool element_block_prec = false;
+   /// start of each element's block of true dofs, used by `prec` if
+   /// `element_block_prec` is true
+   mfem::Array<int> element_offsets;
    /// Defines the output used to evaluate the entropy
    miso::FunctionalOutput ent;
    /// Work vector
    mfem::Vector work;
 
-   void addFlowDomainIntegrators(const nlohmann::json &flow,
+   void addFlowDomainIntegrators(miso::MISONonlinearForm &form,
+                                 const nlohmann::json &flow,
                                  const nlohmann::json &space_dis);
 
-   void addFlowInterfaceIntegrators(const nlohmann::json &flow,
+   void addFlowInterfaceIntegrators(miso::MISONonlinearForm &form,
+                                    const nlohmann::json &flow,
                                     const nlohmann::json &space_dis);
 
-   void addFlowBoundaryIntegrators(const nlohmann::json &flow,
+   void addFlowBoundaryIntegrators(miso::MISONonlinearForm &form,
+                                   const nlohmann::json &flow,
                                    const nlohmann::json &space_dis,
                                    const nlohmann::json &bcs);
 
-   void addInviscidBoundaryIntegrators(const nlohmann::json &flow,
+   void addInviscidBoundaryIntegrators(miso::MISONonlinearForm &form,
+                                       const nlohmann::json &flow,
                                        const nlohmann::json &space_dis,
                                        const nlohmann::json &bcs);
 
-   void addViscousBoundaryIntegrators(const nlohmann::json &flow,
+   void addViscousBoundaryIntegrators(miso::MISONonlinearForm &form,
+                                      const nlohmann::json &flow,
                                       const nlohmann::json &space_dis,
                                       const nlohmann::json &bcs);
 
@@ -269,6 +306,36 @@ mfem::Operator &getJacobian(FlowResidual<dim, entvar> &residual,
    return residual.getJacobian_(inputs, wrt);
 }
 
+/// Evaluate the flow residual and return its state Jacobian in one sweep
+/// \param[inout] residual - the flow residual being evaluated
+/// \param[in] inputs - defines values and fields needed for the evaluation
+/// \param[out] res_vec - where the resulting residual is stored
+/// \returns a reference to an mfem Operator that defines the Jacobian
+/// \tparam dim - number of spatial dimensions (1, 2, or 3)
+/// \tparam entvar - if true, the entropy variables are used in the integrators
+template <int dim, bool entvar>
+mfem::Operator &evaluateAndLinearize(FlowResidual<dim, entvar> &residual,
+                                     const MISOInputs &inputs,
+                                     mfem::Vector &res_vec)
+{
+   return residual.evaluateAndLinearize_(inputs, res_vec);
+}
+
+/// Returns the state Jacobian used to precondition Jacobian-free Newton-Krylov
+/// \param[inout] residual - the flow residual whose Jacobian is sought
+/// \param[in] inputs - defines values and fields needed for the Jacobian
+/// \returns a reference to an mfem Operator that defines the Jacobian
+/// \tparam dim - number of spatial dimensions (1, 2, or 3)
+/// \tparam entvar - if true, the entropy variables are used in the integrators
+/// \note The Jacobian is of the form selected by
+/// `options["nonlin-solver"]["jfnk-prec-operator"]`
+template <int dim, bool entvar>
+mfem::Operator &getPreconditionerJacobian(FlowResidual<dim, entvar> &residual,
+                                          const MISOInputs &inputs)
+{
+   return residual.getPreconditionerJacobian_(inputs);
+}
+
 /// Returns the total integrated entropy over the domain
 /// \param[inout] residual - the flow residual, which helps compute entropy
 /// \param[in] inputs - defines values and fields needed for the entropy
@@ -54,12 +54,28 @@ FlowSolver<dim, entvar>::FlowSolver(MPI_Comm incomm,
    spatial_res = std::make_unique<miso::MISOResidual>(
        FlowResidual<dim, entvar>(options, fes(), fields, diff_stack, *out));
    auto *mass_matrix = getMassMatrix(*spatial_res, options);
+   const bool jacobian_free =
+       options["nonlin-solver"].value("jacobian-free", false);
    space_time_res = std::make_unique<miso::MISOResidual>(
-       miso::TimeDependentResidual(*spatial_res, mass_matrix));
+       miso::TimeDependentResidual(*spatial_res, mass_matrix, jacobian_free));
 
    // get the preconditioner, and construct the linear solver and nonlinear
    // solver
    auto *prec = getPreconditioner(*spatial_res);
+   if (jacobian_free && prec != nullptr)
+   {
+      // hypre's Krylov solvers can only apply an assembled HypreParMatrix
+      const auto lin_type = options["lin-solver"]["type"].get<std::string>();
+      if (lin_type.rfind("hypre", 0) == 0)
+      {
+         throw MISOException(
+             "FlowSolver<dim,entvar> constructor:\n"
+             "\tJacobian-free Newton-Krylov needs an MFEM \"lin-solver\"!\n");
+      }
+      jfnk_prec = std::make_unique<JacobianFreePreconditioner>(*prec);
+      prec = jfnk_prec.get();
+   }
+   prec = lagPreconditioner(prec);
    const auto &lin_solver_opts = options["lin-solver"];
    linear_solver = constructLinearSolver(comm, lin_solver_opts, prec);
    const auto &nonlin_solver_opts = options["nonlin-solver"];
@@ -53,6 +53,9 @@ private:
    double res_norm0 = -1.0;
    /// used to record the total entropy
    std::ofstream entropy_log;
+   /// sets up the preconditioner with a cheaper Jacobian than the one the
+   /// Krylov solver applies; only used if "nonlin-solver" is "jacobian-free"
+   std::unique_ptr<JacobianFreePreconditioner> jfnk_prec;
 
    /// For code that should be executed before the time stepping begins
    /// \param[in] state - the current state
@@ -1,11 +1,21 @@
 #ifndef MISO_INVISCID_INTEG
 #define MISO_INVISCID_INTEG
 
+#include <vector>
+
 #include "adept.h"
 #include "mfem.hpp"
 
 namespace miso
 {
+/// Get the adjugate of the mapping Jacobian at each node of an element
+/// \param[in] el - the finite element whose nodes are used
+/// \param[in] trans - defines the reference to physical element mapping
+/// \param[out] adjJ - adjugate of the mapping Jacobian at each node
+inline void calcNodalAdjugates(const mfem::FiniteElement &el,
+                               mfem::ElementTransformation &trans,
+                               std::vector<mfem::DenseMatrix> &adjJ);
+
 /// Integrator for one-point inviscid flux functions
 /// \tparam Derived - a class Derived from this one (needed for CRTP)
 template <typename Derived>
@@ -26,6 +36,18 @@ public:
     : num_states(num_state_vars), alpha(a), stack(diff_stack)
    { }
 
+   /// \brief Assemble the element residual and Jacobian together, computing
+   /// the nodal adjugates once and the flux with its Jacobian at each node
+   friend void assembleElementVectorAndGrad(InviscidIntegrator &integ,
+                                            const mfem::FiniteElement &el,
+                                            mfem::ElementTransformation &trans,
+                                            const mfem::Vector &elfun,
+                                            mfem::Vector &elvect,
+                                            mfem::DenseMatrix &elmat)
+   {
+      integ.AssembleElementVectorAndGrad(el, trans, elfun, elvect, elmat);
+   }
+
    /// Get the contribution of this element to a functional
    /// \param[in] el - the finite element whose contribution we want
    /// \param[in] trans - defines the reference to physical element mapping
@@ -54,6 +76,18 @@ public:
                             const mfem::Vector &elfun,
                             mfem::DenseMatrix &elmat) override;
 
+   /// Construct the element local residual and Jacobian in one pass
+   /// \param[in] el - the finite element whose residual we want
+   /// \param[in] trans - defines the reference to physical element mapping
+   /// \param[in] elfun - element local state function
+   /// \param[out] elvect - element local residual
+   /// \param[out] elmat - element local Jacobian
+   void AssembleElementVectorAndGrad(const mfem::FiniteElement &el,
+                                     mfem::ElementTransformation &trans,
+                                     const mfem::Vector &elfun,
+                                     mfem::Vector &elvect,
+                                     mfem::DenseMatrix &elmat);
+
 protected:
    /// number of states
    int num_states;
@@ -80,6 +114,8 @@ protected:
    mfem::DenseMatrix elflux;
    /// used to store the residual in (num_states, Dof) format
    mfem::DenseMatrix elres;
+   /// adjugate of the mapping Jacobian at each node of the element
+   std::vector<mfem::DenseMatrix> adjJ_nodes;
 #endif
 
    /// Compute a scalar domain functional
@@ -117,6 +153,33 @@ protected:
       static_cast<Derived *>(this)->calcFluxJacState(dir, u, flux_jac);
    }
 
+   /// Compute the flux function `flux` and its Jacobian w.r.t. `u`
+   /// \param[in] dir - desired direction for the flux
+   /// \param[in] u - state at which to evaluate the flux and its Jacobian
+   /// \param[out] flux_vec - flux evaluated at `u` in direction `dir`
+   /// \param[out] flux_jac - Jacobian of the flux function w.r.t. `u`
+   /// \note This uses the CRTP, so it wraps a call to `calcFluxAndJacState`
+   /// in Derived, which defaults to calling `flux` and `fluxJacState`
+   void fluxAndJacState(const mfem::Vector &dir,
+                        const mfem::Vector &u,
+                        mfem::Vector &flux_vec,
+                        mfem::DenseMatrix &flux_jac)
+   {
+      static_cast<Derived *>(this)->calcFluxAndJacState(
+          dir, u, flux_vec, flux_jac);
+   }
+
+   /// Default for derived classes that cannot compute the flux and its
+   /// Jacobian more cheaply together than apart
+   void calcFluxAndJacState(const mfem::Vector &dir,
+                            const mfem::Vector &u,
+                            mfem::Vector &flux_vec,
+                            mfem::DenseMatrix &flux_jac)
+   {
+      flux(dir, u, flux_vec);
+      fluxJacState(dir, u, flux_jac);
+   }
+
    /// Compute the Jacobian of the flux function `flux` w.r.t. `dir`
    /// \parma[in] dir - desired direction for the flux
    /// \param[in] u - state at which to evaluate the flux Jacobian
@@ -150,6 +213,18 @@ public:
     : num_states(num_state_vars), alpha(a), stack(diff_stack)
    { }
 
+   /// \brief Assemble the element residual and Jacobian together, computing
+   /// each two-point flux with its Jacobians once
+   friend void assembleElementVectorAndGrad(DyadicFluxIntegrator &integ,
+                                            const mfem::FiniteElement &el,
+                                            mfem::ElementTransformation &trans,
+                                            const mfem::Vector &elfun,
+                                            mfem::Vector &elvect,
+                                            mfem::DenseMatrix &elmat)
+   {
+      integ.AssembleElementVectorAndGrad(el, trans, elfun, elvect, elmat);
+   }
+
    /// Construct the element local residual
    /// \param[in] el - the finite element whose residual we want
    /// \param[in] Trans - defines the reference to physical element mapping
@@ -170,6 +245,18 @@ public:
                             const mfem::Vector &elfun,
                             mfem::DenseMatrix &elmat) override;
 
+   /// Construct the element local residual and Jacobian in one pass
+   /// \param[in] el - the finite element whose residual we want
+   /// \param[in] Trans - defines the reference to physical element mapping
+   /// \param[in] elfun - element local state function
+   /// \param[out] elvect - element local residual
+   /// \param[out] elmat - element local Jacobian
+   void AssembleElementVectorAndGrad(const mfem::FiniteElement &el,
+                                     mfem::ElementTransformation &trans,
+                                     const mfem::Vector &elfun,
+                                     mfem::Vector &elvect,
+                                     mfem::DenseMatrix &elmat);
+
 protected:
    /// number of states
    int num_states;
@@ -188,10 +275,10 @@ protected:
    mfem::Vector uj;
    /// stores the result of calling the flux function
    mfem::Vector fluxij;
-   /// used to store the adjugate of the mapping Jacobian at node i
-   mfem::DenseMatrix adjJ_i;
-   /// used to store the adjugate of the mapping Jacobian at node j
-   mfem::DenseMatrix adjJ_j;
+   /// adjugate of the mapping Jacobian at each node of the element
+   std::vector<mfem::DenseMatrix> adjJ_nodes;
+   /// skew entries of the node pairs of the element, from `getSkewEntries`
+   mfem::DenseMatrix skew;
    /// stores a row of the adjugate of the mapping Jacobian
    mfem::Vector dxidx;
    /// stores the jacobian w.r.t left state
@@ -231,6 +318,39 @@ protected:
       static_cast<Derived *>(this)->calcFluxJacStates(
           di, u_left, u_right, jac_left, jac_right);
    }
+
+   /// Compute `flux` and its Jacobians with respect to `u_left` and `u_right`
+   /// \param[in] di - desired coordinate direction for flux
+   /// \param[in] u_left - the "left" state
+   /// \param[in] u_right - the "right" state
+   /// \param[out] flux_vec - flux evaluated at `u_left` and `u_right`
+   /// \param[out] jac_left - Jacobian of `flux` w.r.t. `u_left`
+   /// \param[out] jac_right - Jacobian of `flux` w.r.t. `u_right`
+   /// \note This uses the CRTP, so it wraps a call to `calcFluxAndJacStates`
+   /// in Derived, which defaults to calling `flux` and `fluxJacStates`
+   void fluxAndJacStates(int di,
+                         const mfem::Vector &u_left,
+                         const mfem::Vector &u_right,
+                         mfem::Vector &flux_vec,
+                         mfem::DenseMatrix &jac_left,
+                         mfem::DenseMatrix &jac_right)
+   {
+      static_cast<Derived *>(this)->calcFluxAndJacStates(
+          di, u_left, u_right, flux_vec, jac_left, jac_right);
+   }
+
+   /// Default for derived classes that cannot compute the flux and its
+   /// Jacobians more cheaply together than apart
+   void calcFluxAndJacStates(int di,
+                             const mfem::Vector &u_left,
+                             const mfem::Vector &u_right,
+                             mfem::Vector &flux_vec,
+                             mfem::DenseMatrix &jac_left,
+                             mfem::DenseMatrix &jac_right)
+   {
+      flux(di, u_left, u_right, flux_vec);
+      fluxJacStates(di, u_left, u_right, jac_left, jac_right);
+   }
 };
 
 /// Integrator for local projection stabilization
@@ -295,6 +415,8 @@ protected:
    mfem::DenseMatrix jac_node;
    /// used to hold the (i,j)th LPS matrix operator block entry
    mfem::DenseMatrix Lij;
+   /// used to store the adjugate of the mapping Jacobian at every node
+   std::vector<mfem::DenseMatrix> adjJ_nodes;
 #endif
 
    /// converts working variables to another set (e.g. conservative to entropy)
@@ -330,6 +452,21 @@ protected:
       static_cast<Derived *>(this)->applyScaling(adjJ, u, v, Av);
    }
 
+   /// applies `scale` at every node of an element
+   /// \param[in] adjJ - adjugates of the mapping Jacobian at the nodes
+   /// \param[in] u - `num_nodes` x `num_states` states at the nodes
+   /// \param[in] v - `num_states` x `num_nodes` vectors being multiplied
+   /// \param[out] Av - `num_states` x `num_nodes` products
+   /// \note This uses the CRTP, so it wraps call to `applyScalingNodes` in
+   /// Derived.
+   void scaleNodes(const std::vector<mfem::DenseMatrix> &adjJ,
+                   const mfem::DenseMatrix &u,
+                   const mfem::DenseMatrix &v,
+                   mfem::DenseMatrix &Av)
+   {
+      static_cast<Derived *>(this)->applyScalingNodes(adjJ, u, v, Av);
+   }
+
    /// Computes the Jacobian of the product `A(adjJ,u)*v` w.r.t. `u`
    /// \param[in] adjJ - adjugate of the mapping Jacobian
    /// \param[in] u - state at which the symmetric matrix `A` is evaluated
@@ -583,6 +720,13 @@ protected:
    mfem::DenseMatrix flux_jac_left;
    /// stores the jacobian of the flux with respect to the right state
    mfem::DenseMatrix flux_jac_right;
+   /// the (scaled) normals at the face nodes, one per column
+   mfem::DenseMatrix nrm_nodes;
+   /// the left and right states at the face nodes, one per column
+   mfem::DenseMatrix u_nodes_left;
+   mfem::DenseMatrix u_nodes_right;
+   /// the fluxes at the face nodes, one per column
+   mfem::DenseMatrix flux_nodes;
 #endif
 
    /// Compute a scalar interface function
@@ -613,6 +757,22 @@ protected:
       static_cast<Derived *>(this)->calcFlux(dir, u_left, u_right, flux_vec);
    }
 
+   /// Compute the interface flux at every node of a face
+   /// \param[in] dir - `dim` x `num_nodes` vectors normal to the face
+   /// \param[in] u_left - `num_states` x `num_nodes` "left" states
+   /// \param[in] u_right - `num_states` x `num_nodes` "right" states
+   /// \param[out] flux_vec - `num_states` x `num_nodes` values of the flux
+   /// \note This uses the CRTP, so it wraps a call to `calcFluxNodes` in
+   /// Derived.
+   void fluxNodes(const mfem::DenseMatrix &dir,
+                  const mfem::DenseMatrix &u_left,
+                  const mfem::DenseMatrix &u_right,
+                  mfem::DenseMatrix &flux_vec)
+   {
+      static_cast<Derived *>(this)->calcFluxNodes(
+          dir, u_left, u_right, flux_vec);
+   }
+
    /// Compute the Jacobian of the interface flux function w.r.t. states
    /// \param[in] dir - vector normal to the face
    /// \param[in] u_left - "left" state at which to evaluate the flux
@@ -1,6 +1,8 @@
 #ifndef MISO_INVISCID_INTEG_DEF
 #define MISO_INVISCID_INTEG_DEF
 
+#include <vector>
+
 #include "mfem.hpp"
 
 #include "utils.hpp"
@@ -9,6 +11,19 @@
 
 namespace miso
 {
+inline void calcNodalAdjugates(const mfem::FiniteElement &el,
+                               mfem::ElementTransformation &trans,
+                               std::vector<mfem::DenseMatrix> &adjJ)
+{
+   int num_nodes = el.GetDof();
+   adjJ.resize(num_nodes);
+   for (int i = 0; i < num_nodes; ++i)
+   {
+      trans.SetIntPoint(&el.GetNodes().IntPoint(i));
+      adjJ[i] = trans.AdjugateJacobian();
+   }
+}
+
 template <typename Derived>
 double InviscidIntegrator<Derived>::GetElementEnergy(
     const mfem::FiniteElement &el,
@@ -118,11 +133,16 @@ void InviscidIntegrator<Derived>::AssembleElementGrad(
          u.GetRow(i, ui);
          fluxJacState(dxidx, ui, flux_jaci);
 
-         // loop over rows j for contribution (Q^T)_{i,j} * Jac_i
-         for (int j = 0; j < num_nodes; ++j)
+         // loop over rows j for contribution (Q^T)_{i,j} * Jac_i; only the
+         // nonzeros of row i of Q contribute
+         const auto &Q_nonzeros = sbp.getWeakOperatorNonzeros(di);
+         for (int k = sbp.getWeakOperatorRowBegin(di, i);
+              k < sbp.getWeakOperatorRowBegin(di, i + 1);
+              ++k)
          {
             // get the entry of (Q^T)_{j,i} = Q_{i,j}
-            double Q = alpha * sbp.getQ(di, i, j);
+            int j = Q_nonzeros[k].j;
+            double Q = alpha * Q_nonzeros[k].value;
             for (int n = 0; n < dim + 2; ++n)
             {
                for (int m = 0; m < dim + 2; ++m)
@@ -136,6 +156,70 @@ void InviscidIntegrator<Derived>::AssembleElementGrad(
    }
 }
 
+template <typename Derived>
+void InviscidIntegrator<Derived>::AssembleElementVectorAndGrad(
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::Vector &elfun,
+    mfem::Vector &elvect,
+    mfem::DenseMatrix &elmat)
+{
+   using namespace mfem;
+   const auto &sbp = dynamic_cast<const SBPFiniteElement &>(el);
+   int num_nodes = sbp.GetDof();
+   int dim = sbp.GetDim();
+#ifdef MFEM_THREAD_SAFE
+   Vector ui, fluxi, dxidx;
+   DenseMatrix elflux, elres, flux_jaci;
+   std::vector<DenseMatrix> adjJ_nodes;
+#endif
+   elvect.SetSize(num_states * num_nodes);
+   elmat.SetSize(num_states * num_nodes);
+   elmat = 0.0;
+   ui.SetSize(num_states);
+   dxidx.SetSize(dim);
+   flux_jaci.SetSize(num_states);
+   elflux.SetSize(num_states, num_nodes);
+   elres.SetSize(num_states, num_nodes);
+   DenseMatrix u(elfun.GetData(), num_nodes, num_states);
+   DenseMatrix res(elvect.GetData(), num_nodes, num_states);
+   // the adjugates are shared by every direction
+   calcNodalAdjugates(el, trans, adjJ_nodes);
+
+   elres = 0.0;
+   for (int di = 0; di < dim; ++di)
+   {
+      const auto &Q_nonzeros = sbp.getWeakOperatorNonzeros(di);
+      for (int i = 0; i < num_nodes; ++i)
+      {
+         adjJ_nodes[i].GetRow(di, dxidx);
+         u.GetRow(i, ui);
+         elflux.GetColumnReference(i, fluxi);
+         fluxAndJacState(dxidx, ui, fluxi, flux_jaci);
+
+         // contribution (Q^T)_{j,i} * Jac_i, as in AssembleElementGrad
+         for (int k = sbp.getWeakOperatorRowBegin(di, i);
+              k < sbp.getWeakOperatorRowBegin(di, i + 1);
+              ++k)
+         {
+            int j = Q_nonzeros[k].j;
+            double Q = alpha * Q_nonzeros[k].value;
+            for (int n = 0; n < num_states; ++n)
+            {
+               for (int m = 0; m < num_states; ++m)
+               {
+                  elmat(m * num_nodes + j, n * num_nodes + i) -=
+                      Q * flux_jaci(m, n);
+               }
+            }
+         }
+      }
+      sbp.multWeakOperator(di, elflux, elres, true);
+   }
+   res.Transpose(elres);
+   res *= alpha;
+}
+
 template <typename Derived>
 void DyadicFluxIntegrator<Derived>::AssembleElementVector(
     const mfem::FiniteElement &el,
@@ -150,42 +234,39 @@ void DyadicFluxIntegrator<Derived>::AssembleElementVector(
    int dim = sbp.GetDim();
 #ifdef MFEM_THREAD_SAFE
    Vector ui, uj, fluxij;
-   DenseMatrix adjJ_i, adjJ_j;
+   std::vector<DenseMatrix> adjJ_nodes;
+   DenseMatrix skew;
 #endif
    elvect.SetSize(num_states * num_nodes);
    fluxij.SetSize(num_states);
-   adjJ_i.SetSize(dim);
-   adjJ_j.SetSize(dim);
    DenseMatrix u(elfun.GetData(), num_nodes, num_states);
    DenseMatrix res(elvect.GetData(), num_nodes, num_states);
+   // contract the adjugates with the operators once for the whole element
+   calcNodalAdjugates(el, Trans, adjJ_nodes);
+   sbp.getSkewEntries(adjJ_nodes, skew);
 
    elvect = 0.0;
-   for (int i = 0; i < num_nodes; ++i)
+   const auto &pairs = sbp.getSkewPairs();
+   for (int p = 0; p < skew.Height(); ++p)
    {
-      Trans.SetIntPoint(&el.GetNodes().IntPoint(i));
-      adjJ_i = Trans.AdjugateJacobian();
+      int i = pairs[p].i;
+      int j = pairs[p].j;
       u.GetRow(i, ui);
-      for (int j = i + 1; j < num_nodes; ++j)
+      u.GetRow(j, uj);
+      for (int di = 0; di < dim; ++di)
       {
-         Trans.SetIntPoint(&el.GetNodes().IntPoint(j));
-         adjJ_j = Trans.AdjugateJacobian();
-         u.GetRow(j, uj);
-         for (int di = 0; di < dim; ++di)
+         // TODO: we should add state_offset to ui and uj, and eqn_offset to
+         // fluxij because the flux function may not know about other states
+         // and equations.
+         flux(di, ui, uj, fluxij);
+         double Sij = alpha * skew(p, di);
+         for (int n = 0; n < num_states; ++n)
          {
-            // TODO: we should add state_offset to ui and uj, and eqn_offset to
-            // fluxij because the flux function may not know about other states
-            // and equations.
-            flux(di, ui, uj, fluxij);
-            double Sij = sbp.getSkewEntry(di, i, j, adjJ_i, adjJ_j);
-            Sij *= alpha;
-            for (int n = 0; n < num_states; ++n)
-            {
-               res(i, n) += Sij * fluxij(n);
-               res(j, n) -= Sij * fluxij(n);
-            }
-         }  // di loop
-      }     // j node loop
-   }        // i node loop
+            res(i, n) += Sij * fluxij(n);
+            res(j, n) -= Sij * fluxij(n);
+         }
+      }  // di loop
+   }     // node pair loop
 }
 
 template <typename Derived>
@@ -202,52 +283,107 @@ void DyadicFluxIntegrator<Derived>::AssembleElementGrad(
    int dim = sbp.GetDim();
 #ifdef MFEM_THREAD_SAFE
    Vector ui, uj;
-   DenseMatrix adjJ_i, adjJ_j, flux_jaci, flux_jacj;
+   std::vector<DenseMatrix> adjJ_nodes;
+   DenseMatrix skew, flux_jaci, flux_jacj;
 #endif
    elmat.SetSize(num_states * num_nodes);
    elmat = 0.0;
-   adjJ_i.SetSize(dim);
-   adjJ_j.SetSize(dim);
    flux_jaci.SetSize(num_states);
    flux_jacj.SetSize(num_states);
    DenseMatrix u(elfun.GetData(), num_nodes, num_states);
-   for (int di = 0; di < dim; ++di)
+   // contract the adjugates with the operators once for the whole element
+   calcNodalAdjugates(el, Trans, adjJ_nodes);
+   sbp.getSkewEntries(adjJ_nodes, skew);
+
+   const auto &pairs = sbp.getSkewPairs();
+   for (int p = 0; p < skew.Height(); ++p)
    {
-      for (int i = 0; i < num_nodes; ++i)
+      int i = pairs[p].i;
+      int j = pairs[p].j;
+      u.GetRow(i, ui);
+      u.GetRow(j, uj);
+      for (int di = 0; di < dim; ++di)
       {
-         // get the flux Jacobian at node i
-         Trans.SetIntPoint(&el.GetNodes().IntPoint(i));
-         adjJ_i = Trans.AdjugateJacobian();
-         u.GetRow(i, ui);
-         // loop over rows j for contribution (Q^T)_{i,j} * Jac_i
-         for (int j = i + 1; j < num_nodes; ++j)
+         fluxJacStates(di, ui, uj, flux_jaci, flux_jacj);
+         double Sij = alpha * skew(p, di);
+         for (int n = 0; n < num_states; ++n)
          {
-            // get the flux Jacobian at node i
-            Trans.SetIntPoint(&el.GetNodes().IntPoint(j));
-            adjJ_j = Trans.AdjugateJacobian();
-            u.GetRow(j, uj);
-            fluxJacStates(di, ui, uj, flux_jaci, flux_jacj);
-            double Sij = sbp.getSkewEntry(di, i, j, adjJ_i, adjJ_j);
-            Sij *= alpha;
-            for (int n = 0; n < num_states; ++n)
+            for (int m = 0; m < num_states; ++m)
             {
-               for (int m = 0; m < num_states; ++m)
-               {
-                  // res(i,n) += Sij*fluxij(n);
-                  elmat(n * num_nodes + i, m * num_nodes + i) +=
-                      Sij * flux_jaci(n, m);
-                  elmat(n * num_nodes + i, m * num_nodes + j) +=
-                      Sij * flux_jacj(n, m);
-                  // res(j,n) -= Sij*fluxij(n);
-                  elmat(n * num_nodes + j, m * num_nodes + i) -=
-                      Sij * flux_jaci(n, m);
-                  elmat(n * num_nodes + j, m * num_nodes + j) -=
-                      Sij * flux_jacj(n, m);
-               }
+               // res(i,n) += Sij*fluxij(n);
+               elmat(n * num_nodes + i, m * num_nodes + i) +=
+                   Sij * flux_jaci(n, m);
+               elmat(n * num_nodes + i, m * num_nodes + j) +=
+                   Sij * flux_jacj(n, m);
+               // res(j,n) -= Sij*fluxij(n);
+               elmat(n * num_nodes + j, m * num_nodes + i) -=
+                   Sij * flux_jaci(n, m);
+               elmat(n * num_nodes + j, m * num_nodes + j) -=
+                   Sij * flux_jacj(n, m);
             }
          }
-      }
-   }
+      }  // di loop
+   }     // node pair loop
+}
+
+template <typename Derived>
+void DyadicFluxIntegrator<Derived>::AssembleElementVectorAndGrad(
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::Vector &elfun,
+    mfem::Vector &elvect,
+    mfem::DenseMatrix &elmat)
+{
+   using namespace mfem;
+   const auto &sbp = dynamic_cast<const SBPFiniteElement &>(el);
+   int num_nodes = sbp.GetDof();
+   int dim = sbp.GetDim();
+#ifdef MFEM_THREAD_SAFE
+   Vector ui, uj, fluxij;
+   std::vector<DenseMatrix> adjJ_nodes;
+   DenseMatrix skew, flux_jaci, flux_jacj;
+#endif
+   elvect.SetSize(num_states * num_nodes);
+   elmat.SetSize(num_states * num_nodes);
+   elvect = 0.0;
+   elmat = 0.0;
+   fluxij.SetSize(num_states);
+   flux_jaci.SetSize(num_states);
+   flux_jacj.SetSize(num_states);
+   DenseMatrix u(elfun.GetData(), num_nodes, num_states);
+   DenseMatrix res(elvect.GetData(), num_nodes, num_states);
+   calcNodalAdjugates(el, trans, adjJ_nodes);
+   sbp.getSkewEntries(adjJ_nodes, skew);
+
+   const auto &pairs = sbp.getSkewPairs();
+   for (int p = 0; p < skew.Height(); ++p)
+   {
+      int i = pairs[p].i;
+      int j = pairs[p].j;
+      u.GetRow(i, ui);
+      u.GetRow(j, uj);
+      for (int di = 0; di < dim; ++di)
+      {
+         fluxAndJacStates(di, ui, uj, fluxij, flux_jaci, flux_jacj);
+         double Sij = alpha * skew(p, di);
+         for (int n = 0; n < num_states; ++n)
+         {
+            res(i, n) += Sij * fluxij(n);
+            res(j, n) -= Sij * fluxij(n);
+            for (int m = 0; m < num_states; ++m)
+            {
+               elmat(n * num_nodes + i, m * num_nodes + i) +=
+                   Sij * flux_jaci(n, m);
+               elmat(n * num_nodes + i, m * num_nodes + j) +=
+                   Sij * flux_jacj(n, m);
+               elmat(n * num_nodes + j, m * num_nodes + i) -=
+                   Sij * flux_jaci(n, m);
+               elmat(n * num_nodes + j, m * num_nodes + j) -=
+                   Sij * flux_jacj(n, m);
+            }
+         }
+      }  // di loop
+   }     // node pair loop
 }
 
 template <typename Derived>
@@ -263,15 +399,14 @@ void LPSIntegrator<Derived>::AssembleElementVector(
    int dim = sbp.GetDim();
 #ifdef MFEM_THREAD_SAFE
    Vector ui;
-   DenseMatrix adjJt, w, Pw;
+   DenseMatrix w, Pw;
+   std::vector<DenseMatrix> adjJ_nodes;
 #endif
    elvect.SetSize(num_states * num_nodes);
    ui.SetSize(num_states);
-   adjJt.SetSize(dim);
    w.SetSize(num_states, num_nodes);
    Pw.SetSize(num_states, num_nodes);
    Vector wi;
-   Vector Pwi;
    DenseMatrix u(elfun.GetData(), num_nodes, num_states);
    DenseMatrix res(elvect.GetData(), num_nodes, num_states);
 
@@ -285,17 +420,9 @@ void LPSIntegrator<Derived>::AssembleElementVector(
    // Step 2: apply the projection operator to w
    sbp.multProjOperator(w, Pw, false);
    // Step 3: apply scaling matrix at each node and diagonal norm
-   for (int i = 0; i < num_nodes; ++i)
-   {
-      Trans.SetIntPoint(&el.GetNodes().IntPoint(i));
-      // CalcAdjugateTranspose(Trans.Jacobian(), adjJt);
-      CalcAdjugate(Trans.Jacobian(), adjJt);
-      u.GetRow(i, ui);
-      Pw.GetColumnReference(i, Pwi);
-      w.GetColumnReference(i, wi);
-      scale(adjJt, ui, Pwi, wi);
-      wi *= lps_coeff;
-   }
+   calcNodalAdjugates(el, Trans, adjJ_nodes);
+   scaleNodes(adjJ_nodes, u, Pw, w);
+   w *= lps_coeff;
    sbp.multNormMatrix(w, w);
    // Step 4: apply the transposed projection operator to H*A*P*w
    sbp.multProjOperator(w, Pw, true);
@@ -684,12 +811,10 @@ void InviscidFaceIntegrator<Derived>::AssembleFaceVector(
    const int num_nodes_right = el_right.GetDof();
    const int dim = sbp.GetDim();
 #ifdef MFEM_THREAD_SAFE
-   Vector u_face_left, u_face_right, nrm, flux_face;
+   Vector nrm;
+   DenseMatrix nrm_nodes, u_nodes_left, u_nodes_right, flux_nodes;
 #endif
-   u_face_left.SetSize(num_states);
-   u_face_right.SetSize(num_states);
    nrm.SetSize(dim);
-   flux_face.SetSize(num_states);
    elvect.SetSize(num_states * (num_nodes_left + num_nodes_right));
    elvect = 0.0;
 
@@ -719,30 +844,46 @@ void InviscidFaceIntegrator<Derived>::AssembleFaceVector(
           "InviscidBoundaryIntegrator::AssembleFaceVector())\n"
           "\tcannot handle given dimension");
    }
+   // gather the normals and states at the face nodes, so that the fluxes at
+   // all of them are evaluated at once
+   const int num_face_nodes = sbp_face->GetDof();
+   Array<int> nodes_left(num_face_nodes);
+   Array<int> nodes_right(num_face_nodes);
+   nrm_nodes.SetSize(dim, num_face_nodes);
+   u_nodes_left.SetSize(num_states, num_face_nodes);
+   u_nodes_right.SetSize(num_states, num_face_nodes);
+   flux_nodes.SetSize(num_states, num_face_nodes);
    IntegrationPoint ip_left;
    IntegrationPoint ip_right;
-   for (int i = 0; i < sbp_face->GetDof(); ++i)
+   for (int i = 0; i < num_face_nodes; ++i)
    {
       const IntegrationPoint &ip_face = sbp_face->GetNodes().IntPoint(i);
       trans.Loc1.Transform(ip_face, ip_left);
       trans.Loc2.Transform(ip_face, ip_right);
 
-      int i_left = sbp.getIntegrationPointIndex(ip_left);
-      u_left.GetRow(i_left, u_face_left);
-      int i_right = sbp.getIntegrationPointIndex(ip_right);
-      u_right.GetRow(i_right, u_face_right);
+      nodes_left[i] = sbp.getIntegrationPointIndex(ip_left);
+      nodes_right[i] = sbp.getIntegrationPointIndex(ip_right);
+      for (int n = 0; n < num_states; ++n)
+      {
+         u_nodes_left(n, i) = u_left(nodes_left[i], n);
+         u_nodes_right(n, i) = u_right(nodes_right[i], n);
+      }
 
-      // get the normal vector and the flux on the face
+      // get the normal vector on the face
       trans.Face->SetIntPoint(&ip_face);
       CalcOrtho(trans.Face->Jacobian(), nrm);
       nrm *= ip_face.weight;
-      flux(nrm, u_face_left, u_face_right, flux_face);
+      nrm_nodes.SetCol(i, nrm);
+   }
+   fluxNodes(nrm_nodes, u_nodes_left, u_nodes_right, flux_nodes);
 
-      // multiply by test functions from left and right elements
+   // multiply by test functions from left and right elements
+   for (int i = 0; i < num_face_nodes; ++i)
+   {
       for (int n = 0; n < num_states; ++n)
       {
-         res_left(i_left, n) += alpha * flux_face(n);
-         res_right(i_right, n) -= alpha * flux_face(n);
+         res_left(nodes_left[i], n) += alpha * flux_nodes(n, i);
+         res_right(nodes_right[i], n) -= alpha * flux_nodes(n, i);
       }
    }
 }
@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <variant>
+
+#include "mfem.hpp"
+
+#include "miso_input.hpp"
+#include "geometric_factor_cache.hpp"
+
+namespace miso
+{
+std::size_t ElementGeometricFactors::memoryUsage() const
+{
+   return sizeof(double) *
+          (weights.Size() + dets.Size() + shapes.TotalSize());
+}
+
+void calcCurlShapeFactors(const mfem::FiniteElement &el,
+                          mfem::ElementTransformation &trans,
+                          const mfem::IntegrationRule &ir,
+                          ElementGeometricFactors &factors)
+{
+   const int ndof = el.GetDof();
+   const int dim = el.GetDim();
+   const int dimc = (dim == 3) ? 3 : 1;
+   const int npoints = ir.GetNPoints();
+
+   factors.weights.SetSize(npoints);
+   factors.dets.SetSize(npoints);
+   factors.shapes.SetSize(ndof, dimc, npoints);
+
+   mfem::DenseMatrix curlshape(ndof, dimc);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+
+      factors.dets(i) = trans.Weight();
+      factors.weights(i) = ip.weight / factors.dets(i);
+
+      auto &curlshape_dFt = factors.shapes(i);
+      if (dim == 3)
+      {
+         el.CalcCurlShape(ip, curlshape);
+         MultABt(curlshape, trans.Jacobian(), curlshape_dFt);
+      }
+      else
+      {
+         el.CalcCurlShape(ip, curlshape_dFt);
+      }
+   }
+}
+
+void calcDShapeFactors(const mfem::FiniteElement &el,
+                       mfem::ElementTransformation &trans,
+                       const mfem::IntegrationRule &ir,
+                       ElementGeometricFactors &factors)
+{
+   const int ndof = el.GetDof();
+   const int dim = el.GetDim();
+   const int space_dim = trans.GetSpaceDim();
+   const int npoints = ir.GetNPoints();
+
+   factors.weights.SetSize(npoints);
+   factors.dets.SetSize(npoints);
+   factors.shapes.SetSize(ndof, space_dim, npoints);
+
+   mfem::DenseMatrix dshape(ndof, dim);
+   for (int i = 0; i < npoints; ++i)
+   {
+      const auto &ip = ir.IntPoint(i);
+      trans.SetIntPoint(&ip);
+
+      factors.dets(i) = trans.Weight();
+      factors.weights(i) = ip.weight / factors.dets(i);
+
+      el.CalcDShape(ip, dshape);
+      Mult(dshape, trans.AdjugateJacobian(), factors.shapes(i));
+   }
+}
+
+void setInputs(GeometricFactorCache &cache, const MISOInputs &inputs)
+{
+   if (!cache.enabled)
+   {
+      return;
+   }
+   auto it = inputs.find("mesh_coords");
+   if (it == inputs.end() || !std::holds_alternative<InputVector>(it->second))
+   {
+      return;
+   }
+   mfem::Vector mesh_coords;
+   setVectorFromInput(it->second, mesh_coords);
+
+   bool changed = mesh_coords.Size() != cache.mesh_coords.Size();
+   for (int i = 0; !changed && i < mesh_coords.Size(); ++i)
+   {
+      changed = mesh_coords(i) != cache.mesh_coords(i);
+   }
+   if (changed)
+   {
+      cache.clear();
+      cache.mesh_coords = mesh_coords;
+   }
+}
+
+void GeometricFactorCache::enable(bool use_cache)
+{
+   enabled = use_cache;
+   if (!enabled)
+   {
+      clear();
+      mesh_coords.Destroy();
+   }
+}
+
+const ElementGeometricFactors *GeometricFactorCache::find(int element,
+                                                          int npoints) const
+{
+   if (element < 0 || element >= static_cast<int>(elements.size()))
+   {
+      return nullptr;
+   }
+   const auto &factors = elements[element];
+   if (factors.numPoints() == 0 || factors.numPoints() != npoints)
+   {
+      return nullptr;
+   }
+   return &factors;
+}
+
+void GeometricFactorCache::store(int element,
+                                 const ElementGeometricFactors &factors)
+{
+   if (element >= static_cast<int>(elements.size()))
+   {
+      elements.resize(element + 1);
+   }
+   auto &cached = elements[element];
+   cached.weights = factors.weights;
+   cached.dets = factors.dets;
+   cached.shapes = factors.shapes;
+}
+
+void GeometricFactorCache::reserve(int num_elements)
+{
+   if (num_elements > static_cast<int>(elements.size()))
+   {
+      elements.resize(num_elements);
+   }
+}
+
+bool GeometricFactorCache::isFull(int num_elements) const
+{
+   if (num_elements > static_cast<int>(elements.size()))
+   {
+      return false;
+   }
+   for (int i = 0; i < num_elements; ++i)
+   {
+      if (elements[i].numPoints() == 0)
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void GeometricFactorCache::clear()
+{
+   elements.clear();
+}
+
+std::size_t GeometricFactorCache::memoryUsage() const
+{
+   std::size_t bytes = sizeof(double) * mesh_coords.Size();
+   for (const auto &factors : elements)
+   {
+      bytes += factors.memoryUsage();
+   }
+   return bytes;
+}
+
+}  // namespace miso
@@ -0,0 +1,151 @@
+#ifndef MISO_GEOMETRIC_FACTOR_CACHE
+#define MISO_GEOMETRIC_FACTOR_CACHE
+
+#include <cstddef>
+#include <vector>
+
+#include "mfem.hpp"
+
+#include "miso_input.hpp"
+
+namespace miso
+{
+/// \brief Geometric quantities of one element evaluated at every point of an
+/// integration rule
+struct ElementGeometricFactors
+{
+   /// integration point weight divided by the Jacobian determinant
+   mfem::Vector weights;
+   /// Jacobian determinant
+   mfem::Vector dets;
+   /// reference shape derivatives mapped by the element Jacobian (curls for
+   /// Nedelec elements, adjugate-scaled gradients for H1/L2 elements), stored
+   /// as an (ndof x dim x npoints) tensor
+   mfem::DenseTensor shapes;
+
+   /// \return the number of integration points the factors were computed for
+   int numPoints() const { return weights.Size(); }
+
+   /// \return the number of bytes used to store the factors
+   std::size_t memoryUsage() const;
+};
+
+/// \brief Compute the geometric factors used by curl-curl integrators
+/// \param[in] el - the Nedelec element whose curl shapes we want
+/// \param[in] trans - defines the reference to physical element mapping
+/// \param[in] ir - the integration rule to evaluate the factors at
+/// \param[out] factors - the element's geometric factors
+/// \note In 3D the curl shapes are multiplied by the transposed Jacobian, so
+/// they must still be divided by `dets` to get physical curls. In 2D they are
+/// the reference curls.
+void calcCurlShapeFactors(const mfem::FiniteElement &el,
+                          mfem::ElementTransformation &trans,
+                          const mfem::IntegrationRule &ir,
+                          ElementGeometricFactors &factors);
+
+/// \brief Compute the geometric factors used by diffusion integrators
+/// \param[in] el - the element whose shape gradients we want
+/// \param[in] trans - defines the reference to physical element mapping
+/// \param[in] ir - the integration rule to evaluate the factors at
+/// \param[out] factors - the element's geometric factors
+/// \note The shape gradients are multiplied by the adjugate of the Jacobian,
+/// so they must still be divided by `dets` to get physical gradients
+void calcDShapeFactors(const mfem::FiniteElement &el,
+                       mfem::ElementTransformation &trans,
+                       const mfem::IntegrationRule &ir,
+                       ElementGeometricFactors &factors);
+
+/// \brief Opt-in store of per-element geometric factors, so that repeated
+/// residual and Jacobian assemblies on an unchanged mesh can skip recomputing
+/// Jacobians, determinants, and transformed shape derivatives.
+/// \note The cache is keyed to the "mesh_coords" input: `setInputs` compares
+/// any new mesh coordinates against those the cache was built for and clears
+/// the cache if they differ.
+class GeometricFactorCache
+{
+public:
+   /// \brief Clears the cache if `inputs` holds mesh coordinates different
+   /// from the ones the cache was built with
+   friend void setInputs(GeometricFactorCache &cache, const MISOInputs &inputs);
+
+   /// \brief Turn caching on or off; turning it off releases the memory
+   void enable(bool use_cache);
+
+   /// \return true if the cache is in use
+   bool isEnabled() const { return enabled; }
+
+   /// \brief Look up the cached factors of an element
+   /// \param[in] element - the element number, `trans.ElementNo`
+   /// \param[in] npoints - number of points of the integration rule in use
+   /// \return the cached factors, or nullptr if they are not cached for a rule
+   /// with `npoints` points
+   const ElementGeometricFactors *find(int element, int npoints) const;
+
+   /// \brief Store a copy of an element's geometric factors
+   /// \param[in] element - the element number, `trans.ElementNo`
+   /// \param[in] factors - the factors to store
+   /// \note Different threads may store different elements concurrently once
+   /// `reserve` has been called for all of the elements
+   void store(int element, const ElementGeometricFactors &factors);
+
+   /// \brief Make room for `num_elements` elements so that `store` does not
+   /// need to grow the cache
+   void reserve(int num_elements);
+
+   /// \return true if the factors of all of the first `num_elements` elements
+   /// are cached
+   bool isFull(int num_elements) const;
+
+   /// \brief Drop all cached factors, keeping the cache enabled
+   void clear();
+
+   /// \return the number of bytes used by the cached factors
+   std::size_t memoryUsage() const;
+
+private:
+   /// whether or not factors are being cached
+   bool enabled = false;
+   /// cached factors, indexed by element number
+   std::vector<ElementGeometricFactors> elements;
+   /// the mesh coordinates the cached factors were computed on
+   mfem::Vector mesh_coords;
+};
+
+/// \brief Get the cached factors of `trans.ElementNo`, computing (and, if the
+/// cache is enabled, storing) them if needed
+/// \param[in] cache - the cache to look in
+/// \param[in] calc_factors - function used to compute the factors, e.g.
+/// `calcCurlShapeFactors`
+/// \param[in] el - the element whose factors we want
+/// \param[in] trans - defines the reference to physical element mapping
+/// \param[in] ir - the integration rule to evaluate the factors at
+/// \param[in] scratch - storage used if the factors are not cached
+/// \return reference to either the cached factors or `scratch`
+template <typename CalcFactors>
+const ElementGeometricFactors &getGeometricFactors(
+    GeometricFactorCache &cache,
+    CalcFactors &&calc_factors,
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::IntegrationRule &ir,
+    ElementGeometricFactors &scratch)
+{
+   if (cache.isEnabled())
+   {
+      const auto *cached = cache.find(trans.ElementNo, ir.GetNPoints());
+      if (cached != nullptr)
+      {
+         return *cached;
+      }
+   }
+   calc_factors(el, trans, ir, scratch);
+   if (cache.isEnabled())
+   {
+      cache.store(trans.ElementNo, scratch);
+   }
+   return scratch;
+}
+
+}  // namespace miso
+
+#endif
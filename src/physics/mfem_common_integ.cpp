@@ -813,6 +813,45 @@ void IEAggregateIntegratorNumerator::AssembleElementVector(
    }
 }
 
+void IEAggregateIntegratorNumerator::AddElementEnergies(
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::Vector &elfun,
+    double &max,
+    double &num,
+    double &denom)
+{
+#ifdef MFEM_THREAD_SAFE
+   mfem::Vector shape(elfun.Size());
+#else
+   shape.SetSize(elfun.Size());
+#endif
+
+   const auto *ir = &IntRules.Get(el.GetGeomType(), 2 * el.GetOrder());
+
+   for (int i = 0; i < ir->GetNPoints(); ++i)
+   {
+      const auto &ip = ir->IntPoint(i);
+      trans.SetIntPoint(&ip);
+      const double trans_weight = trans.Weight();
+      const double w = ip.weight * trans_weight;
+
+      el.CalcShape(ip, shape);
+      const double g = shape * elfun;
+      if (g > max)
+      {
+         const double scale = shiftScale(max, g);
+         num *= scale;
+         denom *= scale;
+         max = g;
+      }
+      const double exp_rho_g = exp(rho * (g - max));
+
+      num += g * exp_rho_g * w;
+      denom += exp_rho_g * w;
+   }
+}
+
 void IEAggregateIntegratorNumeratorMeshSens::AssembleRHSElementVect(
     const mfem::FiniteElement &mesh_el,
     mfem::ElementTransformation &mesh_trans,
@@ -1062,6 +1101,12 @@ void setOptions(IECurlMagnitudeAggregateIntegratorNumerator &integ,
    }
 }
 
+void setInputs(IECurlMagnitudeAggregateIntegratorNumerator &integ,
+               const MISOInputs &inputs)
+{
+   setValueFromInputs(inputs, "true_max", integ.true_max);
+}
+
 double IECurlMagnitudeAggregateIntegratorNumerator::GetElementEnergy(
     const mfem::FiniteElement &el,
     mfem::ElementTransformation &trans,
@@ -1124,7 +1169,8 @@ double IECurlMagnitudeAggregateIntegratorNumerator::GetElementEnergy(
       const double curl_vec_norm = curl_vec.Norml2();
       const double curl_mag = curl_vec_norm / trans_weight;
 
-      const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      const double exp_rho_curl_mag =
+          exp(rho * (curl_mag - true_max) / actual_max);
       fun += curl_mag * exp_rho_curl_mag * w;
    }
    return fun;
@@ -1197,7 +1243,8 @@ void IECurlMagnitudeAggregateIntegratorNumerator::AssembleElementVector(
       const double curl_vec_norm = curl_vec.Norml2();
       const double curl_mag = curl_vec_norm / trans_weight;
 
-      const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      const double exp_rho_curl_mag =
+          exp(rho * (curl_mag - true_max) / actual_max);
       // fun += curl_mag * exp_rho_curl_mag * w;
 
       /// Start reverse pass...
@@ -1211,7 +1258,8 @@ void IECurlMagnitudeAggregateIntegratorNumerator::AssembleElementVector(
       exp_rho_curl_mag_bar += fun_bar * curl_mag * w;
       // w_bar += fun_bar * curl_mag * exp_rho_curl_mag;
 
-      /// const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      /// const double exp_rho_curl_mag =
+      ///     exp(rho * (curl_mag - true_max) / actual_max);
       curl_mag_bar +=
           exp_rho_curl_mag_bar * rho / actual_max * exp_rho_curl_mag;
 
@@ -1229,6 +1277,84 @@ void IECurlMagnitudeAggregateIntegratorNumerator::AssembleElementVector(
    }
 }
 
+void IECurlMagnitudeAggregateIntegratorNumerator::AddElementEnergies(
+    const mfem::FiniteElement &el,
+    mfem::ElementTransformation &trans,
+    const mfem::Vector &elfun,
+    double &max,
+    double &num,
+    double &denom)
+{
+   int ndof = el.GetDof();
+   int space_dim = trans.GetSpaceDim();
+   int curl_dim = space_dim;
+
+#ifdef MFEM_THREAD_SAFE
+   mfem::DenseMatrix curlshape(ndof, curl_dim);
+   mfem::DenseMatrix curlshape_dFt(ndof, curl_dim);
+#endif
+   curlshape.SetSize(ndof, curl_dim);
+   curlshape_dFt.SetSize(ndof, curl_dim);
+
+   double curl_vec_buffer[3];
+   Vector curl_vec(curl_vec_buffer, curl_dim);
+
+   const IntegrationRule *ir = IntRule;
+   if (ir == nullptr)
+   {
+      int order = [&]()
+      {
+         if (el.Space() == FunctionSpace::Pk)
+         {
+            return 2 * el.GetOrder() - 2;
+         }
+         else
+         {
+            return 2 * el.GetOrder();
+         }
+      }();
+
+      ir = &IntRules.Get(el.GetGeomType(), order);
+   }
+
+   for (int i = 0; i < ir->GetNPoints(); ++i)
+   {
+      curl_vec = 0.0;
+
+      const auto &ip = ir->IntPoint(i);
+      trans.SetIntPoint(&ip);
+
+      double trans_weight = trans.Weight();
+      const double w = ip.weight * trans_weight;
+
+      if (space_dim == 3)
+      {
+         el.CalcCurlShape(ip, curlshape);
+         MultABt(curlshape, trans.Jacobian(), curlshape_dFt);
+      }
+      else
+      {
+         el.CalcDShape(ip, curlshape);
+         Mult(curlshape, trans.AdjugateJacobian(), curlshape_dFt);
+      }
+      curlshape_dFt.AddMultTranspose(elfun, curl_vec);
+      const double curl_vec_norm = curl_vec.Norml2();
+      const double curl_mag = curl_vec_norm / trans_weight;
+      if (curl_mag > max)
+      {
+         const double scale = shiftScale(max, curl_mag);
+         num *= scale;
+         denom *= scale;
+         max = curl_mag;
+      }
+
+      const double exp_rho_curl_mag =
+          exp(rho * (curl_mag - max) / actual_max);
+      num += curl_mag * exp_rho_curl_mag * w;
+      denom += exp_rho_curl_mag * w;
+   }
+}
+
 void IECurlMagnitudeAggregateIntegratorNumeratorMeshSens::
     AssembleRHSElementVect(const FiniteElement &mesh_el,
                            ElementTransformation &mesh_trans,
@@ -1294,6 +1420,7 @@ void IECurlMagnitudeAggregateIntegratorNumeratorMeshSens::
 
    auto rho = integ.rho;
    auto actual_max = integ.actual_max;
+   auto true_max = integ.true_max;
 
    mesh_coords_bar.SetSize(mesh_ndof * space_dim);
    mesh_coords_bar = 0.0;
@@ -1320,7 +1447,8 @@ void IECurlMagnitudeAggregateIntegratorNumeratorMeshSens::
       const double curl_vec_norm = curl_vec.Norml2();
       const double curl_mag = curl_vec_norm / trans_weight;
 
-      const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      const double exp_rho_curl_mag =
+          exp(rho * (curl_mag - true_max) / actual_max);
 
       // fun += curl_mag * exp_rho_curl_mag * w;
 
@@ -1335,7 +1463,8 @@ void IECurlMagnitudeAggregateIntegratorNumeratorMeshSens::
       exp_rho_curl_mag_bar += fun_bar * curl_mag * w;
       w_bar += fun_bar * curl_mag * exp_rho_curl_mag;
 
-      /// const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      /// const double exp_rho_curl_mag =
+      ///     exp(rho * (curl_mag - true_max) / actual_max);
       curl_mag_bar +=
           exp_rho_curl_mag_bar * rho / actual_max * exp_rho_curl_mag;
 
@@ -1403,6 +1532,12 @@ void setOptions(IECurlMagnitudeAggregateIntegratorDenominator &integ,
    }
 }
 
+void setInputs(IECurlMagnitudeAggregateIntegratorDenominator &integ,
+               const MISOInputs &inputs)
+{
+   setValueFromInputs(inputs, "true_max", integ.true_max);
+}
+
 double IECurlMagnitudeAggregateIntegratorDenominator::GetElementEnergy(
     const mfem::FiniteElement &el,
     mfem::ElementTransformation &trans,
@@ -1464,7 +1599,8 @@ double IECurlMagnitudeAggregateIntegratorDenominator::GetElementEnergy(
       const double curl_vec_norm = curl_vec.Norml2();
       const double curl_mag = curl_vec_norm / trans_weight;
 
-      const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      const double exp_rho_curl_mag =
+          exp(rho * (curl_mag - true_max) / actual_max);
 
       fun += exp_rho_curl_mag * w;
    }
@@ -1536,7 +1672,8 @@ void IECurlMagnitudeAggregateIntegratorDenominator::AssembleElementVector(
       const double curl_vec_norm = curl_vec.Norml2();
       const double curl_mag = curl_vec_norm / trans_weight;
 
-      const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      const double exp_rho_curl_mag =
+          exp(rho * (curl_mag - true_max) / actual_max);
       // fun += exp_rho_curl_mag * w;
 
       /// Start reverse pass...
@@ -1548,7 +1685,8 @@ void IECurlMagnitudeAggregateIntegratorDenominator::AssembleElementVector(
       exp_rho_curl_mag_bar += fun_bar * w;
       // w_bar += fun_bar * exp_rho_curl_mag;
 
-      /// const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      /// const double exp_rho_curl_mag =
+      ///     exp(rho * (curl_mag - true_max) / actual_max);
       double curl_mag_bar = 0.0;
       curl_mag_bar +=
           exp_rho_curl_mag_bar * rho / actual_max * exp_rho_curl_mag;
@@ -1632,6 +1770,7 @@ void IECurlMagnitudeAggregateIntegratorDenominatorMeshSens::
 
    auto rho = integ.rho;
    auto actual_max = integ.actual_max;
+   auto true_max = integ.true_max;
 
    mesh_coords_bar.SetSize(mesh_ndof * space_dim);
    mesh_coords_bar = 0.0;
@@ -1658,7 +1797,8 @@ void IECurlMagnitudeAggregateIntegratorDenominatorMeshSens::
       const double curl_vec_norm = curl_vec.Norml2();
       const double curl_mag = curl_vec_norm / trans_weight;
 
-      const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      const double exp_rho_curl_mag =
+          exp(rho * (curl_mag - true_max) / actual_max);
 
       // fun += exp_rho_curl_mag * w;
 
@@ -1671,7 +1811,8 @@ void IECurlMagnitudeAggregateIntegratorDenominatorMeshSens::
       exp_rho_curl_mag_bar += fun_bar * w;
       w_bar += fun_bar * exp_rho_curl_mag;
 
-      /// const double exp_rho_curl_mag = exp(rho * (curl_mag / actual_max));
+      /// const double exp_rho_curl_mag =
+      ///     exp(rho * (curl_mag - true_max) / actual_max);
       double curl_mag_bar = 0.0;
       curl_mag_bar +=
           exp_rho_curl_mag_bar * rho / actual_max * exp_rho_curl_mag;
@@ -383,6 +383,31 @@ public:
                               const mfem::Vector &elfun,
                               mfem::Vector &elfun_bar) override;
 
+   /// \brief Add an element's contributions to both the numerator and the
+   /// denominator of the aggregate, in a single pass over its points
+   /// \param[in] el - the finite element
+   /// \param[in] trans - the transformation between reference and physical
+   /// space
+   /// \param[in] elfun - the state on the element
+   /// \param[inout] max - the largest state value seen so far, which shifts
+   /// the exponentials of `num` and `denom`; when a larger value is found the
+   /// sums are rescaled to it
+   /// \param[inout] num - the shifted numerator
+   /// \param[inout] denom - the shifted denominator
+   void AddElementEnergies(const mfem::FiniteElement &el,
+                           mfem::ElementTransformation &trans,
+                           const mfem::Vector &elfun,
+                           double &max,
+                           double &num,
+                           double &denom);
+
+   /// \return the factor that rescales sums shifted by `from` to sums shifted
+   /// by `to`
+   double shiftScale(double from, double to) const
+   {
+      return exp(rho * (from - to));
+   }
+
 private:
    /// aggregation parameter rho
    double rho;
@@ -556,6 +581,9 @@ public:
    friend void setOptions(IECurlMagnitudeAggregateIntegratorNumerator &integ,
                           const nlohmann::json &options);
 
+   friend void setInputs(IECurlMagnitudeAggregateIntegratorNumerator &integ,
+                         const MISOInputs &inputs);
+
    IECurlMagnitudeAggregateIntegratorNumerator(double rho,
                                                double actual_max = 1.0)
     : rho(rho), actual_max(actual_max)
@@ -570,11 +598,39 @@ public:
                               const mfem::Vector &elfun,
                               mfem::Vector &elfun_bar) override;
 
+   /// \brief Add an element's contributions to both the numerator and the
+   /// denominator of the aggregate, in a single pass over its points
+   /// \param[in] el - the finite element
+   /// \param[in] trans - the transformation between reference and physical
+   /// space
+   /// \param[in] elfun - the state on the element
+   /// \param[inout] max - the largest curl magnitude seen so far, which shifts
+   /// the exponentials of `num` and `denom`; when a larger value is found the
+   /// sums are rescaled to it
+   /// \param[inout] num - the shifted numerator
+   /// \param[inout] denom - the shifted denominator
+   void AddElementEnergies(const mfem::FiniteElement &el,
+                           mfem::ElementTransformation &trans,
+                           const mfem::Vector &elfun,
+                           double &max,
+                           double &num,
+                           double &denom);
+
+   /// \return the factor that rescales sums shifted by `from` to sums shifted
+   /// by `to`
+   double shiftScale(double from, double to) const
+   {
+      return exp(rho * (from - to) / actual_max);
+   }
+
 private:
    /// aggregation parameter rho
    double rho;
    /// actual maximum from the data, makes the calculation more stable
    double actual_max;
+   /// shift of the curl magnitude in the exponent - used to improve numerical
+   /// conditioning
+   double true_max = 0.0;
 #ifndef MFEM_THREAD_SAFE
    mfem::DenseMatrix curlshape, curlshape_dFt;
 #endif
@@ -653,6 +709,9 @@ public:
    friend void setOptions(IECurlMagnitudeAggregateIntegratorDenominator &integ,
                           const nlohmann::json &options);
 
+   friend void setInputs(IECurlMagnitudeAggregateIntegratorDenominator &integ,
+                         const MISOInputs &inputs);
+
    IECurlMagnitudeAggregateIntegratorDenominator(const double rho,
                                                  double actual_max = 1.0)
     : rho(rho), actual_max(actual_max)
@@ -672,6 +731,9 @@ private:
    double rho;
    /// actual maximum from the data, makes the calculation more stable
    double actual_max;
+   /// shift of the curl magnitude in the exponent - used to improve numerical
+   /// conditioning
+   double true_max = 0.0;
 #ifndef MFEM_THREAD_SAFE
    mfem::DenseMatrix curlshape, curlshape_dFt;
 #endif
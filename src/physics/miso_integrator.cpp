@@ -1,9 +1,12 @@
+#include <cstddef>
 #include <string>
 
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
 
 #include "miso_input.hpp"
+#include "utils.hpp"
+
 #include "miso_integrator.hpp"
 
 namespace miso
@@ -36,4 +39,64 @@ void setOptions(MISOIntegrator &integ, const nlohmann::json &options)
    integ.self_->setOptions_(options);
 }
 
+std::size_t getGeometricCacheMemory(
+    const std::vector<MISOIntegrator> &integrators)
+{
+   std::size_t bytes = 0;
+   for (const auto &integ : integrators)
+   {
+      bytes += getGeometricCacheMemory(integ);
+   }
+   return bytes;
+}
+
+std::size_t getGeometricCacheMemory(const MISOIntegrator &integ)
+{
+   return integ.self_->getGeometricCacheMemory_();
+}
+
+bool prepareThreadedAssembly(std::vector<MISOIntegrator> &integrators,
+                             int num_threads,
+                             int num_elements)
+{
+   bool threadable = true;
+   for (auto &integ : integrators)
+   {
+      /// prepare every integrator, even after one has opted out
+      threadable =
+          prepareThreadedAssembly(integ, num_threads, num_elements) &&
+          threadable;
+   }
+   return threadable;
+}
+
+bool prepareThreadedAssembly(MISOIntegrator &integ,
+                             int num_threads,
+                             int num_elements)
+{
+   return integ.self_->prepareThreadedAssembly_(num_threads, num_elements);
+}
+
+void assembleElementVectorAndGrad(mfem::LinearFormIntegrator &integ,
+                                  const mfem::FiniteElement &el,
+                                  mfem::ElementTransformation &trans,
+                                  const mfem::Vector &elfun,
+                                  mfem::Vector &elvect,
+                                  mfem::DenseMatrix &elmat)
+{
+   throw MISOException(
+       "assembleElementVectorAndGrad: a LinearFormIntegrator has no element "
+       "Jacobian!\n");
+}
+
+void assembleElementVectorAndGrad(MISOIntegrator &integ,
+                                  const mfem::FiniteElement &el,
+                                  mfem::ElementTransformation &trans,
+                                  const mfem::Vector &elfun,
+                                  mfem::Vector &elvect,
+                                  mfem::DenseMatrix &elmat)
+{
+   integ.self_->assembleElementVectorAndGrad_(el, trans, elfun, elvect, elmat);
+}
+
 }  // namespace miso
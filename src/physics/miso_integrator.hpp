@@ -1,6 +1,7 @@
 #ifndef MISO_INTEGRATOR
 #define MISO_INTEGRATOR
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <vector>
@@ -42,6 +43,65 @@ inline void setOptions(mfem::LinearFormIntegrator &integ,
                        const nlohmann::json &options)
 { }
 
+/// Default implementation of getGeometricCacheMemory for a
+/// NonlinearFormIntegrator that does not cache geometric factors
+inline std::size_t getGeometricCacheMemory(
+    const mfem::NonlinearFormIntegrator &integ)
+{
+   return 0;
+}
+
+/// Default implementation of getGeometricCacheMemory for a
+/// LinearFormIntegrator that does not cache geometric factors
+inline std::size_t getGeometricCacheMemory(
+    const mfem::LinearFormIntegrator &integ)
+{
+   return 0;
+}
+
+/// Default implementation of prepareThreadedAssembly for a
+/// NonlinearFormIntegrator whose scratch storage is shared between threads, so
+/// it must be assembled serially
+inline bool prepareThreadedAssembly(mfem::NonlinearFormIntegrator &integ,
+                                    int num_threads,
+                                    int num_elements)
+{
+   return false;
+}
+
+/// Default implementation of prepareThreadedAssembly for a
+/// LinearFormIntegrator whose scratch storage is shared between threads, so it
+/// must be assembled serially
+inline bool prepareThreadedAssembly(mfem::LinearFormIntegrator &integ,
+                                    int num_threads,
+                                    int num_elements)
+{
+   return false;
+}
+
+/// Default implementation of assembleElementVectorAndGrad for a
+/// NonlinearFormIntegrator without a fused kernel, which assembles the element
+/// residual and then its Jacobian
+inline void assembleElementVectorAndGrad(mfem::NonlinearFormIntegrator &integ,
+                                         const mfem::FiniteElement &el,
+                                         mfem::ElementTransformation &trans,
+                                         const mfem::Vector &elfun,
+                                         mfem::Vector &elvect,
+                                         mfem::DenseMatrix &elmat)
+{
+   integ.AssembleElementVector(el, trans, elfun, elvect);
+   integ.AssembleElementGrad(el, trans, elfun, elmat);
+}
+
+/// Default implementation of assembleElementVectorAndGrad for a
+/// LinearFormIntegrator, which has no element Jacobian
+void assembleElementVectorAndGrad(mfem::LinearFormIntegrator &integ,
+                                  const mfem::FiniteElement &el,
+                                  mfem::ElementTransformation &trans,
+                                  const mfem::Vector &elfun,
+                                  mfem::Vector &elvect,
+                                  mfem::DenseMatrix &elmat);
+
 /// Creates common interface for integrators used by miso
 /// A MISOIntegrator can wrap any type `T` that has a function
 /// `setInput(T &, const std::string &, const MISOInput &)` defined.
@@ -60,6 +120,16 @@ class MISOIntegrator
 public:
    friend void setInputs(MISOIntegrator &integ, const MISOInputs &inputs);
    friend void setOptions(MISOIntegrator &integ, const nlohmann::json &options);
+   friend std::size_t getGeometricCacheMemory(const MISOIntegrator &integ);
+   friend bool prepareThreadedAssembly(MISOIntegrator &integ,
+                                       int num_threads,
+                                       int num_elements);
+   friend void assembleElementVectorAndGrad(MISOIntegrator &integ,
+                                            const mfem::FiniteElement &el,
+                                            mfem::ElementTransformation &trans,
+                                            const mfem::Vector &elfun,
+                                            mfem::Vector &elvect,
+                                            mfem::DenseMatrix &elmat);
 
    template <typename T>
    MISOIntegrator(T &x) : self_(new model<T>(x))
@@ -85,6 +155,15 @@ private:
       virtual concept_t *copy_() const = 0;
       virtual void setInputs_(const MISOInputs &inputs) const = 0;
       virtual void setOptions_(const nlohmann::json &options) const = 0;
+      virtual std::size_t getGeometricCacheMemory_() const = 0;
+      virtual bool prepareThreadedAssembly_(int num_threads,
+                                            int num_elements) const = 0;
+      virtual void assembleElementVectorAndGrad_(
+          const mfem::FiniteElement &el,
+          mfem::ElementTransformation &trans,
+          const mfem::Vector &elfun,
+          mfem::Vector &elvect,
+          mfem::DenseMatrix &elmat) const = 0;
    };
 
    template <typename T>
@@ -101,6 +180,24 @@ private:
       {
          setOptions(integ, options);
       }
+      std::size_t getGeometricCacheMemory_() const override
+      {
+         return getGeometricCacheMemory(integ);
+      }
+      bool prepareThreadedAssembly_(int num_threads,
+                                    int num_elements) const override
+      {
+         return prepareThreadedAssembly(integ, num_threads, num_elements);
+      }
+      void assembleElementVectorAndGrad_(
+          const mfem::FiniteElement &el,
+          mfem::ElementTransformation &trans,
+          const mfem::Vector &elfun,
+          mfem::Vector &elvect,
+          mfem::DenseMatrix &elmat) const override
+      {
+         assembleElementVectorAndGrad(integ, el, trans, elfun, elvect, elmat);
+      }
 
       T &integ;
    };
@@ -122,6 +219,48 @@ void setOptions(std::vector<MISOIntegrator> &integrators,
 /// Used to set options in the underlying integrator
 void setOptions(MISOIntegrator &integ, const nlohmann::json &options);
 
+/// Used to get the memory used by geometric factor caches in several
+/// integrators, in bytes
+std::size_t getGeometricCacheMemory(
+    const std::vector<MISOIntegrator> &integrators);
+
+/// Used to get the memory used by the underlying integrator's geometric factor
+/// cache, in bytes
+std::size_t getGeometricCacheMemory(const MISOIntegrator &integ);
+
+/// Used to prepare several integrators for element assembly by multiple
+/// threads
+/// \param[in] num_threads - number of threads that will assemble elements
+/// \param[in] num_elements - number of elements that will be assembled
+/// \return true only if every integrator can be assembled concurrently
+bool prepareThreadedAssembly(std::vector<MISOIntegrator> &integrators,
+                             int num_threads,
+                             int num_elements);
+
+/// Used to prepare the underlying integrator for element assembly by multiple
+/// threads
+/// \param[in] num_threads - number of threads that will assemble elements
+/// \param[in] num_elements - number of elements that will be assembled
+/// \return true if the integrator can be assembled concurrently
+bool prepareThreadedAssembly(MISOIntegrator &integ,
+                             int num_threads,
+                             int num_elements);
+
+/// Used to assemble the element residual and Jacobian of the underlying
+/// integrator together, in one pass over the element's quadrature points if
+/// the integrator has a fused kernel
+/// \param[in] el - the finite element
+/// \param[in] trans - defines the reference to physical element mapping
+/// \param[in] elfun - element local state function
+/// \param[out] elvect - element local residual
+/// \param[out] elmat - element local Jacobian
+void assembleElementVectorAndGrad(MISOIntegrator &integ,
+                                  const mfem::FiniteElement &el,
+                                  mfem::ElementTransformation &trans,
+                                  const mfem::Vector &elfun,
+                                  mfem::Vector &elvect,
+                                  mfem::DenseMatrix &elmat);
+
 /// Function meant to be overloaded to allow residual sensitivity integrators
 /// to be associated with the forward version of the integrator
 /// \param[in] primal_integ - integrator used in forward evaluation
@@ -1,14 +1,595 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <vector>
 
 #include "mfem.hpp"
 
 #include "utils.hpp"
+#include "mfem_extensions.hpp"
 #include "miso_input.hpp"
 #include "miso_integrator.hpp"
+#include "thread_workspaces.hpp"
+#include "timers.hpp"
 #include "miso_nonlinearform.hpp"
 
+namespace
+{
+/// \return true if the elements of `fes` need DOF transformations (e.g. high
+/// order Nedelec elements on tets)
+bool hasDofTransformations(mfem::ParFiniteElementSpace &fes)
+{
+   mfem::Array<mfem::Geometry::Type> geoms;
+   fes.GetMesh()->GetGeometries(fes.GetMesh()->Dimension(), geoms);
+   for (auto geom : geoms)
+   {
+      if (fes.FEColl()->DofTransformationForGeometry(geom) != nullptr)
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+/// \brief Get the vdofs and DOF transformation of element `e` and pass them
+/// to `op`
+/// \note A FiniteElementSpace stores a single DofTransformation that
+/// `GetElementVDofs` updates in place, so when `dof_trans` is true `op` is run
+/// by one thread at a time
+template <typename Op>
+void withElementVDofs(mfem::ParFiniteElementSpace &fes,
+                      int e,
+                      bool dof_trans,
+                      mfem::Array<int> &vdofs,
+                      Op &&op)
+{
+   if (!dof_trans)
+   {
+      op(fes.GetElementVDofs(e, vdofs));
+      return;
+   }
+#ifdef MISO_USE_OPENMP
+#pragma omp critical(miso_element_dof_transformation)
+#endif
+   {
+      op(fes.GetElementVDofs(e, vdofs));
+   }
+}
+
+/// \brief Fill `trans` with the transformation of element `e`
+/// \note the mesh lazily builds shared geometric data (e.g. nodal
+/// coordinates) when filling a transformation, so this is run by one thread
+/// at a time
+void getElementTransformation(mfem::Mesh &mesh,
+                              int e,
+                              mfem::IsoparametricTransformation &trans)
+{
+#ifdef MISO_USE_OPENMP
+#pragma omp critical(miso_element_transformation)
+#endif
+   {
+      mesh.GetElementTransformation(e, &trans);
+   }
+}
+
+/// \brief Build the sparsity of the local Jacobian, with explicit zeros for
+/// every entry coupled by an element
+std::unique_ptr<mfem::SparseMatrix> buildElementSparsity(
+    mfem::ParFiniteElementSpace &fes)
+{
+   auto mat = std::make_unique<mfem::SparseMatrix>(fes.GetVSize());
+   mfem::Array<int> vdofs;
+   mfem::DenseMatrix zeros;
+   for (int e = 0; e < fes.GetNE(); ++e)
+   {
+      fes.GetElementVDofs(e, vdofs);
+      zeros.SetSize(vdofs.Size());
+      zeros = 0.0;
+      mat->AddSubMatrix(vdofs, vdofs, zeros, 0);
+   }
+   mat->Finalize(0);
+   return mat;
+}
+
+/// \brief Add an element matrix into a finalized matrix whose sparsity
+/// already holds every entry; safe to call from several threads at once
+void addElementMatrix(const mfem::Array<int> &vdofs,
+                      const mfem::DenseMatrix &elmat,
+                      mfem::SparseMatrix &mat)
+{
+   for (int i = 0; i < vdofs.Size(); ++i)
+   {
+      const int row = vdofs[i] >= 0 ? vdofs[i] : -1 - vdofs[i];
+      const double row_sign = vdofs[i] >= 0 ? 1.0 : -1.0;
+      for (int j = 0; j < vdofs.Size(); ++j)
+      {
+         const int col = vdofs[j] >= 0 ? vdofs[j] : -1 - vdofs[j];
+         const double col_sign = vdofs[j] >= 0 ? 1.0 : -1.0;
+         const double value = row_sign * col_sign * elmat(i, j);
+         double &entry = mat(row, col);
+#ifdef MISO_USE_OPENMP
+#pragma omp atomic
+#endif
+         entry += value;
+      }
+   }
+}
+
+/// \brief Check if a square operator is symmetric by comparing y^T A x with
+/// x^T A y for random vectors x and y
+/// \param[in] op - the operator to check
+/// \param[in] comm - communicator the operator is distributed over
+/// \return true if the two products agree to a relative tolerance of 1e-10
+bool isSymmetric(const mfem::Operator &op, MPI_Comm comm)
+{
+   int rank = 0;
+   MPI_Comm_rank(comm, &rank);
+
+   mfem::Vector x(op.Width());
+   mfem::Vector y(op.Width());
+   x.Randomize(2 * rank + 1);
+   y.Randomize(2 * rank + 2);
+
+   mfem::Vector op_x(op.Height());
+   mfem::Vector op_y(op.Height());
+   op.Mult(x, op_x);
+   op.Mult(y, op_y);
+
+   const double y_op_x = mfem::InnerProduct(comm, y, op_x);
+   const double x_op_y = mfem::InnerProduct(comm, x, op_y);
+   const double scale = std::max(std::abs(y_op_x), std::abs(x_op_y));
+   return std::abs(y_op_x - x_op_y) <= 1e-10 * scale;
+}
+
+/// \brief Add the finalized matrix `a` to the finalized matrix `sum` in place
+/// \param[in] a - the matrix being added
+/// \param[inout] sum - the matrix `a` is added to
+/// \param[inout] positions - `sum.Width()` entries, all -1, which are -1 again
+/// on return
+/// \return false if `a` has an entry outside the sparsity of `sum`, in which
+/// case `sum` is only partly updated
+bool addInPlace(const mfem::SparseMatrix &a,
+                mfem::SparseMatrix &sum,
+                mfem::Array<int> &positions)
+{
+   const int *a_i = a.GetI();
+   const int *a_j = a.GetJ();
+   const double *a_data = a.GetData();
+   const int *sum_i = sum.GetI();
+   const int *sum_j = sum.GetJ();
+   double *sum_data = sum.GetData();
+   bool contained = true;
+   for (int row = 0; row < a.Height() && contained; ++row)
+   {
+      for (int k = sum_i[row]; k < sum_i[row + 1]; ++k)
+      {
+         positions[sum_j[k]] = k;
+      }
+      for (int k = a_i[row]; k < a_i[row + 1]; ++k)
+      {
+         const int pos = positions[a_j[k]];
+         if (pos < 0)
+         {
+            contained = false;
+            break;
+         }
+         sum_data[pos] += a_data[k];
+      }
+      for (int k = sum_i[row]; k < sum_i[row + 1]; ++k)
+      {
+         positions[sum_j[k]] = -1;
+      }
+   }
+   return contained;
+}
+
+/// Takes the domain integrators and essential dofs out of a nonlinear form, so
+/// that it only assembles its face and boundary terms, and gives them back
+/// when it goes out of scope, even if assembly throws
+class FaceIntegratorsOnly
+{
+public:
+   explicit FaceIntegratorsOnly(mfem::NonlinearForm &nf)
+    : nf(nf), ess_tdof_list(nf.GetEssentialTrueDofs())
+   {
+      mfem::Swap(domain_integs, *nf.GetDNFI());
+      nf.SetEssentialTrueDofs(mfem::Array<int>());
+   }
+
+   ~FaceIntegratorsOnly()
+   {
+      mfem::Swap(domain_integs, *nf.GetDNFI());
+      nf.SetEssentialTrueDofs(ess_tdof_list);
+   }
+
+   FaceIntegratorsOnly(const FaceIntegratorsOnly &) = delete;
+   FaceIntegratorsOnly &operator=(const FaceIntegratorsOnly &) = delete;
+
+private:
+   mfem::NonlinearForm &nf;
+   /// the form's essential dofs, which are not applied to the face terms
+   mfem::Array<int> ess_tdof_list;
+   /// the form's domain integrators while they are swapped out
+   mfem::Array<mfem::NonlinearFormIntegrator *> domain_integs;
+};
+
+}  // anonymous namespace
+
 namespace miso
 {
+bool MISONonlinearForm::useThreadedAssembly()
+{
+   if (assembly_threads < 2)
+   {
+      return false;
+   }
+   /// face and boundary integrators are only assembled by `nf`
+   if (nf.GetDNFI()->Size() != static_cast<int>(integs.size()))
+   {
+      return false;
+   }
+   return prepareThreadedAssembly(
+       integs, assembly_threads, nf.ParFESpace()->GetNE());
+}
+
+void MISONonlinearForm::multThreaded(const mfem::Vector &state,
+                                     mfem::Vector &res_vec)
+{
+   auto &fes = *nf.ParFESpace();
+   auto &mesh = *fes.GetMesh();
+   const auto &dnfi = *nf.GetDNFI();
+   const auto *prolong = fes.GetProlongationMatrix();
+   const int num_elements = fes.GetNE();
+   const bool dof_trans = hasDofTransformations(fes);
+
+   assembly_state.SetSize(fes.GetVSize());
+   prolong->Mult(state, assembly_state);
+
+   thread_res.resize(assembly_threads);
+   for (auto &local_res : thread_res)
+   {
+      local_res.SetSize(fes.GetVSize());
+      local_res = 0.0;
+   }
+
+#ifdef MISO_USE_OPENMP
+#pragma omp parallel num_threads(assembly_threads)
+#endif
+   {
+      auto &local_res = thread_res[getAssemblyThreadNum()];
+      mfem::IsoparametricTransformation trans;
+      mfem::Array<int> vdofs;
+      mfem::Vector elfun;
+      mfem::Vector elvect;
+      mfem::Vector elres;
+
+#ifdef MISO_USE_OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (int e = 0; e < num_elements; ++e)
+      {
+         const auto &el = *fes.GetFE(e);
+         withElementVDofs(fes,
+                          e,
+                          dof_trans,
+                          vdofs,
+                          [&](mfem::DofTransformation *dof_tr)
+                          {
+                             assembly_state.GetSubVector(vdofs, elfun);
+                             if (dof_tr != nullptr)
+                             {
+                                dof_tr->InvTransformPrimal(elfun);
+                             }
+                          });
+         getElementTransformation(mesh, e, trans);
+
+         elres.SetSize(vdofs.Size());
+         elres = 0.0;
+         for (int k = 0; k < dnfi.Size(); ++k)
+         {
+            dnfi[k]->AssembleElementVector(el, trans, elfun, elvect);
+            elres += elvect;
+         }
+         if (dof_trans)
+         {
+            withElementVDofs(fes,
+                             e,
+                             dof_trans,
+                             vdofs,
+                             [&](mfem::DofTransformation *dof_tr)
+                             {
+                                if (dof_tr != nullptr)
+                                {
+                                   dof_tr->TransformDual(elres);
+                                }
+                             });
+         }
+         local_res.AddElementVector(vdofs, elres);
+      }
+   }
+
+   for (int i = 1; i < assembly_threads; ++i)
+   {
+      thread_res[0] += thread_res[i];
+   }
+   res_vec.SetSize(fes.GetTrueVSize());
+   prolong->MultTranspose(thread_res[0], res_vec);
+   res_vec.SetSubVector(nf.GetEssentialTrueDofs(), 0.0);
+}
+
+mfem::SparseMatrix &MISONonlinearForm::localGradientThreaded(
+    const mfem::Vector &state)
+{
+   auto &fes = *nf.ParFESpace();
+   auto &mesh = *fes.GetMesh();
+   const auto &dnfi = *nf.GetDNFI();
+   const auto *prolong = fes.GetProlongationMatrix();
+   const int num_elements = fes.GetNE();
+   const bool dof_trans = hasDofTransformations(fes);
+
+   assembly_state.SetSize(fes.GetVSize());
+   prolong->Mult(state, assembly_state);
+
+   if (local_jac == nullptr || local_jac->Height() != fes.GetVSize())
+   {
+      local_jac = buildElementSparsity(fes);
+   }
+   *local_jac = 0.0;
+
+#ifdef MISO_USE_OPENMP
+#pragma omp parallel num_threads(assembly_threads)
+#endif
+   {
+      mfem::IsoparametricTransformation trans;
+      mfem::Array<int> vdofs;
+      mfem::Vector elfun;
+      mfem::DenseMatrix elmat;
+      mfem::DenseMatrix elgrad;
+
+#ifdef MISO_USE_OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (int e = 0; e < num_elements; ++e)
+      {
+         const auto &el = *fes.GetFE(e);
+         withElementVDofs(fes,
+                          e,
+                          dof_trans,
+                          vdofs,
+                          [&](mfem::DofTransformation *dof_tr)
+                          {
+                             assembly_state.GetSubVector(vdofs, elfun);
+                             if (dof_tr != nullptr)
+                             {
+                                dof_tr->InvTransformPrimal(elfun);
+                             }
+                          });
+         getElementTransformation(mesh, e, trans);
+
+         elgrad.SetSize(vdofs.Size());
+         elgrad = 0.0;
+         for (int k = 0; k < dnfi.Size(); ++k)
+         {
+            dnfi[k]->AssembleElementGrad(el, trans, elfun, elmat);
+            elgrad += elmat;
+         }
+         if (dof_trans)
+         {
+            withElementVDofs(fes,
+                             e,
+                             dof_trans,
+                             vdofs,
+                             [&](mfem::DofTransformation *dof_tr)
+                             {
+                                if (dof_tr != nullptr)
+                                {
+                                   dof_tr->TransformDual(elgrad);
+                                }
+                             });
+         }
+         addElementMatrix(vdofs, elgrad, *local_jac);
+      }
+   }
+   return *local_jac;
+}
+
+mfem::HypreParMatrix &MISONonlinearForm::gradientThreaded(
+    const mfem::Vector &state)
+{
+   return parallelAssemble(localGradientThreaded(state));
+}
+
+mfem::HypreParMatrix &MISONonlinearForm::parallelAssemble(
+    mfem::SparseMatrix &local)
+{
+   auto &fes = *nf.ParFESpace();
+   mfem::OperatorHandle block_diag_jac(mfem::Operator::Hypre_ParCSR);
+   block_diag_jac.MakeSquareBlockDiag(
+       fes.GetComm(), fes.GlobalVSize(), fes.GetDofOffsets(), &local);
+   mfem::OperatorHandle dof_true_dof(mfem::Operator::Hypre_ParCSR);
+   dof_true_dof.ConvertFrom(fes.Dof_TrueDof_Matrix());
+   threaded_jac.Clear();
+   threaded_jac.MakePtAP(block_diag_jac, dof_true_dof);
+   return *threaded_jac.As<mfem::HypreParMatrix>();
+}
+
+mfem::SparseMatrix &MISONonlinearForm::localResidualAndGradient(
+    const mfem::Vector &state,
+    int num_threads,
+    mfem::Vector &local_res)
+{
+   auto &fes = *nf.ParFESpace();
+   auto &mesh = *fes.GetMesh();
+   const auto *prolong = fes.GetProlongationMatrix();
+   const int num_elements = fes.GetNE();
+   const bool dof_trans = hasDofTransformations(fes);
+
+   assembly_state.SetSize(fes.GetVSize());
+   prolong->Mult(state, assembly_state);
+
+   if (local_jac == nullptr || local_jac->Height() != fes.GetVSize())
+   {
+      local_jac = buildElementSparsity(fes);
+   }
+   *local_jac = 0.0;
+
+   thread_res.resize(num_threads);
+   for (auto &thread_local_res : thread_res)
+   {
+      thread_local_res.SetSize(fes.GetVSize());
+      thread_local_res = 0.0;
+   }
+
+#ifdef MISO_USE_OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif
+   {
+      auto &thread_local_res = thread_res[getAssemblyThreadNum()];
+      mfem::IsoparametricTransformation trans;
+      mfem::Array<int> vdofs;
+      mfem::Vector elfun;
+      mfem::Vector elvect;
+      mfem::Vector elres;
+      mfem::DenseMatrix elmat;
+      mfem::DenseMatrix elgrad;
+
+#ifdef MISO_USE_OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (int e = 0; e < num_elements; ++e)
+      {
+         const auto &el = *fes.GetFE(e);
+         withElementVDofs(fes,
+                          e,
+                          dof_trans,
+                          vdofs,
+                          [&](mfem::DofTransformation *dof_tr)
+                          {
+                             assembly_state.GetSubVector(vdofs, elfun);
+                             if (dof_tr != nullptr)
+                             {
+                                dof_tr->InvTransformPrimal(elfun);
+                             }
+                          });
+         getElementTransformation(mesh, e, trans);
+
+         elres.SetSize(vdofs.Size());
+         elres = 0.0;
+         elgrad.SetSize(vdofs.Size());
+         elgrad = 0.0;
+         for (auto k : domain_integs)
+         {
+            assembleElementVectorAndGrad(
+                integs[k], el, trans, elfun, elvect, elmat);
+            elres += elvect;
+            elgrad += elmat;
+         }
+         if (dof_trans)
+         {
+            withElementVDofs(fes,
+                             e,
+                             dof_trans,
+                             vdofs,
+                             [&](mfem::DofTransformation *dof_tr)
+                             {
+                                if (dof_tr != nullptr)
+                                {
+                                   dof_tr->TransformDual(elres);
+                                   dof_tr->TransformDual(elgrad);
+                                }
+                             });
+         }
+         thread_local_res.AddElementVector(vdofs, elres);
+         addElementMatrix(vdofs, elgrad, *local_jac);
+      }
+   }
+
+   for (int i = 1; i < num_threads; ++i)
+   {
+      thread_res[0] += thread_res[i];
+   }
+   local_res.SetSize(fes.GetVSize());
+   local_res = thread_res[0];
+   return *local_jac;
+}
+
+void MISONonlinearForm::setDirichletResidual(const mfem::Vector &state,
+                                             mfem::Vector &res_vec)
+{
+   const auto &ess_tdof_list = getEssentialDofs();
+   if (ess_tdof_list.Size() == 0)
+   {
+      return;
+   }
+
+   if (auto bc_iter = nf_fields.find("dirichlet_bc");
+       bc_iter != nf_fields.end())
+   {
+      auto &dirichlet_bc = bc_iter->second;
+      dirichlet_bc.setTrueVec(scratch);
+
+      for (int i = 0; i < ess_tdof_list.Size(); ++i)
+      {
+         res_vec(ess_tdof_list[i]) =
+             state(ess_tdof_list[i]) - scratch(ess_tdof_list[i]);
+      }
+   }
+}
+
+mfem::Operator &MISONonlinearForm::setJacobian(
+    mfem::HypreParMatrix &hypre_jac)
+{
+   const auto &ess_tdof_list = getEssentialDofs();
+   jac.Reset(&hypre_jac, false);
+
+   // Impose boundary conditions on pGrad
+   jac_e.Clear();
+   jac_e.EliminateRowsCols(jac, ess_tdof_list);
+   jac_e.EliminateRows(ess_tdof_list);
+
+   // reset transposed Jacobian to null (to indicate we should re-transpose it)
+   jac_trans = nullptr;
+   return *jac;
+}
+
+const std::string &MISONonlinearForm::adjointJacobianMode()
+{
+   static const std::string symmetric = "symmetric";
+   static const std::string implicit = "implicit";
+   static const std::string transpose = "transpose";
+   if (adjoint_jacobian != "auto")
+   {
+      return adjoint_jacobian;
+   }
+   if (!symmetric_jacobian.has_value())
+   {
+      symmetric_jacobian = isSymmetric(*jac, nf.ParFESpace()->GetComm());
+   }
+   if (*symmetric_jacobian)
+   {
+      return symmetric;
+   }
+   return implicit_transpose ? implicit : transpose;
+}
+
+PAJacobian &MISONonlinearForm::gradientPA(const mfem::Vector &state)
+{
+   if (pa_jac == nullptr)
+   {
+      auto &dnfi = *nf.GetDNFI();
+      if (static_cast<std::size_t>(dnfi.Size()) != integs.size())
+      {
+         throw MISOException(
+             "Partial assembly of the Jacobian (MISONonlinearForm) only "
+             "supports forms made up entirely of domain integrators!\n");
+      }
+      pa_jac = std::make_unique<PAJacobian>(*nf.ParFESpace(), dnfi);
+   }
+   pa_jac->assemble(state);
+   pa_jac->setEssentialTrueDofs(nf.GetEssentialTrueDofs());
+   return *pa_jac;
+}
+
 int getSize(const MISONonlinearForm &form)
 {
    return form.nf.ParFESpace()->GetTrueVSize();
@@ -38,6 +619,56 @@ void setOptions(MISONonlinearForm &form, const nlohmann::json &options)
 {
    setOptions(form.integs, options);
 
+   if (options.contains("assembly-threads"))
+   {
+      /// a non-positive thread count means use every available thread
+      const int max_threads = getMaxAssemblyThreads();
+      const int threads = options["assembly-threads"].get<int>();
+      form.assembly_threads =
+          threads > 0 ? std::min(threads, max_threads) : max_threads;
+   }
+
+   if (options.contains("jacobian-assembly"))
+   {
+      const auto assembly = options["jacobian-assembly"].get<std::string>();
+      if (assembly != "full" && assembly != "partial")
+      {
+         throw MISOException("Unrecognized \"jacobian-assembly\" option \"" +
+                             assembly + "\"!\n");
+      }
+      form.partial_assembly = assembly == "partial";
+   }
+
+   if (options.contains("adjoint-jacobian"))
+   {
+      const auto mode = options["adjoint-jacobian"].get<std::string>();
+      if (mode != "transpose" && mode != "symmetric" && mode != "implicit" &&
+          mode != "auto")
+      {
+         throw MISOException("Unrecognized \"adjoint-jacobian\" option \"" +
+                             mode + "\"!\n");
+      }
+      form.adjoint_jacobian = mode;
+   }
+
+   if (options.contains("adjoint-implicit-transpose"))
+   {
+      form.implicit_transpose =
+          options["adjoint-implicit-transpose"].get<bool>();
+   }
+
+   if (options.contains("reuse-jacobian-structure"))
+   {
+      form.reuse_jacobian_structure =
+          options["reuse-jacobian-structure"].get<bool>();
+      if (!form.reuse_jacobian_structure)
+      {
+         form.fixed_jac = nullptr;
+         form.fixed_jac_trans = nullptr;
+         form.local_grad = nullptr;
+      }
+   }
+
    if (options.contains("bcs"))
    {
       if (options["bcs"].contains("essential"))
@@ -52,6 +683,11 @@ void setOptions(MISONonlinearForm &form, const nlohmann::json &options)
    }
 }
 
+std::size_t getGeometricCacheMemory(const MISONonlinearForm &form)
+{
+   return getGeometricCacheMemory(form.integs);
+}
+
 double calcFormOutput(MISONonlinearForm &form, const MISOInputs &inputs)
 {
    mfem::Vector state;
@@ -66,32 +702,106 @@ void evaluate(MISONonlinearForm &form,
 {
    mfem::Vector state;
    setVectorFromInputs(inputs, "state", state, false, true);
-   form.nf.Mult(state, res_vec);
+   if (form.useThreadedAssembly())
+   {
+      form.multThreaded(state, res_vec);
+   }
+   else
+   {
+      form.nf.Mult(state, res_vec);
+   }
+   form.setDirichletResidual(state, res_vec);
+}
 
-   const auto &ess_tdof_list = form.getEssentialDofs();
-   if (ess_tdof_list.Size() == 0)
+mfem::Operator &evaluateAndLinearize(MISONonlinearForm &form,
+                                     const MISOInputs &inputs,
+                                     mfem::Vector &res_vec)
+{
+   /// the partially assembled Jacobian only stores quadrature point data, so
+   /// there is nothing to fuse with the residual
+   if (form.partial_assembly)
    {
-      return;
+      evaluate(form, inputs, res_vec);
+      return getJacobian(form, inputs, "state");
    }
 
-   if (auto bc_iter = form.nf_fields.find("dirichlet_bc");
-       bc_iter != form.nf_fields.end())
+   mfem::Vector state;
+   setVectorFromInputs(inputs, "state", state, false, true);
+   auto &fes = *form.nf.ParFESpace();
+   const int num_threads =
+       form.useThreadedAssembly() ? form.assembly_threads : 1;
+   mfem::Vector local_res;
+   auto *local_grad =
+       &form.localResidualAndGradient(state, num_threads, local_res);
+   res_vec.SetSize(fes.GetTrueVSize());
+   fes.GetProlongationMatrix()->MultTranspose(local_res, res_vec);
+
+   /// face and boundary integrators are assembled by `nf` with its domain
+   /// integrators swapped out, so that only the face terms are added
+   if (form.domain_integs.size() != form.integs.size())
    {
-      auto &dirichlet_bc = bc_iter->second;
-      dirichlet_bc.setTrueVec(form.scratch);
+      FaceIntegratorsOnly face_terms(form.nf);
 
-      for (int i = 0; i < ess_tdof_list.Size(); ++i)
+      mfem::Vector face_res(res_vec.Size());
+      form.nf.Mult(state, face_res);
+      res_vec += face_res;
+
+      auto &face_grad = form.nf.GetLocalGradient(state);
+
+      /// the sum keeps its sparsity from one call to the next, so it is only
+      /// rebuilt if either term has entries outside of it
+      auto &fused = form.fused_local_jac;
+      bool refilled = false;
+      if (fused != nullptr && fused->Height() == local_grad->Height() &&
+          fused->Width() == local_grad->Width())
       {
-         res_vec(ess_tdof_list[i]) =
-             state(ess_tdof_list[i]) - form.scratch(ess_tdof_list[i]);
+         *fused = 0.0;
+         mfem::Array<int> positions(fused->Width());
+         positions = -1;
+         refilled = addInPlace(*local_grad, *fused, positions) &&
+                    addInPlace(face_grad, *fused, positions);
+      }
+      if (!refilled)
+      {
+         fused.reset(mfem::Add(*local_grad, face_grad));
       }
+      local_grad = fused.get();
    }
+   res_vec.SetSubVector(form.getEssentialDofs(), 0.0);
+   form.setDirichletResidual(state, res_vec);
+
+   mfem::HypreParMatrix *hypre_jac = nullptr;
+   if (form.reuse_jacobian_structure)
+   {
+      if (form.fixed_jac == nullptr)
+      {
+         form.fixed_jac = std::make_unique<FixedSparsityParMatrix>(fes);
+         form.fixed_jac_trans =
+             std::make_unique<FixedSparsityParMatrix>(fes, true);
+      }
+      form.local_grad = local_grad;
+      hypre_jac = &form.fixed_jac->assemble(*form.local_grad);
+      form.fixed_jac_trans_current = false;
+   }
+   else
+   {
+      hypre_jac = &form.parallelAssemble(*local_grad);
+   }
+   return form.setJacobian(*hypre_jac);
 }
 
 void linearize(MISONonlinearForm &form, const MISOInputs &inputs)
 {
    std::cout << "In linearize!\n";
    setInputs(form, inputs);
+   if (form.partial_assembly)
+   {
+      if (form.pa_jac == nullptr)
+      {
+         getJacobian(form, inputs, "state");
+      }
+      return;
+   }
    if (form.jac.Ptr() == nullptr)
    {
       getJacobian(form, inputs, "state");
@@ -112,33 +822,105 @@ mfem::Operator &getJacobian(MISONonlinearForm &form,
    mfem::Vector state;
    setVectorFromInputs(inputs, "state", state, false, true);
 
+   if (form.partial_assembly)
+   {
+      return form.gradientPA(state);
+   }
+
    mfem::Array<int> ess_tdof_list(form.nf.GetEssentialTrueDofs());
    mfem::Array<int> zeros;
    // Setting our essential true dofs to zero to full Jacobian is preserved
    form.nf.SetEssentialTrueDofs(zeros);
 
    // get our gradient with everything preserved
-   auto *hypre_jac =
-       dynamic_cast<mfem::HypreParMatrix *>(&form.nf.GetGradient(state));
-   form.jac.Reset(hypre_jac, false);
-
-   // Impose boundary conditions on pGrad
-   form.jac_e.Clear();
-   form.jac_e.EliminateRowsCols(form.jac, ess_tdof_list);
-   form.jac_e.EliminateRows(ess_tdof_list);
+   mfem::HypreParMatrix *hypre_jac = nullptr;
+   if (form.reuse_jacobian_structure)
+   {
+      auto &fes = *form.nf.ParFESpace();
+      if (form.fixed_jac == nullptr)
+      {
+         form.fixed_jac = std::make_unique<FixedSparsityParMatrix>(fes);
+         form.fixed_jac_trans =
+             std::make_unique<FixedSparsityParMatrix>(fes, true);
+      }
+      if (form.useThreadedAssembly())
+      {
+         form.local_grad = &form.localGradientThreaded(state);
+      }
+      else
+      {
+         form.local_grad = &form.nf.GetLocalGradient(state);
+      }
+      hypre_jac = &form.fixed_jac->assemble(*form.local_grad);
+      form.fixed_jac_trans_current = false;
+   }
+   else if (form.useThreadedAssembly())
+   {
+      hypre_jac = &form.gradientThreaded(state);
+   }
+   else
+   {
+      hypre_jac =
+          dynamic_cast<mfem::HypreParMatrix *>(&form.nf.GetGradient(state));
+   }
 
    // reset our essential BCs to what they used to be
    form.nf.SetEssentialTrueDofs(ess_tdof_list);
 
-   // reset transposed Jacobian to null (to indicate we should re-transpose it)
-   form.jac_trans = nullptr;
-   return *form.jac;
+   return form.setJacobian(*hypre_jac);
 }
 
 mfem::Operator &getJacobianTranspose(MISONonlinearForm &form,
                                      const MISOInputs &inputs,
                                      const std::string &wrt)
 {
+   if (form.partial_assembly)
+   {
+      if (form.pa_jac == nullptr)
+      {
+         throw MISOException(
+             "getJacobianTranspose (MISONonlinearForm) called before the "
+             "Jacobian was linearized!\n");
+      }
+      /// the partially assembled Jacobian is symmetric
+      return *form.pa_jac;
+   }
+   if (form.jac.Ptr() == nullptr)
+   {
+      throw MISOException(
+          "getJacobianTranspose (MISONonlinearForm) called before the "
+          "Jacobian was linearized!\n");
+   }
+   const auto &mode = form.adjointJacobianMode();
+   if (mode == "symmetric")
+   {
+      return *form.jac;
+   }
+   if (mode == "implicit")
+   {
+      if (form.jac_trans == nullptr)
+      {
+         form.jac_trans =
+             std::make_unique<ImplicitTransposeOperator>(*form.jac);
+      }
+      return *form.jac_trans;
+   }
+   if (form.reuse_jacobian_structure && form.local_grad != nullptr)
+   {
+      if (!form.fixed_jac_trans_current)
+      {
+         auto &jac_trans = form.fixed_jac_trans->assemble(*form.local_grad);
+         /// eliminate the essential dofs the same way setJacobian does, so
+         /// this is the transpose of the eliminated Jacobian, as in the
+         /// rebuilt path below. The eliminated block is not needed here:
+         /// the adjoint and product routines apply the transpose of the
+         /// forward `jac_e` instead.
+         jac_trans.EliminateBC(form.getEssentialDofs(),
+                               mfem::Operator::DIAG_ONE);
+         form.fixed_jac_trans_current = true;
+      }
+      return form.fixed_jac_trans->matrix();
+   }
    if (form.jac_trans == nullptr)
    {
       std::cout << "Re-transposing Jacobian!\n";
@@ -194,6 +976,13 @@ void finalizeAdjointSystem(MISONonlinearForm &form,
    /// New approach
    adjoint.SetSubVector(ess_tdof_list, form.scratch);
 
+   if (form.partial_assembly)
+   {
+      form.pa_jac->multEliminatedTranspose(adjoint, form.adj_work1);
+      subtract(form.adj_work1, adjoint, adjoint);
+      return;
+   }
+
    auto *hypre_jac_e = form.jac_e.As<mfem::HypreParMatrix>();
    if (hypre_jac_e == nullptr)
    {
@@ -228,6 +1017,16 @@ void jacobianVectorProduct(MISONonlinearForm &form,
       const auto &ess_tdof_list = form.getEssentialDofs();
       form.scratch.SetSubVector(ess_tdof_list, 0.0);
 
+      if (form.partial_assembly)
+      {
+         /// the essential rows of the Jacobian are eliminated, while their
+         /// columns are kept
+         form.pa_jac->multUnconstrained(wrt_dot, form.adj_work1);
+         form.adj_work1.SetSubVector(ess_tdof_list, 0.0);
+         res_dot += form.adj_work1;
+         return;
+      }
+
       auto *hypre_jac = form.jac.As<mfem::HypreParMatrix>();
       if (hypre_jac == nullptr)
       {
@@ -283,6 +1082,13 @@ void vectorJacobianProduct(MISONonlinearForm &form,
       const auto &ess_tdof_list = form.getEssentialDofs();
       form.scratch.SetSubVector(ess_tdof_list, 0.0);
 
+      if (form.partial_assembly)
+      {
+         form.pa_jac->multUnconstrained(form.scratch, form.adj_work1);
+         wrt_bar += form.adj_work1;
+         return;
+      }
+
       auto *hypre_jac = form.jac.As<mfem::HypreParMatrix>();
       if (hypre_jac == nullptr)
       {
@@ -322,7 +1128,10 @@ void vectorJacobianProduct(MISONonlinearForm &form,
       /// Integrators added to rev_sens will also reference the state grid func,
       /// so that must have been distributed before calling this function
       auto &wrt_rev_sens = form.rev_sens.at(wrt);
-      wrt_rev_sens.Assemble();
+      {
+         ScopedTimer timer("sensitivity-assembly:" + wrt);
+         assembleTimed(wrt_rev_sens);
+      }
       form.scratch.SetSize(wrt_bar.Size());
       form.scratch = 0.0;
       wrt_rev_sens.ParallelAssemble(form.scratch);
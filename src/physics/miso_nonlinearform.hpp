@@ -2,14 +2,19 @@
 #define MISO_NONLINEAR_FORM
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 #include <list>
+#include <map>
 
 #include "mfem.hpp"
 #include "nlohmann/json.hpp"
 
+#include "fixed_sparsity_par_matrix.hpp"
 #include "miso_input.hpp"
 #include "miso_integrator.hpp"
+#include "pa_jacobian.hpp"
 
 namespace miso
 {
@@ -25,6 +30,9 @@ public:
    friend void setOptions(MISONonlinearForm &form,
                           const nlohmann::json &options);
 
+   /// Get the memory used by the integrators' geometric factor caches, in bytes
+   friend std::size_t getGeometricCacheMemory(const MISONonlinearForm &form);
+
    /// Calls GetEnergy() for the underlying form using "state" in inputs.
    friend double calcFormOutput(MISONonlinearForm &form,
                                 const MISOInputs &inputs);
@@ -34,6 +42,13 @@ public:
                         const MISOInputs &inputs,
                         mfem::Vector &res_vec);
 
+   /// Evaluate the nonlinear form using `inputs`, returning the result in
+   /// `res_vec`, and compute its Jacobian with respect to the state in the
+   /// same sweep over the elements
+   friend mfem::Operator &evaluateAndLinearize(MISONonlinearForm &form,
+                                               const MISOInputs &inputs,
+                                               mfem::Vector &res_vec);
+
    friend void linearize(MISONonlinearForm &form, const MISOInputs &inputs);
 
    /// Compute Jacobian of `form` with respect to `wrt` and return
@@ -169,6 +184,101 @@ private:
    /// work vector
    mfem::Vector scratch;
 
+   /// number of threads used to assemble the domain integrators; with a
+   /// single thread the form is assembled by `nf`
+   int assembly_threads = 1;
+   /// state on the local (non-true) dofs, used by threaded assembly
+   mfem::Vector assembly_state;
+   /// each thread's contribution to the residual on the local dofs
+   std::vector<mfem::Vector> thread_res;
+   /// local Jacobian assembled by threads; its sparsity is built once
+   std::unique_ptr<mfem::SparseMatrix> local_jac;
+   /// parallel Jacobian assembled from `local_jac`
+   mfem::OperatorHandle threaded_jac{mfem::Operator::Hypre_ParCSR};
+
+   /// \brief Prepare the integrators for threaded assembly
+   /// \return true if the residual and Jacobian should be assembled by
+   /// multiple threads instead of by `nf`
+   /// \note Only forms made up entirely of domain integrators that can be
+   /// assembled concurrently use threaded assembly
+   bool useThreadedAssembly();
+
+   /// \brief Evaluate the residual by looping over elements with multiple
+   /// threads, each scattering into its own local residual
+   /// \param[in] state - the state true vector
+   /// \param[out] res_vec - the residual true vector
+   void multThreaded(const mfem::Vector &state, mfem::Vector &res_vec);
+
+   /// \brief Assemble the local Jacobian by looping over elements with
+   /// multiple threads, all adding into the fixed sparsity of `local_jac`
+   /// \param[in] state - the state true vector
+   /// \return the Jacobian on the local dofs, `local_jac`
+   mfem::SparseMatrix &localGradientThreaded(const mfem::Vector &state);
+
+   /// \brief Assemble the parallel Jacobian from `localGradientThreaded`
+   /// \param[in] state - the state true vector
+   /// \return the parallel Jacobian, owned by `threaded_jac`
+   mfem::HypreParMatrix &gradientThreaded(const mfem::Vector &state);
+
+   /// \brief Assemble the parallel Jacobian from a Jacobian on the local dofs
+   /// \param[in] local - the Jacobian on the local dofs
+   /// \return the parallel Jacobian, owned by `threaded_jac`
+   mfem::HypreParMatrix &parallelAssemble(mfem::SparseMatrix &local);
+
+   /// indices in `integs` of the domain integrators, in the order of `nf`'s
+   /// domain integrators
+   std::vector<std::size_t> domain_integs;
+   /// local Jacobian of the domain and face integrators together, used by
+   /// `evaluateAndLinearize` when the form has face integrators; built once
+   /// and refilled in place afterwards
+   std::unique_ptr<mfem::SparseMatrix> fused_local_jac;
+
+   /// \brief Assemble the residual and local Jacobian of the domain
+   /// integrators together, in one loop over the elements
+   /// \param[in] state - the state true vector
+   /// \param[in] num_threads - number of threads that assemble elements
+   /// \param[out] local_res - the residual on the local dofs
+   /// \return the Jacobian on the local dofs, `local_jac`
+   mfem::SparseMatrix &localResidualAndGradient(const mfem::Vector &state,
+                                                int num_threads,
+                                                mfem::Vector &local_res);
+
+   /// \brief Set the residual of the essential dofs from the "dirichlet_bc"
+   /// field, if there is one
+   /// \param[in] state - the state true vector
+   /// \param[inout] res_vec - the residual true vector
+   void setDirichletResidual(const mfem::Vector &state, mfem::Vector &res_vec);
+
+   /// \brief Hold `hypre_jac` as the Jacobian and eliminate the essential
+   /// dofs from it into `jac_e`
+   /// \param[in] hypre_jac - the assembled Jacobian, owned elsewhere
+   /// \return the Jacobian
+   mfem::Operator &setJacobian(mfem::HypreParMatrix &hypre_jac);
+
+   /// if true, the Jacobian is applied matrix-free from quadrature point data
+   /// stored by the integrators instead of being assembled
+   bool partial_assembly = false;
+   /// matrix-free Jacobian used when `partial_assembly` is set
+   std::unique_ptr<PAJacobian> pa_jac;
+
+   /// if true, the Jacobian and its transpose keep their parallel sparsity
+   /// between assemblies and only have their values overwritten
+   bool reuse_jacobian_structure = false;
+   /// Jacobian and transposed Jacobian with fixed sparsity, used when
+   /// `reuse_jacobian_structure` is set
+   std::unique_ptr<FixedSparsityParMatrix> fixed_jac;
+   std::unique_ptr<FixedSparsityParMatrix> fixed_jac_trans;
+   /// the local Jacobian `fixed_jac` was last assembled from, which is
+   /// transposed on demand
+   const mfem::SparseMatrix *local_grad = nullptr;
+   /// true if `fixed_jac_trans` holds the transpose of the current Jacobian
+   bool fixed_jac_trans_current = false;
+
+   /// \brief Store the integrators' quadrature point data at `state`
+   /// \param[in] state - the state true vector
+   /// \return the matrix-free Jacobian, owned by `pa_jac`
+   PAJacobian &gradientPA(const mfem::Vector &state);
+
    /// Essential boundary marker
    mfem::Array<int> ess_bdr;
 
@@ -203,6 +313,22 @@ private:
    /// Holds eliminated entries from the Jacobian
    mfem::OperatorHandle jac_e;
 
+   /// how the transposed Jacobian is applied in adjoint solves: formed
+   /// explicitly ("transpose"), by reusing the Jacobian ("symmetric"),
+   /// through the Jacobian's MultTranspose ("implicit"), or either of the
+   /// latter two depending on a symmetry check ("auto")
+   std::string adjoint_jacobian = "transpose";
+   /// result of the symmetry check used by "auto", done once per form
+   std::optional<bool> symmetric_jacobian;
+   /// if false, "auto" transposes a non-symmetric Jacobian explicitly instead
+   /// of implicitly; set through "adjoint-implicit-transpose" when the
+   /// preconditioner does not implement `MultTranspose`
+   bool implicit_transpose = true;
+
+   /// \return "transpose", "symmetric", or "implicit", resolving "auto" by
+   /// checking the symmetry of the current Jacobian
+   const std::string &adjointJacobianMode();
+
    /// Holds the transpose of the Jacobian, needed for solving for the adjoint
    std::unique_ptr<mfem::Operator> jac_trans;
    /// Holds the transpose of the eliminated entries from the Jacobian,
@@ -219,6 +345,7 @@ private:
 template <typename T>
 void MISONonlinearForm::addDomainIntegrator(T *integrator)
 {
+   domain_integs.push_back(integs.size());
    integs.emplace_back(*integrator);
    nf.AddDomainIntegrator(integrator);
    addDomainSensitivityIntegrator(*integrator,
@@ -236,6 +363,7 @@ void MISONonlinearForm::addDomainIntegrator(
     T *integrator,
     const std::vector<int> &bdr_attr_marker)
 {
+   domain_integs.push_back(integs.size());
    integs.emplace_back(*integrator);
    auto mesh_attr_size = nf.ParFESpace()->GetMesh()->bdr_attributes.Max();
    auto &marker = domain_markers.emplace_back(mesh_attr_size);
@@ -0,0 +1,116 @@
+#include "mfem.hpp"
+
+#include "utils.hpp"
+#include "pa_jacobian.hpp"
+
+namespace miso
+{
+PAJacobian::PAJacobian(
+    mfem::ParFiniteElementSpace &fes,
+    const mfem::Array<mfem::NonlinearFormIntegrator *> &integs)
+ : mfem::Operator(fes.GetTrueVSize()), fes(fes), integs(integs), ndof(0)
+{
+   auto &mesh = *fes.GetMesh();
+   if (mesh.GetNumGeometries(mesh.Dimension()) > 1)
+   {
+      throw MISOException(
+          "PAJacobian does not support meshes with mixed element types!\n");
+   }
+   if (fes.GetNE() > 0)
+   {
+      ndof = fes.GetFE(0)->GetDof() * fes.GetVDim();
+   }
+}
+
+void PAJacobian::assemble(const mfem::Vector &state)
+{
+   fes.GetProlongationMatrix()->Mult(state, local_x);
+   gather(local_x, elem_x);
+   for (int i = 0; i < integs.Size(); ++i)
+   {
+      integs[i]->AssembleGradPA(elem_x, fes);
+   }
+}
+
+void PAJacobian::Mult(const mfem::Vector &x, mfem::Vector &y) const
+{
+   true_x = x;
+   true_x.SetSubVector(ess_tdof_list, 0.0);
+   multUnconstrained(true_x, y);
+   for (int i = 0; i < ess_tdof_list.Size(); ++i)
+   {
+      y(ess_tdof_list[i]) = x(ess_tdof_list[i]);
+   }
+}
+
+void PAJacobian::multUnconstrained(const mfem::Vector &x, mfem::Vector &y) const
+{
+   const auto *prolong = fes.GetProlongationMatrix();
+   prolong->Mult(x, local_x);
+   gather(local_x, elem_x);
+
+   elem_y.SetSize(elem_x.Size());
+   elem_y = 0.0;
+   for (int i = 0; i < integs.Size(); ++i)
+   {
+      integs[i]->AddMultGradPA(elem_x, elem_y);
+   }
+
+   scatter(elem_y, local_y);
+   y.SetSize(height);
+   prolong->MultTranspose(local_y, y);
+}
+
+void PAJacobian::multEliminatedTranspose(const mfem::Vector &x,
+                                         mfem::Vector &y) const
+{
+   /// the eliminated entries couple the essential rows to the other columns;
+   /// by symmetry their transpose is the essential rows of the Jacobian
+   /// applied to `x` without its essential entries
+   true_x = x;
+   true_x.SetSubVector(ess_tdof_list, 0.0);
+   mfem::Vector jac_x(height);
+   multUnconstrained(true_x, jac_x);
+
+   y.SetSize(height);
+   y = 0.0;
+   for (int i = 0; i < ess_tdof_list.Size(); ++i)
+   {
+      y(ess_tdof_list[i]) = jac_x(ess_tdof_list[i]);
+   }
+}
+
+void PAJacobian::gather(const mfem::Vector &local, mfem::Vector &elem) const
+{
+   const int num_elements = fes.GetNE();
+   elem.SetSize(ndof * num_elements);
+   for (int e = 0; e < num_elements; ++e)
+   {
+      auto *dof_tr = fes.GetElementVDofs(e, vdofs);
+      local.GetSubVector(vdofs, elvect);
+      if (dof_tr != nullptr)
+      {
+         dof_tr->InvTransformPrimal(elvect);
+      }
+      elem.SetVector(elvect, e * ndof);
+   }
+}
+
+void PAJacobian::scatter(const mfem::Vector &elem, mfem::Vector &local) const
+{
+   local.SetSize(fes.GetVSize());
+   local = 0.0;
+   for (int e = 0; e < fes.GetNE(); ++e)
+   {
+      auto *dof_tr = fes.GetElementVDofs(e, vdofs);
+      const mfem::Vector elem_e(elem.GetData() + e * ndof, ndof);
+      elvect = elem_e;
+      if (dof_tr != nullptr)
+      {
+         dof_tr->TransformDual(elvect);
+      }
+      local.AddElementVector(vdofs, elvect);
+   }
+}
+
+}  // namespace miso
@@ -0,0 +1,78 @@
+#ifndef MISO_PA_JACOBIAN
+#define MISO_PA_JACOBIAN
+
+#include "mfem.hpp"
+
+namespace miso
+{
+/// \brief Matrix-free Jacobian of a nonlinear form made up of domain
+/// integrators that implement `AssembleGradPA` and `AddMultGradPA`
+/// \note The integrators work on element local vectors stored one after
+/// another, after any dof transformations have been applied, so only meshes
+/// made up of a single element type are supported
+/// \note Essential true dofs are eliminated like
+/// `HypreParMatrix::EliminateRowsCols` does: their rows and columns are zeroed
+/// and their diagonal entries set to one
+/// \note The element Jacobians must be symmetric, so that `MultTranspose` can
+/// apply the same action as `Mult`
+class PAJacobian : public mfem::Operator
+{
+public:
+   /// \param[in] fes - the finite element space the form's state lives in
+   /// \param[in] integs - the form's domain integrators (not owned)
+   PAJacobian(mfem::ParFiniteElementSpace &fes,
+              const mfem::Array<mfem::NonlinearFormIntegrator *> &integs);
+
+   /// \brief Store the integrators' quadrature point data at `state`
+   /// \param[in] state - the state true vector to linearize about
+   void assemble(const mfem::Vector &state);
+
+   /// \brief Set the essential true dofs whose rows and columns are eliminated
+   void setEssentialTrueDofs(const mfem::Array<int> &ess_tdofs)
+   {
+      ess_tdof_list = ess_tdofs;
+   }
+
+   /// \brief Apply the Jacobian with the essential dofs eliminated
+   void Mult(const mfem::Vector &x, mfem::Vector &y) const override;
+
+   /// \brief Apply the transposed Jacobian with the essential dofs eliminated
+   void MultTranspose(const mfem::Vector &x, mfem::Vector &y) const override
+   {
+      Mult(x, y);
+   }
+
+   /// \brief Apply the Jacobian without eliminating the essential dofs
+   void multUnconstrained(const mfem::Vector &x, mfem::Vector &y) const;
+
+   /// \brief Apply the transpose of the entries removed by eliminating the
+   /// essential dofs, excluding the essential rows themselves (the matrix
+   /// `jac_e` holds when the Jacobian is assembled)
+   void multEliminatedTranspose(const mfem::Vector &x, mfem::Vector &y) const;
+
+private:
+   /// the finite element space the form's state lives in
+   mfem::ParFiniteElementSpace &fes;
+   /// the form's domain integrators
+   const mfem::Array<mfem::NonlinearFormIntegrator *> &integs;
+   /// essential true dofs
+   mfem::Array<int> ess_tdof_list;
+   /// number of dofs of each element
+   int ndof;
+
+   /// work vectors on the local dofs and element dofs
+   mutable mfem::Vector local_x, local_y, elem_x, elem_y, true_x;
+   /// work storage used while gathering and scattering a single element
+   mutable mfem::Array<int> vdofs;
+   mutable mfem::Vector elvect;
+
+   /// \brief Gather the element local vectors of a local vector
+   void gather(const mfem::Vector &local, mfem::Vector &elem) const;
+
+   /// \brief Scatter element local vectors into a local vector
+   void scatter(const mfem::Vector &elem, mfem::Vector &local) const;
+};
+
+}  // namespace miso
+
+#endif
@@ -20,9 +20,11 @@
 #endif  // MFEM_USE_EGADS
 #endif  // MFEM_USE_PUMI
 
+#include "checkpoint.hpp"
 #include "finite_element_state.hpp"
 #include "material_library.hpp"
 #include "sbp_fe.hpp"
+#include "timers.hpp"
 #include "utils.hpp"
 
 #include "pde_solver.hpp"
@@ -93,6 +95,43 @@
 
 // }  // namespace
 
+namespace
+{
+/// \brief Partition `smesh` over the ranks of `comm`, as `mfem::ParMesh` does
+/// \param[in] comm - the communicator to partition over
+/// \param[in] smesh - the serial mesh
+/// \param[out] global_elements - index in `smesh` of each of this rank's
+/// elements; left empty for nonconforming meshes, whose elements are reordered
+/// \return this rank's part of the mesh
+std::unique_ptr<mfem::ParMesh> partitionMesh(MPI_Comm comm,
+                                             mfem::Mesh &smesh,
+                                             std::vector<int> &global_elements)
+{
+   global_elements.clear();
+   if (smesh.Nonconforming())
+   {
+      return std::make_unique<mfem::ParMesh>(comm, smesh);
+   }
+   int rank = 0;
+   int num_ranks = 1;
+   MPI_Comm_rank(comm, &rank);
+   MPI_Comm_size(comm, &num_ranks);
+
+   /// the partitioning `mfem::ParMesh` would generate itself, which keeps the
+   /// elements of each rank in the order of the serial mesh
+   std::unique_ptr<int[]> partitioning(smesh.GeneratePartitioning(num_ranks));
+   for (int e = 0; e < smesh.GetNE(); ++e)
+   {
+      if (partitioning[e] == rank)
+      {
+         global_elements.push_back(e);
+      }
+   }
+   return std::make_unique<mfem::ParMesh>(comm, smesh, partitioning.get());
+}
+
+}  // namespace
+
 namespace miso
 {
 #ifdef MFEM_USE_PUMI
@@ -129,7 +168,9 @@ MISOMesh::MISOMesh()
 }
 
 MISOMesh::MISOMesh(MISOMesh &&other) noexcept
- : mesh(std::move(other.mesh)), pumi_mesh(std::move(other.pumi_mesh))
+ : mesh(std::move(other.mesh)),
+   global_elements(std::move(other.global_elements)),
+   pumi_mesh(std::move(other.pumi_mesh))
 {
    ++pumi_mesh_count;
 }
@@ -139,6 +180,7 @@ MISOMesh &MISOMesh::operator=(MISOMesh &&other) noexcept
    if (this != &other)
    {
       mesh = std::move(other.mesh);
+      global_elements = std::move(other.global_elements);
       pumi_mesh = std::move(other.pumi_mesh);
    }
    return *this;
@@ -187,14 +229,14 @@ MISOMesh constructMesh(MPI_Comm comm,
    // if serial mesh passed in, use that
    if (smesh != nullptr)
    {
-      mesh.mesh = std::make_unique<mfem::ParMesh>(comm, *smesh);
+      mesh.mesh = partitionMesh(comm, *smesh, mesh.global_elements);
    }
    // native MFEM mesh
    else if (mesh_ext == "mesh")
    {
       // read in the serial mesh
       smesh = std::make_unique<mfem::Mesh>(mesh_file.c_str(), 1, 1);
-      mesh.mesh = std::make_unique<mfem::ParMesh>(comm, *smesh);
+      mesh.mesh = partitionMesh(comm, *smesh, mesh.global_elements);
    }
    // PUMI mesh
    else if (mesh_ext == "smb" || mesh_ext == "ugrid")
@@ -337,6 +379,80 @@ void PDESolver::getMeshCoordinates(mfem::Vector &mesh_coords) const
    fields.at("mesh_coords").setTrueVec(mesh_coords);
 }
 
+void PDESolver::writeCheckpoint(const std::string &filename,
+                                const mfem::Vector &state,
+                                double time,
+                                int timestep)
+{
+   ScopedTimer timer("write-checkpoint");
+   if (mesh_.global_elements.empty() && mesh().GetGlobalNE() > 0)
+   {
+      throw MISOException(
+          "PDESolver::writeCheckpoint: checkpoints need a mesh partitioned "
+          "from a conforming serial mesh!\n");
+   }
+   getState().distributeSharedDofs(state);
+
+   std::map<std::string, const FiniteElementVector *> vectors;
+   for (const auto &[name, field] : fields)
+   {
+      vectors.emplace(name, &field);
+   }
+   for (const auto &[name, dual] : duals)
+   {
+      if (!vectors.emplace(name, &dual).second)
+      {
+         throw MISOException("PDESolver::writeCheckpoint: \"" + name +
+                             "\" is both a field and a dual!\n");
+      }
+   }
+   miso::writeCheckpoint(filename,
+                         mesh(),
+                         mesh_.global_elements,
+                         vectors,
+                         {{"time", time}, {"timestep", timestep}});
+}
+
+nlohmann::json PDESolver::readCheckpoint(const std::string &filename,
+                                         mfem::Vector &state)
+{
+   ScopedTimer timer("read-checkpoint");
+   if (mesh_.global_elements.empty() && mesh().GetGlobalNE() > 0)
+   {
+      throw MISOException(
+          "PDESolver::readCheckpoint: checkpoints need a mesh partitioned "
+          "from a conforming serial mesh!\n");
+   }
+   CheckpointReader reader(filename);
+   for (auto &[name, field] : fields)
+   {
+      if (reader.contains(name))
+      {
+         reader.read(name, mesh_.global_elements, field);
+      }
+   }
+   for (auto &[name, dual] : duals)
+   {
+      if (reader.contains(name))
+      {
+         reader.read(name, mesh_.global_elements, dual);
+      }
+   }
+   getState().setTrueVec(state);
+
+   /// the residual learns of the restored mesh through its inputs
+   if (reader.contains("mesh_coords") && spatial_res)
+   {
+      mfem::Vector mesh_coords;
+      getMeshCoordinates(mesh_coords);
+      setInputs(*spatial_res, {{"mesh_coords", mesh_coords}});
+   }
+
+   const auto &metadata = reader.metadata();
+   options["time-dis"]["t-initial"] = metadata["time"];
+   return metadata;
+}
+
 PDESolver::PDESolver(MPI_Comm incomm,
                      const nlohmann::json &solver_options,
                      const int num_states,
@@ -542,6 +658,16 @@ void PDESolver::iterationHook(int iter,
                               const mfem::Vector &state)
 {
    AbstractSolver2::iterationHook(iter, t, dt, state);
+   const auto &checkpoint = options["checkpoint"];
+   const int every = checkpoint["every"].get<int>();
+   if (every > 0 && iter > 0 && iter % every == 0)
+   {
+      writeCheckpoint(checkpoint["prefix"].get<std::string>() + "_" +
+                          std::to_string(iter) + ".ckpt",
+                      state,
+                      t,
+                      iter);
+   }
    derivedPDEIterationHook(iter, t, dt, state);
 }
 
@@ -550,6 +676,14 @@ void PDESolver::terminalHook(int iter,
                              const mfem::Vector &state)
 {
    AbstractSolver2::terminalHook(iter, t_final, state);
+   const auto &checkpoint = options["checkpoint"];
+   if (checkpoint["every"].get<int>() > 0)
+   {
+      writeCheckpoint(checkpoint["prefix"].get<std::string>() + "_final.ckpt",
+                      state,
+                      t_final,
+                      iter);
+   }
    derivedPDETerminalHook(iter, t_final, state);
 }
 
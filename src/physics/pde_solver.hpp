@@ -2,6 +2,7 @@
 #define MISO_PDE_SOLVER
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <functional>
 
@@ -37,6 +38,9 @@ namespace miso
 struct MISOMesh
 {
    std::unique_ptr<mfem::ParMesh> mesh = nullptr;
+   /// index in the serial mesh of each of this rank's elements, used to write
+   /// checkpoints that do not depend on the partitioning; empty if unknown
+   std::vector<int> global_elements;
 #ifdef MFEM_USE_PUMI
    std::unique_ptr<apf::Mesh2, pumiDeleter> pumi_mesh = nullptr;
    static int pumi_mesh_count;
@@ -74,6 +78,28 @@ public:
    FiniteElementDual &getResVec() { return res_vec(); }
    const FiniteElementDual &getResVec() const { return res_vec(); }
 
+   /// \brief Collectively write the solver's `fields` and `duals` to a single
+   /// checkpoint file, which can be read back on any number of ranks
+   /// \param[in] filename - the checkpoint file, which is overwritten
+   /// \param[in] state - the true dofs of the state, written as "state"
+   /// \param[in] time - the time of the state
+   /// \param[in] timestep - the time step of the state
+   void writeCheckpoint(const std::string &filename,
+                        const mfem::Vector &state,
+                        double time = 0.0,
+                        int timestep = 0);
+
+   /// \brief Restart from a checkpoint written by `writeCheckpoint`, possibly
+   /// on a different number of ranks
+   /// \param[in] filename - the checkpoint file
+   /// \param[out] state - the true dofs of the checkpoint's state
+   /// \return the checkpoint's {"time", "timestep"}
+   /// \note Every field and dual found in the checkpoint is restored, which
+   /// moves the mesh if "mesh_coords" is, and "t-initial" is set to the
+   /// checkpoint's time so that `solveForState` continues from it
+   nlohmann::json readCheckpoint(const std::string &filename,
+                                 mfem::Vector &state);
+
    /// Construct a `PDESolver`
    /// \param[in] incomm - MPI communicator to associate with the solver
    /// \param[in] solver_options - options used to define the solver
@@ -31,7 +31,7 @@ ThermalSolver::ThermalSolver(MPI_Comm comm,
                   std::forward_as_tuple("thermal_load"),
                   std::forward_as_tuple(mesh(), fes(), "thermal_load"));
 
-   auto *prec = getPreconditioner(*spatial_res);
+   auto *prec = lagPreconditioner(getPreconditioner(*spatial_res));
    auto lin_solver_opts = options["lin-solver"];
    linear_solver = miso::constructLinearSolver(comm, lin_solver_opts, prec);
    auto nonlin_solver_opts = options["nonlin-solver"];
@@ -35,6 +35,11 @@ void setOptions(ThermalResidual &residual, const nlohmann::json &options)
    setOptions(residual.res, options);
 }
 
+std::size_t getGeometricCacheMemory(const ThermalResidual &residual)
+{
+   return getGeometricCacheMemory(residual.res);
+}
+
 void evaluate(ThermalResidual &residual,
               const miso::MISOInputs &inputs,
               mfem::Vector &res_vec)
@@ -47,6 +52,19 @@ void evaluate(ThermalResidual &residual,
    }
 }
 
+mfem::Operator &evaluateAndLinearize(ThermalResidual &residual,
+                                     const miso::MISOInputs &inputs,
+                                     mfem::Vector &res_vec)
+{
+   auto &jac = evaluateAndLinearize(residual.res, inputs, res_vec);
+
+   if (residual.load.Size() == res_vec.Size())
+   {
+      res_vec.Add(-1.0, residual.load);
+   }
+   return jac;
+}
+
 void linearize(ThermalResidual &residual, const miso::MISOInputs &inputs)
 {
    linearize(residual.res, inputs);
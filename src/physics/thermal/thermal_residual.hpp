@@ -26,10 +26,19 @@ public:
    friend void setOptions(ThermalResidual &residual,
                           const nlohmann::json &options);
 
+   /// Get the memory used by the residual's geometric factor caches, in bytes
+   friend std::size_t getGeometricCacheMemory(
+       const ThermalResidual &residual);
+
    friend void evaluate(ThermalResidual &residual,
                         const MISOInputs &inputs,
                         mfem::Vector &res_vec);
 
+   /// Evaluate the residual and compute its state Jacobian in one sweep
+   friend mfem::Operator &evaluateAndLinearize(ThermalResidual &residual,
+                                               const MISOInputs &inputs,
+                                               mfem::Vector &res_vec);
+
    friend void linearize(ThermalResidual &residual,
                          const miso::MISOInputs &inputs);
 
@@ -0,0 +1,63 @@
+#ifndef MISO_THREAD_WORKSPACES
+#define MISO_THREAD_WORKSPACES
+
+#include <vector>
+
+#ifdef MISO_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace miso
+{
+/// \return the index of the calling thread within the current parallel
+/// region, or 0 if MISO was built without OpenMP
+inline int getAssemblyThreadNum()
+{
+#ifdef MISO_USE_OPENMP
+   return omp_get_thread_num();
+#else
+   return 0;
+#endif
+}
+
+/// \return the number of threads available for element assembly, or 1 if
+/// MISO was built without OpenMP
+inline int getMaxAssemblyThreads()
+{
+#ifdef MISO_USE_OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+/// \brief One copy of an integrator's scratch storage for each thread that
+/// assembles elements
+/// \tparam Workspace - the scratch storage used by a single element assembly
+/// \note `resize` must be called outside of any parallel region; `local` may
+/// then be called concurrently by at most that many threads
+template <typename Workspace>
+class ThreadWorkspaces
+{
+public:
+   /// \brief Make sure there is a workspace for each of `num_threads` threads
+   void resize(int num_threads)
+   {
+      if (num_threads > static_cast<int>(workspaces.size()))
+      {
+         workspaces.resize(num_threads);
+      }
+   }
+
+   /// \return the workspace owned by the calling thread
+   Workspace &local() { return workspaces[getAssemblyThreadNum()]; }
+
+private:
+   /// workspaces indexed by thread number; one is always available for
+   /// serial assembly
+   std::vector<Workspace> workspaces = std::vector<Workspace>(1);
+};
+
+}  // namespace miso
+
+#endif
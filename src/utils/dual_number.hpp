@@ -0,0 +1,366 @@
+#ifndef MISO_DUAL_NUMBER
+#define MISO_DUAL_NUMBER
+
+#include <cmath>
+
+namespace miso
+{
+/// The dual number and its operators live in their own namespace, where they
+/// are found by argument-dependent lookup; declaring `sqrt`, `pow`, etc.
+/// directly in `miso` would hide the `double` overloads from code in `miso`
+namespace dual
+{
+/// Forward-mode dual number that carries the derivatives of its value with
+/// respect to `N` independent variables
+/// \tparam N - number of independent variables, fixed at compile time so that
+/// the derivatives live on the stack
+/// \note Templates written for `xdouble` = `double` or `adept::adouble` can be
+/// instantiated with `Dual<N>` to compute Jacobians without an Adept tape
+template <int N>
+class Dual
+{
+public:
+   Dual() = default;
+
+   /// \param[in] value - value of a variable with zero derivatives
+   Dual(double value) : val(value) { }
+
+   /// value of the variable
+   double val = 0.0;
+   /// derivatives of the variable with respect to the independent variables
+   double der[N] = {};
+
+   Dual &operator+=(const Dual &b)
+   {
+      val += b.val;
+      for (int i = 0; i < N; ++i)
+      {
+         der[i] += b.der[i];
+      }
+      return *this;
+   }
+
+   Dual &operator-=(const Dual &b)
+   {
+      val -= b.val;
+      for (int i = 0; i < N; ++i)
+      {
+         der[i] -= b.der[i];
+      }
+      return *this;
+   }
+
+   Dual &operator*=(const Dual &b)
+   {
+      for (int i = 0; i < N; ++i)
+      {
+         der[i] = der[i] * b.val + val * b.der[i];
+      }
+      val *= b.val;
+      return *this;
+   }
+
+   Dual &operator/=(const Dual &b)
+   {
+      const double inv = 1.0 / b.val;
+      val *= inv;
+      for (int i = 0; i < N; ++i)
+      {
+         der[i] = (der[i] - val * b.der[i]) * inv;
+      }
+      return *this;
+   }
+
+   Dual &operator+=(double b)
+   {
+      val += b;
+      return *this;
+   }
+
+   Dual &operator-=(double b)
+   {
+      val -= b;
+      return *this;
+   }
+
+   Dual &operator*=(double b)
+   {
+      val *= b;
+      for (int i = 0; i < N; ++i)
+      {
+         der[i] *= b;
+      }
+      return *this;
+   }
+
+   Dual &operator/=(double b) { return *this *= 1.0 / b; }
+};
+
+/// Apply the chain rule for a function with value `f` and derivative `dfdx`
+/// at `x`
+template <int N>
+inline Dual<N> chain(const Dual<N> &x, double f, double dfdx)
+{
+   Dual<N> y(f);
+   for (int i = 0; i < N; ++i)
+   {
+      y.der[i] = dfdx * x.der[i];
+   }
+   return y;
+}
+
+template <int N>
+inline Dual<N> operator-(const Dual<N> &a)
+{
+   return chain(a, -a.val, -1.0);
+}
+
+template <int N>
+inline Dual<N> operator+(const Dual<N> &a) { return a; }
+
+template <int N>
+inline Dual<N> operator+(Dual<N> a, const Dual<N> &b) { return a += b; }
+
+template <int N>
+inline Dual<N> operator+(Dual<N> a, double b) { return a += b; }
+
+template <int N>
+inline Dual<N> operator+(double a, Dual<N> b) { return b += a; }
+
+template <int N>
+inline Dual<N> operator-(Dual<N> a, const Dual<N> &b) { return a -= b; }
+
+template <int N>
+inline Dual<N> operator-(Dual<N> a, double b) { return a -= b; }
+
+template <int N>
+inline Dual<N> operator-(double a, const Dual<N> &b) { return -b + a; }
+
+template <int N>
+inline Dual<N> operator*(Dual<N> a, const Dual<N> &b) { return a *= b; }
+
+template <int N>
+inline Dual<N> operator*(Dual<N> a, double b) { return a *= b; }
+
+template <int N>
+inline Dual<N> operator*(double a, Dual<N> b) { return b *= a; }
+
+template <int N>
+inline Dual<N> operator/(Dual<N> a, const Dual<N> &b) { return a /= b; }
+
+template <int N>
+inline Dual<N> operator/(Dual<N> a, double b) { return a /= b; }
+
+template <int N>
+inline Dual<N> operator/(double a, const Dual<N> &b)
+{
+   const double inv = 1.0 / b.val;
+   return chain(b, a * inv, -a * inv * inv);
+}
+
+/// Comparisons only look at the values, like those of `adept::adouble`
+#define MISO_DUAL_COMPARISON(op)                                   \
+   template <int N>                                                \
+   inline bool operator op(const Dual<N> &a, const Dual<N> &b)     \
+   {                                                               \
+      return a.val op b.val;                                       \
+   }                                                               \
+   template <int N>                                                \
+   inline bool operator op(const Dual<N> &a, double b)             \
+   {                                                               \
+      return a.val op b;                                           \
+   }                                                               \
+   template <int N>                                                \
+   inline bool operator op(double a, const Dual<N> &b)             \
+   {                                                               \
+      return a op b.val;                                           \
+   }
+MISO_DUAL_COMPARISON(<)
+MISO_DUAL_COMPARISON(<=)
+MISO_DUAL_COMPARISON(>)
+MISO_DUAL_COMPARISON(>=)
+MISO_DUAL_COMPARISON(==)
+MISO_DUAL_COMPARISON(!=)
+#undef MISO_DUAL_COMPARISON
+
+template <int N>
+inline Dual<N> sqrt(const Dual<N> &x)
+{
+   const double f = std::sqrt(x.val);
+   return chain(x, f, 0.5 / f);
+}
+
+template <int N>
+inline Dual<N> exp(const Dual<N> &x)
+{
+   const double f = std::exp(x.val);
+   return chain(x, f, f);
+}
+
+template <int N>
+inline Dual<N> log(const Dual<N> &x)
+{
+   return chain(x, std::log(x.val), 1.0 / x.val);
+}
+
+template <int N>
+inline Dual<N> pow(const Dual<N> &x, double p)
+{
+   if (x.val != 0.0)
+   {
+      const double f = std::pow(x.val, p - 1.0);
+      return chain(x, f * x.val, p * f);
+   }
+   /// at zero, x^(p-1) is singular for p < 1; the derivatives are only
+   /// infinite along directions that move x, and zero (not NaN) otherwise
+   if (p == 0.0)
+   {
+      return Dual<N>(1.0);
+   }
+   if (p >= 1.0)
+   {
+      return chain(x, 0.0, p == 1.0 ? 1.0 : 0.0);
+   }
+   const double dfdx = p * std::pow(x.val, p - 1.0);
+   Dual<N> y(std::pow(x.val, p));
+   for (int i = 0; i < N; ++i)
+   {
+      y.der[i] = x.der[i] == 0.0 ? 0.0 : dfdx * x.der[i];
+   }
+   return y;
+}
+
+template <int N>
+inline Dual<N> pow(double a, const Dual<N> &p)
+{
+   const double f = std::pow(a, p.val);
+   return chain(p, f, f * std::log(a));
+}
+
+template <int N>
+inline Dual<N> pow(const Dual<N> &x, const Dual<N> &p)
+{
+   return exp(p * log(x));
+}
+
+template <int N>
+inline Dual<N> sin(const Dual<N> &x)
+{
+   return chain(x, std::sin(x.val), std::cos(x.val));
+}
+
+template <int N>
+inline Dual<N> cos(const Dual<N> &x)
+{
+   return chain(x, std::cos(x.val), -std::sin(x.val));
+}
+
+template <int N>
+inline Dual<N> atan(const Dual<N> &x)
+{
+   return chain(x, std::atan(x.val), 1.0 / (1.0 + x.val * x.val));
+}
+
+template <int N>
+inline Dual<N> tanh(const Dual<N> &x)
+{
+   const double f = std::tanh(x.val);
+   return chain(x, f, 1.0 - f * f);
+}
+
+template <int N>
+inline Dual<N> fabs(const Dual<N> &x)
+{
+   return x.val < 0.0 ? -x : x;
+}
+
+template <int N>
+inline Dual<N> abs(const Dual<N> &x)
+{
+   return fabs(x);
+}
+
+template <int N>
+inline Dual<N> max(const Dual<N> &a, const Dual<N> &b)
+{
+   return a.val < b.val ? b : a;
+}
+
+template <int N>
+inline Dual<N> min(const Dual<N> &a, const Dual<N> &b)
+{
+   return b.val < a.val ? b : a;
+}
+
+}  // namespace dual
+
+using dual::Dual;
+
+/// Set dual numbers to the values in `x`, with zero derivatives
+/// \param[in] x - values of the passive variables
+/// \param[in] n - number of variables
+/// \param[out] x_d - the dual numbers
+template <int N>
+inline void setDualValues(const double *x, int n, Dual<N> *x_d)
+{
+   for (int i = 0; i < n; ++i)
+   {
+      x_d[i] = Dual<N>(x[i]);
+   }
+}
+
+/// Set dual numbers to the independent variables `offset`, ...,
+/// `offset + n - 1`, with values from `x`
+/// \param[in] x - values of the independent variables
+/// \param[in] n - number of variables
+/// \param[in] offset - index of the first of the independent variables
+/// \param[out] x_d - the dual numbers
+template <int N>
+inline void seedDual(const double *x, int n, int offset, Dual<N> *x_d)
+{
+   for (int i = 0; i < n; ++i)
+   {
+      x_d[i] = Dual<N>(x[i]);
+      x_d[i].der[offset + i] = 1.0;
+   }
+}
+
+/// Copy the values of dual numbers
+/// \param[in] y_d - the dual numbers
+/// \param[in] n - number of variables
+/// \param[out] y - the values of `y_d`
+template <int N>
+inline void getDualValues(const Dual<N> *y_d, int n, double *y)
+{
+   for (int i = 0; i < n; ++i)
+   {
+      y[i] = y_d[i].val;
+   }
+}
+
+/// Copy the derivatives of dependent dual numbers into a Jacobian
+/// \param[in] y_d - the dependent dual numbers
+/// \param[in] m - number of dependent variables
+/// \param[in] col_begin - first independent variable to copy
+/// \param[in] num_cols - number of independent variables to copy
+/// \param[out] jac - column-major `m` x `num_cols` Jacobian, e.g. the data
+/// of an `mfem::DenseMatrix`
+template <int N>
+inline void getDualJacobian(const Dual<N> *y_d,
+                            int m,
+                            int col_begin,
+                            int num_cols,
+                            double *jac)
+{
+   for (int j = 0; j < num_cols; ++j)
+   {
+      for (int i = 0; i < m; ++i)
+      {
+         jac[i + j * m] = y_d[i].der[col_begin + j];
+      }
+   }
+}
+
+}  // namespace miso
+
+#endif
@@ -292,7 +292,7 @@ MeshWarper::MeshWarper(MPI_Comm incomm,
        MeshWarperResidual(fes(), fields, options, surface_indices));
    miso::setOptions(*spatial_res, options);
 
-   auto *prec = getPreconditioner(*spatial_res);
+   auto *prec = lagPreconditioner(getPreconditioner(*spatial_res));
    auto lin_solver_opts = options["lin-solver"];
    linear_solver = miso::constructLinearSolver(comm, lin_solver_opts, prec);
    auto nonlin_solver_opts = options["nonlin-solver"];
@@ -0,0 +1,222 @@
+#ifndef MISO_SIMD_PACK
+#define MISO_SIMD_PACK
+
+#include <cmath>
+
+/// Asks the compiler to vectorize the loop that follows over the lanes of a
+/// `Pack`; lane loops have a compile-time trip count and no dependences, so
+/// they vectorize without the hint at -O3
+/// \note `log`, `exp` and `pow` are only vectorized when the math library has
+/// vector variants, e.g. glibc's libmvec with `-fopenmp-simd -ffast-math`;
+/// otherwise they are called lane by lane
+#if defined(_OPENMP)
+#define MISO_SIMD_LOOP _Pragma("omp simd")
+#elif defined(__clang__)
+#define MISO_SIMD_LOOP _Pragma("clang loop vectorize(enable)")
+#elif defined(__GNUC__)
+#define MISO_SIMD_LOOP _Pragma("GCC ivdep")
+#else
+#define MISO_SIMD_LOOP
+#endif
+
+namespace miso
+{
+/// Fixed-width packs of doubles that are operated on lane by lane
+/// \note Like `Dual`, the pack and its math functions live in their own
+/// namespace, where argument-dependent lookup finds them, so that they do not
+/// hide the `double` overloads from code in `miso`
+namespace simd
+{
+/// Number of double lanes of the widest vector registers being compiled for
+#if defined(__AVX512F__)
+constexpr int default_width = 8;
+#elif defined(__AVX__)
+constexpr int default_width = 4;
+#else
+constexpr int default_width = 2;
+#endif
+
+/// Pack of `W` doubles, one per SIMD lane
+/// \tparam W - number of lanes
+/// \note Templates written for `xdouble` = `double` can be instantiated with
+/// `Pack<W>` to evaluate `W` independent problems at once, provided they do
+/// not branch on the value of an `xdouble`
+template <int W>
+class Pack
+{
+public:
+   Pack() = default;
+
+   /// \param[in] value - value to broadcast to all lanes
+   Pack(double value)
+   {
+      MISO_SIMD_LOOP
+      for (int l = 0; l < W; ++l)
+      {
+         lane[l] = value;
+      }
+   }
+
+   /// \brief Load the lanes from `W` contiguous doubles
+   static Pack load(const double *data)
+   {
+      Pack p;
+      MISO_SIMD_LOOP
+      for (int l = 0; l < W; ++l)
+      {
+         p.lane[l] = data[l];
+      }
+      return p;
+   }
+
+   /// \brief Store the lanes in `W` contiguous doubles
+   void store(double *data) const
+   {
+      MISO_SIMD_LOOP
+      for (int l = 0; l < W; ++l)
+      {
+         data[l] = lane[l];
+      }
+   }
+
+   double &operator[](int l) { return lane[l]; }
+   double operator[](int l) const { return lane[l]; }
+
+   /// the values of the lanes
+   double lane[W];
+
+#define MISO_PACK_COMPOUND(op)                \
+   Pack &operator op(const Pack &b)           \
+   {                                          \
+      MISO_SIMD_LOOP                          \
+      for (int l = 0; l < W; ++l)             \
+      {                                       \
+         lane[l] op b.lane[l];                \
+      }                                       \
+      return *this;                           \
+   }                                          \
+   Pack &operator op(double b)                \
+   {                                          \
+      MISO_SIMD_LOOP                          \
+      for (int l = 0; l < W; ++l)             \
+      {                                       \
+         lane[l] op b;                        \
+      }                                       \
+      return *this;                           \
+   }
+   MISO_PACK_COMPOUND(+=)
+   MISO_PACK_COMPOUND(-=)
+   MISO_PACK_COMPOUND(*=)
+   MISO_PACK_COMPOUND(/=)
+#undef MISO_PACK_COMPOUND
+};
+
+#define MISO_PACK_BINARY(op, op_assign)                           \
+   template <int W>                                                \
+   inline Pack<W> operator op(const Pack<W> &a, const Pack<W> &b)  \
+   {                                                               \
+      Pack<W> c = a;                                               \
+      return c op_assign b;                                        \
+   }                                                               \
+   template <int W>                                                \
+   inline Pack<W> operator op(const Pack<W> &a, double b)          \
+   {                                                               \
+      Pack<W> c = a;                                               \
+      return c op_assign b;                                        \
+   }                                                               \
+   template <int W>                                                \
+   inline Pack<W> operator op(double a, const Pack<W> &b)          \
+   {                                                               \
+      Pack<W> c(a);                                                \
+      return c op_assign b;                                        \
+   }
+MISO_PACK_BINARY(+, +=)
+MISO_PACK_BINARY(-, -=)
+MISO_PACK_BINARY(*, *=)
+MISO_PACK_BINARY(/, /=)
+#undef MISO_PACK_BINARY
+
+template <int W>
+inline Pack<W> operator-(const Pack<W> &a)
+{
+   return 0.0 - a;
+}
+
+/// Apply the scalar function `f` to each lane of `a`
+#define MISO_PACK_UNARY(name, f)                   \
+   template <int W>                                \
+   inline Pack<W> name(const Pack<W> &a)           \
+   {                                               \
+      Pack<W> b;                                   \
+      MISO_SIMD_LOOP                               \
+      for (int l = 0; l < W; ++l)                  \
+      {                                            \
+         b.lane[l] = f(a.lane[l]);                 \
+      }                                            \
+      return b;                                    \
+   }
+MISO_PACK_UNARY(sqrt, std::sqrt)
+MISO_PACK_UNARY(exp, std::exp)
+MISO_PACK_UNARY(log, std::log)
+MISO_PACK_UNARY(fabs, std::fabs)
+MISO_PACK_UNARY(abs, std::fabs)
+#undef MISO_PACK_UNARY
+
+template <int W>
+inline Pack<W> pow(const Pack<W> &a, double p)
+{
+   Pack<W> b;
+   MISO_SIMD_LOOP
+   for (int l = 0; l < W; ++l)
+   {
+      b.lane[l] = std::pow(a.lane[l], p);
+   }
+   return b;
+}
+
+template <int W>
+inline Pack<W> max(const Pack<W> &a, const Pack<W> &b)
+{
+   Pack<W> c;
+   MISO_SIMD_LOOP
+   for (int l = 0; l < W; ++l)
+   {
+      c.lane[l] = a.lane[l] < b.lane[l] ? b.lane[l] : a.lane[l];
+   }
+   return c;
+}
+
+template <int W>
+inline Pack<W> min(const Pack<W> &a, const Pack<W> &b)
+{
+   Pack<W> c;
+   MISO_SIMD_LOOP
+   for (int l = 0; l < W; ++l)
+   {
+      c.lane[l] = b.lane[l] < a.lane[l] ? b.lane[l] : a.lane[l];
+   }
+   return c;
+}
+
+/// \return the lanes of `a` where `mask` is less than `threshold`, and those
+/// of `b` elsewhere; the branch-free replacement for `if (mask < threshold)`
+template <int W>
+inline Pack<W> selectLess(const Pack<W> &mask,
+                          double threshold,
+                          const Pack<W> &a,
+                          const Pack<W> &b)
+{
+   Pack<W> c;
+   MISO_SIMD_LOOP
+   for (int l = 0; l < W; ++l)
+   {
+      c.lane[l] = mask.lane[l] < threshold ? a.lane[l] : b.lane[l];
+   }
+   return c;
+}
+
+}  // namespace simd
+
+}  // namespace miso
+
+#endif
@@ -8,6 +8,7 @@
 #include "miso_residual.hpp"
 #include "matrix_operators.hpp"
 #include "mfem_extensions.hpp"
+#include "timers.hpp"
 #include "utils.hpp"
 
 using std::cout;
@@ -324,4 +325,219 @@ TEST_CASE("Testing AbstractSolver using RRK6", "[abstract-solver]")
    REQUIRE( error < 7.0e-7 );
 
    REQUIRE( entropy == Approx(entropy0).margin(1e-12) );
-}
\ No newline at end of file
+}
+
+TEST_CASE("LaggedPreconditioner reuses setups until they are stale",
+          "[abstract-solver]")
+{
+   using namespace mfem;
+
+   SparseMatrix mat(3);
+   for (int i = 0; i < 3; ++i)
+   {
+      mat.Set(i, i, 2.0);
+   }
+   mat.Finalize();
+   DSmoother jacobi;
+   Vector x(3), y(3);
+   x = 1.0;
+
+   SECTION("set up again after a fixed number of operators")
+   {
+      miso::LaggedPreconditioner prec(jacobi, 3, 0);
+      for (int i = 0; i < 7; ++i)
+      {
+         prec.SetOperator(mat);
+         prec.Mult(x, y);
+      }
+      REQUIRE(prec.numSetups() == 3);
+      REQUIRE(prec.numReuses() == 4);
+      REQUIRE(y(0) == Approx(0.5));
+   }
+
+   SECTION("set up again once a linear solve takes too many iterations")
+   {
+      miso::LaggedPreconditioner prec(jacobi, 0, 2);
+      prec.SetOperator(mat);
+      prec.Mult(x, y);
+      prec.SetOperator(mat);
+      REQUIRE(prec.numSetups() == 1);
+      for (int i = 0; i < 3; ++i)
+      {
+         prec.Mult(x, y);
+      }
+      prec.SetOperator(mat);
+      REQUIRE(prec.numSetups() == 2);
+
+      prec.invalidate();
+      prec.SetOperator(mat);
+      REQUIRE(prec.numSetups() == 3);
+      REQUIRE(prec.numReuses() == 1);
+   }
+}
+
+TEST_CASE("FixedOperatorSolver keeps the operator of the solver it wraps",
+          "[abstract-solver]")
+{
+   using namespace mfem;
+
+   SparseMatrix mat(3), other_mat(3);
+   for (int i = 0; i < 3; ++i)
+   {
+      mat.Set(i, i, 2.0);
+      other_mat.Set(i, i, 4.0);
+   }
+   mat.Finalize();
+   other_mat.Finalize();
+   DSmoother jacobi;
+   jacobi.SetOperator(mat);
+   Vector x(3), y(3);
+   x = 1.0;
+
+   miso::FixedOperatorSolver fixed(jacobi);
+   fixed.SetOperator(other_mat);
+   fixed.Mult(x, y);
+   REQUIRE(fixed.Height() == 3);
+   REQUIRE(y(0) == Approx(0.5));
+}
+
+TEST_CASE("RecyclingGMRESSolver reuses its subspace across solves",
+          "[abstract-solver]")
+{
+   using namespace mfem;
+
+   const int size = 40;
+   auto buildMatrix = [&](double diag)
+   {
+      SparseMatrix mat(size);
+      for (int i = 0; i < size; ++i)
+      {
+         mat.Set(i, i, diag);
+         if (i > 0)
+         {
+            mat.Set(i, i - 1, -1.3);
+         }
+         if (i < size - 1)
+         {
+            mat.Set(i, i + 1, -0.7);
+         }
+      }
+      mat.Finalize();
+      return mat;
+   };
+   auto mat = buildMatrix(2.0);
+   auto perturbed_mat = buildMatrix(2.1);
+
+   Vector b(size), x(size), res(size);
+   b = 1.0;
+   auto solve = [&](miso::RecyclingGMRESSolver &solver,
+                    const SparseMatrix &op)
+   {
+      x = 0.0;
+      solver.Mult(b, x);
+      op.Mult(x, res);
+      res -= b;
+      REQUIRE(solver.GetConverged());
+      REQUIRE(res.Norml2() <= 1e-8 * b.Norml2());
+      return solver.GetNumIterations();
+   };
+
+   miso::RecyclingGMRESSolver solver(10, 10);
+   solver.SetRelTol(1e-10);
+   solver.SetMaxIter(400);
+   solver.SetOperator(mat);
+   const int first_iters = solve(solver, mat);
+   REQUIRE(solver.recycledSize() > 0);
+   REQUIRE(solver.recycledSize() <= 10);
+
+   SECTION("the same system converges in the recycled subspace")
+   {
+      REQUIRE(solve(solver, mat) < first_iters / 2);
+   }
+
+   SECTION("a perturbed system needs fewer iterations than without recycling")
+   {
+      solver.SetOperator(perturbed_mat);
+      const int recycled_iters = solve(solver, perturbed_mat);
+
+      miso::RecyclingGMRESSolver fresh_solver(10, 10);
+      fresh_solver.SetRelTol(1e-10);
+      fresh_solver.SetMaxIter(400);
+      fresh_solver.SetOperator(perturbed_mat);
+      REQUIRE(recycled_iters < solve(fresh_solver, perturbed_mat));
+   }
+}
+
+TEST_CASE("TimerRegistry nests timers and counters", "[abstract-solver]")
+{
+   miso::TimerRegistry registry;
+   for (int i = 0; i < 2; ++i)
+   {
+      registry.start("solve");
+      registry.start("linear-solve");
+      registry.count("krylov-iterations", 5);
+      registry.stop();
+      registry.stop();
+   }
+   registry.count("newton-iterations");
+
+   auto local = registry.local();
+   REQUIRE(local["timers"]["solve"]["calls"] == 2);
+   REQUIRE(local["timers"]["solve/linear-solve"]["calls"] == 2);
+   REQUIRE(local["counters"]["solve/linear-solve/krylov-iterations"] == 10);
+   REQUIRE(local["counters"]["newton-iterations"] == 1);
+   REQUIRE(local["timers"]["solve"]["time"].get<double>() >=
+           local["timers"]["solve/linear-solve"]["time"].get<double>());
+
+   int num_ranks = 1;
+   MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+   auto reduced = registry.reduce(MPI_COMM_WORLD);
+   REQUIRE(reduced["ranks"] == num_ranks);
+   REQUIRE(reduced["counters"]["newton-iterations"]["sum"] == num_ranks);
+
+   registry.reset();
+   REQUIRE(registry.local()["timers"].empty());
+   REQUIRE_THROWS_AS(registry.stop(), miso::MISOException);
+}
+
+TEST_CASE("assembleTimed times each integrator once per assembly",
+          "[abstract-solver]")
+{
+   auto smesh = mfem::Mesh::MakeCartesian2D(
+       4, 4, mfem::Element::TRIANGLE, true, 1.0, 1.0);
+   mfem::ParMesh mesh(MPI_COMM_WORLD, smesh);
+   mfem::H1_FECollection fec(1, mesh.Dimension());
+   mfem::ParFiniteElementSpace fes(&mesh, &fec);
+
+   mfem::ConstantCoefficient one(1.0);
+   mfem::FunctionCoefficient x_coeff([](const mfem::Vector &x)
+                                     { return x(0); });
+   auto add_integrators = [&](mfem::ParLinearForm &form)
+   {
+      form.AddDomainIntegrator(new mfem::DomainLFIntegrator(one));
+      form.AddDomainIntegrator(new mfem::DomainLFIntegrator(x_coeff));
+      form.AddBoundaryIntegrator(new mfem::BoundaryLFIntegrator(x_coeff));
+   };
+   mfem::ParLinearForm form(&fes);
+   add_integrators(form);
+   mfem::ParLinearForm expected(&fes);
+   add_integrators(expected);
+   expected.Assemble();
+
+   miso::timers().reset();
+   miso::assembleTimed(form);
+   miso::assembleTimed(form);
+
+   for (int i = 0; i < form.Size(); ++i)
+   {
+      REQUIRE(form(i) == Approx(expected(i)).margin(1e-14));
+   }
+   auto local = miso::timers().local();
+   REQUIRE(local["timers"]["DomainLFIntegrator"]["calls"] == 4);
+   REQUIRE(local["timers"]["BoundaryLFIntegrator"]["calls"] == 2);
+
+   /// the form keeps its integrators
+   REQUIRE(form.GetDLFI()->Size() == 2);
+   REQUIRE(form.GetBLFI()->Size() == 1);
+   miso::timers().reset();
+}
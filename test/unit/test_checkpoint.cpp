@@ -0,0 +1,144 @@
+#include <memory>
+#include <random>
+#include <string>
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "checkpoint.hpp"
+#include "finite_element_dual.hpp"
+#include "finite_element_state.hpp"
+#include "pde_solver.hpp"
+#include "utils.hpp"
+
+TEST_CASE("writeCheckpoint and CheckpointReader round trip")
+{
+   using namespace miso;
+   std::uniform_real_distribution<double> u(-1.0, 1.0);
+   std::default_random_engine r;
+
+   int rank = 0;
+   int num_ranks = 1;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+
+   auto smesh = std::make_unique<mfem::Mesh>(
+       mfem::Mesh::MakeCartesian2D(4, 4, mfem::Element::TRIANGLE));
+   const int num_elements = smesh->GetNE();
+   auto mesh_options = R"({"file": "checkpoint.mesh"})"_json;
+   auto mesh = constructMesh(MPI_COMM_WORLD, mesh_options, std::move(smesh));
+   REQUIRE(static_cast<int>(mesh.global_elements.size()) ==
+           mesh.mesh->GetNE());
+
+   FiniteElementState state(*mesh.mesh, {.order = 2, .num_states = 2});
+   FiniteElementDual residual(*mesh.mesh, {.order = 2, .num_states = 2});
+
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+   mfem::Vector residual_tv(residual.space().GetTrueVSize());
+   for (int i = 0; i < state_tv.Size(); ++i)
+   {
+      state_tv(i) = u(r);
+      residual_tv(i) = u(r);
+   }
+   state.distributeSharedDofs(state_tv);
+   residual.distributeSharedDofs(residual_tv);
+
+   writeCheckpoint("test_checkpoint.ckpt",
+                   *mesh.mesh,
+                   mesh.global_elements,
+                   {{"state", &state}, {"residual", &residual}},
+                   {{"time", 0.25}, {"timestep", 5}});
+
+   CheckpointReader reader("test_checkpoint.ckpt");
+   REQUIRE(reader.metadata()["time"].get<double>() == 0.25);
+   REQUIRE(reader.metadata()["timestep"].get<int>() == 5);
+   REQUIRE(reader.numRanks() == num_ranks);
+   REQUIRE(reader.contains("state"));
+   REQUIRE(reader.contains("residual"));
+   REQUIRE(!reader.contains("adjoint"));
+
+   auto partitioning = reader.partitioning();
+   REQUIRE(static_cast<int>(partitioning.size()) == num_elements);
+   for (int e : mesh.global_elements)
+   {
+      REQUIRE(partitioning[e] == rank);
+   }
+
+   FiniteElementState read_state(*mesh.mesh, {.order = 2, .num_states = 2});
+   FiniteElementDual read_residual(*mesh.mesh, {.order = 2, .num_states = 2});
+   reader.read("state", mesh.global_elements, read_state);
+   reader.read("residual", mesh.global_elements, read_residual);
+
+   mfem::Vector read_tv(state_tv.Size());
+   read_state.setTrueVec(read_tv);
+   for (int i = 0; i < state_tv.Size(); ++i)
+   {
+      REQUIRE(read_tv(i) == Approx(state_tv(i)).margin(1e-14));
+   }
+   read_residual.setTrueVec(read_tv);
+   for (int i = 0; i < residual_tv.Size(); ++i)
+   {
+      REQUIRE(read_tv(i) == Approx(residual_tv(i)).margin(1e-14));
+   }
+
+   FiniteElementState scalar(*mesh.mesh, {.order = 1, .num_states = 1});
+   REQUIRE_THROWS_AS(reader.read("state", mesh.global_elements, scalar),
+                     MISOException);
+}
+
+TEST_CASE("CheckpointReader reads a checkpoint on a different partitioning")
+{
+   using namespace miso;
+
+   int num_ranks = 1;
+   MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+
+   // a field the order 2 space represents exactly, so the field read back can
+   // be compared with its projection on the reading mesh
+   auto field = [](const mfem::Vector &x, mfem::Vector &u)
+   {
+      u.SetSize(2);
+      u(0) = x(0) * x(1) + 0.5;
+      u(1) = x(0) * x(0) - 2.0 * x(1);
+   };
+
+   auto smesh = std::make_unique<mfem::Mesh>(
+       mfem::Mesh::MakeCartesian2D(4, 4, mfem::Element::TRIANGLE));
+   auto serial_mesh = std::make_unique<mfem::Mesh>(*smesh);
+   const int num_elements = smesh->GetNE();
+   auto mesh_options = R"({"file": "checkpoint.mesh"})"_json;
+
+   // write the field partitioned over every rank...
+   auto world_mesh =
+       constructMesh(MPI_COMM_WORLD, mesh_options, std::move(smesh));
+   FiniteElementState state(*world_mesh.mesh, {.order = 2, .num_states = 2});
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+   state.project(field, state_tv);
+   writeCheckpoint("test_checkpoint_repartition.ckpt",
+                   *world_mesh.mesh,
+                   world_mesh.global_elements,
+                   {{"state", &state}},
+                   {{"time", 0.0}});
+   MPI_Barrier(MPI_COMM_WORLD);
+
+   // ...and read all of it back on each rank, on its own unpartitioned mesh
+   auto self_mesh =
+       constructMesh(MPI_COMM_SELF, mesh_options, std::move(serial_mesh));
+   REQUIRE(static_cast<int>(self_mesh.global_elements.size()) == num_elements);
+   CheckpointReader reader("test_checkpoint_repartition.ckpt");
+   REQUIRE(reader.numRanks() == num_ranks);
+   FiniteElementState read_state(*self_mesh.mesh,
+                                 {.order = 2, .num_states = 2});
+   reader.read("state", self_mesh.global_elements, read_state);
+
+   FiniteElementState expected(*self_mesh.mesh, {.order = 2, .num_states = 2});
+   mfem::Vector expected_tv(expected.space().GetTrueVSize());
+   expected.project(field, expected_tv);
+   mfem::Vector read_tv(expected_tv.Size());
+   read_state.setTrueVec(read_tv);
+   for (int i = 0; i < expected_tv.Size(); ++i)
+   {
+      REQUIRE(read_tv(i) == Approx(expected_tv(i)).margin(1e-12));
+   }
+}
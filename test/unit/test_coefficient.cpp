@@ -152,6 +152,42 @@ std::uniform_real_distribution<double> uniform(-1.0,1.0);
 }
 
 
+TEST_CASE("MeshDependentCoefficient attribute dispatch")
+{
+   using namespace mfem;
+   using namespace miso;
+
+   std::stringstream meshStr;
+   meshStr << two_tet_mesh_str;
+   Mesh mesh(meshStr);
+
+   const auto &ip = IntRules.Get(Geometry::TETRAHEDRON, 1).IntPoint(0);
+
+   // attribute 2 is in the table, attribute 1 falls through to the default
+   auto dflt = std::make_unique<ConstantCoefficient>(5.0);
+   MeshDependentCoefficient coeff(std::move(dflt));
+   coeff.addCoefficient(2, std::make_unique<ConstantCoefficient>(3.0));
+   coeff.addCoefficient(7, std::make_unique<ConstantCoefficient>(-1.0));
+
+   // without a default, unknown attributes evaluate to zero
+   MeshDependentCoefficient no_dflt_coeff;
+   no_dflt_coeff.addCoefficient(2, std::make_unique<ConstantCoefficient>(3.0));
+
+   const double expected[] = {5.0, 3.0};
+   const double expected_no_dflt[] = {0.0, 3.0};
+   for (int j = 0; j < mesh.GetNE(); ++j)
+   {
+      IsoparametricTransformation trans;
+      mesh.GetElementTransformation(j, &trans);
+      trans.SetIntPoint(&ip);
+
+      REQUIRE(coeff.Eval(trans, ip) == Approx(expected[j]));
+      REQUIRE(coeff.Eval(trans, ip, 1.0) == Approx(expected[j]));
+      REQUIRE(coeff.EvalStateDeriv(trans, ip, 1.0) == Approx(0.0));
+      REQUIRE(no_dflt_coeff.Eval(trans, ip) == Approx(expected_no_dflt[j]));
+   }
+}
+
 TEST_CASE("MeshDependentVectorCoefficient::EvalRevDiff",
           "[MeshDependentVectorCoefficient]")
 {
@@ -1,7 +1,9 @@
+#include <cmath>
 #include <map>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "catch.hpp"
 #include "mfem.hpp"
@@ -565,6 +567,67 @@ TEST_CASE("StateAverageFunctional::calcOutput (3D)")
    REQUIRE(rms == Approx(sqrt(2)/2).margin(1e-10));
 }
 
+TEST_CASE("calcOutputs evaluates several functionals in one sweep")
+{
+   int num_edge = 3;
+   auto smesh = mfem::Mesh::MakeCartesian3D(num_edge, num_edge, num_edge,
+                                            mfem::Element::TETRAHEDRON,
+                                            2*M_PI, 1.0, 1.0, true);
+
+   mfem::ParMesh mesh(MPI_COMM_WORLD, smesh);
+   mesh.EnsureNodes();
+   auto dim = mesh.Dimension();
+
+   auto p = 2;
+   mfem::H1_FECollection fec(p, dim);
+   mfem::ParFiniteElementSpace fes(&mesh, &fec);
+
+   std::map<std::string, miso::FiniteElementState> fields;
+
+   fields.emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple("state"),
+      std::forward_as_tuple(mesh, fes, "state"));
+
+   auto &mesh_gf = *dynamic_cast<mfem::ParGridFunction *>(mesh.GetNodes());
+   auto *mesh_fespace = mesh_gf.ParFESpace();
+   /// create new state vector copying the mesh's fe space
+   fields.emplace(
+         std::piecewise_construct,
+         std::forward_as_tuple("mesh_coords"),
+         std::forward_as_tuple(mesh, *mesh_fespace, "mesh_coords"));
+
+   miso::StateAverageFunctional average(fes, fields);
+   miso::VolumeFunctional volume(fields, {});
+
+   auto &state = fields.at("state");
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+
+   state.project([](const mfem::Vector &p)
+   {
+      return sin(p(0)) * sin(p(0)) + p(1);
+   }, state_tv);
+
+   miso::MISOInputs inputs{{"state", state_tv}};
+   const double average_value = calcOutput(average, inputs);
+   const double volume_value = calcOutput(volume, inputs);
+
+   std::vector<miso::FunctionalOutput *> functionals;
+   addFunctionals(average, functionals);
+   addFunctionals(volume, functionals);
+   REQUIRE(functionals.size() == 3);
+
+   mfem::Vector values;
+   calcOutputs(functionals, inputs, values);
+   REQUIRE(values.Size() == 3);
+
+   REQUIRE(calcOutputFromFunctionals(average, values.GetData()) ==
+           Approx(average_value).margin(1e-12));
+   REQUIRE(calcOutputFromFunctionals(volume, values.GetData() + 2) ==
+           Approx(volume_value).margin(1e-12));
+   REQUIRE(volume_value == Approx(2 * M_PI).margin(1e-10));
+}
+
 TEST_CASE("StateAverageFunctional sensitivity wrt state")
 {
    using namespace mfem;
@@ -795,6 +858,51 @@ TEST_CASE("IEAggregateFunctional::calcOutput")
    REQUIRE(max_state == Approx(0.8544376503));
 }
 
+TEST_CASE("IEAggregateFunctional::calcOutput with a large state")
+{
+   auto smesh = mfem::Mesh::MakeCartesian2D(3, 3, mfem::Element::TRIANGLE);
+   mfem::ParMesh mesh(MPI_COMM_WORLD, smesh);
+   mesh.EnsureNodes();
+   auto dim = mesh.Dimension();
+
+   auto p = 2;
+
+   // get the finite-element space for the state
+   mfem::H1_FECollection fec(p, dim);
+   mfem::ParFiniteElementSpace fes(&mesh, &fec);
+
+   std::map<std::string, miso::FiniteElementState> fields;
+   fields.emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple("state"),
+      std::forward_as_tuple(mesh, fes, "state"));
+
+   auto &state = fields.at("state");
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+
+   nlohmann::json output_opts{{"rho", 50.0}};
+   miso::IEAggregateFunctional out(fes, fields, output_opts);
+
+   state.project([](const mfem::Vector &p)
+   {
+      const double x = p(0);
+
+      return - pow(x - 0.5, 2) - pow(x - 0.5, 2) + 1001;
+   }, state_tv);
+
+   /// the exponentials would overflow without the shift, which cancels
+   miso::MISOInputs inputs{{"state", state_tv}};
+   double max_state = calcOutput(out, inputs);
+   REQUIRE(max_state == Approx(1000.9919141335));
+
+   /// a second evaluation at the same state is served from the cache
+   REQUIRE(calcOutput(out, inputs) == max_state);
+
+   state_tv -= 1000.0;
+   max_state = calcOutput(out, inputs);
+   REQUIRE(max_state == Approx(0.9919141335));
+}
+
 TEST_CASE("IEAggregateFunctional sensitivity wrt state")
 {
    using namespace mfem;
@@ -1033,3 +1141,49 @@ TEST_CASE("IECurlMagnitudeAggregateFunctional::calcOutput")
    REQUIRE(max_state == Approx(1.0152746915));
 
 }
+
+TEST_CASE("IECurlMagnitudeAggregateFunctional::calcOutput with a large field")
+{
+   auto smesh = mfem::Mesh::MakeCartesian3D(3, 3, 3, mfem::Element::TETRAHEDRON);
+   mfem::ParMesh mesh(MPI_COMM_WORLD, smesh);
+   mesh.EnsureNodes();
+   auto dim = mesh.Dimension();
+
+   auto p = 2;
+
+   // get the finite-element space for the state
+   mfem::ND_FECollection fec(p, dim);
+   mfem::ParFiniteElementSpace fes(&mesh, &fec);
+
+   std::map<std::string, miso::FiniteElementState> fields;
+   fields.emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple("state"),
+      std::forward_as_tuple(mesh, fes, "state"));
+
+   auto &state = fields.at("state");
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+
+   state.project([](const mfem::Vector &p, mfem::Vector &A)
+   {
+      const double x = p(0);
+      const double y = p(1);
+
+      A = 0.0;
+      A(2) = sin(x) + cos(y);
+   }, state_tv);
+
+   /// scaling the field by c and rho by 1 / c scales the aggregate by c, while
+   /// rho times the largest curl magnitude is far beyond what exp can hold
+   nlohmann::json output_opts{{"rho", 1000.0}};
+   miso::IECurlMagnitudeAggregateFunctional out(fes, fields, output_opts);
+   miso::MISOInputs inputs{{"state", state_tv}};
+   const double max_state = calcOutput(out, inputs);
+   REQUIRE(std::isfinite(max_state));
+   REQUIRE(max_state == Approx(1.2908573815).epsilon(1e-2));
+
+   state_tv *= 1000.0;
+   output_opts["rho"] = 1.0;
+   setOptions(out, output_opts);
+   REQUIRE(calcOutput(out, inputs) == Approx(1000.0 * max_state));
+}
@@ -1,4 +1,8 @@
+#include <filesystem>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "catch.hpp"
 #include "mfem.hpp"
@@ -64,3 +68,131 @@ TEST_CASE("Test Binary Data Logging")
       REQUIRE(read_vec(i) == test_vec(i));
    }
 }
+
+TEST_CASE("BackgroundWriter runs jobs in order")
+{
+   std::vector<int> order;
+   long ticket = -1;
+   {
+      miso::BackgroundWriter writer;
+      for (int i = 0; i < 10; ++i)
+      {
+         ticket = writer.post([&order, i] { order.push_back(i); });
+      }
+      writer.wait(ticket);
+      REQUIRE(order.size() == 10);
+
+      // a failed job must not stop the jobs after it
+      writer.post([] { throw std::runtime_error("failed job"); });
+      writer.post([&order] { order.push_back(10); });
+      writer.flush();
+      REQUIRE(order.size() == 11);
+
+      // jobs still pending when the writer is destroyed are run
+      writer.post([&order] { order.push_back(11); });
+   }
+   REQUIRE(order.size() == 12);
+   for (int i = 0; i < 12; ++i)
+   {
+      REQUIRE(order[i] == i);
+   }
+}
+
+TEST_CASE("AsyncStateLogger writes every state it is given")
+{
+   constexpr int size = 10;
+   constexpr int num_steps = 8;
+   mfem::Vector state(size);
+   miso::DataLogger logger = miso::BinaryLogger{};
+   {
+      // fewer buffers than states, so saving must wait for the writes
+      miso::BackgroundWriter writer;
+      miso::AsyncStateLogger async_logger(writer, 2);
+      for (int step = 0; step < num_steps; ++step)
+      {
+         for (int i = 0; i < size; ++i)
+         {
+            state(i) = step + 0.1 * i;
+         }
+         async_logger.saveState(
+             logger, state, "async_state", step, 0.5 * step, 0);
+      }
+      async_logger.flush(logger);
+   }
+
+   for (int step = 0; step < num_steps; ++step)
+   {
+      double read_time = 0.0;
+      mfem::Vector read_vec;
+      miso::BinaryLogger::readState(
+          "async_state", step, 0, read_time, read_vec);
+      REQUIRE(read_time == 0.5 * step);
+      REQUIRE(read_vec.Size() == size);
+      for (int i = 0; i < size; ++i)
+      {
+         REQUIRE(read_vec(i) == step + 0.1 * i);
+      }
+   }
+}
+
+TEST_CASE("AsyncParaViewWriter saves snapshots at its cadence")
+{
+   namespace fs = std::filesystem;
+   constexpr int num_saves = 7;
+
+   auto smesh = mfem::Mesh::MakeCartesian2D(2, 2, mfem::Element::TRIANGLE);
+   mfem::ParMesh mesh(MPI_COMM_WORLD, smesh);
+   mfem::H1_FECollection fec(1, mesh.Dimension());
+   mfem::ParFiniteElementSpace fes(&mesh, &fec);
+   mfem::ParGridFunction field(&fes);
+   field = 1.0;
+
+   int rank = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   for (int every : {1, 3, 0})
+   {
+      DYNAMIC_SECTION("...saving every " << every << " call(s)")
+      {
+         const std::string name = "cadence" + std::to_string(every);
+         const auto collection = fs::path("ParaView") / name;
+         if (rank == 0)
+         {
+            fs::remove_all(collection);
+         }
+         MPI_Barrier(MPI_COMM_WORLD);
+         {
+            miso::BackgroundWriter writer;
+            miso::AsyncParaViewWriter paraview(name, mesh, &writer, every);
+            paraview.registerField("field", field);
+            for (int i = 0; i < num_saves; ++i)
+            {
+               field = i;
+               paraview.save(i);
+            }
+         }
+         MPI_Barrier(MPI_COMM_WORLD);
+
+         // each snapshot is saved as its own cycle directory
+         int cycles = 0;
+         if (fs::exists(collection))
+         {
+            for (const auto &entry : fs::directory_iterator(collection))
+            {
+               const auto entry_name = entry.path().filename().string();
+               if (entry.is_directory() && entry_name.rfind("Cycle", 0) == 0)
+               {
+                  ++cycles;
+               }
+            }
+         }
+         const int expected = every < 1 ? 0 : (num_saves + every - 1) / every;
+         REQUIRE(cycles == expected);
+
+         MPI_Barrier(MPI_COMM_WORLD);
+         if (rank == 0)
+         {
+            fs::remove_all(collection);
+         }
+      }
+   }
+}
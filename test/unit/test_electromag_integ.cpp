@@ -149,6 +149,141 @@ TEST_CASE("NonlinearDiffusionIntegrator::AssembleElementGrad")
    }
 }
 
+TEST_CASE("NonlinearDiffusionIntegrator geometric factor cache")
+{
+   using namespace mfem;
+   using namespace electromag_data;
+
+   // generate a 6 element mesh
+   int num_edge = 2;
+   auto mesh = Mesh::MakeCartesian2D(num_edge,
+                                     num_edge,
+                                     Element::TRIANGLE);
+   mesh.EnsureNodes();
+   const auto dim = mesh.SpaceDimension();
+
+   mesh.SetCurvature(1);
+
+   auto &mesh_gf = *mesh.GetNodes();
+   auto *mesh_fespace = mesh_gf.FESpace();
+
+   mfem::GridFunction mesh_pert(mesh_fespace);
+   for (int i = 0; i < mesh_pert.Size(); ++i)
+   {
+      mesh_pert(i) = electromag_data::randNumber();
+   }
+   mesh_pert /= (100 * (num_edge / 32.0));
+
+   mfem::Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   mfem::Array<int> ess_tdof_list;
+   mesh_fespace->GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   mesh_pert.SetSubVector(ess_tdof_list, 0.0);
+
+   NonLinearCoefficient nu;
+   for (int p = 1; p <= 2; ++p)
+   {
+      DYNAMIC_SECTION( "...for degree p = " << p )
+      {
+         H1_FECollection fec(p, dim);
+         FiniteElementSpace fes(&mesh, &fec);
+
+         GridFunction state(&fes);
+         FunctionCoefficient pert(randState);
+         state.ProjectCoefficient(pert);
+
+         NonlinearForm res(&fes);
+         res.AddDomainIntegrator(new miso::NonlinearDiffusionIntegrator(nu));
+
+         auto *cached_integ = new miso::NonlinearDiffusionIntegrator(nu);
+         setOptions(*cached_integ, {{"geometric-cache", true}});
+         NonlinearForm cached_res(&fes);
+         cached_res.AddDomainIntegrator(cached_integ);
+
+         GridFunction r(&fes), cached_r(&fes);
+         res.Mult(state, r);
+         // the first evaluation fills the cache, the second one uses it
+         cached_res.Mult(state, cached_r);
+         REQUIRE(getGeometricCacheMemory(*cached_integ) > 0);
+         cached_res.Mult(state, cached_r);
+         for (int i = 0; i < r.Size(); ++i)
+         {
+            REQUIRE(cached_r(i) == Approx(r(i)).margin(1e-14));
+         }
+
+         // moving the mesh and passing the new coordinates clears the cache
+         mesh_gf += mesh_pert;
+         miso::MISOInputs inputs{{"mesh_coords", miso::InputVector(mesh_gf)}};
+         setInputs(*cached_integ, inputs);
+         REQUIRE(getGeometricCacheMemory(*cached_integ) ==
+                 sizeof(double) * mesh_gf.Size());
+
+         res.Mult(state, r);
+         cached_res.Mult(state, cached_r);
+         for (int i = 0; i < r.Size(); ++i)
+         {
+            REQUIRE(cached_r(i) == Approx(r(i)).margin(1e-14));
+         }
+         mesh_gf -= mesh_pert;
+      }
+   }
+}
+
+TEST_CASE("NonlinearDiffusionIntegrator::AssembleElementVectorAndGrad")
+{
+   using namespace mfem;
+   using namespace electromag_data;
+
+   // generate a 6 element mesh
+   int num_edge = 2;
+   auto mesh = Mesh::MakeCartesian2D(num_edge,
+                                     num_edge,
+                                     Element::TRIANGLE);
+   mesh.EnsureNodes();
+   const auto dim = mesh.SpaceDimension();
+
+   NonLinearCoefficient nu;
+   for (int p = 1; p <= 4; ++p)
+   {
+      DYNAMIC_SECTION( "...for degree p = " << p )
+      {
+         H1_FECollection fec(p, dim);
+         FiniteElementSpace fes(&mesh, &fec);
+
+         GridFunction state(&fes);
+         FunctionCoefficient pert(randState);
+         state.ProjectCoefficient(pert);
+
+         miso::NonlinearDiffusionIntegrator integ(nu);
+         Array<int> vdofs;
+         Vector elfun, elvect, fused_elvect;
+         DenseMatrix elmat, fused_elmat;
+         for (int e = 0; e < fes.GetNE(); ++e)
+         {
+            const auto &el = *fes.GetFE(e);
+            auto &trans = *fes.GetElementTransformation(e);
+            fes.GetElementVDofs(e, vdofs);
+            state.GetSubVector(vdofs, elfun);
+
+            integ.AssembleElementVector(el, trans, elfun, elvect);
+            integ.AssembleElementGrad(el, trans, elfun, elmat);
+            assembleElementVectorAndGrad(
+                integ, el, trans, elfun, fused_elvect, fused_elmat);
+
+            for (int i = 0; i < elvect.Size(); ++i)
+            {
+               REQUIRE(fused_elvect(i) == Approx(elvect(i)).margin(1e-12));
+               for (int j = 0; j < elvect.Size(); ++j)
+               {
+                  REQUIRE(fused_elmat(i, j) ==
+                          Approx(elmat(i, j)).margin(1e-12));
+               }
+            }
+         }
+      }
+   }
+}
+
 TEST_CASE("NonlinearDiffusionIntegratorMeshRevSens::AssembleRHSElementVect")
 {
    using namespace mfem;
@@ -1554,6 +1689,68 @@ TEST_CASE("CurlCurlNLFIntegrator::AssembleElementGrad - Nonlinear",
    }
 }
 
+TEST_CASE("CurlCurlNLFIntegrator::AssembleElementVectorAndGrad",
+          "[CurlCurlNLFIntegrator]")
+{
+   using namespace mfem;
+   using namespace electromag_data;
+
+   const int dim = 3;
+
+   // generate a 6 element mesh
+   int num_edge = 2;
+   std::unique_ptr<Mesh> mesh(
+      new Mesh(Mesh::MakeCartesian3D(num_edge, num_edge, num_edge,
+                                     Element::TETRAHEDRON,
+                                     1.0, 1.0, 1.0, true)));
+   mesh->EnsureNodes();
+
+   for (int p = 1; p <= 4; ++p)
+   {
+      DYNAMIC_SECTION( "...for degree p = " << p )
+      {
+         ND_FECollection fec(p, dim);
+         FiniteElementSpace fes(mesh.get(), &fec);
+
+         GridFunction a(&fes);
+         VectorFunctionCoefficient pert(3, randBaselineVectorPert);
+         a.ProjectCoefficient(pert);
+
+         NonLinearCoefficient nu;
+         miso::CurlCurlNLFIntegrator integ(nu);
+         Array<int> vdofs;
+         Vector elfun, elvect, fused_elvect;
+         DenseMatrix elmat, fused_elmat;
+         for (int e = 0; e < fes.GetNE(); ++e)
+         {
+            const auto &el = *fes.GetFE(e);
+            auto &trans = *fes.GetElementTransformation(e);
+            auto *dof_tr = fes.GetElementVDofs(e, vdofs);
+            a.GetSubVector(vdofs, elfun);
+            if (dof_tr != nullptr)
+            {
+               dof_tr->InvTransformPrimal(elfun);
+            }
+
+            integ.AssembleElementVector(el, trans, elfun, elvect);
+            integ.AssembleElementGrad(el, trans, elfun, elmat);
+            assembleElementVectorAndGrad(
+                integ, el, trans, elfun, fused_elvect, fused_elmat);
+
+            for (int i = 0; i < elvect.Size(); ++i)
+            {
+               REQUIRE(fused_elvect(i) == Approx(elvect(i)).margin(1e-12));
+               for (int j = 0; j < elvect.Size(); ++j)
+               {
+                  REQUIRE(fused_elmat(i, j) ==
+                          Approx(elmat(i, j)).margin(1e-12));
+               }
+            }
+         }
+      }
+   }
+}
+
 TEST_CASE("CurlCurlNLFIntegratorMeshRevSens::AssembleRHSElementVect")
 {
    using namespace mfem;
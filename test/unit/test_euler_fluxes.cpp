@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include "mfem.hpp"
+#include "dual_number.hpp"
 #include "euler_fluxes.hpp"
 #include "euler_test_data.hpp"
 
@@ -480,3 +481,198 @@ TEST_CASE( "calcIsentropicVortexFlux is correct", "[vortex-flux]")
       REQUIRE( flux(i) == Approx(flux2(i)) );
    }
 }
+
+TEMPLATE_TEST_CASE_SIG("Dual-number flux Jacobians match Adept's",
+                       "[euler][dual]", ((int dim), dim), 1, 2, 3)
+{
+   using namespace euler_data;
+   constexpr int num_states = dim + 2;
+   double qL[num_states];
+   double qR[num_states];
+   qL[0] = rho;
+   qL[dim + 1] = rhoe;
+   qR[0] = rho2;
+   qR[dim + 1] = rhoe2;
+   for (int di = 0; di < dim; ++di)
+   {
+      qL[di + 1] = rhou[di];
+      qR[di + 1] = rhou2[di];
+   }
+   const double diss_coeff = 0.5;
+
+   // Jacobian w.r.t. both states, taped by Adept
+   adept::Stack stack;
+   std::vector<adouble> dir_a(dim);
+   std::vector<adouble> qL_a(num_states);
+   std::vector<adouble> qR_a(num_states);
+   adept::set_values(dir_a.data(), dim, dir);
+   adept::set_values(qL_a.data(), num_states, qL);
+   adept::set_values(qR_a.data(), num_states, qR);
+   stack.new_recording();
+   std::vector<adouble> flux_a(num_states);
+   miso::calcIsmailRoeFaceFluxWithDiss<adouble, dim>(
+       dir_a.data(), diss_coeff, qL_a.data(), qR_a.data(), flux_a.data());
+   stack.independent(qL_a.data(), num_states);
+   stack.independent(qR_a.data(), num_states);
+   stack.dependent(flux_a.data(), num_states);
+   mfem::DenseMatrix jac_adept(num_states, 2 * num_states);
+   stack.jacobian(jac_adept.GetData());
+
+   // the same Jacobian from dual numbers
+   using dual_t = miso::Dual<2 * num_states>;
+   dual_t dir_d[dim];
+   dual_t qL_d[num_states];
+   dual_t qR_d[num_states];
+   dual_t flux_d[num_states];
+   miso::setDualValues(dir, dim, dir_d);
+   miso::seedDual(qL, num_states, 0, qL_d);
+   miso::seedDual(qR, num_states, num_states, qR_d);
+   miso::calcIsmailRoeFaceFluxWithDiss<dual_t, dim>(
+       dir_d, dual_t(diss_coeff), qL_d, qR_d, flux_d);
+   mfem::DenseMatrix jac_dual(num_states, 2 * num_states);
+   miso::getDualJacobian(
+       flux_d, num_states, 0, 2 * num_states, jac_dual.GetData());
+
+   for (int i = 0; i < num_states; ++i)
+   {
+      REQUIRE(flux_d[i].val == Approx(flux_a[i].value()));
+      for (int j = 0; j < 2 * num_states; ++j)
+      {
+         REQUIRE(jac_dual(i, j) == Approx(jac_adept(i, j)).margin(abs_tol));
+      }
+   }
+}
+
+TEST_CASE("Dual-number pow is finite at zero", "[dual]")
+{
+   using dual_t = miso::Dual<2>;
+   // x = 0 depends on the first variable only
+   dual_t x(0.0);
+   x.der[0] = 1.0;
+
+   auto root = pow(x, 0.5);
+   REQUIRE(root.val == 0.0);
+   REQUIRE(std::isinf(root.der[0]));
+   REQUIRE(root.der[1] == 0.0);
+
+   auto linear = pow(x, 1.0);
+   REQUIRE(linear.val == 0.0);
+   REQUIRE(linear.der[0] == 1.0);
+   REQUIRE(linear.der[1] == 0.0);
+
+   auto square = pow(x, 2.0);
+   REQUIRE(square.val == 0.0);
+   REQUIRE(square.der[0] == 0.0);
+   REQUIRE(square.der[1] == 0.0);
+
+   auto constant = pow(x, 0.0);
+   REQUIRE(constant.val == 1.0);
+   REQUIRE(constant.der[0] == 0.0);
+   REQUIRE(constant.der[1] == 0.0);
+}
+
+TEMPLATE_TEST_CASE_SIG("Batched flux functions match the scalar ones",
+                       "[euler][simd]", ((int dim), dim), 1, 2, 3)
+{
+   using namespace euler_data;
+   constexpr int num_states = dim + 2;
+   constexpr int W = 4;
+   // lane l uses the data scaled by 1 + 0.1 l; lane 1 has equal left and
+   // right states, which takes the series branch of the log-average
+   double qL[num_states * W];
+   double qR[num_states * W];
+   double nrm[dim * W];
+   double adjJ[dim * dim * W];
+   double vec[num_states * W];
+   for (int l = 0; l < W; ++l)
+   {
+      const double scale = 1.0 + 0.1 * l;
+      qL[l] = rho * scale;
+      qL[(dim + 1) * W + l] = rhoe * scale;
+      qR[l] = l == 1 ? qL[l] : rho2;
+      qR[(dim + 1) * W + l] = l == 1 ? qL[(dim + 1) * W + l] : rhoe2;
+      for (int di = 0; di < dim; ++di)
+      {
+         qL[(di + 1) * W + l] = rhou[di] * scale;
+         qR[(di + 1) * W + l] = l == 1 ? qL[(di + 1) * W + l] : rhou2[di];
+         nrm[di * W + l] = dir[di] * scale;
+      }
+      for (int k = 0; k < dim * dim; ++k)
+      {
+         adjJ[k * W + l] = 1.0 + 0.3 * k - 0.1 * l;
+      }
+      for (int k = 0; k < num_states; ++k)
+      {
+         vec[k * W + l] = 0.1 * k - 0.2 * scale;
+      }
+   }
+
+   // copy lane l of structure-of-arrays data
+   auto getLane = [](const double *data, int n, int l, double *lane)
+   {
+      for (int k = 0; k < n; ++k)
+      {
+         lane[k] = data[k * W + l];
+      }
+   };
+
+   double flux[num_states * W];
+   double qL_l[num_states];
+   double qR_l[num_states];
+   double flux_l[num_states];
+
+   SECTION("calcIsmailRoeFluxBatch is correct")
+   {
+      for (int di = 0; di < dim; ++di)
+      {
+         miso::calcIsmailRoeFluxBatch<dim, false, W>(di, qL, qR, flux);
+         for (int l = 0; l < W; ++l)
+         {
+            getLane(qL, num_states, l, qL_l);
+            getLane(qR, num_states, l, qR_l);
+            miso::calcIsmailRoeFlux<double, dim>(di, qL_l, qR_l, flux_l);
+            for (int k = 0; k < num_states; ++k)
+            {
+               REQUIRE(flux[k * W + l] == Approx(flux_l[k]).margin(abs_tol));
+            }
+         }
+      }
+   }
+
+   SECTION("calcIsmailRoeFaceFluxWithDissBatch is correct")
+   {
+      miso::calcIsmailRoeFaceFluxWithDissBatch<dim, false, W>(
+          nrm, 0.5, qL, qR, flux);
+      double nrm_l[dim];
+      for (int l = 0; l < W; ++l)
+      {
+         getLane(nrm, dim, l, nrm_l);
+         getLane(qL, num_states, l, qL_l);
+         getLane(qR, num_states, l, qR_l);
+         miso::calcIsmailRoeFaceFluxWithDiss<double, dim>(
+             nrm_l, 0.5, qL_l, qR_l, flux_l);
+         for (int k = 0; k < num_states; ++k)
+         {
+            REQUIRE(flux[k * W + l] == Approx(flux_l[k]).margin(abs_tol));
+         }
+      }
+   }
+
+   SECTION("applyLPSScalingBatch is correct")
+   {
+      miso::applyLPSScalingBatch<dim, false, W>(adjJ, qL, vec, flux);
+      double adjJ_l[dim * dim];
+      double vec_l[num_states];
+      for (int l = 0; l < W; ++l)
+      {
+         getLane(adjJ, dim * dim, l, adjJ_l);
+         getLane(qL, num_states, l, qL_l);
+         getLane(vec, num_states, l, vec_l);
+         miso::applyLPSScaling<double, dim>(adjJ_l, qL_l, vec_l, flux_l);
+         for (int k = 0; k < num_states; ++k)
+         {
+            REQUIRE(flux[k * W + l] == Approx(flux_l[k]).margin(abs_tol));
+         }
+      }
+   }
+}
@@ -139,4 +139,63 @@ TEST_CASE("FlowResidual calcEntropyChange", "[FlowResidual]")
       {"state", q}, {"state_dot", dqdt}, {"time", 0.0}, {"dt", 0.0}
    });
    REQUIRE( calcEntropyChange(res, inputs) == Approx(0.0).margin(1e-14) );
-}
\ No newline at end of file
+}
+
+TEST_CASE("FlowResidual getPreconditionerJacobian", "[FlowResidual]")
+{
+   const int dim = 2; // templating is hard here because mesh constructors
+   int num_state = dim + 2;
+   adept::Stack diff_stack;
+
+   // generate a 8 element mesh and build the finite-element space
+   int num_edge = 2;
+   Mesh smesh(Mesh::MakeCartesian2D(num_edge, num_edge, Element::TRIANGLE,
+                                    true /* gen. edges */, 1.0, 1.0, true));
+   ParMesh mesh(MPI_COMM_WORLD, smesh);
+   int p = options["space-dis"]["degree"].get<int>();
+   SBPCollection fec(p, dim);
+   ParFiniteElementSpace fespace(&mesh, &fec, num_state, Ordering::byVDIM);
+   std::map<std::string, FiniteElementState> fields;
+
+   // construct a JFNK residual with the IR flux, preconditioned by the
+   // low-order operator, and a residual that uses the Euler flux directly
+   auto jfnk_options = options;
+   jfnk_options["space-dis"]["flux-fun"] = "IR";
+   jfnk_options["nonlin-solver"]["jacobian-free"] = true;
+   jfnk_options["nonlin-solver"]["jfnk-prec-operator"] = "low-order";
+   FlowResidual<dim,false> res(jfnk_options, fespace, fields, diff_stack);
+   auto euler_options = options;
+   euler_options["space-dis"]["flux-fun"] = "Euler";
+   FlowResidual<dim,false> euler_res(euler_options, fespace, fields,
+                                     diff_stack);
+   int num_var = getSize(res);
+
+   // create a randomly perturbed conservative variable state
+   static std::default_random_engine gen;
+   static std::uniform_real_distribution<double> uniform_rand(0.9,1.1);
+   Vector q(num_var);
+   double mach = options["flow-param"]["mach"].get<double>();
+   double aoa = options["flow-param"]["aoa"].get<double>();
+   for (int i = 0; i < num_var/num_state; ++i)
+   {
+      getFreeStreamQ<double, dim>(mach, aoa, 0, 1, q.GetData()+num_state*i);
+      for (int j = 0; j < num_state; ++j)
+      {
+         q(num_state*i + j) *= uniform_rand(gen);
+      }
+   }
+
+   // the preconditioner Jacobian should be the Euler-flux Jacobian
+   auto inputs = MISOInputs({{"state", q}});
+   Vector v(num_var);
+   for (int i = 0; i < num_var; ++i)
+   {
+      v(i) = uniform_rand(gen);
+   }
+   Vector prec_jac_v(num_var);
+   Vector euler_jac_v(num_var);
+   getPreconditionerJacobian(res, inputs).Mult(v, prec_jac_v);
+   getJacobian(euler_res, inputs, "state").Mult(v, euler_jac_v);
+   euler_jac_v -= prec_jac_v;
+   REQUIRE( euler_jac_v.Norml2() == Approx(0.0).margin(1e-12) );
+}
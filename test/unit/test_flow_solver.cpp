@@ -309,4 +309,98 @@ TEMPLATE_TEST_CASE_SIG("Testing FlowSolver on steady isentropic vortex",
          REQUIRE(drag_error == Approx(target_drag_error[nx-1]).margin(1e-10));
       }
    }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Testing FlowSolver with Jacobian-free Newton-Krylov",
+          "[Euler-Vortex]")
+{
+   using namespace mfem;
+   using namespace miso;
+
+   // Provide the options explicitly for regression tests
+   auto options = R"(
+   {
+      "silent" : true,
+      "flow-param": {
+         "entropy-state": false,
+         "mach": 1.0
+      },
+      "space-dis": {
+         "degree": 1,
+         "lps-coeff": 1.0,
+         "iface-coeff": 1.0,
+         "basis-type": "dsbp",
+         "flux-fun": "IR"
+      },
+      "time-dis": {
+         "type": "PTC",
+         "steady": true,
+         "steady-abstol": 1e-12,
+         "steady-restol": 1e-10,
+         "t-final": 100,
+         "dt": 1e12,
+         "cfl": 1.0,
+         "res-exp": 2.0
+      },
+      "bcs": {
+         "vortex": [1, 2, 3],
+         "slip-wall": [4]
+      },
+      "nonlin-solver": {
+         "printlevel": 0,
+         "maxiter": 50,
+         "reltol": 1e-1,
+         "abstol": 1e-12
+      },
+      "lin-solver": {
+         "type": "hyprefgmres",
+         "printlevel": 0,
+         "filllevel": 3,
+         "maxiter": 100,
+         "reltol": 1e-2,
+         "abstol": 1e-12
+      },
+      "saveresults": false
+   })"_json;
+   const int nx = 2;
+   const int mesh_degree = options["space-dis"]["degree"].get<int>() + 1;
+
+   // the error of the state found with the assembled Jacobian
+   double target_error = 0.0;
+   {
+      FlowSolver<2, false> solver(MPI_COMM_WORLD, options,
+                                  buildQuarterAnnulusMesh(mesh_degree, nx, nx));
+      mfem::Vector state_tv(solver.getStateSize());
+      solver.setState(steadyVortexExact, state_tv);
+      MISOInputs inputs;
+      solver.solveForState(inputs, state_tv);
+      solver.getState().distributeSharedDofs(state_tv);
+      target_error = solver.calcConservativeVarsL2Error(steadyVortexExact, 0);
+   }
+
+   // JFNK solves the same discrete equations, so it must reach the same state
+   // whatever Jacobian its preconditioner is set up with
+   auto jfnk_options = options;
+   jfnk_options["nonlin-solver"]["jacobian-free"] = true;
+   jfnk_options["lin-solver"]["type"] = "gmres";
+   for (const auto *prec_operator : {"full", "low-order", "element-block"})
+   {
+      DYNAMIC_SECTION("...with the " << prec_operator << " preconditioner")
+      {
+         jfnk_options["nonlin-solver"]["jfnk-prec-operator"] = prec_operator;
+         FlowSolver<2, false> solver(
+             MPI_COMM_WORLD,
+             jfnk_options,
+             buildQuarterAnnulusMesh(mesh_degree, nx, nx));
+         mfem::Vector state_tv(solver.getStateSize());
+         solver.setState(steadyVortexExact, state_tv);
+         MISOInputs inputs;
+         solver.solveForState(inputs, state_tv);
+         solver.getState().distributeSharedDofs(state_tv);
+
+         double l2_error =
+             solver.calcConservativeVarsL2Error(steadyVortexExact, 0);
+         REQUIRE(l2_error == Approx(target_error).margin(1e-8));
+      }
+   }
+}
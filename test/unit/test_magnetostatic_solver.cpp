@@ -1,3 +1,367 @@
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "nlohmann/json.hpp"
+
+#include "magnetostatic.hpp"
+
+namespace
+{
+/// Build a unit square mesh whose central elements, within [0.25, 0.75]^2,
+/// form a rotor (attribute 1) surrounded by a stator (attribute 2)
+std::unique_ptr<mfem::Mesh> buildRotorMesh(int nxy)
+{
+   auto mesh = std::make_unique<mfem::Mesh>(
+       mfem::Mesh::MakeCartesian2D(nxy, nxy, mfem::Element::TRIANGLE));
+   for (int e = 0; e < mesh->GetNE(); ++e)
+   {
+      mfem::Array<int> verts;
+      mesh->GetElement(e)->GetVertices(verts);
+      bool rotor = true;
+      for (int v : verts)
+      {
+         const double *vtx = mesh->GetVertex(v);
+         rotor = rotor && std::abs(vtx[0] - 0.5) <= 0.25 + 1e-12 &&
+                 std::abs(vtx[1] - 0.5) <= 0.25 + 1e-12;
+      }
+      mesh->SetAttribute(e, rotor ? 1 : 2);
+   }
+   mesh->SetAttributes();
+   return mesh;
+}
+
+auto rotor_options = R"(
+{
+   "silent": true,
+   "print-options": false,
+   "space-dis": {
+      "basis-type": "h1",
+      "degree": 1
+   },
+   "time-dis": {
+      "steady": true,
+      "steady-abstol": 1e-10,
+      "steady-reltol": 1e-10,
+      "ode-solver": "PTC",
+      "t-final": 100,
+      "dt": 1,
+      "max-iter": 5
+   },
+   "lin-solver": {
+      "type": "gmres",
+      "printlevel": -1,
+      "maxiter": 200,
+      "abstol": 1e-14,
+      "reltol": 1e-14
+   },
+   "lin-prec": {
+      "type": "hypreboomeramg",
+      "printlevel": 0
+   },
+   "nonlin-solver": {
+      "type": "newton",
+      "printlevel": -1,
+      "maxiter": 5,
+      "reltol": 1e-12,
+      "abstol": 1e-12
+   },
+   "components": {
+      "rotor": {
+         "attrs": [1],
+         "material": {
+            "name": "rotor",
+            "mu_r": 1.0
+         }
+      },
+      "stator": {
+         "attrs": [2],
+         "material": {
+            "name": "stator",
+            "mu_r": 1.0
+         }
+      }
+   },
+   "current": {
+      "box": {
+         "box1": [1],
+         "box2": [2]
+      }
+   },
+   "bcs": {
+      "essential": [1, 2, 3, 4]
+   }
+})"_json;
+
+}  // anonymous namespace
+
+TEST_CASE("rotateNodes moves only the rotor's nodes")
+{
+   auto smesh = buildRotorMesh(4);
+   mfem::ParMesh mesh(MPI_COMM_WORLD, *smesh);
+   mesh.EnsureNodes();
+   auto &nodes = *dynamic_cast<mfem::ParGridFunction *>(mesh.GetNodes());
+   auto &mesh_fes = *nodes.ParFESpace();
+
+   const auto rotor_dofs = miso::findNodesOfAttributes(mesh_fes, {1});
+   std::vector<bool> is_rotor(mesh_fes.GetNDofs(), false);
+   for (int dof : rotor_dofs)
+   {
+      is_rotor[dof] = true;
+   }
+   // every node of a rotor element is found
+   mfem::Array<int> dofs;
+   for (int e = 0; e < mesh.GetNE(); ++e)
+   {
+      if (mesh.GetAttribute(e) != 1)
+      {
+         continue;
+      }
+      mesh_fes.GetElementDofs(e, dofs);
+      for (int dof : dofs)
+      {
+         REQUIRE(is_rotor[dof]);
+      }
+   }
+
+   // one increment of the sweep
+   const std::vector<double> center{0.5, 0.5};
+   const double step = 5.0;
+   mfem::Vector coords(nodes.Size());
+   miso::rotateNodes(mesh_fes, rotor_dofs, center, step, nodes, coords);
+
+   const double cos_step = std::cos(step * M_PI / 180.0);
+   const double sin_step = std::sin(step * M_PI / 180.0);
+   for (int dof = 0; dof < mesh_fes.GetNDofs(); ++dof)
+   {
+      const int x_vdof = mesh_fes.DofToVDof(dof, 0);
+      const int y_vdof = mesh_fes.DofToVDof(dof, 1);
+      if (!is_rotor[dof])
+      {
+         REQUIRE(coords(x_vdof) == nodes(x_vdof));
+         REQUIRE(coords(y_vdof) == nodes(y_vdof));
+         continue;
+      }
+      // the node keeps its radius and turns by the step about the center
+      const double dx0 = nodes(x_vdof) - center[0];
+      const double dy0 = nodes(y_vdof) - center[1];
+      const double dx1 = coords(x_vdof) - center[0];
+      const double dy1 = coords(y_vdof) - center[1];
+      const double r2 = dx0 * dx0 + dy0 * dy0;
+      REQUIRE(dx1 * dx1 + dy1 * dy1 == Approx(r2).margin(1e-14));
+      REQUIRE(dx0 * dx1 + dy0 * dy1 == Approx(r2 * cos_step).margin(1e-14));
+      REQUIRE(dx0 * dy1 - dy0 * dx1 == Approx(r2 * sin_step).margin(1e-14));
+   }
+}
+
+TEST_CASE("calcSweepStatistics")
+{
+   auto stats = miso::calcSweepStatistics({1.0, 2.0, 4.0, 1.0});
+   REQUIRE(stats["values"].get<std::vector<double>>().size() == 4);
+   REQUIRE(stats["mean"].get<double>() == Approx(2.0));
+   REQUIRE(stats["min"].get<double>() == Approx(1.0));
+   REQUIRE(stats["max"].get<double>() == Approx(4.0));
+   REQUIRE(stats["ripple"].get<double>() == Approx(1.5));
+
+   // the ripple is relative to the magnitude of the mean
+   stats = miso::calcSweepStatistics({-1.0, -3.0});
+   REQUIRE(stats["mean"].get<double>() == Approx(-2.0));
+   REQUIRE(stats["ripple"].get<double>() == Approx(1.0));
+
+   // and is zero for a zero mean
+   stats = miso::calcSweepStatistics({-1.0, 1.0});
+   REQUIRE(stats["ripple"].get<double>() == 0.0);
+}
+
+TEST_CASE("sweepRotorPositions matches a serial sweep")
+{
+   const std::vector<double> angles{0.0, 1.0, 2.0, 3.0};
+   miso::MISOInputs inputs{{"current_density:box", 1.0}};
+   nlohmann::json sweep_options{
+       {"rotor-attributes", {1}},
+       {"center", {0.5, 0.5}},
+       {"angles", angles},
+       {"outputs", {{"energy", nlohmann::json::object()}}}};
+
+   // every rank sweeps all the angles on its own
+   nlohmann::json serial_values;
+   {
+      miso::MagnetostaticSolver solver(
+          MPI_COMM_SELF, rotor_options, buildRotorMesh(4));
+      mfem::Vector state(solver.getStateSize());
+      state = 0.0;
+      serial_values =
+          solver.solveAtRotorPositions(sweep_options, angles, inputs, state);
+   }
+   const auto serial_energy =
+       serial_values["energy"].get<std::vector<double>>();
+   REQUIRE(serial_energy.size() == angles.size());
+
+   // with several ranks, the groups split the communicator
+   int num_ranks = 1;
+   MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+   std::vector<int> group_counts{1};
+   if (num_ranks > 1)
+   {
+      group_counts.push_back(num_ranks);
+   }
+   for (int num_groups : group_counts)
+   {
+      DYNAMIC_SECTION("...with " << num_groups << " group(s)")
+      {
+         sweep_options["num-groups"] = num_groups;
+         auto results = miso::sweepRotorPositions(MPI_COMM_WORLD,
+                                                  rotor_options,
+                                                  sweep_options,
+                                                  inputs,
+                                                  buildRotorMesh(4));
+         REQUIRE(results["angles"].get<std::vector<double>>() == angles);
+
+         const auto &energy = results["outputs"]["energy"];
+         const auto values = energy["values"].get<std::vector<double>>();
+         REQUIRE(values.size() == angles.size());
+         for (std::size_t i = 0; i < angles.size(); ++i)
+         {
+            REQUIRE(values[i] == Approx(serial_energy[i]).epsilon(1e-8));
+         }
+
+         const auto stats = miso::calcSweepStatistics(serial_energy);
+         REQUIRE(energy["mean"].get<double>() ==
+                 Approx(stats["mean"].get<double>()).epsilon(1e-8));
+         REQUIRE(energy["min"].get<double>() ==
+                 Approx(stats["min"].get<double>()).epsilon(1e-8));
+         REQUIRE(energy["max"].get<double>() ==
+                 Approx(stats["max"].get<double>()).epsilon(1e-8));
+      }
+   }
+}
+
+TEST_CASE("MagnetostaticSolver::calcOutputs matches calcOutput")
+{
+   miso::MagnetostaticSolver solver(
+       MPI_COMM_WORLD, rotor_options, buildRotorMesh(4));
+
+   const std::vector<std::string> names{
+       "dc_loss", "ac_loss", "core_loss", "torque", "energy"};
+   solver.createOutput("dc_loss");
+   solver.createOutput("ac_loss");
+   solver.createOutput("core_loss");
+   solver.createOutput("torque",
+                       {{"attributes", {1}},
+                        {"axis", {0.0, 0.0, 1.0}},
+                        {"about", {0.5, 0.5, 0.0}}});
+   solver.createOutput("energy");
+
+   mfem::Vector state(solver.getStateSize());
+   for (int i = 0; i < state.Size(); ++i)
+   {
+      state(i) = std::sin(0.1 * i);
+   }
+   mfem::Vector peak_flux(solver.getFieldSize("peak_flux"));
+   peak_flux = 0.5;
+   miso::MISOInputs inputs{{"state", state},
+                           {"peak_flux", peak_flux},
+                           {"frequency", 1000.0},
+                           {"wire_length", 2.0},
+                           {"rms_current", 10.0},
+                           {"strand_radius", 1e-3},
+                           {"strands_in_hand", 2.0},
+                           {"stack_length", 0.1},
+                           {"num_turns", 10.0},
+                           {"num_slots", 4.0}};
+
+   mfem::Vector values;
+   solver.calcOutputs(names, inputs, values);
+   REQUIRE(values.Size() == static_cast<int>(names.size()));
+   for (int i = 0; i < values.Size(); ++i)
+   {
+      DYNAMIC_SECTION("...for output " << names[i])
+      {
+         const double value = solver.calcOutput(names[i], inputs);
+         REQUIRE(std::isfinite(value));
+         REQUIRE(values(i) == Approx(value).epsilon(1e-10).margin(1e-14));
+      }
+   }
+}
+
+TEST_CASE("The heat source saves its peak flux only if ParaView logging is on")
+{
+   namespace fs = std::filesystem;
+   const auto collection = fs::path("ParaView") / "peak_flux";
+   int rank = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   auto count_cycles = [&collection]()
+   {
+      int cycles = 0;
+      if (fs::exists(collection))
+      {
+         for (const auto &entry : fs::directory_iterator(collection))
+         {
+            const auto name = entry.path().filename().string();
+            if (entry.is_directory() && name.rfind("Cycle", 0) == 0)
+            {
+               ++cycles;
+            }
+         }
+      }
+      return cycles;
+   };
+
+   constexpr int num_evaluations = 5;
+   auto evaluate = [](const nlohmann::json &options)
+   {
+      miso::MagnetostaticSolver solver(
+          MPI_COMM_WORLD, options, buildRotorMesh(4));
+      solver.createOutput("heat_source");
+
+      mfem::Vector state(solver.getStateSize());
+      state = 0.0;
+      mfem::Vector peak_flux(solver.getFieldSize("peak_flux"));
+      peak_flux = 0.5;
+      miso::MISOInputs inputs{{"state", state},
+                              {"peak_flux", peak_flux},
+                              {"frequency", 1000.0}};
+      mfem::Vector heat_source(solver.getOutputSize("heat_source"));
+      for (int i = 0; i < num_evaluations; ++i)
+      {
+         solver.calcOutput("heat_source", inputs, heat_source);
+      }
+   };
+
+   for (const bool log : {true, false})
+   {
+      DYNAMIC_SECTION("...with ParaView logging " << (log ? "on" : "off"))
+      {
+         if (rank == 0)
+         {
+            fs::remove_all(collection);
+         }
+         MPI_Barrier(MPI_COMM_WORLD);
+
+         auto options = rotor_options;
+         options["paraview"] = {{"log", log},
+                                {"fields", nlohmann::json::array()},
+                                {"diagnostics-every", 2}};
+         evaluate(options);
+         MPI_Barrier(MPI_COMM_WORLD);
+
+         // evaluations 0, 2, and 4 are saved
+         REQUIRE(count_cycles() == (log ? 3 : 0));
+
+         MPI_Barrier(MPI_COMM_WORLD);
+         if (rank == 0)
+         {
+            fs::remove_all(collection);
+         }
+      }
+   }
+}
+
 // #include <random>
 
 // #include "catch.hpp"
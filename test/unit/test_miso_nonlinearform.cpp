@@ -5,9 +5,15 @@
 #include "nlohmann/json.hpp"
 #include "mfem.hpp"
 
+#include "electromag_integ.hpp"
 #include "finite_element_state.hpp"
+#include "mfem_extensions.hpp"
 #include "miso_integrator.hpp"
 #include "miso_nonlinearform.hpp"
+#include "thread_workspaces.hpp"
+#include "utils.hpp"
+
+#include "electromag_test_data.hpp"
 
 class TestIntegrator : public mfem::NonlinearFormIntegrator
 {
@@ -267,6 +273,42 @@ inline void addDomainSensitivityIntegrator(
 
 using namespace miso;
 
+/// The "state" and "mesh_coords" fields on a 2 x 2 x 2 tetrahedral mesh, as
+/// used by the assembly tests below
+struct TetMeshFields
+{
+   /// \param[in] state_options - options of the "state" field
+   explicit TetMeshFields(FiniteElementState::Options &&state_options)
+    : smesh(mfem::Mesh::MakeCartesian3D(2, 2, 2, mfem::Element::TETRAHEDRON)),
+      mesh(MPI_COMM_WORLD, smesh)
+   {
+      mesh.EnsureNodes();
+      fields.emplace(std::piecewise_construct,
+                     std::forward_as_tuple("state"),
+                     std::forward_as_tuple(mesh, std::move(state_options)));
+      auto &mesh_gf = *dynamic_cast<mfem::ParGridFunction *>(mesh.GetNodes());
+      fields.emplace(std::piecewise_construct,
+                     std::forward_as_tuple("mesh_coords"),
+                     std::forward_as_tuple(mesh,
+                                           *mesh_gf.ParFESpace(),
+                                           "mesh_coords"));
+   }
+
+   /// \return the "state" field
+   FiniteElementState &state() { return fields.at("state"); }
+
+   mfem::Mesh smesh;
+   mfem::ParMesh mesh;
+   std::map<std::string, FiniteElementState> fields;
+};
+
+/// \return options of a degree `p` Nedelec "state" field
+FiniteElementState::Options nedelecOptions(int p)
+{
+   return FiniteElementState::Options{
+       .order = p, .coll = std::make_unique<mfem::ND_FECollection>(p, 3)};
+}
+
 TEST_CASE("MISONonlinearForm vectorJacobianProduct (vector) test")
 {
    static std::default_random_engine gen;
@@ -491,3 +533,428 @@ TEST_CASE("MISONonlinearForm vectorJacobianProduct (scalar) test")
    }
    REQUIRE(wrt_bar == Approx(wrt_bar_fd));
 }
+
+#ifdef MISO_USE_OPENMP
+TEST_CASE("MISONonlinearForm threaded assembly matches serial assembly")
+{
+   // with a single thread the "threaded" form would be assembled serially
+   REQUIRE(miso::getMaxAssemblyThreads() > 1);
+
+   static std::default_random_engine gen;
+   static std::uniform_real_distribution<double> uniform_rand(-1.0,1.0);
+
+   electromag_data::NonLinearCoefficient nu;
+
+   // p = 2 Nedelec elements on tets need DOF transformations
+   for (int p = 1; p <= 2; ++p)
+   {
+      DYNAMIC_SECTION("...for degree p = " << p)
+      {
+         TetMeshFields problem(nedelecOptions(p));
+         auto &fields = problem.fields;
+         auto &state = problem.state();
+
+         MISONonlinearForm serial_form(state.space(), fields);
+         serial_form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+
+         MISONonlinearForm threaded_form(state.space(), fields);
+         threaded_form.addDomainIntegrator(
+             new miso::CurlCurlNLFIntegrator(nu));
+         setOptions(threaded_form,
+                    {{"assembly-threads", 4}, {"geometric-cache", true}});
+
+         mfem::Vector state_tv(state.space().GetTrueVSize());
+         for (int i = 0; i < state_tv.Size(); ++i)
+         {
+            state_tv(i) = uniform_rand(gen);
+         }
+         mfem::Vector v(state_tv.Size());
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            v(i) = uniform_rand(gen);
+         }
+         MISOInputs inputs{{"state", state_tv}};
+
+         mfem::Vector res(getSize(serial_form));
+         evaluate(serial_form, inputs, res);
+         mfem::Vector jac_v(getSize(serial_form));
+         getJacobian(serial_form, inputs, "state").Mult(v, jac_v);
+
+         // the first pass fills the geometric factor cache serially, the
+         // second pass is assembled by threads from the cached factors
+         mfem::Vector threaded_res(getSize(threaded_form));
+         mfem::Vector threaded_jac_v(getSize(threaded_form));
+         for (int pass = 0; pass < 2; ++pass)
+         {
+            evaluate(threaded_form, inputs, threaded_res);
+            getJacobian(threaded_form, inputs, "state")
+                .Mult(v, threaded_jac_v);
+            for (int i = 0; i < res.Size(); ++i)
+            {
+               REQUIRE(threaded_res(i) == Approx(res(i)).margin(1e-12));
+               REQUIRE(threaded_jac_v(i) == Approx(jac_v(i)).margin(1e-12));
+            }
+         }
+      }
+   }
+}
+#endif
+
+TEST_CASE("MISONonlinearForm partially assembled Jacobian matches assembled "
+          "Jacobian")
+{
+   static std::default_random_engine gen;
+   static std::uniform_real_distribution<double> uniform_rand(-1.0,1.0);
+
+   electromag_data::NonLinearCoefficient nu;
+
+   // p = 2 Nedelec elements on tets need DOF transformations
+   for (int p = 1; p <= 2; ++p)
+   {
+      DYNAMIC_SECTION("...for degree p = " << p)
+      {
+         TetMeshFields problem(nedelecOptions(p));
+         auto &fields = problem.fields;
+         auto &state = problem.state();
+
+         nlohmann::json options = {{"bcs", {{"essential", {1}}}}};
+
+         MISONonlinearForm full_form(state.space(), fields);
+         full_form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+         setOptions(full_form, options);
+
+         MISONonlinearForm pa_form(state.space(), fields);
+         pa_form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+         options["jacobian-assembly"] = "partial";
+         setOptions(pa_form, options);
+
+         mfem::Vector state_tv(state.space().GetTrueVSize());
+         for (int i = 0; i < state_tv.Size(); ++i)
+         {
+            state_tv(i) = uniform_rand(gen);
+         }
+         mfem::Vector v(state_tv.Size());
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            v(i) = uniform_rand(gen);
+         }
+         MISOInputs inputs{{"state", state_tv}};
+
+         auto &jac = getJacobian(full_form, inputs, "state");
+         auto &pa_jac = getJacobian(pa_form, inputs, "state");
+         auto &jac_trans = getJacobianTranspose(full_form, inputs, "state");
+         auto &pa_jac_trans = getJacobianTranspose(pa_form, inputs, "state");
+
+         mfem::Vector jac_v(v.Size());
+         mfem::Vector pa_jac_v(v.Size());
+         jac.Mult(v, jac_v);
+         pa_jac.Mult(v, pa_jac_v);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(pa_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+         }
+
+         jac_trans.Mult(v, jac_v);
+         pa_jac_trans.Mult(v, pa_jac_v);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(pa_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+         }
+
+         jac_v = 0.0;
+         pa_jac_v = 0.0;
+         jacobianVectorProduct(full_form, v, "state", jac_v);
+         jacobianVectorProduct(pa_form, v, "state", pa_jac_v);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(pa_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+         }
+
+         jac_v = 0.0;
+         pa_jac_v = 0.0;
+         vectorJacobianProduct(full_form, v, "state", jac_v);
+         vectorJacobianProduct(pa_form, v, "state", pa_jac_v);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(pa_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+         }
+      }
+   }
+}
+
+TEST_CASE("MISONonlinearForm Jacobian with reused structure matches rebuilt "
+          "Jacobian")
+{
+   static std::default_random_engine gen;
+   static std::uniform_real_distribution<double> uniform_rand(-1.0,1.0);
+
+   electromag_data::NonLinearCoefficient nu;
+
+   const int p = 2;
+   TetMeshFields problem(nedelecOptions(p));
+   auto &fields = problem.fields;
+   auto &state = problem.state();
+
+   // the curl-curl Jacobian is symmetric, so force explicit transposes to
+   // compare the transposes with the essential dofs eliminated
+   nlohmann::json options = {{"bcs", {{"essential", {1}}}},
+                             {"adjoint-jacobian", "transpose"}};
+
+   MISONonlinearForm rebuilt_form(state.space(), fields);
+   rebuilt_form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+   setOptions(rebuilt_form, options);
+
+   MISONonlinearForm reused_form(state.space(), fields);
+   reused_form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+   options["reuse-jacobian-structure"] = true;
+   setOptions(reused_form, options);
+
+   mfem::Vector v(state.space().GetTrueVSize());
+   for (int i = 0; i < v.Size(); ++i)
+   {
+      v(i) = uniform_rand(gen);
+   }
+
+   // the second state overwrites the values of the structure built for the
+   // first one, in the same matrices
+   const mfem::Operator *reused_jac = nullptr;
+   const mfem::Operator *reused_jac_trans = nullptr;
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+   for (int pass = 0; pass < 2; ++pass)
+   {
+      for (int i = 0; i < state_tv.Size(); ++i)
+      {
+         state_tv(i) = uniform_rand(gen);
+      }
+      MISOInputs inputs{{"state", state_tv}};
+
+      mfem::Vector jac_v(v.Size());
+      mfem::Vector reused_jac_v(v.Size());
+      getJacobian(rebuilt_form, inputs, "state").Mult(v, jac_v);
+      auto &jac = getJacobian(reused_form, inputs, "state");
+      jac.Mult(v, reused_jac_v);
+      for (int i = 0; i < v.Size(); ++i)
+      {
+         REQUIRE(reused_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+      }
+
+      getJacobianTranspose(rebuilt_form, inputs, "state").Mult(v, jac_v);
+      auto &jac_trans = getJacobianTranspose(reused_form, inputs, "state");
+      jac_trans.Mult(v, reused_jac_v);
+      for (int i = 0; i < v.Size(); ++i)
+      {
+         REQUIRE(reused_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+      }
+
+      if (pass == 0)
+      {
+         reused_jac = &jac;
+         reused_jac_trans = &jac_trans;
+      }
+      else
+      {
+         REQUIRE(&jac == reused_jac);
+         REQUIRE(&jac_trans == reused_jac_trans);
+      }
+   }
+}
+
+TEST_CASE("MISONonlinearForm fused residual and Jacobian match separate "
+          "assembly")
+{
+   static std::default_random_engine gen;
+   static std::uniform_real_distribution<double> uniform_rand(-1.0,1.0);
+
+   electromag_data::NonLinearCoefficient nu;
+
+   const int p = 2;
+   TetMeshFields problem(nedelecOptions(p));
+   auto &fields = problem.fields;
+   auto &state = problem.state();
+
+   for (bool reuse : {false, true})
+   {
+      DYNAMIC_SECTION("...with reuse-jacobian-structure = " << reuse)
+      {
+         nlohmann::json options = {{"bcs", {{"essential", {1}}}},
+                                   {"reuse-jacobian-structure", reuse}};
+
+         MISONonlinearForm form(state.space(), fields);
+         form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+         setOptions(form, options);
+
+         MISONonlinearForm fused_form(state.space(), fields);
+         fused_form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+         setOptions(fused_form, options);
+
+         mfem::Vector v(state.space().GetTrueVSize());
+         mfem::Vector state_tv(v.Size());
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            v(i) = uniform_rand(gen);
+            state_tv(i) = uniform_rand(gen);
+         }
+         MISOInputs inputs{{"state", state_tv}};
+
+         mfem::Vector res(v.Size());
+         mfem::Vector fused_res(v.Size());
+         evaluate(form, inputs, res);
+         auto &fused_jac = evaluateAndLinearize(fused_form, inputs, fused_res);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(fused_res(i) == Approx(res(i)).margin(1e-10));
+         }
+
+         mfem::Vector jac_v(v.Size());
+         mfem::Vector fused_jac_v(v.Size());
+         getJacobian(form, inputs, "state").Mult(v, jac_v);
+         fused_jac.Mult(v, fused_jac_v);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(fused_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+         }
+
+         // the transpose is formed from the fused Jacobian as well
+         getJacobianTranspose(form, inputs, "state").Mult(v, jac_v);
+         getJacobianTranspose(fused_form, inputs, "state")
+             .Mult(v, fused_jac_v);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(fused_jac_v(i) == Approx(jac_v(i)).margin(1e-10));
+         }
+      }
+   }
+}
+
+TEST_CASE("MISONonlinearForm adjoint Jacobian modes match explicit transpose")
+{
+   static std::default_random_engine gen;
+   static std::uniform_real_distribution<double> uniform_rand(-1.0,1.0);
+
+   electromag_data::NonLinearCoefficient nu;
+
+   const int p = 2;
+   TetMeshFields problem(nedelecOptions(p));
+   auto &fields = problem.fields;
+   auto &state = problem.state();
+
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+   mfem::Vector v(state_tv.Size());
+   for (int i = 0; i < v.Size(); ++i)
+   {
+      state_tv(i) = uniform_rand(gen);
+      v(i) = uniform_rand(gen);
+   }
+   MISOInputs inputs{{"state", state_tv}};
+
+   nlohmann::json options = {{"bcs", {{"essential", {1}}}}};
+   MISONonlinearForm explicit_form(state.space(), fields);
+   explicit_form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+   setOptions(explicit_form, options);
+   getJacobian(explicit_form, inputs, "state");
+   mfem::Vector jac_trans_v(v.Size());
+   getJacobianTranspose(explicit_form, inputs, "state").Mult(v, jac_trans_v);
+
+   for (const auto *mode : {"symmetric", "implicit", "auto"})
+   {
+      DYNAMIC_SECTION("...for \"adjoint-jacobian\": " << mode)
+      {
+         MISONonlinearForm form(state.space(), fields);
+         form.addDomainIntegrator(new miso::CurlCurlNLFIntegrator(nu));
+         options["adjoint-jacobian"] = mode;
+         setOptions(form, options);
+
+         auto &jac = getJacobian(form, inputs, "state");
+         auto &jac_trans = getJacobianTranspose(form, inputs, "state");
+
+         // the curl-curl Jacobian is symmetric, so "auto" reuses it
+         if (std::string(mode) != "implicit")
+         {
+            REQUIRE(&jac_trans == &jac);
+         }
+
+         mfem::Vector mode_jac_trans_v(v.Size());
+         jac_trans.Mult(v, mode_jac_trans_v);
+         for (int i = 0; i < v.Size(); ++i)
+         {
+            REQUIRE(mode_jac_trans_v(i) ==
+                    Approx(jac_trans_v(i)).margin(1e-10));
+         }
+      }
+   }
+}
+
+TEST_CASE("MISONonlinearForm adjoint of a non-symmetric Jacobian with a hypre "
+          "preconditioner")
+{
+   static std::default_random_engine gen;
+   static std::uniform_real_distribution<double> uniform_rand(-1.0,1.0);
+
+   TetMeshFields problem(
+       FiniteElementState::Options{.order = 1, .num_states = 3});
+   auto &fields = problem.fields;
+   auto &state = problem.state();
+
+   mfem::Vector state_tv(state.space().GetTrueVSize());
+   mfem::Vector rhs(state_tv.Size());
+   for (int i = 0; i < rhs.Size(); ++i)
+   {
+      state_tv(i) = uniform_rand(gen);
+      rhs(i) = uniform_rand(gen);
+   }
+   MISOInputs inputs{{"state", state_tv}};
+
+   // the Jacobian of the convection term u . grad(u) is not symmetric
+   mfem::ConstantCoefficient one(1.0);
+   nlohmann::json options = {{"bcs", {{"essential", {1}}}}};
+
+   mfem::HypreILU ilu;
+   REQUIRE(!supportsTranspose(ilu));
+
+   SECTION("\"implicit\" refuses a preconditioner without MultTranspose")
+   {
+      MISONonlinearForm form(state.space(), fields);
+      form.addDomainIntegrator(new mfem::VectorConvectionNLFIntegrator(one));
+      options["adjoint-jacobian"] = "implicit";
+      setOptions(form, options);
+
+      getJacobian(form, inputs, "state");
+      auto &jac_trans = getJacobianTranspose(form, inputs, "state");
+
+      AdjointPreconditioner adj_prec(ilu);
+      REQUIRE_THROWS_AS(adj_prec.SetOperator(jac_trans), MISOException);
+   }
+
+   SECTION("\"auto\" transposes explicitly for such a preconditioner")
+   {
+      MISONonlinearForm form(state.space(), fields);
+      form.addDomainIntegrator(new mfem::VectorConvectionNLFIntegrator(one));
+      options["adjoint-jacobian"] = "auto";
+      options["adjoint-implicit-transpose"] = false;
+      setOptions(form, options);
+
+      auto &jac = getJacobian(form, inputs, "state");
+      auto &jac_trans = getJacobianTranspose(form, inputs, "state");
+      REQUIRE(&jac_trans != &jac);
+      REQUIRE(dynamic_cast<mfem::HypreParMatrix *>(&jac_trans) != nullptr);
+
+      mfem::GMRESSolver gmres(MPI_COMM_WORLD);
+      gmres.SetRelTol(1e-12);
+      gmres.SetAbsTol(1e-14);
+      gmres.SetMaxIter(500);
+      gmres.SetKDim(100);
+      gmres.SetPreconditioner(ilu);
+      gmres.SetOperator(jac_trans);
+
+      mfem::Vector adjoint(rhs.Size());
+      adjoint = 0.0;
+      gmres.Mult(rhs, adjoint);
+      REQUIRE(gmres.GetConverged());
+
+      // the adjoint satisfies the transposed forward system
+      mfem::Vector adj_res(rhs.Size());
+      jac.MultTranspose(adjoint, adj_res);
+      adj_res -= rhs;
+      REQUIRE(adj_res.Normlinf() == Approx(0.0).margin(1e-8));
+   }
+}
@@ -6,6 +6,7 @@
 #include "nlohmann/json.hpp"
 
 #include "electromag_test_data.hpp"
+#include "material_library.hpp"
 #include "reluctivity_coefficient.hpp"
 
 namespace
@@ -160,4 +161,165 @@ TEST_CASE("logNuBBSplineReluctivityCoefficient::EvalState2ndDeriv")
          REQUIRE(second_deriv == Approx(second_deriv_fd));
       }
    }
-}
\ No newline at end of file
+}
+
+TEST_CASE("logNuBBSplineReluctivityCoefficient tabulated evaluation")
+{
+   std::default_random_engine generator;
+   std::uniform_real_distribution<double> distribution(0.0,10.0);
+
+   // Create quadratic mesh with single C-shaped quadrilateral
+   std::stringstream meshStr;
+   meshStr << mesh_str;
+   mfem::Mesh mesh(meshStr);
+
+   auto component = R"({
+      "components": {
+         "test": {
+            "attrs": [1],
+            "material": {
+               "name": "hiperco50",
+               "reluctivity": {
+                  "model": "lognu",
+                  "cps": [5.5286, 5.4645, 4.5597, 4.2891, 3.8445, 4.2880, 4.9505, 11.9364, 11.9738, 12.6554, 12.8097, 13.3347, 13.5871, 13.5871, 13.5871],
+                  "knots": [0, 0, 0, 0, 0.1479, 0.5757, 0.9924, 1.4090, 1.8257, 2.2424, 2.6590, 3.0757, 3.4924, 3.9114, 8.0039, 10.0000, 10.0000, 10.0000, 10.0000],
+                  "degree": 3
+               }
+            }
+         }
+      }
+   })"_json;
+   miso::ReluctivityCoefficient coeff(component, {});
+
+   component["components"]["test"]["material"]["reluctivity"]["tabulate"] = true;
+   miso::ReluctivityCoefficient table_coeff(component, {});
+
+   mfem::IsoparametricTransformation trans;
+   mesh.GetElementTransformation(0, &trans);
+   const auto &ip = mfem::IntRules.Get(mfem::Geometry::SQUARE, 2).IntPoint(0);
+   trans.SetIntPoint(&ip);
+
+   for (int i = 0; i < 100; ++i)
+   {
+      double state = distribution(generator);
+
+      double nu = coeff.Eval(trans, ip, state);
+      double table_nu = table_coeff.Eval(trans, ip, state);
+      REQUIRE(table_nu == Approx(nu).epsilon(1e-10));
+
+      double dnudb = coeff.EvalStateDeriv(trans, ip, state);
+      double table_dnudb = table_coeff.EvalStateDeriv(trans, ip, state);
+      REQUIRE(table_dnudb == Approx(dnudb).epsilon(1e-10).margin(1e-8));
+
+      double d2nudb2 = coeff.EvalState2ndDeriv(trans, ip, state);
+      double table_d2nudb2 = table_coeff.EvalState2ndDeriv(trans, ip, state);
+      REQUIRE(table_d2nudb2 == Approx(d2nudb2).epsilon(1e-10).margin(1e-8));
+   }
+}
+
+TEST_CASE("BHBSplineReluctivityCoefficient tabulated evaluation")
+{
+   std::default_random_engine generator;
+   std::uniform_real_distribution<double> distribution(0.01,2.0);
+
+   // Create quadratic mesh with single C-shaped quadrilateral
+   std::stringstream meshStr;
+   meshStr << mesh_str;
+   mfem::Mesh mesh(meshStr);
+
+   auto component = R"({
+      "components": {
+         "test": {
+            "attrs": [1],
+            "material": {
+               "name": "hiperco50",
+               "reluctivity": {
+                  "model": "bh"
+               }
+            }
+         }
+      }
+   })"_json;
+   miso::ReluctivityCoefficient coeff(component, miso::material_library);
+
+   component["components"]["test"]["material"]["reluctivity"]["tabulate"] = true;
+   miso::ReluctivityCoefficient table_coeff(component, miso::material_library);
+
+   mfem::IsoparametricTransformation trans;
+   mesh.GetElementTransformation(0, &trans);
+   const auto &ip = mfem::IntRules.Get(mfem::Geometry::SQUARE, 2).IntPoint(0);
+   trans.SetIntPoint(&ip);
+
+   for (int i = 0; i < 100; ++i)
+   {
+      double state = distribution(generator);
+
+      double nu = coeff.Eval(trans, ip, state);
+      double table_nu = table_coeff.Eval(trans, ip, state);
+      REQUIRE(table_nu == Approx(nu).epsilon(1e-10));
+
+      double dnudb = coeff.EvalStateDeriv(trans, ip, state);
+      double table_dnudb = table_coeff.EvalStateDeriv(trans, ip, state);
+      REQUIRE(table_dnudb == Approx(dnudb).epsilon(1e-10).margin(1e-8));
+   }
+}
+
+TEST_CASE("ReluctivityCoefficient::EvalStateDerivBatch")
+{
+   std::default_random_engine generator;
+   std::uniform_real_distribution<double> distribution(0.1,2.0);
+
+   // Create quadratic mesh with single C-shaped quadrilateral
+   std::stringstream meshStr;
+   meshStr << mesh_str;
+   mfem::Mesh mesh(meshStr);
+
+   auto component = R"({
+      "components": {
+         "test": {
+            "attrs": [1],
+            "material": {
+               "name": "hiperco50",
+               "reluctivity": {
+                  "model": "lognu",
+                  "cps": [5.5286, 5.4645, 4.5597, 4.2891, 3.8445, 4.2880, 4.9505, 11.9364, 11.9738, 12.6554, 12.8097, 13.3347, 13.5871, 13.5871, 13.5871],
+                  "knots": [0, 0, 0, 0, 0.1479, 0.5757, 0.9924, 1.4090, 1.8257, 2.2424, 2.6590, 3.0757, 3.4924, 3.9114, 8.0039, 10.0000, 10.0000, 10.0000, 10.0000],
+                  "degree": 3
+               }
+            }
+         }
+      }
+   })"_json;
+
+   for (bool tabulate : {false, true})
+   {
+      component["components"]["test"]["material"]["reluctivity"]["tabulate"] = tabulate;
+      miso::ReluctivityCoefficient coeff(component, {});
+
+      mfem::IsoparametricTransformation trans;
+      mesh.GetElementTransformation(0, &trans);
+      const auto &ir = mfem::IntRules.Get(mfem::Geometry::SQUARE, 6);
+
+      mfem::Vector states(ir.GetNPoints());
+      for (int i = 0; i < ir.GetNPoints(); ++i)
+      {
+         states(i) = distribution(generator);
+      }
+
+      mfem::Vector values, batch_values, batch_derivs;
+      coeff.EvalBatch(trans, ir, states, values);
+      coeff.EvalStateDerivBatch(trans, ir, states, batch_values, batch_derivs);
+
+      for (int i = 0; i < ir.GetNPoints(); ++i)
+      {
+         const auto &ip = ir.IntPoint(i);
+         trans.SetIntPoint(&ip);
+
+         double nu = coeff.Eval(trans, ip, states(i));
+         double dnudb = coeff.EvalStateDeriv(trans, ip, states(i));
+         REQUIRE(values(i) == Approx(nu));
+         REQUIRE(batch_values(i) == Approx(nu));
+         REQUIRE(batch_derivs(i) == Approx(dnudb));
+      }
+   }
+}
@@ -962,4 +962,91 @@ TEST_CASE( "Triangle DSBP multProjOperator is accurate...", "[dsbp-tri-Prj]")
 
       } // DYNAMIC SECTION
    } // loop over p
-}
\ No newline at end of file
+}
+
+TEST_CASE( "SBP sparse operators match the dense ones...", "[sbp-sparse]")
+{
+   const Geometry::Type geoms[3] = {Geometry::SEGMENT, Geometry::TRIANGLE,
+                                    Geometry::TETRAHEDRON};
+   const int min_degree[3] = {0, 1, 0};
+   const int max_degree[3] = {4, 4, 1};
+   for (int dim = 1; dim <= 3; ++dim)
+   {
+      for (int p = min_degree[dim - 1]; p <= max_degree[dim - 1]; ++p)
+      {
+         DYNAMIC_SECTION( "...for dim = " << dim << " and degree p = " << p )
+         {
+            // segments are taken from the 2D collection, like the tests above
+            std::unique_ptr<FiniteElementCollection> fec(
+               new SBPCollection(p, std::max(dim, 2)));
+            const SBPFiniteElement &sbp = dynamic_cast<const SBPFiniteElement&>(
+               *(fec->FiniteElementForGeometry(geoms[dim - 1])));
+            int num_nodes = sbp.GetDof();
+
+            // the nonzeros reproduce the weak operators
+            DenseMatrix Q, Q_sparse(num_nodes);
+            for (int di = 0; di < dim; ++di)
+            {
+               sbp.getWeakOperator(di, Q);
+               Q_sparse = 0.0;
+               const auto &nonzeros = sbp.getWeakOperatorNonzeros(di);
+               for (int i = 0; i < num_nodes; ++i)
+               {
+                  for (int k = sbp.getWeakOperatorRowBegin(di, i);
+                       k < sbp.getWeakOperatorRowBegin(di, i + 1); ++k)
+                  {
+                     REQUIRE( nonzeros[k].i == i );
+                     Q_sparse(i, nonzeros[k].j) = nonzeros[k].value;
+                  }
+               }
+               for (int i = 0; i < num_nodes; ++i)
+               {
+                  for (int j = 0; j < num_nodes; ++j)
+                  {
+                     REQUIRE( Q_sparse(i,j) == Approx(Q(i,j)).margin(abs_tol) );
+                  }
+               }
+            }
+
+            // the skew entries of the pairs match getSkewEntry for arbitrary
+            // adjugates, and the pairs left out have zero skew entries
+            std::vector<DenseMatrix> adjJ(num_nodes, DenseMatrix(dim));
+            for (int i = 0; i < num_nodes; ++i)
+            {
+               for (int k = 0; k < dim; ++k)
+               {
+                  for (int l = 0; l < dim; ++l)
+                  {
+                     adjJ[i](k, l) = 1.0 + 0.1 * i - 0.3 * k + 0.7 * l;
+                  }
+               }
+            }
+            DenseMatrix S;
+            sbp.getSkewEntries(adjJ, S);
+            const auto &pairs = sbp.getSkewPairs();
+            int num_pairs = pairs.size();
+            REQUIRE( S.Height() == num_pairs );
+            int p_idx = 0;
+            for (int i = 0; i < num_nodes; ++i)
+            {
+               for (int j = i + 1; j < num_nodes; ++j)
+               {
+                  bool is_pair = p_idx < num_pairs && pairs[p_idx].i == i
+                                 && pairs[p_idx].j == j;
+                  for (int di = 0; di < dim; ++di)
+                  {
+                     double Sij = sbp.getSkewEntry(di, i, j, adjJ[i], adjJ[j]);
+                     double Sij_sparse = is_pair ? S(p_idx, di) : 0.0;
+                     REQUIRE( Sij_sparse == Approx(Sij).margin(abs_tol) );
+                  }
+                  if (is_pair)
+                  {
+                     ++p_idx;
+                  }
+               }
+            }
+            REQUIRE( p_idx == num_pairs );
+         } // DYNAMIC SECTION
+      } // loop over p
+   } // loop over dim
+}
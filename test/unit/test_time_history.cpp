@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+#include "time_history.hpp"
+
+namespace
+{
+/// \return a smooth state that changes with `step`
+mfem::Vector historyState(int size, int step)
+{
+   mfem::Vector state(size);
+   for (int i = 0; i < size; ++i)
+   {
+      state(i) = std::sin(0.01 * i + 0.1 * step) + step;
+   }
+   return state;
+}
+
+/// \brief Check that `history` reads back the states of `historyState`
+void checkHistory(const miso::TimeHistory &history, int size, int num_steps)
+{
+   REQUIRE(history.numSteps() == num_steps);
+   mfem::Vector state;
+   /// read out of order, as a reverse sweep does
+   for (int step = num_steps - 1; step >= 0; --step)
+   {
+      const double time = history.read(step, state);
+      REQUIRE(time == Approx(0.5 * step));
+      REQUIRE(state.Size() == size);
+      auto expected = historyState(size, step);
+      for (int i = 0; i < size; ++i)
+      {
+         REQUIRE(state(i) == expected(i));
+      }
+   }
+}
+
+}  // namespace
+
+TEST_CASE("TimeHistory stores and reads back states")
+{
+   int rank = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   const auto filename = "time_history_" + std::to_string(rank);
+   const int size = 1000;
+
+   std::vector<std::string> compressions = {"none"};
+#ifdef MISO_USE_ZSTD
+   compressions.emplace_back("zstd");
+#endif
+   for (const auto &compression : compressions)
+   {
+      DYNAMIC_SECTION("with compression " << compression)
+      {
+         {
+            miso::TimeHistory history(filename, compression);
+            for (int step = 0; step < 5; ++step)
+            {
+               REQUIRE(history.append(historyState(size, step), 0.5 * step) ==
+                       step);
+            }
+            checkHistory(history, size, 5);
+         }
+
+         /// reopening keeps the stored states and appends after them
+         miso::TimeHistory history(filename, compression, true);
+         checkHistory(history, size, 5);
+         for (int step = 5; step < 8; ++step)
+         {
+            history.append(historyState(size, step), 0.5 * step);
+         }
+         checkHistory(history, size, 8);
+      }
+   }
+   std::remove(filename.c_str());
+}
+
+TEST_CASE("revolveSchedule reverses every step with bounded snapshots")
+{
+   for (int num_snapshots = 1; num_snapshots <= 4; ++num_snapshots)
+   {
+      for (int num_steps = 1; num_steps <= 40; ++num_steps)
+      {
+         const auto actions = miso::revolveSchedule(num_steps, num_snapshots);
+         std::vector<int> snapshots(num_snapshots, -1);
+         int current = 0;
+         int next_reverse = num_steps - 1;
+         for (const auto &action : actions)
+         {
+            switch (action.type)
+            {
+            case miso::RevolveAction::advance:
+               REQUIRE(action.step == current);
+               REQUIRE(action.to > current);
+               REQUIRE(action.to <= next_reverse);
+               current = action.to;
+               break;
+            case miso::RevolveAction::store:
+               REQUIRE(action.step == current);
+               REQUIRE(action.slot >= 0);
+               REQUIRE(action.slot < num_snapshots);
+               snapshots[action.slot] = current;
+               break;
+            case miso::RevolveAction::restore:
+               REQUIRE(snapshots[action.slot] == action.step);
+               current = action.step;
+               break;
+            case miso::RevolveAction::reverse:
+               REQUIRE(action.step == current);
+               REQUIRE(action.step == next_reverse);
+               --next_reverse;
+               break;
+            }
+         }
+         REQUIRE(next_reverse == -1);
+      }
+   }
+}